@@ -96,10 +96,12 @@ HEADERS += $${PWD}/script/addrulegroup.h \
            $${PWD}/news/newsview.h \
            $${PWD}/news/newsmodel.h \
            $${PWD}/aboutdialog.h \
+           $${PWD}/barengine.h \
            $${PWD}/currencyinfo.h \
            $${PWD}/currencypairitem.h \
            $${PWD}/datafolderchusedialog.h \
            $${PWD}/debugviewer.h \
+           $${PWD}/depthdeltaqueue.h \
            $${PWD}/depthitem.h \
            $${PWD}/depthmodel.h \
            $${PWD}/exchange/exchange.h \
@@ -118,7 +120,14 @@ HEADERS += $${PWD}/script/addrulegroup.h \
            $${PWD}/historyitem.h \
            $${PWD}/historymodel.h \
            $${PWD}/julyaes256.h \
+           $${PWD}/julydecimal.h \
+           $${PWD}/julyfixed.h \
            $${PWD}/julyhttp.h \
+           $${PWD}/julyhttppool.h \
+           $${PWD}/julyjson.h \
+           $${PWD}/julyratelimiter.h \
+           $${PWD}/julyringbuffer.h \
+           $${PWD}/julywebsocket.h \
            $${PWD}/julylightchanges.h \
            $${PWD}/julyrsa.h \
            $${PWD}/julyscrolluponidle.h \
@@ -128,13 +137,18 @@ HEADERS += $${PWD}/script/addrulegroup.h \
            $${PWD}/logthread.h \
            $${PWD}/main.h \
            $${PWD}/login/newpassworddialog.h \
+           $${PWD}/orderbook.h \
+           $${PWD}/orderbookregistry.h \
            $${PWD}/orderitem.h \
            $${PWD}/ordersmodel.h \
            $${PWD}/orderstablecancelbutton.h \
            $${PWD}/login/passworddialog.h \
            $${PWD}/percentpicker.h \
            $${PWD}/qtbitcointrader.h \
+           $${PWD}/rowtextcache.h \
+           $${PWD}/storedtradesreader.h \
            $${PWD}/thisfeatureunderdevelopment.h \
+           $${PWD}/tickstore.h \
            $${PWD}/tradesitem.h \
            $${PWD}/tradesmodel.h \
            $${PWD}/translationdialog.h \
@@ -153,6 +167,8 @@ HEADERS += $${PWD}/script/addrulegroup.h \
            $${PWD}/timesync.h \
            $${PWD}/translationmessage.h \
            $${PWD}/indicatorengine.h \
+           $${PWD}/indicatorsubscriber.h \
+           $${PWD}/technicalindicators.h \
            $${PWD}/menu/currencymenu.h \
            $${PWD}/menu/currencymenucell.h \
            $${PWD}/utils/currencysignloader.h \
@@ -217,9 +233,11 @@ SOURCES +=$${PWD}/script/addrulegroup.cpp \
           $${PWD}/settings/settingsdialoglistelement.cpp \
           $${PWD}/settings/settingsdecimals.cpp \
           $${PWD}/aboutdialog.cpp \
+          $${PWD}/barengine.cpp \
           $${PWD}/currencypairitem.cpp \
           $${PWD}/datafolderchusedialog.cpp \
           $${PWD}/debugviewer.cpp \
+          $${PWD}/depthdeltaqueue.cpp \
           $${PWD}/depthitem.cpp \
           $${PWD}/depthmodel.cpp \
           $${PWD}/exchange/exchange.cpp \
@@ -238,7 +256,12 @@ SOURCES +=$${PWD}/script/addrulegroup.cpp \
           $${PWD}/historyitem.cpp \
           $${PWD}/historymodel.cpp \
           $${PWD}/julyaes256.cpp \
+          $${PWD}/julydecimal.cpp \
           $${PWD}/julyhttp.cpp \
+          $${PWD}/julyhttppool.cpp \
+          $${PWD}/julyjson.cpp \
+          $${PWD}/julyratelimiter.cpp \
+          $${PWD}/julywebsocket.cpp \
           $${PWD}/julylightchanges.cpp \
           $${PWD}/julyrsa.cpp \
           $${PWD}/julyscrolluponidle.cpp \
@@ -248,13 +271,18 @@ SOURCES +=$${PWD}/script/addrulegroup.cpp \
           $${PWD}/logthread.cpp \
           $${PWD}/main.cpp \
           $${PWD}/login/newpassworddialog.cpp \
+          $${PWD}/orderbook.cpp \
+          $${PWD}/orderbookregistry.cpp \
           $${PWD}/orderitem.cpp \
           $${PWD}/ordersmodel.cpp \
           $${PWD}/orderstablecancelbutton.cpp \
           $${PWD}/login/passworddialog.cpp \
           $${PWD}/percentpicker.cpp \
           $${PWD}/qtbitcointrader.cpp \
+          $${PWD}/rowtextcache.cpp \
+          $${PWD}/storedtradesreader.cpp \
           $${PWD}/thisfeatureunderdevelopment.cpp \
+          $${PWD}/tickstore.cpp \
           $${PWD}/tradesitem.cpp \
           $${PWD}/tradesmodel.cpp \
           $${PWD}/translationdialog.cpp \
@@ -272,6 +300,8 @@ SOURCES +=$${PWD}/script/addrulegroup.cpp \
           $${PWD}/timesync.cpp \
           $${PWD}/translationmessage.cpp \
           $${PWD}/indicatorengine.cpp \
+          $${PWD}/indicatorsubscriber.cpp \
+          $${PWD}/technicalindicators.cpp \
           $${PWD}/menu/currencymenu.cpp \
           $${PWD}/menu/currencymenucell.cpp \
           $${PWD}/utils/currencysignloader.cpp \
@@ -0,0 +1,327 @@
+//  This file is part of Qt Bitcoin Trader
+//      https://github.com/JulyIGHOR/QtBitcoinTrader
+//  Copyright (C) 2013-2018 July IGHOR <julyighor@gmail.com>
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  In addition, as a special exception, the copyright holders give
+//  permission to link the code of portions of this program with the
+//  OpenSSL library under certain conditions as described in each
+//  individual source file, and distribute linked combinations including
+//  the two.
+//
+//  You must obey the GNU General Public License in all respects for all
+//  of the code used other than OpenSSL. If you modify file(s) with this
+//  exception, you may extend this exception to your version of the
+//  file(s), but you are not obligated to do so. If you do not wish to do
+//  so, delete this exception statement from your version. If you delete
+//  this exception statement from all source files in the program, then
+//  also delete it here.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "barengine.h"
+#include <QStringList>
+#include "main.h"
+#include "tradesitem.h"
+#include "indicatorengine.h"
+#include "technicalindicators.h"
+
+namespace
+{
+    void sendBarValue(const QString& symbol, const QString& name, double value)
+    {
+        IndicatorEngine::setValue(baseValues.exchangeName, symbol, name, value);
+        mainWindow.sendIndicatorEvent(symbol, name, value);
+    }
+}
+
+BarItem::BarItem()
+{
+    date = 0;
+    open = 0.0;
+    high = 0.0;
+    low = 0.0;
+    close = 0.0;
+    volume = 0.0;
+    turnover = 0.0;
+}
+
+double BarItem::vwap() const
+{
+    if (volume <= 0.0)
+        return close;
+
+    return turnover / volume;
+}
+
+BarEngine::Series::Series()
+{
+    lastTradeDate = 0;
+    hasCurrent = false;
+    closedChanged = false;
+}
+
+BarEngine::SymbolBars::SymbolBars()
+{
+    resumeDate = 0;
+}
+
+BarEngine::BarEngine()
+{
+    historyLimit = 1000;
+}
+
+BarEngine* BarEngine::global()
+{
+    static BarEngine instance;
+    return &instance;
+}
+
+qint64 BarEngine::timeframeSeconds(int timeframe)
+{
+    switch (timeframe)
+    {
+        case Minute1:
+            return 60;
+
+        case Minute5:
+            return 300;
+
+        case Minute15:
+            return 900;
+
+        case Hour1:
+            return 3600;
+
+        case Day1:
+            return 86400;
+    }
+
+    return 0;
+}
+
+QString BarEngine::timeframeName(int timeframe)
+{
+    switch (timeframe)
+    {
+        case Minute1:
+            return QLatin1String("1m");
+
+        case Minute5:
+            return QLatin1String("5m");
+
+        case Minute15:
+            return QLatin1String("15m");
+
+        case Hour1:
+            return QLatin1String("1h");
+
+        case Day1:
+            return QLatin1String("1d");
+    }
+
+    return QString();
+}
+
+int BarEngine::timeframeFromName(const QString& name)
+{
+    for (int timeframe = 0; timeframe < TimeframesCount; timeframe++)
+        if (name.compare(timeframeName(timeframe), Qt::CaseInsensitive) == 0)
+            return timeframe;
+
+    return -1;
+}
+
+void BarEngine::setHistoryLimit(int bars)
+{
+    historyLimit = qMax(1, bars);
+}
+
+void BarEngine::addTrades(const QList<TradesItem>& trades)
+{
+    QStringList changedSymbols;
+
+    for (int n = 0; n < trades.count(); n++)
+    {
+        const TradesItem& trade = trades.at(n);
+
+        if (trade.date <= 0 || trade.price <= 0.0 || trade.amount <= 0.0 || trade.symbol.isEmpty())
+            continue;
+
+        SymbolBars& bars = symbolsBars[trade.symbol];
+
+        if (trade.date <= bars.resumeDate)
+            continue;
+
+        for (int timeframe = 0; timeframe < TimeframesCount; timeframe++)
+            addTrade(bars.series[timeframe], timeframe, trade);
+
+        if (!changedSymbols.contains(trade.symbol))
+            changedSymbols << trade.symbol;
+    }
+
+    for (int n = 0; n < changedSymbols.count(); n++)
+    {
+        SymbolBars& bars = symbolsBars[changedSymbols.at(n)];
+
+        for (int timeframe = 0; timeframe < TimeframesCount; timeframe++)
+            publish(changedSymbols.at(n), timeframe, bars.series[timeframe]);
+    }
+}
+
+void BarEngine::addTrade(Series& series, int timeframe, const TradesItem& trade)
+{
+    qint64 barDate = trade.date - trade.date % timeframeSeconds(timeframe);
+
+    // A late trade of an already closed bar is dropped, closed bars never change
+    if (series.hasCurrent && barDate < series.current.date)
+        return;
+
+    if (!series.hasCurrent || barDate > series.current.date)
+    {
+        if (series.hasCurrent)
+        {
+            series.closed.append(series.current);
+
+            if (series.closed.count() > historyLimit)
+                series.closed.removeFirst(series.closed.count() - historyLimit);
+
+            series.closedChanged = true;
+            TechnicalIndicators::global()->addClosedBar(trade.symbol, timeframe, series.current);
+        }
+
+        series.current = BarItem();
+        series.current.date = barDate;
+        series.current.open = trade.price;
+        series.current.high = trade.price;
+        series.current.low = trade.price;
+        series.current.close = trade.price;
+        series.lastTradeDate = trade.date;
+        series.hasCurrent = true;
+    }
+    else
+    {
+        series.current.high = qMax(series.current.high, trade.price);
+        series.current.low = qMin(series.current.low, trade.price);
+
+        if (trade.date >= series.lastTradeDate)
+        {
+            series.current.close = trade.price;
+            series.lastTradeDate = trade.date;
+        }
+    }
+
+    series.current.volume += trade.amount;
+    series.current.turnover += trade.price * trade.amount;
+}
+
+void BarEngine::publish(const QString& symbol, int timeframe, Series& series)
+{
+    if (!series.hasCurrent)
+        return;
+
+    QString barName = QLatin1String("Bar") + timeframeName(timeframe);
+    const BarItem& current = series.current;
+    const BarItem& published = series.published;
+    bool newBar = current.date != published.date;
+
+    // Only the fields a batch really changed are sent
+    if (newBar || current.open != published.open)
+        sendBarValue(symbol, barName + QLatin1String("Open"), current.open);
+
+    if (newBar || current.high != published.high)
+        sendBarValue(symbol, barName + QLatin1String("High"), current.high);
+
+    if (newBar || current.low != published.low)
+        sendBarValue(symbol, barName + QLatin1String("Low"), current.low);
+
+    if (newBar || current.close != published.close)
+        sendBarValue(symbol, barName + QLatin1String("Close"), current.close);
+
+    if (newBar || current.volume != published.volume)
+    {
+        sendBarValue(symbol, barName + QLatin1String("Volume"), current.volume);
+        sendBarValue(symbol, barName + QLatin1String("VWAP"), current.vwap());
+    }
+
+    series.published = current;
+
+    if (!series.closedChanged || series.closed.isEmpty())
+        return;
+
+    series.closedChanged = false;
+    const BarItem& closed = series.closed.last();
+    QString closedName = QLatin1String("Closed") + barName;
+
+    sendBarValue(symbol, closedName + QLatin1String("Open"), closed.open);
+    sendBarValue(symbol, closedName + QLatin1String("High"), closed.high);
+    sendBarValue(symbol, closedName + QLatin1String("Low"), closed.low);
+    sendBarValue(symbol, closedName + QLatin1String("Close"), closed.close);
+    sendBarValue(symbol, closedName + QLatin1String("Volume"), closed.volume);
+    sendBarValue(symbol, closedName + QLatin1String("VWAP"), closed.vwap());
+
+    // Sent last and always different, scripts can wait for it to read a whole closed bar
+    sendBarValue(symbol, closedName + QLatin1String("Time"), closed.date);
+}
+
+void BarEngine::addStoredTrades(const QString& symbol, const QList<TradesItem>& trades)
+{
+    if (trades.isEmpty())
+        return;
+
+    addTrades(trades);
+    symbolsBars[symbol].resumeDate = qMax(symbolsBars[symbol].resumeDate, trades.last().date);
+}
+
+bool BarEngine::bar(const QString& symbol, int timeframe, int barsBack, BarItem* result) const
+{
+    if (timeframe < 0 || timeframe >= TimeframesCount || barsBack < 0)
+        return false;
+
+    QHash<QString, SymbolBars>::const_iterator found = symbolsBars.constFind(symbol);
+
+    if (found == symbolsBars.constEnd())
+        return false;
+
+    const Series& series = found->series[timeframe];
+
+    if (!series.hasCurrent)
+        return false;
+
+    if (barsBack == 0)
+    {
+        *result = series.current;
+        return true;
+    }
+
+    int index = series.closed.count() - barsBack;
+
+    if (index < 0)
+        return false;
+
+    *result = series.closed.at(index);
+    return true;
+}
+
+int BarEngine::barsCount(const QString& symbol, int timeframe) const
+{
+    if (timeframe < 0 || timeframe >= TimeframesCount)
+        return 0;
+
+    QHash<QString, SymbolBars>::const_iterator found = symbolsBars.constFind(symbol);
+
+    if (found == symbolsBars.constEnd() || !found->series[timeframe].hasCurrent)
+        return 0;
+
+    return found->series[timeframe].closed.count() + 1;
+}
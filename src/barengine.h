@@ -0,0 +1,118 @@
+//  This file is part of Qt Bitcoin Trader
+//      https://github.com/JulyIGHOR/QtBitcoinTrader
+//  Copyright (C) 2013-2018 July IGHOR <julyighor@gmail.com>
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  In addition, as a special exception, the copyright holders give
+//  permission to link the code of portions of this program with the
+//  OpenSSL library under certain conditions as described in each
+//  individual source file, and distribute linked combinations including
+//  the two.
+//
+//  You must obey the GNU General Public License in all respects for all
+//  of the code used other than OpenSSL. If you modify file(s) with this
+//  exception, you may extend this exception to your version of the
+//  file(s), but you are not obligated to do so. If you do not wish to do
+//  so, delete this exception statement from your version. If you delete
+//  this exception statement from all source files in the program, then
+//  also delete it here.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef BARENGINE_H
+#define BARENGINE_H
+
+#include <QHash>
+#include <QList>
+#include <QMetaType>
+#include <QString>
+#include "julyringbuffer.h"
+
+struct TradesItem;
+
+struct BarItem
+{
+    BarItem();
+
+    qint64 date;//Open time of the bar, aligned to its timeframe
+    double open;
+    double high;
+    double low;
+    double close;
+    double volume;
+    double turnover;//Sum of price * amount, gives the VWAP
+
+    double vwap() const;
+};
+
+Q_DECLARE_METATYPE(BarItem)
+
+// OHLCV bars of every traded symbol in 1m, 5m, 15m, 1h and 1d timeframes.
+// Each trade updates the open bar of every timeframe in place, a trade past the
+// bar end closes it into a bounded history. Intervals without trades make no bar.
+// The open and the last closed bars are sent to IndicatorEngine and scripts as
+// Bar1mClose, ClosedBar1mClose and so on, once per batch of trades.
+// Every closed bar also goes to TechnicalIndicators.
+// Lives on the GUI thread, fed from QtBitcoinTrader::addLastTrades.
+class BarEngine
+{
+public:
+    enum Timeframe {Minute1, Minute5, Minute15, Hour1, Day1, TimeframesCount};
+
+    BarEngine();
+
+    static BarEngine* global();
+
+    static qint64 timeframeSeconds(int timeframe);
+    static QString timeframeName(int timeframe);
+    static int timeframeFromName(const QString& name);
+
+    void setHistoryLimit(int bars);
+    void addTrades(const QList<TradesItem>& trades);
+
+    // Trades read back from TickStore, live trades up to the last of them are skipped afterwards
+    void addStoredTrades(const QString& symbol, const QList<TradesItem>& trades);
+
+    // barsBack 0 is the open bar, 1 the last closed one
+    bool bar(const QString& symbol, int timeframe, int barsBack, BarItem* result) const;
+    int barsCount(const QString& symbol, int timeframe) const;
+
+private:
+    struct Series
+    {
+        Series();
+
+        JulyRingBuffer<BarItem> closed;
+        BarItem current;
+        BarItem published;
+        qint64 lastTradeDate;
+        bool hasCurrent;
+        bool closedChanged;
+    };
+
+    struct SymbolBars
+    {
+        SymbolBars();
+
+        Series series[TimeframesCount];
+        qint64 resumeDate;
+    };
+
+    QHash<QString, SymbolBars> symbolsBars;
+    int historyLimit;
+
+    void addTrade(Series& series, int timeframe, const TradesItem& trade);
+    void publish(const QString& symbol, int timeframe, Series& series);
+};
+
+#endif // BARENGINE_H
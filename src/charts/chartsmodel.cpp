@@ -36,12 +36,55 @@
 #include "timesync.h"
 #include "charts/chartsmodel.h"
 
+template <typename T>
+static qint32 firstIndexFrom(const JulyRingBuffer<T>& items, quint32 date)
+{
+    qint32 first = 0;
+    qint32 last = items.count();
+
+    while (first < last)
+    {
+        qint32 middle = (first + last) / 2;
+
+        if (items.at(middle).date < date)
+            first = middle + 1;
+        else
+            last = middle;
+    }
+
+    return first;
+}
+
+static const qint32 levelSeconds[]   = {1, 60, 3600};
+static const qint32 levelRetention[] = {6 * 3600, 14 * 86400, 366 * 86400};
+static const qint32 zoomIntervals[]  = {60, 300, 900, 3600, 4 * 3600, 86400, 7 * 86400};
+static const qint32 zoomIntervalsCount = sizeof(zoomIntervals) / sizeof(zoomIntervals[0]);
+
+// A level is used while it gives at most this many columns per pixel
+static const qint32 levelColumnsPerPixel = 8;
+
 ChartsModel::ChartsModel()
     : QObject(),
-      perfomanceStep(1),
+      layoutChanged(true),
+      graphTradesStable(0),
       intervalDate(60),
       intervalCount(10),
-      fontMetrics(new QFontMetrics(QApplication::font()))
+      fontMetrics(new QFontMetrics(QApplication::font())),
+      tradesSequence(0),
+      holdTrades(false),
+      zoomIndex(0),
+      viewEndDate(0),
+      layoutValid(false),
+      layoutWidth(0),
+      layoutHeight(0),
+      layoutFirstDate(0),
+      layoutLevel(SecondsLevel),
+      openColumnDate(0),
+      graphXScale(0.0),
+      graphLevel(SecondsLevel),
+      boundsVisible(true),
+      amountMax(0.0),
+      priceInit(false)
 {
 
 }
@@ -52,54 +95,203 @@ ChartsModel::~ChartsModel()
 
 void ChartsModel::addLastTrades(QList<TradesItem>* newItems)
 {
-    for (qint32 n = 0; n < newItems->count(); ++n)
+    if (holdTrades)
+    {
+        heldTrades << *newItems;
+        delete newItems;
+        return;
+    }
+
+    appendTrades(*newItems);
+    delete newItems;
+}
+
+void ChartsModel::addStoredTrades(QList<TradesItem>* newItems)
+{
+    appendTrades(*newItems);
+    delete newItems;
+}
+
+void ChartsModel::holdLastTrades(bool hold)
+{
+    holdTrades = hold;
+
+    if (hold || heldTrades.isEmpty())
+        return;
+
+    appendTrades(heldTrades);
+    heldTrades.clear();
+}
+
+void ChartsModel::appendTrades(const QList<TradesItem>& newItems)
+{
+    for (qint32 n = 0; n < newItems.count(); ++n)
     {
-        if (tradesDate.count() && tradesDate.last() > newItems->at(n).date)
+        const TradesItem& item = newItems.at(n);
+
+        if (tradesLevels[SecondsLevel].count() && tradesLevels[SecondsLevel].last().date > item.date)
             continue;
 
-        tradesDate .append(newItems->at(n).date);
-        tradesPrice.append(newItems->at(n).price);
-        tradesType .append(newItems->at(n).orderType);
+        ChartsTradesColumn trade;
+        trade.date = item.date;
+        trade.firstPrice = trade.lowPrice = trade.highPrice = trade.lastPrice = item.price;
+        trade.firstType = trade.lowType = trade.highType = trade.lastType = item.orderType;
+        trade.firstSequence = trade.lowSequence = trade.highSequence = trade.lastSequence = ++tradesSequence;
+        trade.volume = item.amount;
 
-        if (amountDate.count() && newItems->at(n).date < (amountDate.last() + intervalDate))
-            amountPrice.last() += newItems->at(n).amount;
-        else
-        {
-            amountPrice.append(newItems->at(n).amount);
-            amountDate.append(int(newItems->at(n).date / intervalDate) * intervalDate);
-        }
+        for (qint32 level = SecondsLevel; level < LevelsCount; ++level)
+            addToLevel(level, trade);
     }
 
-    delete newItems;
-
+    removeOldData();
     baseValues_->mainWindow_->chartsView->comeNewData();
 }
 
+qint32 ChartsModel::timeSpan() const
+{
+    return intervalDate * intervalCount;
+}
+
+qint32 ChartsModel::historySpan() const
+{
+    return levelRetention[MinutesLevel];
+}
+
+void ChartsModel::zoom(qint32 steps)
+{
+    qint32 newZoomIndex = qBound(0, zoomIndex + steps, zoomIntervalsCount - 1);
+
+    if (newZoomIndex == zoomIndex)
+        return;
+
+    zoomIndex = newZoomIndex;
+    intervalDate = zoomIntervals[zoomIndex];
+
+    if (viewEndDate)
+        viewEndDate = (viewEndDate + intervalDate - 1) / intervalDate * intervalDate;
+}
+
+void ChartsModel::pan(qint32 intervals)
+{
+    quint32 currentTime = TimeSync::getTimeT();
+    qint64 liveLastDate = qint64(currentTime / intervalDate) * intervalDate + intervalDate;
+    qint64 oldestLastDate = qint64((currentTime - historySpan()) / intervalDate) * intervalDate + timeSpan();
+    qint64 lastDate = viewEndDate ? viewEndDate : liveLastDate;
+
+    lastDate = qMax(lastDate + qint64(intervals) * intervalDate, oldestLastDate);
+    viewEndDate = lastDate >= liveLastDate ? 0 : quint32(lastDate);
+}
+
+void ChartsModel::resetView()
+{
+    zoomIndex = 0;
+    intervalDate = zoomIntervals[zoomIndex];
+    viewEndDate = 0;
+}
+
+bool ChartsModel::isLive() const
+{
+    return viewEndDate == 0;
+}
+
+qint32 ChartsModel::intervalWidth() const
+{
+    return qRound(graphXScale * intervalDate);
+}
+
+void ChartsModel::addToLevel(qint32 level, ChartsTradesColumn trade)
+{
+    JulyRingBuffer<ChartsTradesColumn>& columns = tradesLevels[level];
+    trade.date = trade.date / levelSeconds[level] * levelSeconds[level];
+
+    if (columns.count() && columns.last().date == trade.date)
+        mergeTradesColumn(columns[columns.count() - 1], trade);
+    else
+        columns.append(trade);
+}
+
 void ChartsModel::addBound(double price, bool type)
 {
     if (type == true)
+        addBoundPoint(boundsSell, price);
+    else
+        addBoundPoint(boundsBuy, price);
+}
+
+void ChartsModel::addBoundPoint(JulyRingBuffer<ChartsPoint>& bounds, double price)
+{
+    quint32 date = TimeSync::getTimeT();
+
+    if (bounds.count())
     {
-        boundsSellDate .append(TimeSync::getTimeT());
-        boundsSellPrice.append(price);
+        if (bounds.last().price == price)
+            return;
+
+        // Bounds change on every depth update, only the last price of a second is drawn
+        if (bounds.last().date == date)
+        {
+            bounds[bounds.count() - 1].price = price;
+            return;
+        }
     }
-    else
+
+    ChartsPoint bound;
+    bound.date = date;
+    bound.price = price;
+    bounds.append(bound);
+
+    removeOldData();
+}
+
+void ChartsModel::removeOldData()
+{
+    quint32 currentTime = TimeSync::getTimeT();
+
+    for (qint32 level = SecondsLevel; level < LevelsCount; ++level)
+        tradesLevels[level].removeFirst(firstIndexFrom(tradesLevels[level], currentTime - levelRetention[level]));
+
+    // The last bound before the retention is the price the spread starts from
+    quint32 firstDate = currentTime - levelRetention[SecondsLevel];
+    boundsSell.removeFirst(firstIndexFrom(boundsSell, firstDate) - 1);
+    boundsBuy.removeFirst(firstIndexFrom(boundsBuy, firstDate) - 1);
+}
+
+void ChartsModel::mergeTradesColumn(ChartsTradesColumn& column, const ChartsTradesColumn& next)
+{
+    if (next.lowPrice < column.lowPrice)
     {
-        boundsBuyDate .append(TimeSync::getTimeT());
-        boundsBuyPrice.append(price);
+        column.lowPrice = next.lowPrice;
+        column.lowType = next.lowType;
+        column.lowSequence = next.lowSequence;
     }
+
+    if (next.highPrice > column.highPrice)
+    {
+        column.highPrice = next.highPrice;
+        column.highType = next.highType;
+        column.highSequence = next.highSequence;
+    }
+
+    column.lastPrice = next.lastPrice;
+    column.lastType = next.lastType;
+    column.lastSequence = next.lastSequence;
+    column.volume += next.volume;
 }
 
 void ChartsModel::clearCharts()
 {
-    amountDate .clear();
-    amountPrice.clear();
-    tradesDate .clear();
-    tradesPrice.clear();
-    tradesType .clear();
-    boundsSellDate .clear();
-    boundsSellPrice.clear();
-    boundsBuyDate  .clear();
-    boundsBuyPrice .clear();
+    for (qint32 level = SecondsLevel; level < LevelsCount; ++level)
+        tradesLevels[level].clear();
+
+    heldTrades.clear();
+    boundsSell.clear();
+    boundsBuy.clear();
+    invalidateLayout();
+}
+
+void ChartsModel::invalidateLayout()
+{
+    layoutValid = false;
 }
 
 double ChartsModel::stepRound(double step)
@@ -177,6 +369,46 @@ double ChartsModel::axisRound(double old_x, double old_step)
 }
 
 void ChartsModel::prepareInit()
+{
+    graphAmountX.clear();
+    graphAmountY.clear();
+    graphBoundsSellX.clear();
+    graphBoundsSellY.clear();
+    graphBoundsBuyX.clear();
+    graphBoundsBuyY.clear();
+
+    nowTime        = TimeSync::getTimeT();
+    graphLastDate  = int(nowTime / intervalDate) * intervalDate + intervalDate;
+
+    if (viewEndDate && viewEndDate < graphLastDate)
+        graphLastDate = viewEndDate;
+    else
+        viewEndDate = 0;
+
+    graphFirstDate = graphLastDate - intervalDate * intervalCount;
+}
+
+void ChartsModel::prepareLevel(qint16 parentWidth)
+{
+    graphLevel = SecondsLevel;
+
+    while (graphLevel + 1 < LevelsCount && (timeSpan() / levelSeconds[graphLevel] > parentWidth * levelColumnsPerPixel ||
+                                            nowTime - levelRetention[graphLevel] > graphFirstDate))
+        ++graphLevel;
+
+    // Bounds are kept with the seconds only
+    boundsVisible = graphLevel == SecondsLevel;
+
+    const JulyRingBuffer<ChartsTradesColumn>& columns = tradesLevels[graphLevel];
+    iTradesFirst     = firstIndexFrom(columns,    graphFirstDate);
+    iTradesEnd       = firstIndexFrom(columns,    graphLastDate);
+    iBoundsSellFirst = firstIndexFrom(boundsSell, graphFirstDate);
+    iBoundsSellEnd   = firstIndexFrom(boundsSell, graphLastDate);
+    iBoundsBuyFirst  = firstIndexFrom(boundsBuy,  graphFirstDate);
+    iBoundsBuyEnd    = firstIndexFrom(boundsBuy,  graphLastDate);
+}
+
+void ChartsModel::prepareLayout()
 {
     graphDateText .clear();
     graphDateTextX.clear();
@@ -185,19 +417,11 @@ void ChartsModel::prepareInit()
     graphPriceText .clear();
     graphPriceTextY.clear();
 
-    graphAmountX.clear();
-    graphAmountY.clear();
     graphTradesX   .clear();
     graphTradesY   .clear();
     graphTradesType.clear();
-    graphBoundsSellX.clear();
-    graphBoundsSellY.clear();
-    graphBoundsBuyX.clear();
-    graphBoundsBuyY.clear();
-
-    nowTime        = TimeSync::getTimeT();
-    graphLastDate  = int(nowTime / intervalDate) * intervalDate + intervalDate;
-    graphFirstDate = graphLastDate - intervalDate * 10;
+    graphTradesStable = 0;
+    openColumnDate = graphFirstDate;
 }
 
 void ChartsModel::prepareXAxis()
@@ -207,19 +431,48 @@ void ChartsModel::prepareXAxis()
     for (quint32 i = graphFirstDate; i <= graphLastDate; i += intervalDate)
     {
         graphDateTextX.append(qRound(graphXScale * (i - graphFirstDate)));
-        graphDateText .append(QDateTime::fromTime_t(i).toString("h:mm"));
+        graphDateText .append(QDateTime::fromTime_t(i).toString(intervalDate < 86400 ? "h:mm" : "dd.MM"));
+    }
+}
+
+void ChartsModel::prepareAmountMax()
+{
+    const JulyRingBuffer<ChartsTradesColumn>& columns = tradesLevels[graphLevel];
+    double newAmountMax = 0.0;
+    amountBins.clear();
+
+    for (qint32 i = iTradesFirst; i < iTradesEnd; ++i)
+    {
+        quint32 binDate = columns.at(i).date / intervalDate * intervalDate;
+
+        if (amountBins.count() && amountBins.last().date == binDate)
+            amountBins.last().price += columns.at(i).volume;
+        else
+        {
+            ChartsPoint amount;
+            amount.date = binDate;
+            amount.price = columns.at(i).volume;
+            amountBins.append(amount);
+        }
+
+        newAmountMax = qMax(newAmountMax, amountBins.last().price);
+    }
+
+    // The scale is kept while the bars still use more than half of it
+    if (layoutChanged || newAmountMax > amountMax || newAmountMax * 2 < amountMax)
+    {
+        amountMax = newAmountMax;
+        layoutChanged = true;
     }
 }
 
 void ChartsModel::prepareAmountYAxis()
 {
-    iAmountFirst = qLowerBound(amountDate.begin(), amountDate.end(), graphFirstDate) - amountDate.begin();
     widthAmountYAxis = 5;
+    amountYScale = 0.0;
 
-    if (iAmountFirst < amountDate.count())
+    if (amountMax > 0)
     {
-        amountMax    = amountPrice.at(std::max_element(amountPrice.begin() + iAmountFirst,
-                                      amountPrice.end()) - amountPrice.begin());
         amountYScale = double(chartsHeight) * 0.9 / amountMax;
         double amountStepY = stepRound(amountMax / 5);
 
@@ -236,97 +489,104 @@ void ChartsModel::prepareAmountYAxis()
 
 void ChartsModel::prepareAmount()
 {
-    if (iAmountFirst < amountDate.count())
+    for (qint32 i = 0; i < amountBins.count(); ++i)
     {
-        for (qint32 i = iAmountFirst; i < amountPrice.count(); ++i)
-        {
-            graphAmountX.append(qRound(graphXScale * (amountDate.at(i) - graphFirstDate + intervalDate / 2)));
-            graphAmountY.append(qRound(amountYScale * amountPrice.at(i)));
-        }
+        graphAmountX.append(qRound(graphXScale * (amountBins.at(i).date - graphFirstDate + intervalDate / 2)));
+        graphAmountY.append(qRound(amountYScale * amountBins.at(i).price));
     }
 }
 
 void ChartsModel::preparePriceMinMax()
 {
-    priceInit = false;
-    priceMin = -1;
-    priceMax = -1;
-    iTradesFirst     = qLowerBound(tradesDate.begin(),     tradesDate.end(),     graphFirstDate) - tradesDate.begin();
-    iBoundsSellFirst = qLowerBound(boundsSellDate.begin(), boundsSellDate.end(), graphFirstDate) - boundsSellDate.begin();
-    iBoundsBuyFirst  = qLowerBound(boundsBuyDate.begin(),  boundsBuyDate.end(),  graphFirstDate) - boundsBuyDate.begin();
-
-    double temp;
+    const JulyRingBuffer<ChartsTradesColumn>& columns = tradesLevels[graphLevel];
     QList<double> min;
     QList<double> max;
 
-    if (iTradesFirst < tradesDate.count())
+    if (iTradesFirst < iTradesEnd)
     {
-        temp = tradesPrice.at(std::min_element(tradesPrice.begin() + iTradesFirst, tradesPrice.end()) - tradesPrice.begin());
+        double tradesMin = columns.at(iTradesFirst).lowPrice;
+        double tradesMax = columns.at(iTradesFirst).highPrice;
 
-        if (temp > 0)
-            min.push_back(temp);
+        for (qint32 i = iTradesFirst + 1; i < iTradesEnd; ++i)
+        {
+            tradesMin = qMin(tradesMin, columns.at(i).lowPrice);
+            tradesMax = qMax(tradesMax, columns.at(i).highPrice);
+        }
 
-        temp = tradesPrice.at(std::max_element(tradesPrice.begin() + iTradesFirst, tradesPrice.end()) - tradesPrice.begin());
+        if (tradesMin > 0)
+            min.push_back(tradesMin);
 
-        if (temp > 0)
-            max.push_back(temp);
+        if (tradesMax > 0)
+            max.push_back(tradesMax);
     }
 
-    if (iBoundsSellFirst < boundsSellDate.count())
+    if (boundsVisible && iBoundsSellFirst < iBoundsSellEnd)
     {
-        int tempIBoundsSellFirst = iBoundsSellFirst;
-
-        if (tempIBoundsSellFirst > 0)
-            --tempIBoundsSellFirst;
+        double boundsMin = boundsSell.at(qMax(0, iBoundsSellFirst - 1)).price;
+        double boundsMax = boundsMin;
 
-        temp = boundsSellPrice.at(std::min_element(boundsSellPrice.begin() + tempIBoundsSellFirst,
-                                  boundsSellPrice.end()) - boundsSellPrice.begin());
-
-        if (temp > 0)
-            min.push_back(temp);
+        for (qint32 i = qMax(0, iBoundsSellFirst - 1) + 1; i < iBoundsSellEnd; ++i)
+        {
+            boundsMin = qMin(boundsMin, boundsSell.at(i).price);
+            boundsMax = qMax(boundsMax, boundsSell.at(i).price);
+        }
 
-        temp = boundsSellPrice.at(std::max_element(boundsSellPrice.begin() + tempIBoundsSellFirst,
-                                  boundsSellPrice.end()) - boundsSellPrice.begin());
+        if (boundsMin > 0)
+            min.push_back(boundsMin);
 
-        if (temp > 0)
-            max.push_back(temp);
+        if (boundsMax > 0)
+            max.push_back(boundsMax);
     }
 
-    if (iBoundsBuyFirst < boundsBuyDate.count())
+    if (boundsVisible && iBoundsBuyFirst < iBoundsBuyEnd)
     {
-        int tempIBoundsBuyFirst = iBoundsBuyFirst;
+        double boundsMin = boundsBuy.at(qMax(0, iBoundsBuyFirst - 1)).price;
+        double boundsMax = boundsBuy.at(iBoundsBuyFirst).price;
 
-        if (tempIBoundsBuyFirst > 0)
-            --tempIBoundsBuyFirst;
+        for (qint32 i = qMax(0, iBoundsBuyFirst - 1) + 1; i < iBoundsBuyEnd; ++i)
+            boundsMin = qMin(boundsMin, boundsBuy.at(i).price);
 
-        temp = boundsBuyPrice.at(std::min_element(boundsBuyPrice.begin() + tempIBoundsBuyFirst,
-                                 boundsBuyPrice.end()) - boundsBuyPrice.begin());
+        for (qint32 i = iBoundsBuyFirst + 1; i < iBoundsBuyEnd; ++i)
+            boundsMax = qMax(boundsMax, boundsBuy.at(i).price);
 
-        if (temp > 0)
+        if (boundsMin > 0)
         {
             if (min.count() < 2)
-                min.push_back(temp);
+                min.push_back(boundsMin);
             else
-                min.last() = qMin(min.last(), temp);
+                min.last() = qMin(min.last(), boundsMin);
         }
 
-        temp = boundsBuyPrice.at(std::max_element(boundsBuyPrice.begin() + iBoundsBuyFirst,
-                                 boundsBuyPrice.end()) - boundsBuyPrice.begin());
-
-        if (temp > 0)
+        if (boundsMax > 0)
         {
             if (max.count() < 2)
-                max.push_back(temp);
+                max.push_back(boundsMax);
             else
-                max.last() = qMax(max.last(), temp);
+                max.last() = qMax(max.last(), boundsMax);
         }
     }
 
     if (min.count() == 0 || max.count() == 0)
+    {
+        if (priceInit)
+            layoutChanged = true;
+
+        priceInit = false;
         return;
+    }
+
+    double newPriceMin = qMin(min.first(), min.last());
+    double newPriceMax = qMax(max.first(), max.last());
 
-    priceMin = qMin(min.first(), min.last());
-    priceMax = qMax(max.first(), max.last());
+    // Prices inside the axis keep it, unless they shrank to a quarter of it
+    if (!layoutChanged && priceInit && newPriceMin >= priceMin && newPriceMax <= priceMax &&
+        (newPriceMax - newPriceMin) * 4 >= priceMax - priceMin)
+        return;
+
+    layoutChanged = true;
+    priceInit = false;
+    priceMin = newPriceMin;
+    priceMax = newPriceMax;
 
     if (priceMax != priceMin)
     {
@@ -372,49 +632,91 @@ void ChartsModel::preparePriceYAxis()
 
 void ChartsModel::preparePrice()
 {
-    qint16 x, y;
+    graphTradesX   .erase(graphTradesX   .begin() + graphTradesStable, graphTradesX   .end());
+    graphTradesY   .erase(graphTradesY   .begin() + graphTradesStable, graphTradesY   .end());
+    graphTradesType.erase(graphTradesType.begin() + graphTradesStable, graphTradesType.end());
 
-    if (priceInit)
+    const JulyRingBuffer<ChartsTradesColumn>& columns = tradesLevels[graphLevel];
+    qint32 iFirst = firstIndexFrom(columns, openColumnDate);
+
+    if (!priceInit || iFirst >= iTradesEnd)
+        return;
+
+    // Level columns falling into one pixel column are merged, each column draws at most four points.
+    // Only the last column can still change, the ones before it are kept until the layout changes.
+    ChartsTradesColumn column = columns.at(iFirst);
+    qint16 columnX = qRound(graphXScale * (column.date - graphFirstDate));
+
+    for (qint32 i = iFirst + 1; i < iTradesEnd; ++i)
     {
-        for (qint32 i = iTradesFirst; i < tradesDate.count(); ++i)
+        qint16 x = qRound(graphXScale * (columns.at(i).date - graphFirstDate));
+
+        if (x == columnX)
         {
-            x = qRound(graphXScale * (tradesDate .at(i) - graphFirstDate));
-            y = qRound(priceYScale * (tradesPrice.at(i) - priceMin));
+            mergeTradesColumn(column, columns.at(i));
+            continue;
+        }
 
-            if (graphTradesX.count())
-            {
-                if (abs(x - graphTradesX.last()) <= perfomanceStep && abs(y - graphTradesY.last()) <= perfomanceStep)
-                    continue;
-            }
+        appendTradesColumn(columnX, column);
+        graphTradesStable = graphTradesX.count();
+        openColumnDate = columns.at(i).date;
+        column = columns.at(i);
+        columnX = x;
+    }
 
-            graphTradesX.append(x);
-            graphTradesY.append(y);
-            graphTradesType.append(tradesType.at(i));
-        }
+    appendTradesColumn(columnX, column);
+}
+
+void ChartsModel::appendTradesColumn(qint16 x, const ChartsTradesColumn& column)
+{
+    double price[4] = {column.firstPrice, column.lowPrice, column.highPrice, column.lastPrice};
+    qint16 type[4] = {column.firstType, column.lowType, column.highType, column.lastType};
+    quint32 sequence[4] = {column.firstSequence, column.lowSequence, column.highSequence, column.lastSequence};
+
+    if (sequence[2] < sequence[1])
+    {
+        qSwap(price[1], price[2]);
+        qSwap(type[1], type[2]);
+        qSwap(sequence[1], sequence[2]);
+    }
+
+    for (qint32 i = 0; i < 4; ++i)
+    {
+        if (i > 0 && sequence[i] == sequence[i - 1])
+            continue;
+
+        qint16 y = qRound(priceYScale * (price[i] - priceMin));
+
+        if (graphTradesX.count() && graphTradesX.last() == x && graphTradesY.last() == y)
+            continue;
+
+        graphTradesX.append(x);
+        graphTradesY.append(y);
+        graphTradesType.append(type[i]);
     }
 }
 
 void ChartsModel::prepareBound()
 {
-    if (priceInit)
+    if (priceInit && boundsVisible)
     {
         qint16 graphBoundX;
 
-        if (iBoundsSellFirst > 0 && iBoundsSellFirst <= boundsSellPrice.count())
+        if (iBoundsSellFirst > 0 && iBoundsSellFirst <= boundsSell.count())
         {
             graphBoundsSellX.append(1);
-            graphBoundsSellY.append(qRound(priceYScale * (boundsSellPrice[iBoundsSellFirst - 1] - priceMin)));
+            graphBoundsSellY.append(qRound(priceYScale * (boundsSell.at(iBoundsSellFirst - 1).price - priceMin)));
         }
 
-        if (iBoundsBuyFirst > 0 && iBoundsBuyFirst <= boundsBuyPrice.count())
+        if (iBoundsBuyFirst > 0 && iBoundsBuyFirst <= boundsBuy.count())
         {
             graphBoundsBuyX.append(1);
-            graphBoundsBuyY.append(qRound(priceYScale * (boundsBuyPrice[iBoundsBuyFirst - 1] - priceMin)));
+            graphBoundsBuyY.append(qRound(priceYScale * (boundsBuy.at(iBoundsBuyFirst - 1).price - priceMin)));
         }
 
-        for (qint32 i = iBoundsSellFirst; i < boundsSellPrice.count(); ++i)
+        for (qint32 i = iBoundsSellFirst; i < iBoundsSellEnd; ++i)
         {
-            graphBoundX = qRound(graphXScale * (boundsSellDate[i] - graphFirstDate));
+            graphBoundX = qRound(graphXScale * (boundsSell.at(i).date - graphFirstDate));
 
             if (graphBoundsSellY.count())
             {
@@ -423,12 +725,12 @@ void ChartsModel::prepareBound()
             }
 
             graphBoundsSellX.append(graphBoundX);
-            graphBoundsSellY.append(qRound(priceYScale * (boundsSellPrice[i] - priceMin)));
+            graphBoundsSellY.append(qRound(priceYScale * (boundsSell.at(i).price - priceMin)));
         }
 
-        for (qint32 i = iBoundsBuyFirst; i < boundsBuyPrice.count(); ++i)
+        for (qint32 i = iBoundsBuyFirst; i < iBoundsBuyEnd; ++i)
         {
-            graphBoundX = qRound(graphXScale * (boundsBuyDate[i] - graphFirstDate));
+            graphBoundX = qRound(graphXScale * (boundsBuy.at(i).date - graphFirstDate));
 
             if (graphBoundsBuyY.count())
             {
@@ -437,18 +739,20 @@ void ChartsModel::prepareBound()
             }
 
             graphBoundsBuyX.append(graphBoundX);
-            graphBoundsBuyY.append(qRound(priceYScale * (boundsBuyPrice[i] - priceMin)));
+            graphBoundsBuyY.append(qRound(priceYScale * (boundsBuy.at(i).price - priceMin)));
         }
 
+        qint16 graphBoundLastX = qRound(graphXScale * (qMin(nowTime, graphLastDate) - graphFirstDate));
+
         if (graphBoundsSellX.count())
         {
-            graphBoundsSellX.append(qRound(graphXScale * (nowTime - graphFirstDate)));
+            graphBoundsSellX.append(graphBoundLastX);
             graphBoundsSellY.append(graphBoundsSellY.last());
         }
 
         if (graphBoundsBuyX.count())
         {
-            graphBoundsBuyX.append(qRound(graphXScale * (nowTime - graphFirstDate)));
+            graphBoundsBuyX.append(graphBoundLastX);
             graphBoundsBuyY.append(graphBoundsBuyY.last());
         }
     }
@@ -456,18 +760,34 @@ void ChartsModel::prepareBound()
 
 bool ChartsModel::prepareChartsData(qint16 parentWidth, qint16 parentHeight)
 {
-    if (!boundsSellDate.count())
+    if (!boundsSell.count())
         return false;
 
+    prepareInit();
+    prepareLevel(parentWidth);
+    layoutChanged = !layoutValid || parentWidth != layoutWidth || parentHeight != layoutHeight ||
+                    graphFirstDate != layoutFirstDate || graphLevel != layoutLevel;
     chartsHeight = parentHeight - 5;
 
-    prepareInit();
-    prepareAmountYAxis();
+    prepareAmountMax();
     preparePriceMinMax();
-    preparePriceYAxis();
 
-    chartsWidth = parentWidth - widthAmountYAxis - widthPriceYAxis - 1;
-    prepareXAxis();
+    if (layoutChanged)
+    {
+        layoutValid     = true;
+        layoutWidth     = parentWidth;
+        layoutHeight    = parentHeight;
+        layoutFirstDate = graphFirstDate;
+        layoutLevel     = graphLevel;
+
+        prepareLayout();
+        prepareAmountYAxis();
+        preparePriceYAxis();
+
+        chartsWidth = parentWidth - widthAmountYAxis - widthPriceYAxis - 1;
+        prepareXAxis();
+    }
+
     prepareAmount();
     preparePrice();
     prepareBound();
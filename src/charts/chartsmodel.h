@@ -33,8 +33,9 @@
 #define CHARTSMODEL_H
 
 #include <QObject>
+#include "julyringbuffer.h"
+#include "tradesitem.h"
 
-struct TradesItem;
 class QFontMetrics;
 
 class ChartsModel : public QObject
@@ -45,7 +46,11 @@ public:
     qint16 chartsHeight;
     qint32 widthAmountYAxis;
     qint32 widthPriceYAxis;
-    qint16 perfomanceStep;
+
+    // Set when axes or scales moved and everything drawn before must be redrawn,
+    // otherwise only graphTrades points after graphTradesStable are new or changed
+    bool   layoutChanged;
+    qint32 graphTradesStable;
 
     QList<qint16>  graphTradesX;
     QList<qint16>  graphTradesY;
@@ -68,6 +73,19 @@ public:
     ~ChartsModel();
 
     bool prepareChartsData(qint16, qint16);
+    void invalidateLayout();
+    qint32 timeSpan() const;
+    qint32 historySpan() const;
+
+    void zoom(qint32);
+    void pan(qint32);
+    void resetView();
+    bool isLive() const;
+    qint32 intervalWidth() const;
+
+    // While stored history is being read, live trades wait so every level still gets them in time order
+    void holdLastTrades(bool);
+    void addStoredTrades(QList<TradesItem>*);
 
 public slots:
     void addLastTrades(QList<TradesItem>*);
@@ -75,19 +93,46 @@ public slots:
     void clearCharts();
 
 private:
+    enum ChartsLevel {SecondsLevel, MinutesLevel, HoursLevel, LevelsCount};
+
     qint32 intervalDate;
     qint32 intervalCount;
     QScopedPointer<QFontMetrics> fontMetrics;
 
-    QList<quint32> tradesDate;
-    QList<double>  tradesPrice;
-    QList<qint16>  tradesType;
-    QList<quint32> boundsSellDate;
-    QList<double>  boundsSellPrice;
-    QList<quint32> boundsBuyDate;
-    QList<double>  boundsBuyPrice;
-    QList<quint32> amountDate;
-    QList<double>  amountPrice;
+    struct ChartsPoint
+    {
+        quint32 date;
+        double  price;
+    };
+
+    // First, lowest, highest and last trade of a time range, sequences keep their order
+    struct ChartsTradesColumn
+    {
+        quint32 date;
+        double  firstPrice, lowPrice, highPrice, lastPrice;
+        qint16  firstType, lowType, highType, lastType;
+        quint32 firstSequence, lowSequence, highSequence, lastSequence;
+        double  volume;
+    };
+
+    // Trades reduced to seconds, minutes and hours, each level keeps its own retention.
+    // Charts draw from the finest level that covers the span with a bounded number of columns.
+    JulyRingBuffer<ChartsTradesColumn> tradesLevels[LevelsCount];
+    JulyRingBuffer<ChartsPoint> boundsSell;
+    JulyRingBuffer<ChartsPoint> boundsBuy;
+    QList<ChartsPoint> amountBins;
+    quint32 tradesSequence;
+    bool    holdTrades;
+    QList<TradesItem> heldTrades;
+    qint32  zoomIndex;
+    quint32 viewEndDate;
+
+    bool    layoutValid;
+    qint16  layoutWidth;
+    qint16  layoutHeight;
+    quint32 layoutFirstDate;
+    qint32  layoutLevel;
+    quint32 openColumnDate;
 
     quint32 nowTime;
     quint32 graphLastDate;
@@ -95,10 +140,14 @@ private:
     double  graphXScale;
     double  amountYScale;
     double  priceYScale;
-    qint32  iAmountFirst;
+    qint32  graphLevel;
+    bool    boundsVisible;
     qint32  iTradesFirst;
+    qint32  iTradesEnd;
     qint32  iBoundsSellFirst;
+    qint32  iBoundsSellEnd;
     qint32  iBoundsBuyFirst;
+    qint32  iBoundsBuyEnd;
     double  amountMax;
     bool    priceInit;
     double  priceMin;
@@ -107,8 +156,17 @@ private:
 
     double stepRound(double);
     double axisRound(double, double);
+    void removeOldData();
+    void appendTrades(const QList<TradesItem>&);
+    void addToLevel(qint32, ChartsTradesColumn);
+    void addBoundPoint(JulyRingBuffer<ChartsPoint>&, double);
+    void mergeTradesColumn(ChartsTradesColumn&, const ChartsTradesColumn&);
+    void appendTradesColumn(qint16, const ChartsTradesColumn&);
     void prepareInit();
+    void prepareLevel(qint16);
+    void prepareLayout();
     void prepareXAxis();
+    void prepareAmountMax();
     void prepareAmountYAxis();
     void prepareAmount();
     void preparePriceMinMax();
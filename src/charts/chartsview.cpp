@@ -31,7 +31,8 @@
 
 #include <QGraphicsScene>
 #include <QGraphicsTextItem>
-#include <QElapsedTimer>
+#include <QMouseEvent>
+#include <QWheelEvent>
 #include "main.h"
 #include "charts/chartsmodel.h"
 #include "charts/chartsview.h"
@@ -41,8 +42,13 @@ ChartsView::ChartsView()
     : QWidget(),
       ui(new Ui::ChartsView),
       refreshTimer(new QTimer),
-      perfomanceTimer(new QElapsedTimer),
       timeRefreshCharts(5000),
+      layerTop(0),
+      paintedTrades(0),
+      tradesItem(nullptr),
+      boundsItem(nullptr),
+      dragging(false),
+      dragX(0),
       lastResize(0),
       lastNewData(0)
 {
@@ -82,6 +88,9 @@ ChartsView::ChartsView()
     sceneCharts.reset(new QGraphicsScene);
     ui->graphicsView->scale(1, -1);
     ui->graphicsView->setScene(sceneCharts.data());
+    ui->graphicsView->viewport()->installEventFilter(this);
+    ui->graphicsView->setToolTip(julyTr("CHARTS_NAVIGATION_HINT",
+                                        "Wheel to zoom, drag to move back in time, double click to return to live"));
     leftSceneCharts.reset(new QGraphicsScene);
     ui->leftGraphicsView->scale(1, -1);
     ui->leftGraphicsView->setScene(leftSceneCharts.data());
@@ -129,6 +138,67 @@ void ChartsView::resizeEvent(QResizeEvent* event)
     }
 }
 
+bool ChartsView::eventFilter(QObject* obj, QEvent* event)
+{
+    if (obj != ui->graphicsView->viewport())
+        return QWidget::eventFilter(obj, event);
+
+    switch (event->type())
+    {
+        case QEvent::Wheel:
+            {
+                qint32 delta = static_cast<QWheelEvent*>(event)->angleDelta().y();
+
+                if (delta)
+                {
+                    chartsModel->zoom(delta > 0 ? -1 : 1);
+                    refreshCharts();
+                }
+
+                return true;
+            }
+
+        case QEvent::MouseButtonPress:
+            dragging = static_cast<QMouseEvent*>(event)->button() == Qt::LeftButton;
+            dragX = static_cast<QMouseEvent*>(event)->x();
+            return true;
+
+        case QEvent::MouseMove:
+            {
+                qint32 intervalWidth = chartsModel->intervalWidth();
+
+                if (!dragging || intervalWidth <= 0)
+                    return true;
+
+                // The span moves by whole intervals so the axes stay aligned
+                qint32 steps = (static_cast<QMouseEvent*>(event)->x() - dragX) / intervalWidth;
+
+                if (steps)
+                {
+                    chartsModel->pan(-steps);
+                    dragX += steps * intervalWidth;
+                    refreshCharts();
+                }
+
+                return true;
+            }
+
+        case QEvent::MouseButtonRelease:
+            dragging = false;
+            return true;
+
+        case QEvent::MouseButtonDblClick:
+            chartsModel->resetView();
+            refreshCharts();
+            return true;
+
+        default:
+            break;
+    }
+
+    return QWidget::eventFilter(obj, event);
+}
+
 void ChartsView::comeNewData()
 {
     if (!isVisible)
@@ -165,10 +235,62 @@ void ChartsView::drawText(QGraphicsScene* scene, QString text, qint16 x, qint16
     }
 }
 
-void ChartsView::drawRect(qint16 x, qint16 h)
+QGraphicsItem* ChartsView::drawRect(qint16 x, qint16 h)
 {
     int w = 20;
-    sceneCharts->addRect(x - w / 2, 1, w, h, QPen(Qt::lightGray), QBrush(Qt::lightGray));
+    QGraphicsItem* rectItem = sceneCharts->addRect(x - w / 2, 1, w, h, QPen(Qt::lightGray), QBrush(Qt::lightGray));
+    rectItem->setZValue(1);
+    return rectItem;
+}
+
+void ChartsView::resetLayers()
+{
+    liveItems.clear();
+    tradesItem = nullptr;
+    boundsItem = nullptr;
+    paintedTrades = 0;
+    chartsModel->invalidateLayout();
+}
+
+QGraphicsPixmapItem* ChartsView::addLayer(const QPixmap& pixmap, qreal z)
+{
+    QGraphicsPixmapItem* layerItem = sceneCharts->addPixmap(pixmap);
+    layerItem->setTransform(QTransform::fromScale(1, -1));
+    layerItem->setPos(0, layerTop);
+    layerItem->setZValue(z);
+    return layerItem;
+}
+
+void ChartsView::beginLayerPaint(QPainter& painter)
+{
+    painter.translate(0, layerTop);
+    painter.scale(1, -1);
+}
+
+void ChartsView::paintTrades()
+{
+    if (paintedTrades >= chartsModel->graphTradesStable)
+        return;
+
+    QPainter painter(&tradesPixmap);
+    beginLayerPaint(painter);
+
+    for (qint32 i = paintedTrades; i < chartsModel->graphTradesStable; ++i)
+    {
+        if (i > 0)
+        {
+            painter.setPen(QPen("#555555"));
+            painter.drawLine(chartsModel->graphTradesX.at(i - 1), chartsModel->graphTradesY.at(i - 1),
+                             chartsModel->graphTradesX.at(i), chartsModel->graphTradesY.at(i));
+        }
+
+        painter.setPen(QPen(chartsModel->graphTradesType.at(i) == 1 ? "#FF0000" : "#0000FF"));
+        painter.drawEllipse(QRectF(chartsModel->graphTradesX.at(i) - 2, chartsModel->graphTradesY.at(i) - 2, 4, 4));
+    }
+
+    painter.end();
+    paintedTrades = chartsModel->graphTradesStable;
+    tradesItem->setPixmap(tradesPixmap);
 }
 
 bool ChartsView::prepareCharts()
@@ -177,6 +299,9 @@ bool ChartsView::prepareCharts()
                                         ui->graphicsView->height() - fontHeightHalf))
         return false;
 
+    if (!chartsModel->layoutChanged && tradesItem)
+        return true;
+
     bottomSceneCharts->clear();
     bottomSceneCharts->setSceneRect(1, -fontHeight - 5,
                                     ui->bottomGraphicsView->width(), ui->bottomGraphicsView->height());
@@ -215,26 +340,44 @@ bool ChartsView::prepareCharts()
     ui->graphicsView->setScene(0);
     sceneCharts.reset(new QGraphicsScene);
     ui->graphicsView->setScene(sceneCharts.data());
+    liveItems.clear();
 
     int graphWidth = chartsModel->chartsWidth;
     int graphHeight = chartsModel->chartsHeight;
     sceneCharts->setSceneRect(0, -5, graphWidth + 1, ui->graphicsView->height());
-    sceneCharts->addLine(0, 0, graphWidth, 0,  QPen("#777777"));
-    sceneCharts->addLine(0, 0, 0, graphHeight, QPen("#777777"));
-    sceneCharts->addLine(graphWidth, 0, graphWidth, graphHeight, QPen("#777777"));
+    layerTop = ui->graphicsView->height() - 5;
 
-    for (qint32 i = 0; i < chartsModel->graphDateText.count(); ++i)
-    {
-        sceneCharts->addLine(chartsModel->graphDateTextX.at(i), -5,
-                             chartsModel->graphDateTextX.at(i), 0, QPen("#777777"));
-    }
+    QPixmap backgroundPixmap(graphWidth + 1, ui->graphicsView->height());
+    backgroundPixmap.fill(Qt::transparent);
+    QPainter backgroundPainter(&backgroundPixmap);
+    beginLayerPaint(backgroundPainter);
+    backgroundPainter.setPen(QPen("#DDDDDD"));
 
     for (qint32 i = 1; i < chartsModel->graphPriceText.count(); ++i)
     {
-        sceneCharts->addLine(1, chartsModel->graphPriceTextY.at(i),
-                             graphWidth - 1, chartsModel->graphPriceTextY.at(i), QPen("#DDDDDD"));
+        backgroundPainter.drawLine(1, chartsModel->graphPriceTextY.at(i),
+                                   graphWidth - 1, chartsModel->graphPriceTextY.at(i));
     }
 
+    backgroundPainter.setPen(QPen("#777777"));
+    backgroundPainter.drawLine(0, 0, graphWidth, 0);
+    backgroundPainter.drawLine(0, 0, 0, graphHeight);
+    backgroundPainter.drawLine(graphWidth, 0, graphWidth, graphHeight);
+
+    for (qint32 i = 0; i < chartsModel->graphDateText.count(); ++i)
+        backgroundPainter.drawLine(chartsModel->graphDateTextX.at(i), -5, chartsModel->graphDateTextX.at(i), 0);
+
+    backgroundPainter.end();
+    addLayer(backgroundPixmap, 0);
+
+    boundsItem = sceneCharts->addPolygon(QPolygonF(), QPen("#4000FF00"), QBrush("#4000FF00"));
+    boundsItem->setZValue(2);
+
+    tradesPixmap = QPixmap(backgroundPixmap.size());
+    tradesPixmap.fill(Qt::transparent);
+    tradesItem = addLayer(tradesPixmap, 3);
+    paintedTrades = 0;
+
     return true;
 }
 
@@ -245,6 +388,7 @@ void ChartsView::clearCharts()
     leftSceneCharts->clear();
     rightSceneCharts->clear();
     sceneCharts->clear();
+    resetLayers();
     drawText(sceneCharts.data(), julyTr("CHARTS_WAITING_FOR_DATA", "Waiting for data..."),
              0, 0, "font-size:28px;color:" + baseValues.appTheme.gray.name());
     sceneCharts->setSceneRect(sceneCharts->itemsBoundingRect());
@@ -256,11 +400,10 @@ void ChartsView::refreshCharts()
     if (!isVisible)
         return;
 
-    perfomanceTimer->start();
-
     if (!prepareCharts())
     {
         sceneCharts->clear();
+        resetLayers();
         bottomSceneCharts->clear();
         leftSceneCharts->clear();
         rightSceneCharts->clear();
@@ -269,10 +412,12 @@ void ChartsView::refreshCharts()
         return;
     }
 
+    // Volume bars and the last trades column are the only items rebuilt on each refresh
+    qDeleteAll(liveItems);
+    liveItems.clear();
+
     for (qint32 i = 0; i < chartsModel->graphAmountY.count(); ++i)
-    {
-        drawRect(chartsModel->graphAmountX.at(i), chartsModel->graphAmountY.at(i));
-    }
+        liveItems.append(drawRect(chartsModel->graphAmountX.at(i), chartsModel->graphAmountY.at(i)));
 
     QPolygonF boundsPolygon;
 
@@ -288,50 +433,40 @@ void ChartsView::refreshCharts()
                                  chartsModel->graphBoundsBuyY.at(i));
     }
 
-    if (boundsPolygon.count())
-        sceneCharts->addPolygon(boundsPolygon, QPen("#4000FF00"), QBrush("#4000FF00"));
+    boundsItem->setPolygon(boundsPolygon);
+    paintTrades();
 
-    QPolygonF tradesPolygon;
+    qint32 tradesCount = chartsModel->graphTradesX.count();
 
-    if (chartsModel->graphTradesX.count())
+    if (tradesCount > chartsModel->graphTradesStable)
     {
-        for (qint32 i = 0; i < chartsModel->graphTradesX.count(); ++i)
+        QPolygonF tradesPolygon;
+
+        for (qint32 i = qMax(0, chartsModel->graphTradesStable - 1); i < tradesCount; ++i)
         {
             tradesPolygon << QPointF(chartsModel->graphTradesX.at(i),
                                      chartsModel->graphTradesY.at(i));
         }
-    }
 
-    if (tradesPolygon.count())
-    {
         QPainterPath tradesPath;
         tradesPath.addPolygon(tradesPolygon);
-        sceneCharts->addPath(tradesPath, QPen("#555555"));
-    }
+        QGraphicsItem* pathItem = sceneCharts->addPath(tradesPath, QPen("#555555"));
+        pathItem->setZValue(4);
+        liveItems.append(pathItem);
 
-    QPen pen;
+        QPen pen;
 
-    if (chartsModel->graphTradesX.count())
-    {
-        for (qint32 i = 0; i < chartsModel->graphTradesX.count(); ++i)
+        for (qint32 i = chartsModel->graphTradesStable; i < tradesCount; ++i)
         {
             if (chartsModel->graphTradesType[i] == 1)
                 pen = QPen("#FF0000");
             else
                 pen = QPen("#0000FF");
 
-            sceneCharts->addEllipse(chartsModel->graphTradesX.at(i) - 2,
-                                    chartsModel->graphTradesY.at(i) - 2, 4, 4, pen);
+            QGraphicsItem* pointItem = sceneCharts->addEllipse(chartsModel->graphTradesX.at(i) - 2,
+                                       chartsModel->graphTradesY.at(i) - 2, 4, 4, pen);
+            pointItem->setZValue(4);
+            liveItems.append(pointItem);
         }
     }
-
-    quint32 perfDeltaTime = perfomanceTimer->elapsed();
-
-    if (perfDeltaTime > 50 && chartsModel->perfomanceStep < 10)
-        ++chartsModel->perfomanceStep;
-    else
-    {
-        if (perfDeltaTime < 30 && chartsModel->perfomanceStep > 1)
-            --chartsModel->perfomanceStep;
-    }
 }
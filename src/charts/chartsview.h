@@ -33,9 +33,13 @@
 #define CHARTSVIEW_H
 
 #include <QWidget>
+#include <QPixmap>
 
 class QGraphicsScene;
-class QElapsedTimer;
+class QGraphicsItem;
+class QGraphicsPixmapItem;
+class QGraphicsPolygonItem;
+class QPainter;
 class ChartsModel;
 
 namespace Ui
@@ -69,16 +73,30 @@ private:
     QScopedPointer<QGraphicsScene> rightSceneCharts;
     QScopedPointer<QGraphicsScene> bottomSceneCharts;
     QScopedPointer<QTimer> refreshTimer;
-    QScopedPointer<QElapsedTimer> perfomanceTimer;
     qint32 timeRefreshCharts;
+
+    // Grid and finished trades are painted once into pixmaps, the items below are owned by sceneCharts
+    qint16 layerTop;
+    QPixmap tradesPixmap;
+    qint32 paintedTrades;
+    QGraphicsPixmapItem* tradesItem;
+    QGraphicsPolygonItem* boundsItem;
+    QList<QGraphicsItem*> liveItems;
+    bool dragging;
+    qint32 dragX;
     qint32 lastResize;
     qint32 lastNewData;
 
     void resizeEvent(QResizeEvent* event);
+    bool eventFilter(QObject* obj, QEvent* event);
     void drawText(QGraphicsScene*, QString, qint16 x = 0, qint16 y = 0, QString style = "");
     void explainColor(QString, qint16, qint16, QColor);
     bool prepareCharts();
-    void drawRect(qint16, qint16);
+    void resetLayers();
+    QGraphicsPixmapItem* addLayer(const QPixmap&, qreal);
+    void beginLayerPaint(QPainter&);
+    void paintTrades();
+    QGraphicsItem* drawRect(qint16, qint16);
 };
 
 #endif // CHARTSVIEW_H
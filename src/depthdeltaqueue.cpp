@@ -0,0 +1,126 @@
+//  This file is part of Qt Bitcoin Trader
+//      https://github.com/JulyIGHOR/QtBitcoinTrader
+//  Copyright (C) 2013-2018 July IGHOR <julyighor@gmail.com>
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  In addition, as a special exception, the copyright holders give
+//  permission to link the code of portions of this program with the
+//  OpenSSL library under certain conditions as described in each
+//  individual source file, and distribute linked combinations including
+//  the two.
+//
+//  You must obey the GNU General Public License in all respects for all
+//  of the code used other than OpenSSL. If you modify file(s) with this
+//  exception, you may extend this exception to your version of the
+//  file(s), but you are not obligated to do so. If you do not wish to do
+//  so, delete this exception statement from your version. If you delete
+//  this exception statement from all source files in the program, then
+//  also delete it here.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "depthdeltaqueue.h"
+
+DepthDeltaQueue::DepthDeltaQueue(int capacityPowerOfTwo)
+    : ring(1 << capacityPowerOfTwo),
+      mask((1u << capacityPowerOfTwo) - 1),
+      head(0),
+      tail(0),
+      resyncRequested(false),
+      readerPending(false),
+      writeSequence(0),
+      writeOverflowed(false),
+      readSequence(0),
+      readResyncing(false)
+{
+}
+
+void DepthDeltaQueue::push(DepthDelta::Kind kind, bool isAsk, double price, double volume)
+{
+    DepthDelta delta;
+    delta.sequence = ++writeSequence;
+    delta.price = price;
+    delta.volume = volume;
+    delta.kind = kind;
+    delta.isAsk = isAsk;
+
+    quint32 currentTail = tail.load(std::memory_order_relaxed);
+
+    if (currentTail - head.load(std::memory_order_acquire) > mask)
+    {
+        // The sequence number is spent, the reader notices the gap
+        writeOverflowed = true;
+        return;
+    }
+
+    ring[currentTail & mask] = delta;
+    tail.store(currentTail + 1, std::memory_order_release);
+}
+
+bool DepthDeltaQueue::takeResyncRequest()
+{
+    bool resync = resyncRequested.exchange(false) || writeOverflowed;
+    writeOverflowed = false;
+    return resync;
+}
+
+bool DepthDeltaQueue::wakeReader()
+{
+    if (tail.load(std::memory_order_relaxed) == head.load(std::memory_order_acquire))
+        return false;
+
+    return !readerPending.exchange(true);
+}
+
+bool DepthDeltaQueue::pop(DepthDelta* delta)
+{
+    quint32 currentHead = head.load(std::memory_order_relaxed);
+
+    while (currentHead != tail.load(std::memory_order_acquire))
+    {
+        *delta = ring.at(currentHead & mask);
+        head.store(++currentHead, std::memory_order_release);
+
+        if (delta->kind == DepthDelta::Reset)
+        {
+            readSequence = delta->sequence;
+            readResyncing = false;
+            return true;
+        }
+
+        if (readResyncing)
+            continue;
+
+        if (delta->sequence != readSequence + 1)
+        {
+            requestResync();
+            continue;
+        }
+
+        readSequence = delta->sequence;
+        return true;
+    }
+
+    return false;
+}
+
+void DepthDeltaQueue::requestResync()
+{
+    readResyncing = true;
+    resyncRequested.store(true);
+}
+
+void DepthDeltaQueue::readerWoken()
+{
+    readerPending.store(false);
+}
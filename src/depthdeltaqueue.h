@@ -0,0 +1,89 @@
+//  This file is part of Qt Bitcoin Trader
+//      https://github.com/JulyIGHOR/QtBitcoinTrader
+//  Copyright (C) 2013-2018 July IGHOR <julyighor@gmail.com>
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  In addition, as a special exception, the copyright holders give
+//  permission to link the code of portions of this program with the
+//  OpenSSL library under certain conditions as described in each
+//  individual source file, and distribute linked combinations including
+//  the two.
+//
+//  You must obey the GNU General Public License in all respects for all
+//  of the code used other than OpenSSL. If you modify file(s) with this
+//  exception, you may extend this exception to your version of the
+//  file(s), but you are not obligated to do so. If you do not wish to do
+//  so, delete this exception statement from your version. If you delete
+//  this exception statement from all source files in the program, then
+//  also delete it here.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef DEPTHDELTAQUEUE_H
+#define DEPTHDELTAQUEUE_H
+
+#include <QVector>
+#include <atomic>
+
+// One change of the published depth. Sequence numbers run without gaps from the writer,
+// Reset tells the reader to drop its rows, the deltas after it rebuild the whole book.
+struct DepthDelta
+{
+    enum Kind {Level, FirstLevel, Reset};
+
+    quint64 sequence;
+    double price;
+    double volume;
+    qint32 kind;
+    bool isAsk;
+};
+Q_DECLARE_TYPEINFO(DepthDelta, Q_PRIMITIVE_TYPE);
+
+// Lock-free single producer, single consumer ring between the exchange thread and the GUI.
+// The exchange pushes deltas and wakes the GUI once, the GUI drains everything pending per frame.
+// A full ring drops deltas, the reader sees the sequence gap, skips to the next Reset and asks
+// the writer for one, so a slow GUI jumps over intermediate states instead of queueing them.
+class DepthDeltaQueue
+{
+public:
+    explicit DepthDeltaQueue(int capacityPowerOfTwo = 13);
+
+    // Exchange thread
+    void push(DepthDelta::Kind kind, bool isAsk, double price, double volume);
+    bool takeResyncRequest();
+    bool wakeReader();
+
+    // GUI thread
+    bool pop(DepthDelta* delta);
+    void requestResync();
+    void readerWoken();
+
+private:
+    QVector<DepthDelta> ring;
+    quint32 mask;
+
+    std::atomic<quint32> head;
+    std::atomic<quint32> tail;
+    std::atomic<bool> resyncRequested;
+    std::atomic<bool> readerPending;
+
+    // Writer only
+    quint64 writeSequence;
+    bool writeOverflowed;
+
+    // Reader only
+    quint64 readSequence;
+    bool readResyncing;
+};
+
+#endif // DEPTHDELTAQUEUE_H
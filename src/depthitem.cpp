@@ -30,20 +30,8 @@
 //  along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "depthitem.h"
-#include "main.h"
-#include "julymath.h"
 
-bool DepthItem::isValid()
+bool DepthItem::isValid() const
 {
-    bool valid = price >= 0.0 && volume >= 0.0;
-
-    if (valid)
-    {
-        priceStr = JulyMath::textFromDouble(price, qMin(baseValues.currentPair.priceDecimals, baseValues.decimalsPriceOrderBook));
-
-        int decimals = qMin(baseValues.currentPair.currADecimals, baseValues.decimalsAmountOrderBook);
-        volumeStr = JulyMath::textFromDouble(volume, decimals, decimals);
-    }
-
-    return valid;
+    return price >= 0.0 && volume >= 0.0;
 }
@@ -38,9 +38,7 @@ struct DepthItem
 {
     double price;
     double volume;
-    QString priceStr;
-    QString volumeStr;
-    bool isValid();
+    bool isValid() const;
 };
 
 #endif // DEPTHITEM_H
@@ -50,6 +50,10 @@ DepthModel::DepthModel(bool isAskData)
     isAsk = isAskData;
     originalIsAsk = isAsk;
     columnsCount = 5;
+    firstChangedRow = -1;
+    maxVolume = 0.0;
+    maxVolumeDirty = false;
+    sizeTreeDirty = true;
 }
 
 DepthModel::~DepthModel()
@@ -57,89 +61,186 @@ DepthModel::~DepthModel()
 
 }
 
-double& DepthModel::sizeListAt(int row)
+int DepthModel::rowForPrice(double price, bool afterEqual) const
 {
-    if (!originalIsAsk)
-        return sizeList[sizeList.count() - row - 1];
+    int first = 0;
+    int last = rows.count();
 
-    return sizeList[row];
+    while (first < last)
+    {
+        int middle = (first + last) / 2;
+        double middlePrice = rows.at(middle).price;
+        bool before;
+
+        if (originalIsAsk)
+            before = middlePrice < price;
+        else
+            before = middlePrice > price;
+
+        if (before || (afterEqual && middlePrice == price))
+            first = middle + 1;
+        else
+            last = middle;
+    }
+
+    return first;
 }
 
-double DepthModel::sizeListGet(int row) const
+void DepthModel::markChanged(int row)
 {
-    if (!originalIsAsk)
-        return sizeList[sizeList.count() - row - 1];
+    somethingChanged = true;
 
-    return sizeList[row];
+    if (firstChangedRow < 0 || row < firstChangedRow)
+        firstChangedRow = row;
 }
 
-void DepthModel::sizeListRemoveAt(int row)
+void DepthModel::ensureSizeTree() const
 {
-    if (!originalIsAsk)
-        sizeList.removeAt(sizeList.count() - row - 1);
-    else
-        sizeList.removeAt(row);
+    if (!sizeTreeDirty)
+        return;
+
+    int rowsCount = rows.count();
+    sizeTree.fill(JulyAmount(), rowsCount + 1);
+
+    for (int n = 1; n <= rowsCount; n++)
+    {
+        sizeTree[n] += rows.at(n - 1).volumeAmount;
+        int parentNode = n + (n & -n);
+
+        if (parentNode <= rowsCount)
+            sizeTree[parentNode] += sizeTree.at(n);
+    }
+
+    sizeTreeDirty = false;
 }
 
-double DepthModel::getPriceByVolume(double amount)
+void DepthModel::addSize(int row, const JulyAmount& delta)
 {
-    if (sizeList.count() == 0)
-        return 0.0;
+    if (sizeTreeDirty)
+        return;
 
-    int outside = 1;
-    int currentIndex = qLowerBound(sizeList.begin(), sizeList.end(), amount) - sizeList.begin();
+    for (int n = row + 1; n < sizeTree.count(); n += n & -n)
+        sizeTree[n] += delta;
+}
 
-    if (currentIndex < 0)
-        return 0.0;
+JulyAmount DepthModel::sizeUpTo(int row) const
+{
+    ensureSizeTree();
+    JulyAmount result;
+
+    for (int n = qMin(row + 1, rows.count()); n > 0; n -= n & -n)
+        result += sizeTree.at(n);
 
-    if (currentIndex >= sizeList.count())
+    return result;
+}
+
+int DepthModel::rowBySize(JulyAmount size) const
+{
+    ensureSizeTree();
+    int rowsCount = rows.count();
+    int step = 1;
+
+    while (step * 2 <= rowsCount)
+        step *= 2;
+
+    int position = 0;
+
+    for (; step > 0; step /= 2)
     {
-        currentIndex = sizeList.count() - 1;
-        outside = -1;
+        if (position + step <= rowsCount && sizeTree.at(position + step) < size)
+        {
+            position += step;
+            size -= sizeTree.at(position);
+        }
     }
 
-    if (!originalIsAsk)
-        currentIndex = priceList.count() - currentIndex - 1;
+    return position;
+}
+
+double DepthModel::sizeAt(int row) const
+{
+    return sizeUpTo(row).toDouble();
+}
+
+QString DepthModel::priceTextAt(int row) const
+{
+    const DepthRow& depthRow = rows.at(row);
+    const QString* cachedText = textCache.find(depthRow.generation, 0);
+
+    if (cachedText)
+        return *cachedText;
+
+    QString priceText = JulyPrice::fromDouble(depthRow.price).toString(qMin(baseValues.currentPair.priceDecimals,
+                        baseValues.decimalsPriceOrderBook));
+    textCache.insert(depthRow.generation, 0, priceText);
+    return priceText;
+}
+
+QString DepthModel::volumeTextAt(int row) const
+{
+    const DepthRow& depthRow = rows.at(row);
+    const QString* cachedText = textCache.find(depthRow.generation, 1);
+
+    if (cachedText)
+        return *cachedText;
+
+    int decimals = qMin(baseValues.currentPair.currADecimals, baseValues.decimalsAmountOrderBook);
+    QString volumeText = JulyAmount::fromDouble(depthRow.volume).toString(decimals, decimals);
+    textCache.insert(depthRow.generation, 1, volumeText);
+    return volumeText;
+}
+
+QString DepthModel::sizeTextAt(int row) const
+{
+    JulyAmount size = sizeUpTo(row);
+    const QString* cachedText = sizeTextCache.find(quint64(size.raw()), size.decimals());
+
+    if (cachedText)
+        return *cachedText;
 
-    return priceList.at(currentIndex) * outside;
+    QString sizeText = size.toString(qMin(baseValues.currentPair.currADecimals,
+                       baseValues.decimalsTotalOrderBook));
+    sizeTextCache.insert(quint64(size.raw()), size.decimals(), sizeText);
+    return sizeText;
 }
 
-double DepthModel::getVolumeByPrice(double price, bool isAsk)
+double DepthModel::getPriceByVolume(double amount)
 {
-    if (priceList.count() == 0)
+    if (rows.isEmpty())
         return 0.0;
 
-    int currentIndex;
     int outside = 1;
+    int currentIndex = rowBySize(JulyAmount::fromDouble(amount));
 
-    if (isAsk)
+    if (currentIndex >= rows.count())
     {
-        currentIndex = qUpperBound(priceList.begin(), priceList.end(), price) - priceList.begin();
-        --currentIndex;
+        currentIndex = rows.count() - 1;
+        outside = -1;
+    }
 
-        if (currentIndex < 0)
-            return 0.0;
+    return rows.at(currentIndex).price * outside;
+}
 
-        if (currentIndex >= priceList.count() - 1 && price > priceList.last())
-            outside = -1;
-    }
-    else
-    {
-        currentIndex = qLowerBound(priceList.begin(), priceList.end(), price) - priceList.begin();
+double DepthModel::getVolumeByPrice(double price, bool)
+{
+    if (rows.isEmpty())
+        return 0.0;
 
-        if (currentIndex >= priceList.count())
-            return 0.0;
+    int outside = 1;
+    int rowsAtPrice = rowForPrice(price, true);
 
-        if (currentIndex == 0 && price < priceList[0])
-            outside = -1;
-    }
+    if (rowsAtPrice == 0)
+        return 0.0;
+
+    if (rowsAtPrice == rows.count() && rows.last().price != price)
+        outside = -1;
 
-    return sizeListAt(currentIndex) * outside;
+    return sizeAt(rowsAtPrice - 1) * outside;
 }
 
 int DepthModel::rowCount(const QModelIndex&) const
 {
-    return priceList.count() + grouped;
+    return rows.count() + grouped;
 }
 
 int DepthModel::columnCount(const QModelIndex&) const
@@ -156,8 +257,13 @@ QVariant DepthModel::data(const QModelIndex& index, int role) const
 
     if (role == Qt::WhatsThisRole)
     {
-        return baseValues.currentPair.currBSign + priceListStr.at(currentRow) + " " + baseValues.currentPair.currASign +
-               volumeListStr.at(currentRow) + " " + baseValues.currentPair.currASign + sizeListStr.at(currentRow);
+        currentRow -= grouped;
+
+        if (currentRow < 0 || currentRow >= rows.count())
+            return QVariant();
+
+        return baseValues.currentPair.currBSign + priceTextAt(currentRow) + " " + baseValues.currentPair.currASign +
+               volumeTextAt(currentRow) + " " + baseValues.currentPair.currASign + sizeTextAt(currentRow);
     }
 
     if (role != Qt::DisplayRole && role != Qt::ToolTipRole && role != Qt::StatusTipRole && role != Qt::ForegroundRole &&
@@ -221,17 +327,16 @@ QVariant DepthModel::data(const QModelIndex& index, int role) const
     if (grouped)
         currentRow -= grouped;
 
-    if (currentRow < 0 || currentRow >= priceList.count())
+    if (currentRow < 0 || currentRow >= rows.count())
         return QVariant();
 
-    if (!originalIsAsk)
-        currentRow = priceList.count() - currentRow - 1;
+    const DepthRow& depthRow = rows.at(currentRow);
 
     if (role == Qt::StatusTipRole)
     {
         QString direction;
 
-        switch (directionList.at(currentRow))
+        switch (depthRow.direction)
         {
             case -1:
                 direction = downArrowStr + "\t";
@@ -242,15 +347,15 @@ QVariant DepthModel::data(const QModelIndex& index, int role) const
                 break;
         }
 
-        return baseValues.currentPair.currBSign + priceListStr.at(currentRow) + "\t" + baseValues.currentPair.currASign +
-               volumeListStr.at(currentRow) + "\t" + direction + baseValues.currentPair.currASign + sizeListStr.at(currentRow);
+        return baseValues.currentPair.currBSign + priceTextAt(currentRow) + "\t" + baseValues.currentPair.currASign +
+               volumeTextAt(currentRow) + "\t" + direction + baseValues.currentPair.currASign + sizeTextAt(currentRow);
     }
 
     if (role == Qt::ForegroundRole)
     {
         if (indexColumn == 1)
         {
-            double volume = volumeList.at(currentRow);
+            double volume = depthRow.volume;
             double smallValue = baseValues.currentPair.currAInfo.valueSmall;
 
             if (volume <= smallValue)
@@ -277,7 +382,7 @@ QVariant DepthModel::data(const QModelIndex& index, int role) const
         return baseValues.appTheme.black;
     }
 
-    double requestedPrice = priceList.at(currentRow);
+    double requestedPrice = depthRow.price;
 
     if (requestedPrice <= 0.0)
         return QVariant();
@@ -286,12 +391,12 @@ QVariant DepthModel::data(const QModelIndex& index, int role) const
     {
         if (originalIsAsk)
         {
-            if (mainWindow.ordersModel->currentAsksPrices.value(requestedPrice, false))
+            if (mainWindow.ordersModel->currentAsksPrices.contains(JulyPrice::fromDouble(requestedPrice)))
                 return baseValues.appTheme.lightGreen;
         }
         else
         {
-            if (mainWindow.ordersModel->currentBidsPrices.value(requestedPrice, false))
+            if (mainWindow.ordersModel->currentBidsPrices.contains(JulyPrice::fromDouble(requestedPrice)))
                 return baseValues.appTheme.lightGreen;
         }
 
@@ -304,28 +409,28 @@ QVariant DepthModel::data(const QModelIndex& index, int role) const
     {
         case 0://Price
             if (role == Qt::ToolTipRole)
-                baseValues.currentPair.currBSign + priceListStr.at(currentRow);
+                baseValues.currentPair.currBSign + priceTextAt(currentRow);
 
-            return priceListStr.at(currentRow);
+            return priceTextAt(currentRow);
             break;
 
         case 1:
             {
                 //Volume
-                if (volumeList.at(currentRow) <= 0.0)
+                if (depthRow.volume <= 0.0)
                     return QVariant();
 
                 if (role == Qt::ToolTipRole)
-                    baseValues.currentPair.currASign + volumeListStr.at(currentRow);
+                    baseValues.currentPair.currASign + volumeTextAt(currentRow);
 
-                return volumeListStr.at(currentRow);
+                return volumeTextAt(currentRow);
             }
             break;
 
         case 2:
             {
                 //Direction
-                switch (directionList.at(currentRow))
+                switch (depthRow.direction)
                 {
                     case -1:
                         return downArrowStr;
@@ -341,13 +446,13 @@ QVariant DepthModel::data(const QModelIndex& index, int role) const
         case 3:
             {
                 //Size
-                if (sizeListGet(currentRow) <= 0.0)
+                if (sizeUpTo(currentRow) <= JulyAmount())
                     return QVariant();
 
                 if (role == Qt::ToolTipRole)
-                    baseValues.currentPair.currASign + sizeListStr.at(currentRow);
+                    baseValues.currentPair.currASign + sizeTextAt(currentRow);
 
-                return sizeListStr.at(currentRow);
+                return sizeTextAt(currentRow);
             }
             break;
 
@@ -368,7 +473,7 @@ void DepthModel::reloadVisibleItems()
 
 void DepthModel::delayedReloadVisibleItems()
 {
-    emit dataChanged(index(0, 0), index(priceList.count() - 1, columnsCount - 1));
+    emit dataChanged(index(0, 0), index(rowCount() - 1, columnsCount - 1));
 }
 
 void DepthModel::calculateSize()
@@ -376,57 +481,26 @@ void DepthModel::calculateSize()
     if (!somethingChanged)
         return;
 
-    somethingChanged = true;
-
-    double maxPrice = 0.0;
-    double maxVolume = 0.0;
-    double maxTotal = 0.0;
-
-    double totalSize = 0.0;
-    double totalPrice = 0.0;
+    somethingChanged = false;
+    ensureSizeTree();
 
-    if (originalIsAsk)
+    if (maxVolumeDirty)
     {
-        for (int n = 0; n < priceList.count(); n++)
-        {
-            int currentRow = n;
-
-            if (!originalIsAsk)
-                currentRow = priceList.count() - currentRow - 1;
-
-            totalSize += volumeList.at(currentRow);
-            totalPrice += volumeList.at(currentRow) * priceList.at(currentRow);
+        maxVolume = 0.0;
 
-            sizeListAt(currentRow) = totalSize;
-            sizePriceList[currentRow] = totalPrice;
-            sizeListStr[currentRow] = JulyMath::textFromDouble(totalSize, qMin(baseValues.currentPair.currADecimals,
-                                      baseValues.decimalsTotalOrderBook));
+        for (int n = 0; n < rows.count(); n++)
+            maxVolume = qMax(maxVolume, rows.at(n).volume);
 
-            maxPrice = qMax(maxPrice, priceList.at(currentRow));
-            maxVolume = qMax(maxVolume, volumeList.at(currentRow));
-            maxTotal = qMax(maxTotal, sizeListAt(currentRow));
-        }
+        maxVolumeDirty = false;
     }
-    else
-    {
-        for (int n = priceList.count() - 1; n >= 0; n--)
-        {
-            int currentRow = n;
-
-            if (originalIsAsk)
-                currentRow = priceList.count() - currentRow - 1;
 
-            totalSize += volumeList.at(currentRow);
-            totalPrice += volumeList.at(currentRow) * priceList.at(currentRow);
-            sizeListAt(currentRow) = totalSize;
-            sizePriceList[currentRow] = totalPrice;
-            sizeListStr[currentRow] = JulyMath::textFromDouble(totalSize, qMin(baseValues.currentPair.currADecimals,
-                                      baseValues.decimalsTotalOrderBook));
+    double maxPrice = 0.0;
+    double maxTotal = 0.0;
 
-            maxPrice = qMax(maxPrice, priceList.at(currentRow));
-            maxVolume = qMax(maxVolume, volumeList.at(currentRow));
-            maxTotal = qMax(maxTotal, sizeListAt(currentRow));
-        }
+    if (!rows.isEmpty())
+    {
+        maxPrice = originalIsAsk ? rows.last().price : rows.first().price;
+        maxTotal = sizeAt(rows.count() - 1);
     }
 
     widthPrice = 10 + textFontWidth(JulyMath::textFromDouble(maxPrice, baseValues.currentPair.priceDecimals));
@@ -437,12 +511,16 @@ void DepthModel::calculateSize()
     widthVolume = qMax(widthVolume, widthVolumeTitle);
     widthSize = qMax(widthSize, widthSizeTitle);
 
-    int sizeColumn = 2;
+    int sizeColumn = 3;
 
     if (isAsk)
-        sizeColumn = 1;
+        sizeColumn = columnsCount - sizeColumn - 1;
 
-    emit dataChanged(index(0, sizeColumn), index(priceList.count() - 1, sizeColumn));
+    // Only rows at or after the first changed level have a new cumulative size
+    if (firstChangedRow >= 0 && firstChangedRow < rows.count())
+        emit dataChanged(index(firstChangedRow + grouped, sizeColumn), index(rows.count() - 1 + grouped, sizeColumn));
+
+    firstChangedRow = -1;
 }
 
 QModelIndex DepthModel::index(int row, int column, const QModelIndex& parent) const
@@ -460,20 +538,20 @@ QModelIndex DepthModel::parent(const QModelIndex&) const
 
 void DepthModel::clear()
 {
-    if (priceList.isEmpty())
+    if (rows.isEmpty())
         return;
 
     beginResetModel();
     groupedPrice = 0.0;
     groupedVolume = 0.0;
-    directionList.clear();
-    priceList.clear();
-    volumeList.clear();
-    sizeList.clear();
-    sizePriceList.clear();
-    priceListStr.clear();
-    volumeListStr.clear();
-    sizeListStr.clear();
+    rows.clear();
+    textCache.clear();
+    sizeTextCache.clear();
+    sizeTree.clear();
+    sizeTreeDirty = true;
+    maxVolume = 0.0;
+    maxVolumeDirty = false;
+    firstChangedRow = -1;
     endResetModel();
     somethingChanged = false;
 }
@@ -485,7 +563,7 @@ Qt::ItemFlags DepthModel::flags(const QModelIndex& index) const
 
     if (grouped)
     {
-        if (index.row() == 1 || (groupedPrice == 0.0 && priceList.isEmpty()))
+        if (index.row() == 1 || (groupedPrice == 0.0 && rows.isEmpty()))
             return Qt::NoItemFlags;
     }
 
@@ -590,19 +668,15 @@ void DepthModel::depthFirstOrder(double price, double volume)
         emit dataChanged(index(0, 0), index(0, 1));
 }
 
-void DepthModel::depthUpdateOrders(QList<DepthItem>* items)
+void DepthModel::depthUpdateOrders(const QVector<DepthItem>& items)
 {
-    if (items == nullptr)
-        return;
-
-    for (int n = 0; n < items->count(); n++)
-        depthUpdateOrder(items->at(n));
+    for (int n = 0; n < items.count(); n++)
+        depthUpdateOrder(items.at(n));
 
-    delete items;
     calculateSize();
 }
 
-void DepthModel::depthUpdateOrder(DepthItem item)
+void DepthModel::depthUpdateOrder(const DepthItem& item)
 {
     double price = item.price;
     double volume = item.volume;
@@ -610,60 +684,66 @@ void DepthModel::depthUpdateOrder(DepthItem item)
     if (price == 0.0)
         return;
 
-    int currentIndex = qLowerBound(priceList.begin(), priceList.end(), price) - priceList.begin();
-    bool matchListRang = currentIndex > -1 && priceList.count() > currentIndex;
+    int currentIndex = rowForPrice(price, false);
+    bool matchListRang = currentIndex < rows.count() && rows.at(currentIndex).price == price;
 
     if (volume == 0.0)
     {
         //Remove item
         if (matchListRang)
         {
+            if (rows.at(currentIndex).volume >= maxVolume)
+                maxVolumeDirty = true;
+
             beginRemoveRows(QModelIndex(), currentIndex + grouped, currentIndex + grouped);
-            directionList.removeAt(currentIndex);
-            priceList.removeAt(currentIndex);
-            volumeList.removeAt(currentIndex);
-            sizeListRemoveAt(currentIndex);
-            sizePriceList.removeAt(currentIndex);
-            priceListStr.removeAt(currentIndex);
-            volumeListStr.removeAt(currentIndex);
-            sizeListStr.removeAt(currentIndex);
+            rows.remove(currentIndex);
+            sizeTreeDirty = true;
             endRemoveRows();
-            somethingChanged = true;
+            markChanged(currentIndex);
         }
 
         return;
     }
 
-    if (matchListRang && priceList.at(currentIndex) == price)
+    if (matchListRang)
     {
         //Update
-        if (volumeList.at(currentIndex) == volume)
+        DepthRow& depthRow = rows[currentIndex];
+
+        if (depthRow.volume == volume)
             return;
 
-        directionList[currentIndex] = volumeList.at(currentIndex) < volume ? 1 : -1;
-        volumeList[currentIndex] = volume;
-        sizeListAt(currentIndex) = 0.0;
-        sizePriceList[currentIndex] = 0.0;
-        priceListStr[currentIndex] = item.priceStr;
-        volumeListStr[currentIndex] = item.volumeStr;
-        sizeListStr[currentIndex] = "0.0";
-        somethingChanged = true;
+        if (depthRow.volume >= maxVolume && volume < depthRow.volume)
+            maxVolumeDirty = true;
+        else
+            maxVolume = qMax(maxVolume, volume);
+
+        JulyAmount volumeAmount = JulyAmount::fromDouble(volume);
+        addSize(currentIndex, volumeAmount - depthRow.volumeAmount);
+
+        depthRow.direction = depthRow.volume < volume ? 1 : -1;
+        depthRow.volume = volume;
+        depthRow.volumeAmount = volumeAmount;
+        depthRow.generation = RowTextCache::newGeneration();
+        markChanged(currentIndex);
         emit dataChanged(index(currentIndex + grouped, 0), index(currentIndex + grouped, columnsCount - 1));
     }
     else
     {
         //Insert
+        DepthRow depthRow;
+        depthRow.price = price;
+        depthRow.volume = volume;
+        depthRow.volumeAmount = JulyAmount::fromDouble(volume);
+        depthRow.direction = 0;
+        depthRow.generation = RowTextCache::newGeneration();
+
         beginInsertRows(QModelIndex(), currentIndex + grouped, currentIndex + grouped);
-        priceList.insert(currentIndex, price);
-        volumeList.insert(currentIndex, volume);
-        sizeList.insert(currentIndex, volume);
-        sizePriceList.insert(currentIndex, volume * price);
-        directionList.insert(currentIndex, 0);
-        priceListStr.insert(currentIndex, item.priceStr);
-        volumeListStr.insert(currentIndex, item.volumeStr);
-        sizeListStr.insert(currentIndex, item.volumeStr);
+        rows.insert(currentIndex, depthRow);
+        sizeTreeDirty = true;
         endInsertRows();
-        somethingChanged = true;
+        maxVolume = qMax(maxVolume, volume);
+        markChanged(currentIndex);
     }
 }
 
@@ -679,13 +759,10 @@ double DepthModel::rowPrice(int row)
 
     row -= grouped;
 
-    if (!originalIsAsk)
-        row = priceList.count() - row - 1;
-
-    if (row < 0 || row >= priceList.count())
+    if (row < 0 || row >= rows.count())
         return 0.0;
 
-    return priceList.at(row);
+    return rows.at(row).price;
 }
 
 double DepthModel::rowVolume(int row)
@@ -700,13 +777,10 @@ double DepthModel::rowVolume(int row)
 
     row -= grouped;
 
-    if (!originalIsAsk)
-        row = priceList.count() - row - 1;
-
-    if (row < 0 || row >= priceList.count())
+    if (row < 0 || row >= rows.count())
         return 0.0;
 
-    return volumeList.at(row);
+    return rows.at(row).volume;
 }
 
 double DepthModel::rowSize(int row)
@@ -716,11 +790,8 @@ double DepthModel::rowSize(int row)
 
     row -= grouped;
 
-    if (!originalIsAsk)
-        row = priceList.count() - row - 1;
-
-    if (row < 0 || row >= priceList.count())
+    if (row < 0 || row >= rows.count())
         return 0.0;
 
-    return sizeListAt(row);
+    return sizeAt(row);
 }
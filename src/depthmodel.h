@@ -34,7 +34,20 @@
 
 #include <QAbstractItemModel>
 #include <QStringList>
+#include <QVector>
 #include "depthitem.h"
+#include "rowtextcache.h"
+#include "julyfixed.h"
+
+struct DepthRow
+{
+    double price;
+    double volume;
+    JulyAmount volumeAmount;
+    int direction;
+    quint64 generation;
+};
+Q_DECLARE_TYPEINFO(DepthRow, Q_MOVABLE_TYPE);
 
 class DepthModel : public QAbstractItemModel
 {
@@ -45,7 +58,7 @@ public:
     void fixTitleWidths();
     int itemsCount()
     {
-        return volumeList.count();
+        return rows.count();
     }
     void calculateSize();
     void clear();
@@ -70,7 +83,7 @@ public:
     int rowCount(const QModelIndex& parent = QModelIndex()) const;
     int columnCount(const QModelIndex& parent = QModelIndex()) const;
 
-    void depthUpdateOrders(QList<DepthItem>* items);
+    void depthUpdateOrders(const QVector<DepthItem>& items);
     void depthFirstOrder(double price, double volume);
 
     double getVolumeByPrice(double, bool);
@@ -79,7 +92,17 @@ public:
 private slots:
     void delayedReloadVisibleItems();
 private:
-    void depthUpdateOrder(DepthItem item);
+    void depthUpdateOrder(const DepthItem& item);
+    int rowForPrice(double price, bool afterEqual) const;
+    void markChanged(int row);
+    void ensureSizeTree() const;
+    void addSize(int row, const JulyAmount& delta);
+    JulyAmount sizeUpTo(int row) const;
+    int rowBySize(JulyAmount size) const;
+    double sizeAt(int row) const;
+    QString priceTextAt(int row) const;
+    QString volumeTextAt(int row) const;
+    QString sizeTextAt(int row) const;
     bool originalIsAsk;
     bool somethingChanged;
     double groupedPrice;
@@ -96,17 +119,21 @@ private:
     int columnsCount;
     QStringList headerLabels;
     bool isAsk;
-    QList<double> volumeList;
-    QList<double> sizeList;
-    double& sizeListAt(int);
-    double sizeListGet(int) const;
-    void sizeListRemoveAt(int);
-    QList<double> sizePriceList;
-    QList<double> priceList;
-    QStringList volumeListStr;
-    QStringList sizeListStr;
-    QStringList priceListStr;
-    QList<int> directionList;
+
+    // Rows sorted best price first for both sides, row n is shown at n + grouped
+    QVector<DepthRow> rows;
+    int firstChangedRow;
+    double maxVolume;
+    bool maxVolumeDirty;
+
+    // Fenwick tree over rows[].volumeAmount for the cumulative size column, sums of any book size fit.
+    // Volume updates patch it in place, inserts and removals rebuild it once per batch
+    mutable QVector<JulyAmount> sizeTree;
+    mutable bool sizeTreeDirty;
+
+    // Price and volume text by row generation, size text by the cumulative size itself
+    mutable RowTextCache textCache;
+    mutable RowTextCache sizeTextCache;
 };
 
 #endif // DEPTHMODEL_H
@@ -60,6 +60,12 @@ Exchange::Exchange()
     checkDuplicatedOID = false;
     isLastTradesTypeSupported = true;
     forceDepthLoad = false;
+    watchedDepthIndex = 0;
+    lastTopOfBook.time = 0;
+
+    // Connected before the GUI takes the list, so it is read here on the exchange thread before it is deleted there
+    connect(this, SIGNAL(addLastTrades(QString, QList<TradesItem>*)), this, SLOT(storeLastTrades(QString,
+            QList<TradesItem>*)), Qt::DirectConnection);
 
     clearVariables();
 }
@@ -151,7 +157,7 @@ void Exchange::quitExchange()
 void Exchange::secondSlot()
 {
     if (secondTimer)
-        secondTimer->start(baseValues.httpRequestInterval);
+        secondTimer->start(rateLimiter.suggestedInterval(baseValues.httpRequestInterval, minimumRequestIntervalAllowed));
 }
 
 void Exchange::dataReceivedAuth(QByteArray, int)
@@ -160,7 +166,133 @@ void Exchange::dataReceivedAuth(QByteArray, int)
 
 void Exchange::reloadDepth()
 {
+    depthBook.resetPublished();
+    lastDepthData.clear();
     forceDepthLoad = true;
+
+    // A new pair starts from its kept book while the fresh snapshot loads
+    if (depthBookSymbol != baseValues.currentPair.symbol)
+    {
+        // Unwatched books are only kept when the pair is left, not on every change
+        if (!depthBookSymbol.isEmpty() && !depthBook.isEmpty())
+            OrderBookRegistry::global()->publish(depthBookSymbol, depthBook);
+
+        depthBook.clear();
+        depthBookSymbol = baseValues.currentPair.symbol;
+
+        if (OrderBookRegistry::global()->restore(depthBookSymbol, &depthBook))
+            depthSubmitBook();
+    }
+}
+
+void Exchange::regroupDepth()
+{
+    // Every grouping is kept by the book itself, so only the shown rows have to be sent again
+    if (!depthBook.isEmpty())
+        depthSubmitBook();
+}
+
+bool Exchange::depthSnapshotFull(bool isAsk)
+{
+    // Ungrouped snapshots arrive best price first, the rows past the limit would never be shown
+    return baseValues.depthCountLimit && baseValues.groupPriceValue <= 0.0 &&
+           depthBook.count(isAsk) >= baseValues.depthCountLimit;
+}
+
+void Exchange::depthSubmitBook()
+{
+    if (depthQueue.takeResyncRequest())
+    {
+        depthBook.resetPublished();
+        depthQueue.push(DepthDelta::Reset, false, 0.0, 0.0);
+    }
+
+    if (baseValues.groupPriceValue > 0.0)
+    {
+        for (int side = 0; side < 2; side++)
+        {
+            bool isAsk = side == 0;
+
+            if (depthBook.count(isAsk))
+                depthQueue.push(DepthDelta::FirstLevel, isAsk, depthBook.level(isAsk, 0).price.toDouble(),
+                                depthBook.level(isAsk, 0).volume.toDouble());
+        }
+    }
+
+    for (int side = 0; side < 2; side++)
+    {
+        bool isAsk = side == 0;
+        depthChanges.clear();
+        depthBook.takeChanges(isAsk, baseValues.groupPriceValue, baseValues.depthCountLimit, &depthChanges);
+
+        for (int n = 0; n < depthChanges.count(); n++)
+            depthQueue.push(DepthDelta::Level, isAsk, depthChanges.at(n).price, depthChanges.at(n).volume);
+    }
+
+    if (depthQueue.wakeReader())
+        emit depthDeltasReady();
+
+    if (depthBookSymbol.isEmpty())
+        depthBookSymbol = baseValues.currentPair.symbol;
+
+    if (!depthBook.isEmpty())
+    {
+        if (OrderBookRegistry::global()->isWatched(depthBookSymbol))
+            OrderBookRegistry::global()->publish(depthBookSymbol, depthBook);
+
+        storeTopOfBook();
+    }
+}
+
+void Exchange::storeTopOfBook()
+{
+    TopOfBookTick tick;
+    tick.time = QDateTime::currentMSecsSinceEpoch();
+
+    if (depthBook.count(false))
+    {
+        tick.bidPrice = depthBook.level(false, 0).price;
+        tick.bidVolume = depthBook.level(false, 0).volume;
+    }
+
+    if (depthBook.count(true))
+    {
+        tick.askPrice = depthBook.level(true, 0).price;
+        tick.askVolume = depthBook.level(true, 0).volume;
+    }
+
+    if (tick.bidPrice == lastTopOfBook.bidPrice && tick.bidVolume == lastTopOfBook.bidVolume &&
+        tick.askPrice == lastTopOfBook.askPrice && tick.askVolume == lastTopOfBook.askVolume)
+        return;
+
+    lastTopOfBook = tick;
+    TickStore::global()->appendTopOfBook(baseValues.exchangeName, depthBookSymbol, tick);
+}
+
+void Exchange::storeLastTrades(QString symbol, QList<TradesItem>* trades)
+{
+    TickStore::global()->appendTrades(baseValues.exchangeName, symbol, *trades);
+}
+
+QString Exchange::nextWatchedDepthSymbol()
+{
+    QStringList symbols = OrderBookRegistry::global()->watchedSymbols();
+
+    for (int n = symbols.count() - 1; n >= 0; n--)
+        if (symbols.at(n) == baseValues.currentPair.symbol || !baseValues.currencyPairMap.contains(symbols.at(n)))
+            symbols.removeAt(n);
+
+    if (symbols.isEmpty())
+        return QString();
+
+    watchedDepthIndex = (watchedDepthIndex + 1) % symbols.count();
+    return symbols.at(watchedDepthIndex);
+}
+
+void Exchange::depthSubmitWatched()
+{
+    OrderBookRegistry::global()->publish(watchedDepthSymbol, watchedBook);
+    watchedBook.clear();
 }
 
 void Exchange::clearVariables()
@@ -205,16 +337,14 @@ void Exchange::setupApi(QtBitcoinTrader* mainClass, bool tickOnly)//Execute only
 
     connect(this, SIGNAL(depthRequested()), mainClass, SLOT(depthRequested()));
     connect(this, SIGNAL(depthRequestReceived()), mainClass, SLOT(depthRequestReceived()));
-    connect(this, SIGNAL(depthSubmitOrders(QString, QList<DepthItem>*, QList<DepthItem>*)), mainClass,
-            SLOT(depthSubmitOrders(QString, QList<DepthItem>*, QList<DepthItem>*)));
-    connect(this, SIGNAL(depthFirstOrder(QString, double, double, bool)), mainClass, SLOT(depthFirstOrder(QString, double,
-            double, bool)));
+    connect(this, SIGNAL(depthDeltasReady()), mainClass, SLOT(depthDeltasReady()));
     connect(this, SIGNAL(showErrorMessage(QString)), mainClass, SLOT(showErrorMessage(QString)));
 
     connect(this, SIGNAL(availableAmountChanged(QString, double)), mainClass, SLOT(availableAmountChanged(QString,
             double)));
     connect(mainClass, SIGNAL(clearValues()), this, SLOT(clearValues()));
     connect(mainClass, SIGNAL(reloadDepth()), this, SLOT(reloadDepth()));
+    connect(mainClass, SIGNAL(regroupDepth()), this, SLOT(regroupDepth()));
 
     connect(this, SIGNAL(accVolumeChanged(double)), mainClass->ui.accountVolume, SLOT(setValue(double)));
     connect(this, SIGNAL(accFeeChanged(QString, double)), mainClass, SLOT(accFeeChanged(QString, double)));
@@ -39,15 +39,21 @@
 #include "main.h"
 #include <QtCore/qmath.h>
 #include "qtbitcointrader.h"
-#include "julyhttp.h"
+#include "julyhttppool.h"
+#include "julywebsocket.h"
+#include "julyratelimiter.h"
+#include "julyjson.h"
+#include "orderbook.h"
+#include "orderbookregistry.h"
+#include "tickstore.h"
+#include "depthdeltaqueue.h"
+#include "depthitem.h"
 #include "orderitem.h"
 #include "tradesitem.h"
 #include "julymath.h"
 #include "timesync.h"
 #include "indicatorengine.h"
 
-struct DepthItem;
-
 class Exchange : public QObject
 {
     Q_OBJECT
@@ -63,6 +69,7 @@ public:
     CurrencyPairItem defaultCurrencyParams;
     bool balanceDisplayAvailableAmount;
     int minimumRequestIntervalAllowed;
+    JulyRateLimiter rateLimiter;
     int minimumRequestTimeoutAllowed;
     double decAmountFromOpenOrder;
     int calculatingFeeMode;//0: direct multiply; 1: rounded by decimals
@@ -83,6 +90,8 @@ public:
     double lastFee;
 
     QByteArray lastDepthData;
+    OrderBook depthBook;
+    DepthDeltaQueue depthQueue;
     QByteArray lastHistory;
     QByteArray lastOrders;
 
@@ -121,6 +130,13 @@ private:
     QList<char*> apiKeyChars;
     QList<char*> apiSignChars;
 
+    QVector<DepthItem> depthChanges;
+    QString depthBookSymbol;
+    int watchedDepthIndex;
+    TopOfBookTick lastTopOfBook;
+
+    void storeTopOfBook();
+
 signals:
     void started();
     void threadFinished();
@@ -128,9 +144,7 @@ signals:
     void availableAmountChanged(QString, double);
     void depthRequested();
     void depthRequestReceived();
-    void depthFirstOrder(QString, double, double, bool);
-
-    void depthSubmitOrders(QString, QList<DepthItem>* asks, QList<DepthItem>* bids);
+    void depthDeltasReady();
 
     void addLastTrades(QString, QList<TradesItem>* trades);
 
@@ -149,13 +163,24 @@ signals:
     void loginChanged(QString);
     void apiDownChanged(bool);
     void softLagChanged(int);
+protected:
+    QString watchedDepthSymbol;
+    OrderBook watchedBook;
+
+    bool depthSnapshotFull(bool isAsk);
+    QString nextWatchedDepthSymbol();
+    void depthSubmitWatched();
+protected slots:
+    void depthSubmitBook();
 private slots:
     void sslErrors(const QList<QSslError>&);
     void quitExchange();
+    void storeLastTrades(QString, QList<TradesItem>*);
 public slots:
     virtual void secondSlot();
     virtual void dataReceivedAuth(QByteArray, int);
     virtual void reloadDepth();
+    void regroupDepth();
     virtual void clearValues();
     virtual void getHistory(bool);
     virtual void buy(QString, double, double);
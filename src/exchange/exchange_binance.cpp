@@ -41,10 +41,9 @@ Exchange_Binance::Exchange_Binance(QByteArray pRestSign, QByteArray pRestKey)
       lastTradesId(0),
       lastHistoryId(0),
       julyHttp(nullptr),
-      depthAsks(nullptr),
-      depthBids(nullptr),
-      lastDepthAsksMap(),
-      lastDepthBidsMap()
+      webSocket(nullptr),
+      bookSynced(false),
+      bookLastUpdateId(0)
 {
     clearHistoryOnCurrencyChanged = true;
     calculatingFeeMode = 1;
@@ -72,6 +71,20 @@ Exchange_Binance::Exchange_Binance(QByteArray pRestSign, QByteArray pRestKey)
     supportsLoginIndicator = false;
     supportsAccountVolume = false;
 
+    //Bucket 0: request weight per minute, bucket 1: orders per 10 seconds
+    rateLimiter.addBucket(0, 1200, 60000);
+    rateLimiter.addBucket(1, 50, 10000);
+    rateLimiter.addCost(103, 103, 0, 1);
+    rateLimiter.addCost(109, 109, 0, 5);
+    rateLimiter.addCost(111, 111, 0, 10);
+    rateLimiter.addCost(202, 202, 0, 10);
+    rateLimiter.addCost(204, 204, 0, 40);
+    rateLimiter.addCost(208, 208, 0, 10);
+    rateLimiter.addCost(305, 307, 0, 1);
+    rateLimiter.addCost(306, 307, 1, 1);
+    rateLimiter.addUsageHeader("X-MBX-USED-WEIGHT-1M", 0);
+    rateLimiter.addUsageHeader("X-MBX-ORDER-COUNT-10S", 1);
+
     connect(this, &Exchange::threadFinished, this, &Exchange_Binance::quitThread, Qt::DirectConnection);
 }
 
@@ -83,14 +96,11 @@ void Exchange_Binance::quitThread()
 {
     clearValues();
 
-    if (depthAsks)
-        delete depthAsks;
-
-    if (depthBids)
-        delete depthBids;
-
     if (julyHttp)
         delete julyHttp;
+
+    if (webSocket)
+        delete webSocket;
 }
 
 void Exchange_Binance::clearVariables()
@@ -115,9 +125,8 @@ void Exchange_Binance::clearValues()
 
 void Exchange_Binance::reloadDepth()
 {
-    lastDepthBidsMap.clear();
-    lastDepthAsksMap.clear();
-    lastDepthData.clear();
+    bookSynced = false;
+    pendingDepthEvents.clear();
     Exchange::reloadDepth();
 }
 
@@ -131,67 +140,90 @@ void Exchange_Binance::dataReceivedAuth(QByteArray data, int reqType)
     if (data.size() && data.at(0) == QLatin1Char('<'))
         return;
 
+    JulyJsonValue json = JulyJsonValue::fromData(data);
     bool success = !data.startsWith("{\"success\":0");
     QString errorString;
 
     if (!success)
-        errorString = getMidData("msg\":\"", "\"", &data);
+        errorString = json.value("msg").toByteArray();
 
 
     switch (reqType)
     {
         case 103: //ticker
             {
-                double tickerHigh = getMidData("\"highPrice\":\"", "\"", &data).toDouble();
+                double tickerHigh = 0.0;
+                double tickerLow = 0.0;
+                double tickerSell = 0.0;
+                double tickerBuy = 0.0;
+                double tickerVolume = 0.0;
+                double tickerLastDouble = 0.0;
+                qint64 tickerId = 0;
+                JulyJsonIterator tickerIterator(json);
+
+                while (tickerIterator.next())
+                {
+                    const JulyJsonValue& key = tickerIterator.key();
+
+                    if (key == "highPrice")
+                        tickerHigh = tickerIterator.value().toDouble();
+                    else if (key == "lowPrice")
+                        tickerLow = tickerIterator.value().toDouble();
+                    else if (key == "bidPrice")
+                        tickerSell = tickerIterator.value().toDouble();
+                    else if (key == "askPrice")
+                        tickerBuy = tickerIterator.value().toDouble();
+                    else if (key == "volume")
+                        tickerVolume = tickerIterator.value().toDouble();
+                    else if (key == "lastPrice")
+                        tickerLastDouble = tickerIterator.value().toDouble();
+                    else if (key == "lastId")
+                        tickerId = tickerIterator.value().toLongLong();
+                }
 
                 if (tickerHigh > 0.0 && !qFuzzyCompare(tickerHigh, lastTickerHigh))
                 {
-                    IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "High", tickerHigh);
+                    IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                              IndicatorEngine::High, tickerHigh);
                     lastTickerHigh = tickerHigh;
                 }
 
-                double tickerLow = getMidData("\"lowPrice\":\"", "\"", &data).toDouble();
-
                 if (tickerLow > 0.0 && !qFuzzyCompare(tickerLow, lastTickerLow))
                 {
-                    IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Low", tickerLow);
+                    IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                              IndicatorEngine::Low, tickerLow);
                     lastTickerLow = tickerLow;
                 }
 
-                double tickerSell = getMidData("\"bidPrice\":\"", "\"", &data).toDouble();
-
                 if (tickerSell > 0.0 && !qFuzzyCompare(tickerSell, lastTickerSell))
                 {
-                    IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Sell", tickerSell);
+                    IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                              IndicatorEngine::Sell, tickerSell);
                     lastTickerSell = tickerSell;
                 }
 
-                double tickerBuy = getMidData("\"askPrice\":\"", "\"", &data).toDouble();
-
                 if (tickerBuy > 0.0 && !qFuzzyCompare(tickerBuy, lastTickerBuy))
                 {
-                    IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Buy", tickerBuy);
+                    IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                              IndicatorEngine::Buy, tickerBuy);
                     lastTickerBuy = tickerBuy;
                 }
 
-                double tickerVolume = getMidData("\"volume\":\"", "\"", &data).toDouble();
-
                 if (tickerVolume > 0.0 && !qFuzzyCompare(tickerVolume, lastTickerVolume))
                 {
-                    IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Volume", tickerVolume);
+                    IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                              IndicatorEngine::Volume, tickerVolume);
                     lastTickerVolume = tickerVolume;
                 }
 
-                qint64 tickerId = getMidData("\"lastId\":", ",", &data).toLongLong();
-
                 if (tickerId > lastTickerId)
                 {
                     lastTickerId = tickerId;
-                    double tickerLastDouble = getMidData("\"lastPrice\":\"", "\"", &data).toDouble();
 
                     if (tickerLastDouble > 0.0 && !qFuzzyCompare(tickerLastDouble, lastTickerLast))
                     {
-                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Last", tickerLastDouble);
+                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                                  IndicatorEngine::Last, tickerLastDouble);
                         lastTickerLast = tickerLastDouble;
                     }
                 }
@@ -200,50 +232,62 @@ void Exchange_Binance::dataReceivedAuth(QByteArray data, int reqType)
 
         case 109: //trades
             {
-                if (data.size() < 10)
+                if (!json.isArray())
                     break;
 
                 qint64 time10Min = QDateTime::currentDateTime().toTime_t() - 600;
-                QStringList tradeList = QString(data).split("},{");
                 QList<TradesItem>* newTradesItems = new QList<TradesItem>;
-                int lastIndex = tradeList.count() - 1;
+                JulyJsonIterator tradesIterator(json);
 
-                for (int n = 0; n < tradeList.count(); ++n)
+                while (tradesIterator.next())
                 {
-                    QByteArray tradeData = tradeList.at(n).toLatin1() + "}";
                     TradesItem newItem;
-                    qint64 currentTid = getMidData("\"id\":", ",", &tradeData).toLongLong();
+                    qint64 currentTid = 0;
+                    JulyJsonIterator fieldIterator(tradesIterator.value());
+
+                    while (fieldIterator.next())
+                    {
+                        const JulyJsonValue& key = fieldIterator.key();
+
+                        if (key == "id")
+                            currentTid = fieldIterator.value().toLongLong();
+                        else if (key == "price")
+                            newItem.price = fieldIterator.value().toDouble();
+                        else if (key == "qty")
+                            newItem.amount = fieldIterator.value().toDouble();
+                        else if (key == "time")
+                            newItem.date = fieldIterator.value().toLongLong() / 1000;
+                        else if (key == "isBuyerMaker")
+                            newItem.orderType = fieldIterator.value().toBool() ? 1 : -1;
+                    }
 
                     if (currentTid <= lastTradesId)
                         continue;
 
                     lastTradesId = currentTid;
-                    newItem.date = getMidData("\"time\":", ",", &tradeData).toLongLong() / 1000;
 
                     if (newItem.date < time10Min)
                         continue;
 
-                    newItem.price = getMidData("\"price\":\"", "\"", &tradeData).toDouble();
-
-                    if (n == lastIndex && currentTid > lastTickerId)
-                    {
-                        lastTickerId = currentTid;
-
-                        if (newItem.price > 0.0 && !qFuzzyCompare(newItem.price, lastTickerLast))
-                        {
-                            IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Last", newItem.price);
-                            lastTickerLast = newItem.price;
-                        }
-                    }
-
-                    newItem.amount = getMidData("\"qty\":\"", "\"", &tradeData).toDouble();
                     newItem.symbol = baseValues.currentPair.symbol;
-                    newItem.orderType = getMidData("\"isBuyerMaker\":", ",", &tradeData) == "true" ? 1 : -1;
 
                     if (newItem.isValid())
                         (*newTradesItems) << newItem;
                     else if (debugLevel)
-                        logThread->writeLog("Invalid trades fetch data line:" + tradeData, 2);
+                        logThread->writeLog("Invalid trades fetch data line:" + tradesIterator.value().toByteArray(), 2);
+                }
+
+                if (!newTradesItems->isEmpty() && lastTradesId > lastTickerId)
+                {
+                    lastTickerId = lastTradesId;
+                    double tickerLastDouble = newTradesItems->last().price;
+
+                    if (tickerLastDouble > 0.0 && !qFuzzyCompare(tickerLastDouble, lastTickerLast))
+                    {
+                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                                  IndicatorEngine::Last, tickerLastDouble);
+                        lastTickerLast = tickerLastDouble;
+                    }
                 }
 
                 if (newTradesItems->count())
@@ -254,156 +298,131 @@ void Exchange_Binance::dataReceivedAuth(QByteArray data, int reqType)
             break;//trades
 
         case 111: //depth
-            if (data.startsWith("{\"lastUpdateId\":"))
             {
-                emit depthRequestReceived();
-                QByteArray lastUpdateId = getMidData("\"lastUpdateId\":", ",", &data);
+                JulyJsonValue lastUpdateId;
+                JulyJsonValue asks;
+                JulyJsonValue bids;
+                JulyJsonIterator depthIterator(json);
 
-                if (lastUpdateId != lastDepthData)
+                while (depthIterator.next())
                 {
-                    lastDepthData = lastUpdateId;
-                    depthAsks = new QList<DepthItem>;
-                    depthBids = new QList<DepthItem>;
+                    const JulyJsonValue& key = depthIterator.key();
+
+                    if (key == "lastUpdateId")
+                        lastUpdateId = depthIterator.value();
+                    else if (key == "asks")
+                        asks = depthIterator.value();
+                    else if (key == "bids")
+                        bids = depthIterator.value();
+                }
 
-                    QMap<double, double> currentAsksMap;
-                    QStringList asksList = QString(getMidData("\"asks\":[[\"", "\",[]]]", &data)).split("\",[]],[\"");
-                    double groupedPrice = 0.0;
-                    double groupedVolume = 0.0;
-                    int rowCounter = 0;
+                if (!lastUpdateId.isValid())
+                {
+                    if (debugLevel)
+                        logThread->writeLog("Invalid depth data:" + data, 2);
 
-                    for (int n = 0; n < asksList.count(); n++)
-                    {
-                        if (baseValues.depthCountLimit && rowCounter >= baseValues.depthCountLimit)
-                            break;
+                    break;
+                }
 
-                        QStringList currentPair = asksList.at(n).split("\",\"");
+                emit depthRequestReceived();
 
-                        if (currentPair.count() != 2)
-                            continue;
+                if (lastUpdateId != lastDepthData.constData())
+                {
+                    lastDepthData = lastUpdateId.toByteArray();
+                    bookLastUpdateId = lastUpdateId.toLongLong();
+                    depthBook.clearLevels();
+                    readDepthLevels(&depthBook, asks, true);
+                    readDepthLevels(&depthBook, bids, false);
 
-                        double priceDouble = currentPair.first().toDouble();
-                        double amount = currentPair.last().toDouble();
+                    if (webSocket && webSocket->isOpened())
+                    {
+                        bookSynced = true;
 
-                        if (baseValues.groupPriceValue > 0.0)
-                        {
-                            if (n == 0)
-                            {
-                                emit depthFirstOrder(baseValues.currentPair.symbol, priceDouble, amount, true);
-                                groupedPrice = baseValues.groupPriceValue * static_cast<int>(priceDouble / baseValues.groupPriceValue);
-                                groupedVolume = amount;
-                            }
-                            else
+                        for (int n = 0; n < pendingDepthEvents.count(); ++n)
+                            if (!applyDepthEvent(pendingDepthEvents.at(n)))
                             {
-                                bool matchCurrentGroup = priceDouble < groupedPrice + baseValues.groupPriceValue;
-
-                                if (matchCurrentGroup)
-                                    groupedVolume += amount;
-
-                                if (!matchCurrentGroup || n == asksList.count() - 1)
-                                {
-                                    depthSubmitOrder(baseValues.currentPair.symbol,
-                                                     &currentAsksMap, groupedPrice + baseValues.groupPriceValue, groupedVolume, true);
-                                    rowCounter++;
-                                    groupedVolume = amount;
-                                    groupedPrice += baseValues.groupPriceValue;
-                                }
+                                bookSynced = false;
+                                forceDepthLoad = true;
+                                break;
                             }
-                        }
-                        else
-                        {
-                            depthSubmitOrder(baseValues.currentPair.symbol,
-                                             &currentAsksMap, priceDouble, amount, true);
-                            rowCounter++;
-                        }
+
+                        pendingDepthEvents.clear();
                     }
 
-                    QList<double> currentAsksList = lastDepthAsksMap.keys();
+                    depthSubmitBook();
+                }
+            }
+            break;
 
-                    for (int n = 0; n < currentAsksList.count(); n++)
-                        if (qFuzzyIsNull(currentAsksMap.value(currentAsksList.at(n), 0)))
-                            depthUpdateOrder(baseValues.currentPair.symbol,
-                                             currentAsksList.at(n), 0.0, true);
+        case 112: //watched depth
+            {
+                JulyJsonValue asks = json.value("asks");
+                JulyJsonValue bids = json.value("bids");
 
-                    lastDepthAsksMap = currentAsksMap;
+                if (!asks.isValid() || !bids.isValid())
+                {
+                    if (debugLevel)
+                        logThread->writeLog("Invalid watched depth data:" + data, 2);
 
-                    QMap<double, double> currentBidsMap;
-                    QStringList bidsList = QString(getMidData("\"bids\":[[\"", "\",[]]]", &data)).split("\",[]],[\"");
-                    groupedPrice = 0.0;
-                    groupedVolume = 0.0;
-                    rowCounter = 0;
+                    break;
+                }
 
-                    for (int n = 0; n < bidsList.count(); n++)
-                    {
-                        if (baseValues.depthCountLimit && rowCounter >= baseValues.depthCountLimit)
-                            break;
+                watchedBook.clear();
+                readDepthLevels(&watchedBook, asks, true);
+                readDepthLevels(&watchedBook, bids, false);
+                depthSubmitWatched();
+            }
+            break;
 
-                        QStringList currentPair = bidsList.at(n).split("\",\"");
+        case 202: //info
+            {
+                if (!success)
+                    break;
 
-                        if (currentPair.count() != 2)
-                            continue;
+                QByteArray currA = baseValues.currentPair.currAStr.toLatin1();
+                QByteArray currB = baseValues.currentPair.currBStr.toLatin1();
+                double btcBalance = 0.0;
+                double usdBalance = 0.0;
+                double makerCommission = 0.0;
+                double takerCommission = 0.0;
+                JulyJsonValue rights;
+                JulyJsonIterator infoIterator(json);
 
-                        double priceDouble = currentPair.first().toDouble();
-                        double amount = currentPair.last().toDouble();
+                while (infoIterator.next())
+                {
+                    const JulyJsonValue& key = infoIterator.key();
+
+                    if (key == "makerCommission")
+                        makerCommission = infoIterator.value().toDouble();
+                    else if (key == "takerCommission")
+                        takerCommission = infoIterator.value().toDouble();
+                    else if (key == "canTrade")
+                        rights = infoIterator.value();
+                    else if (key == "balances")
+                    {
+                        JulyJsonIterator balanceIterator(infoIterator.value());
 
-                        if (baseValues.groupPriceValue > 0.0)
+                        while (balanceIterator.next())
                         {
-                            if (n == 0)
-                            {
-                                emit depthFirstOrder(baseValues.currentPair.symbol, priceDouble, amount, false);
-                                groupedPrice = baseValues.groupPriceValue * static_cast<int>(priceDouble / baseValues.groupPriceValue);
-                                groupedVolume = amount;
-                            }
-                            else
+                            JulyJsonValue asset;
+                            double free = 0.0;
+                            JulyJsonIterator fieldIterator(balanceIterator.value());
+
+                            while (fieldIterator.next())
                             {
-                                bool matchCurrentGroup = priceDouble > groupedPrice - baseValues.groupPriceValue;
-
-                                if (matchCurrentGroup)
-                                    groupedVolume += amount;
-
-                                if (!matchCurrentGroup || n == asksList.count() - 1)
-                                {
-                                    depthSubmitOrder(baseValues.currentPair.symbol,
-                                                     &currentBidsMap, groupedPrice - baseValues.groupPriceValue, groupedVolume, false);
-                                    rowCounter++;
-                                    groupedVolume = amount;
-                                    groupedPrice -= baseValues.groupPriceValue;
-                                }
+                                if (fieldIterator.key() == "asset")
+                                    asset = fieldIterator.value();
+                                else if (fieldIterator.key() == "free")
+                                    free = fieldIterator.value().toDouble();
                             }
-                        }
-                        else
-                        {
-                            depthSubmitOrder(baseValues.currentPair.symbol,
-                                             &currentBidsMap, priceDouble, amount, false);
-                            rowCounter++;
+
+                            if (asset == currA.constData())
+                                btcBalance = free;
+                            else if (asset == currB.constData())
+                                usdBalance = free;
                         }
                     }
-
-                    QList<double> currentBidsList = lastDepthBidsMap.keys();
-
-                    for (int n = 0; n < currentBidsList.count(); n++)
-                        if (qFuzzyIsNull(currentBidsMap.value(currentBidsList.at(n), 0)))
-                            depthUpdateOrder(baseValues.currentPair.symbol,
-                                             currentBidsList.at(n), 0.0, false);
-
-                    lastDepthBidsMap = currentBidsMap;
-
-                    emit depthSubmitOrders(baseValues.currentPair.symbol, depthAsks, depthBids);
-                    depthAsks = nullptr;
-                    depthBids = nullptr;
                 }
-            }
-            else if (debugLevel)
-                logThread->writeLog("Invalid depth data:" + data, 2);
-
-            break;
-
-        case 202: //info
-            {
-                if (!success)
-                    break;
-
-                QByteArray fundsData = getMidData("\"balances\":[{", "}]}", &data);
-                double btcBalance = getMidData("\"" + baseValues.currentPair.currAStr + "\",\"free\":\"", "\"", &fundsData).toDouble();
 
                 if (btcBalance > 0.0 && !qFuzzyCompare(btcBalance, lastBtcBalance))
                 {
@@ -411,16 +430,13 @@ void Exchange_Binance::dataReceivedAuth(QByteArray data, int reqType)
                     lastBtcBalance = btcBalance;
                 }
 
-                double usdBalance = getMidData("\"" + baseValues.currentPair.currBStr + "\",\"free\":\"", "\"", &fundsData).toDouble();
-
                 if (usdBalance > 0.0 && !qFuzzyCompare(usdBalance, lastUsdBalance))
                 {
                     emit accUsdBalanceChanged(baseValues.currentPair.symbol, usdBalance);
                     lastUsdBalance = usdBalance;
                 }
 
-                double fee = qMax(getMidData("\"makerCommission\":", ",", &data).toDouble(),
-                                  getMidData("\"takerCommission\":", ",", &data).toDouble()) / 100;
+                double fee = qMax(makerCommission, takerCommission) / 100;
 
                 if (!qFuzzyCompare(fee + 1.0, lastFee + 1.0))
                 {
@@ -428,17 +444,12 @@ void Exchange_Binance::dataReceivedAuth(QByteArray data, int reqType)
                     lastFee = fee;
                 }
 
-                if (isFirstAccInfo)
+                if (isFirstAccInfo && rights.isValid())
                 {
-                    QByteArray rights = getMidData("\"canTrade\":", ",", &data);
+                    if (!rights.toBool())
+                        emit showErrorMessage("I:>invalid_rights");
 
-                    if (!rights.isEmpty())
-                    {
-                        if (rights != "true")
-                            emit showErrorMessage("I:>invalid_rights");
-
-                        isFirstAccInfo = false;
-                    }
+                    isFirstAccInfo = false;
                 }
             }
             break;//info
@@ -455,36 +466,48 @@ void Exchange_Binance::dataReceivedAuth(QByteArray data, int reqType)
                         break;
                     }
 
-                    QStringList ordersList = QString(data).split("},{");
                     QList<OrderItem>* orders = new QList<OrderItem>;
+                    QList<CurrencyPairItem>* pairs = IniEngine::getPairs();
+                    JulyJsonIterator ordersIterator(json);
 
-                    for (int n = 0; n < ordersList.count(); ++n)
+                    while (ordersIterator.next())
                     {
                         OrderItem currentOrder;
-                        QByteArray currentOrderData = ordersList.at(n).toLatin1();
-                        QByteArray status = getMidData("status\":\"", "\"", &currentOrderData);
-
-                        //0=Canceled, 1=Open, 2=Pending, 3=Post-Pending
-                        if (status == "CANCELED" || status == "REJECTED" || status == "EXPIRED")
-                            currentOrder.status = 0;
-                        else if (status == "NEW" || status == "PARTIALLY_FILLED")
-                            currentOrder.status = 1;
-                        else
-                            currentOrder.status = 2;
-
-                        QByteArray date     = getMidData("\"time\":",      ",",  &currentOrderData);
-                        date.chop(3);
-                        currentOrder.date   = date.toUInt();
-                        currentOrder.oid    = getMidData("\"orderId\":",   ",",  &currentOrderData);
-                        currentOrder.type   = getMidData("\"side\":\"",    "\"", &currentOrderData) == "SELL";
-                        currentOrder.amount = getMidData("\"origQty\":\"", "\"", &currentOrderData).toDouble();
-                        currentOrder.price  = getMidData("\"price\":\"",   "\"", &currentOrderData).toDouble();
-                        QByteArray request  = getMidData("\"symbol\":\"",  "\"", &currentOrderData);
-                        QList<CurrencyPairItem>* pairs = IniEngine::getPairs();
+                        JulyJsonValue request;
+                        JulyJsonIterator fieldIterator(ordersIterator.value());
+
+                        while (fieldIterator.next())
+                        {
+                            const JulyJsonValue& key = fieldIterator.key();
+                            const JulyJsonValue& value = fieldIterator.value();
+
+                            if (key == "status")
+                            {
+                                //0=Canceled, 1=Open, 2=Pending, 3=Post-Pending
+                                if (value == "CANCELED" || value == "REJECTED" || value == "EXPIRED")
+                                    currentOrder.status = 0;
+                                else if (value == "NEW" || value == "PARTIALLY_FILLED")
+                                    currentOrder.status = 1;
+                                else
+                                    currentOrder.status = 2;
+                            }
+                            else if (key == "time")
+                                currentOrder.date = value.toLongLong() / 1000;
+                            else if (key == "orderId")
+                                currentOrder.oid = value.toByteArray();
+                            else if (key == "side")
+                                currentOrder.type = value == "SELL";
+                            else if (key == "origQty")
+                                currentOrder.amount = value.toDouble();
+                            else if (key == "price")
+                                currentOrder.price = value.toDouble();
+                            else if (key == "symbol")
+                                request = value;
+                        }
 
                         for (int i = 0; i < pairs->count(); ++i)
                         {
-                            if (pairs->at(i).currRequestPair == request)
+                            if (request == pairs->at(i).currRequestPair.constData())
                             {
                                 currentOrder.symbol = pairs->at(i).symbol;
                                 break;
@@ -507,7 +530,7 @@ void Exchange_Binance::dataReceivedAuth(QByteArray data, int reqType)
         case 305: //order/cancel
             if (success)
             {
-                QByteArray oid = getMidData("\"orderId\":", ",", &data);
+                QByteArray oid = json.value("orderId").toByteArray();
 
                 if (!oid.isEmpty())
                     emit orderCanceled(baseValues.currentPair.symbol, oid);
@@ -536,14 +559,41 @@ void Exchange_Binance::dataReceivedAuth(QByteArray data, int reqType)
                 {
                     lastHistory = data;
 
-                    QStringList historyList = QString(data).split("},{");
+                    QList<JulyJsonValue> historyList;
+                    JulyJsonIterator historyIterator(json);
+
+                    while (historyIterator.next())
+                        historyList << historyIterator.value();
+
                     qint64 maxId = 0;
                     QList<HistoryItem>* historyItems = new QList<HistoryItem>;
+                    QList<CurrencyPairItem>* pairs = IniEngine::getPairs();
 
                     for (int n = historyList.count() - 1; n >= 0; --n)
                     {
-                        QByteArray logData(historyList.at(n).toLatin1());
-                        qint64 id = getMidData("\"id\":", ",", &logData).toLongLong();
+                        HistoryItem currentHistoryItem;
+                        qint64 id = 0;
+                        JulyJsonValue request;
+                        JulyJsonIterator fieldIterator(historyList.at(n));
+
+                        while (fieldIterator.next())
+                        {
+                            const JulyJsonValue& key = fieldIterator.key();
+                            const JulyJsonValue& value = fieldIterator.value();
+
+                            if (key == "id")
+                                id = value.toLongLong();
+                            else if (key == "isBuyer")
+                                currentHistoryItem.type = value.toBool() ? 2 : 1;
+                            else if (key == "symbol")
+                                request = value;
+                            else if (key == "time")
+                                currentHistoryItem.dateTimeInt = value.toLongLong() / 1000;
+                            else if (key == "price")
+                                currentHistoryItem.price = value.toDouble();
+                            else if (key == "qty")
+                                currentHistoryItem.volume = value.toDouble();
+                        }
 
                         if (id <= lastHistoryId)
                             break;
@@ -551,31 +601,15 @@ void Exchange_Binance::dataReceivedAuth(QByteArray data, int reqType)
                         if (id > maxId)
                             maxId = id;
 
-                        HistoryItem currentHistoryItem;
-
-                        if (getMidData("\"isBuyer\":", ",", &logData) == "true")
-                            currentHistoryItem.type = 2;
-                        else
-                            currentHistoryItem.type = 1;
-
-                        QByteArray request  = getMidData("\"symbol\":\"", "\"", &logData);
-                        QList<CurrencyPairItem>* pairs = IniEngine::getPairs();
-
                         for (int i = 0; i < pairs->count(); ++i)
                         {
-                            if (pairs->at(i).currRequestPair == request)
+                            if (request == pairs->at(i).currRequestPair.constData())
                             {
                                 currentHistoryItem.symbol = pairs->at(i).symbol;
                                 break;
                             }
                         }
 
-                        QByteArray data                = getMidData("\"time\":",    ",",  &logData);
-                        data.chop(3);
-                        currentHistoryItem.dateTimeInt = data.toUInt();
-                        currentHistoryItem.price       = getMidData("\"price\":\"", "\"", &logData).toDouble();
-                        currentHistoryItem.volume      = getMidData("\"qty\":\"",   "\"", &logData).toDouble();
-
                         if (currentHistoryItem.isValid())
                             (*historyItems) << currentHistoryItem;
                     }
@@ -635,60 +669,203 @@ void Exchange_Binance::dataReceivedAuth(QByteArray data, int reqType)
     }
 }
 
-void Exchange_Binance::depthUpdateOrder(QString symbol, double price, double amount, bool isAsk)
+void Exchange_Binance::readDepthLevels(OrderBook* book, const JulyJsonValue& levels, bool isAsk)
 {
-    if (symbol != baseValues.currentPair.symbol)
-        return;
+    // Levels look like ["price","qty"] in the streams and ["price","qty",[]] in the REST snapshot
+    JulyJsonIterator levelIterator(levels);
 
-    if (isAsk)
+    while (levelIterator.next())
     {
-        if (depthAsks == nullptr)
-            return;
+        JulyJsonIterator fieldIterator(levelIterator.value());
+
+        if (!fieldIterator.next())
+            continue;
+
+        double priceDouble = fieldIterator.value().toDouble();
 
-        DepthItem newItem;
-        newItem.price = price;
-        newItem.volume = amount;
+        if (!fieldIterator.next())
+            continue;
 
-        if (newItem.isValid())
-            (*depthAsks) << newItem;
+        book->updateLevel(isAsk, priceDouble, fieldIterator.value().toDouble());
     }
-    else
+}
+
+JulyJsonValue Exchange_Binance::streamEvent(const QByteArray& message)
+{
+    // Combined streams wrap every event as {"stream":"...","data":{...}}
+    JulyJsonValue root = JulyJsonValue::fromData(message);
+    JulyJsonValue event = root.value("data");
+    return event.isObject() ? event : root;
+}
+
+bool Exchange_Binance::applyDepthEvent(const QByteArray& message)
+{
+    qint64 firstUpdateId = 0;
+    qint64 lastUpdateId = 0;
+    JulyJsonValue asks;
+    JulyJsonValue bids;
+    JulyJsonIterator eventIterator(streamEvent(message));
+
+    while (eventIterator.next())
     {
-        if (depthBids == nullptr)
-            return;
+        const JulyJsonValue& key = eventIterator.key();
+
+        if (key == "U")
+            firstUpdateId = eventIterator.value().toLongLong();
+        else if (key == "u")
+            lastUpdateId = eventIterator.value().toLongLong();
+        else if (key == "a")
+            asks = eventIterator.value();
+        else if (key == "b")
+            bids = eventIterator.value();
+    }
 
-        DepthItem newItem;
-        newItem.price = price;
-        newItem.volume = amount;
+    if (lastUpdateId <= bookLastUpdateId)
+        return true;
+
+    if (firstUpdateId > bookLastUpdateId + 1)
+        return false;
+
+    readDepthLevels(&depthBook, bids, false);
+    readDepthLevels(&depthBook, asks, true);
+    bookLastUpdateId = lastUpdateId;
+    return true;
+}
+
+void Exchange_Binance::depthEventReceived(const QByteArray& message)
+{
+    if (!isDepthEnabled())
+        return;
+
+    if (!bookSynced)
+    {
+        if (pendingDepthEvents.count() >= 1000)
+            pendingDepthEvents.removeFirst();
+
+        pendingDepthEvents << message;
+        return;
+    }
 
-        if (newItem.isValid())
-            (*depthBids) << newItem;
+    if (applyDepthEvent(message))
+    {
+        depthSubmitBook();
+        return;
     }
+
+    if (debugLevel)
+        logThread->writeLog("Depth stream gap, reloading snapshot", 2);
+
+    bookSynced = false;
+    pendingDepthEvents.clear();
+    pendingDepthEvents << message;
+    lastDepthData.clear();
+    forceDepthLoad = true;
 }
 
-void Exchange_Binance::depthSubmitOrder(QString symbol, QMap<double, double>* currentMap, double priceDouble,
-                                    double amount, bool isAsk)
+void Exchange_Binance::tradeEventReceived(const JulyJsonValue& event)
 {
-    if (symbol != baseValues.currentPair.symbol)
+    TradesItem newItem;
+    qint64 currentTid = 0;
+    JulyJsonIterator eventIterator(event);
+
+    while (eventIterator.next())
+    {
+        const JulyJsonValue& key = eventIterator.key();
+
+        if (key == "t")
+            currentTid = eventIterator.value().toLongLong();
+        else if (key == "p")
+            newItem.price = eventIterator.value().toDouble();
+        else if (key == "q")
+            newItem.amount = eventIterator.value().toDouble();
+        else if (key == "T")
+            newItem.date = eventIterator.value().toLongLong() / 1000;
+        else if (key == "m")
+            newItem.orderType = eventIterator.value().toBool() ? 1 : -1;
+    }
+
+    if (currentTid <= lastTradesId)
         return;
 
-    if (priceDouble == 0.0 || amount == 0.0)
+    lastTradesId = currentTid;
+    newItem.symbol = baseValues.currentPair.symbol;
+
+    if (!newItem.isValid())
+    {
+        if (debugLevel)
+            logThread->writeLog("Invalid trade event:" + event.toByteArray(), 2);
+
         return;
+    }
 
-    if (isAsk)
+    if (currentTid > lastTickerId)
     {
-        (*currentMap)[priceDouble] = amount;
+        lastTickerId = currentTid;
 
-        if (!qFuzzyCompare(lastDepthAsksMap.value(priceDouble, 0.0), amount))
-            depthUpdateOrder(symbol, priceDouble, amount, true);
+        if (!qFuzzyCompare(newItem.price, lastTickerLast))
+        {
+            IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                      IndicatorEngine::Last, newItem.price);
+            lastTickerLast = newItem.price;
+        }
     }
-    else
+
+    QList<TradesItem>* newTradesItems = new QList<TradesItem>;
+    (*newTradesItems) << newItem;
+    emit addLastTrades(baseValues.currentPair.symbol, newTradesItems);
+}
+
+void Exchange_Binance::webSocketMessage(QByteArray message)
+{
+    if (debugLevel)
+        logThread->writeLog("WS RCV: " + message);
+
+    JulyJsonValue event = streamEvent(message);
+    JulyJsonValue eventType;
+    JulyJsonValue eventSymbol;
+    JulyJsonIterator eventIterator(event);
+
+    while ((!eventType.isValid() || !eventSymbol.isValid()) && eventIterator.next())
     {
-        (*currentMap)[priceDouble] = amount;
+        if (eventIterator.key() == "e")
+            eventType = eventIterator.value();
+        else if (eventIterator.key() == "s")
+            eventSymbol = eventIterator.value();
+    }
 
-        if (!qFuzzyCompare(lastDepthBidsMap.value(priceDouble, 0.0), amount))
-            depthUpdateOrder(symbol, priceDouble, amount, false);
+    if (eventSymbol != baseValues.currentPair.currRequestPair.constData())
+        return;
+
+    if (eventType == "depthUpdate")
+        depthEventReceived(message);
+    else if (eventType == "trade")
+        tradeEventReceived(event);
+}
+
+void Exchange_Binance::webSocketClosed()
+{
+    bookSynced = false;
+    pendingDepthEvents.clear();
+}
+
+void Exchange_Binance::setupWebSocket()
+{
+    webSocketPair = baseValues.currentPair.currRequestPair;
+    QByteArray streamPair = webSocketPair.toLower();
+    QByteArray path = "/stream?streams=" + streamPair + "@depth@100ms/" + streamPair + "@trade";
+
+    if (webSocket == nullptr)
+    {
+        webSocket = new JulyWebSocket("stream.binance.com", 9443, path, this);
+        connect(webSocket, SIGNAL(textMessageReceived(QByteArray)), this, SLOT(webSocketMessage(QByteArray)));
+        connect(webSocket, SIGNAL(closed()), this, SLOT(webSocketClosed()));
+        connect(webSocket, SIGNAL(sslErrorSignal(const QList<QSslError>&)), this, SLOT(sslErrors(const QList<QSslError>&)));
     }
+    else
+        webSocket->setPath(path);
+
+    webSocketClosed();
+    webSocket->open();
 }
 
 bool Exchange_Binance::isReplayPending(int reqType)
@@ -703,6 +880,11 @@ void Exchange_Binance::secondSlot()
 {
     static int sendCounter = 0;
 
+    if (baseValues.webSocketsEnabled && webSocketPair != baseValues.currentPair.currRequestPair)
+        setupWebSocket();
+
+    bool webSocketOpened = webSocket && webSocket->isOpened();
+
     switch (sendCounter)
     {
         case 0:
@@ -718,7 +900,7 @@ void Exchange_Binance::secondSlot()
             break;
 
         case 2:
-            if (!isReplayPending(109))
+            if (!webSocketOpened && !isReplayPending(109))
             {
                 QByteArray fromId = lastTradesId ? "&fromId=" + QByteArray::number(lastTradesId + 1) : "";
                 sendToApi(109, "v1/historicalTrades?symbol=" + baseValues.currentPair.currRequestPair + fromId, false, false);
@@ -733,13 +915,25 @@ void Exchange_Binance::secondSlot()
             break;
 
         case 4:
-            if (isDepthEnabled() && (forceDepthLoad || !isReplayPending(111)))
+            if (isDepthEnabled() && (forceDepthLoad || (!bookSynced && !isReplayPending(111))))
             {
+                // The stream only carries changes, so its snapshot has to be deep enough to keep them in range
+                QByteArray depthLimit = webSocketOpened ? QByteArray("1000") : baseValues.depthCountLimitStr;
                 emit depthRequested();
-                sendToApi(111, "v1/depth?symbol=" + baseValues.currentPair.currRequestPair + "&limit=" + baseValues.depthCountLimitStr, false, true);
+                sendToApi(111, "v1/depth?symbol=" + baseValues.currentPair.currRequestPair + "&limit=" + depthLimit, false, true);
                 forceDepthLoad = false;
             }
 
+            if (!isReplayPending(112))
+            {
+                // Other pairs scripts watch are refreshed one at a time, a response always belongs to watchedDepthSymbol
+                watchedDepthSymbol = nextWatchedDepthSymbol();
+
+                if (!watchedDepthSymbol.isEmpty())
+                    sendToApi(112, "v1/depth?symbol=" + baseValues.currencyPairMap.value(watchedDepthSymbol).currRequestPair +
+                              "&limit=" + baseValues.depthCountLimitStr, false, true);
+            }
+
             break;
 
         case 5:
@@ -838,13 +1032,14 @@ void Exchange_Binance::sendToApi(int reqType, QByteArray method, bool auth, bool
 {
     if (julyHttp == nullptr)
     {
-        julyHttp = new JulyHttp("api.binance.com", "X-MBX-APIKEY: " + getApiKey() + "\r", this);
+        julyHttp = new JulyHttpPool("api.binance.com", "X-MBX-APIKEY: " + getApiKey() + "\r", this);
         connect(julyHttp, SIGNAL(anyDataReceived()), baseValues_->mainWindow_, SLOT(anyDataReceived()));
         connect(julyHttp, SIGNAL(apiDown(bool)), baseValues_->mainWindow_, SLOT(setApiDown(bool)));
         connect(julyHttp, SIGNAL(setDataPending(bool)), baseValues_->mainWindow_, SLOT(setDataPending(bool)));
         connect(julyHttp, SIGNAL(errorSignal(QString)), baseValues_->mainWindow_, SLOT(showErrorMessage(QString)));
         connect(julyHttp, SIGNAL(sslErrorSignal(const QList<QSslError>&)), this, SLOT(sslErrors(const QList<QSslError>&)));
         connect(julyHttp, SIGNAL(dataReceived(QByteArray, int)), this, SLOT(dataReceivedAuth(QByteArray, int)));
+        julyHttp->setRateLimiter(&rateLimiter);
     }
 
     if (auth)
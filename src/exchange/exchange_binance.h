@@ -55,11 +55,17 @@ private slots:
     void dataReceivedAuth(QByteArray, int);
     void secondSlot();
     void quitThread();
+    void webSocketMessage(QByteArray);
+    void webSocketClosed();
 
 private:
     void clearVariables();
-    void depthSubmitOrder(QString, QMap<double, double>* currentMap, double priceDouble, double amount, bool isAsk);
-    void depthUpdateOrder(QString, double, double, bool);
+    void readDepthLevels(OrderBook* book, const JulyJsonValue& levels, bool isAsk);
+    JulyJsonValue streamEvent(const QByteArray& message);
+    bool applyDepthEvent(const QByteArray& message);
+    void depthEventReceived(const QByteArray& message);
+    void tradeEventReceived(const JulyJsonValue& event);
+    void setupWebSocket();
     void sendToApi(int reqType, QByteArray method, bool auth = false, bool simple = false, QByteArray commands = nullptr);
     bool isReplayPending(int);
 
@@ -71,13 +77,13 @@ private:
     qint64 lastTradesId;
     qint64 lastHistoryId;
 
-    JulyHttp* julyHttp;
+    JulyHttpPool* julyHttp;
+    JulyWebSocket* webSocket;
+    QByteArray webSocketPair;
 
-    QList<DepthItem>* depthAsks;
-    QList<DepthItem>* depthBids;
-
-    QMap<double, double> lastDepthAsksMap;
-    QMap<double, double> lastDepthBidsMap;
+    bool bookSynced;
+    qint64 bookLastUpdateId;
+    QList<QByteArray> pendingDepthEvents;
 };
 
 #endif // EXCHANGE_BINANCE_H
@@ -49,10 +49,14 @@ Exchange_Bitfinex::Exchange_Bitfinex(QByteArray pRestSign, QByteArray pRestKey)
 
     setApiKeySecret(pRestKey, pRestSign);
 
-    depthAsks = 0;
-    depthBids = 0;
     forceDepthLoad = false;
     julyHttp = 0;
+    webSocket = nullptr;
+    bookChannelId = 0;
+    tradesChannelId = 0;
+    lastTradesWsId = 0;
+    bookSynced = false;
+    bookSubmitPending = false;
     tickerOnly = false;
 
     currencyMapFile = "Bitfinex";
@@ -74,6 +78,12 @@ Exchange_Bitfinex::Exchange_Bitfinex(QByteArray pRestSign, QByteArray pRestKey)
     supportsLoginIndicator = false;
     supportsAccountVolume = false;
 
+    //Bucket 0: public requests per minute, bucket 1: authenticated requests per minute
+    rateLimiter.addBucket(0, 90, 60000);
+    rateLimiter.addBucket(1, 90, 60000);
+    rateLimiter.addCost(100, 199, 0, 1);
+    rateLimiter.addCost(200, 399, 1, 1);
+
     authRequestTime.restart();
     privateNonce = (QDateTime::currentDateTime().toTime_t() - 1371854884) * 10;
 
@@ -88,14 +98,11 @@ void Exchange_Bitfinex::quitThread()
 {
     clearValues();
 
-    if (depthAsks)
-        delete depthAsks;
-
-    if (depthBids)
-        delete depthBids;
-
     if (julyHttp)
         delete julyHttp;
+
+    if (webSocket)
+        delete webSocket;
 }
 
 void Exchange_Bitfinex::clearVariables()
@@ -119,7 +126,10 @@ void Exchange_Bitfinex::clearVariables()
     tickerLastDate = 0;
     lastTradesDate = 0;
     lastTradesDateCache = "0";
+    lastTradesWsId = 0;
     lastHistoryId = 0;
+    depthBook.clear();
+    bookSynced = false;
 }
 
 void Exchange_Bitfinex::clearValues()
@@ -134,6 +144,11 @@ void Exchange_Bitfinex::secondSlot()
 {
     static int sendCounter = 0;
 
+    if (baseValues.webSocketsEnabled && webSocketPair != baseValues.currentPair.currRequestPair)
+        setupWebSocket();
+
+    bool webSocketTrades = tradesChannelId && webSocket && webSocket->isOpened();
+
     switch (sendCounter)
     {
     case 0:
@@ -149,7 +164,7 @@ void Exchange_Bitfinex::secondSlot()
         break;
 
     case 2:
-        if (!isReplayPending(109))
+        if (!webSocketTrades && !isReplayPending(109))
             sendToApi(109, "trades/" + baseValues.currentPair.currRequestPair + "?timestamp=" + lastTradesDateCache +
                       "&limit_trades=200"/*astTradesDateCache*/, false, true);
 
@@ -162,7 +177,7 @@ void Exchange_Bitfinex::secondSlot()
         break;
 
     case 4:
-        if (isDepthEnabled() && (forceDepthLoad || !isReplayPending(111)))
+        if (isDepthEnabled() && !bookSynced && (forceDepthLoad || !isReplayPending(111)))
         {
             emit depthRequested();
             sendToApi(111, "book/" + baseValues.currentPair.currRequestPair + "?limit_bids=" + baseValues.depthCountLimitStr +
@@ -292,13 +307,14 @@ void Exchange_Bitfinex::sendToApi(int reqType, QByteArray method, bool auth, boo
 {
     if (julyHttp == 0)
     {
-        julyHttp = new JulyHttp("api.bitfinex.com", "X-BFX-APIKEY: " + getApiKey() + "\r\n", this);
+        julyHttp = new JulyHttpPool("api.bitfinex.com", "X-BFX-APIKEY: " + getApiKey() + "\r\n", this);
         connect(julyHttp, SIGNAL(anyDataReceived()), baseValues_->mainWindow_, SLOT(anyDataReceived()));
         connect(julyHttp, SIGNAL(setDataPending(bool)), baseValues_->mainWindow_, SLOT(setDataPending(bool)));
         connect(julyHttp, SIGNAL(apiDown(bool)), baseValues_->mainWindow_, SLOT(setApiDown(bool)));
         connect(julyHttp, SIGNAL(errorSignal(QString)), baseValues_->mainWindow_, SLOT(showErrorMessage(QString)));
         connect(julyHttp, SIGNAL(sslErrorSignal(const QList<QSslError>&)), this, SLOT(sslErrors(const QList<QSslError>&)));
         connect(julyHttp, SIGNAL(dataReceived(QByteArray, int)), this, SLOT(dataReceivedAuth(QByteArray, int)));
+        julyHttp->setRateLimiter(&rateLimiter);
     }
 
     if (auth)
@@ -325,71 +341,237 @@ void Exchange_Bitfinex::sendToApi(int reqType, QByteArray method, bool auth, boo
     }
 }
 
-void Exchange_Bitfinex::depthUpdateOrder(QString symbol, double price, double amount, bool isAsk)
+void Exchange_Bitfinex::reloadDepth()
+{
+    Exchange::reloadDepth();
+
+    if (bookSynced && !bookSubmitPending)
+    {
+        bookSubmitPending = true;
+        QTimer::singleShot(0, this, SLOT(bookSubmitSlot()));
+    }
+}
+
+void Exchange_Bitfinex::bookSubmitSlot()
 {
-    if (symbol != baseValues.currentPair.symbol)
+    bookSubmitPending = false;
+
+    if (!bookSynced || !isDepthEnabled())
         return;
 
-    if (isAsk)
+    if (depthBook.count(true) && depthBook.level(true, 0).price != JulyPrice::fromDouble(lastTickerBuy))
     {
-        if (depthAsks == 0)
-            return;
+        lastTickerBuy = depthBook.level(true, 0).price.toDouble();
+        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                  IndicatorEngine::Buy, lastTickerBuy);
+    }
+
+    if (depthBook.count(false) && depthBook.level(false, 0).price != JulyPrice::fromDouble(lastTickerSell))
+    {
+        lastTickerSell = depthBook.level(false, 0).price.toDouble();
+        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                  IndicatorEngine::Sell, lastTickerSell);
+    }
 
-        DepthItem newItem;
-        newItem.price = price;
-        newItem.volume = amount;
+    depthSubmitBook();
+}
+
+void Exchange_Bitfinex::bookEventReceived(const JulyJsonValue& body)
+{
+    // Book levels are [PRICE,COUNT,AMOUNT], a snapshot is a list of them
+    QList<JulyJsonValue> levelList;
+
+    if (body.at(0).isArray())
+    {
+        depthBook.clearLevels();
 
-        if (newItem.isValid())
-            (*depthAsks) << newItem;
+        JulyJsonIterator levelIterator(body);
+
+        while (levelIterator.next())
+            levelList << levelIterator.value();
+
+        bookSynced = true;
+        emit depthRequestReceived();
     }
-    else
+    else if (body.isArray())
+        levelList << body;
+
+    if (!bookSynced || levelList.isEmpty())
+        return;
+
+    for (int n = 0; n < levelList.count(); n++)
     {
-        if (depthBids == 0)
-            return;
+        const JulyJsonValue& level = levelList.at(n);
+
+        if (level.count() != 3)
+            continue;
 
-        DepthItem newItem;
-        newItem.price = price;
-        newItem.volume = amount;
+        double priceDouble = level.at(0).toDouble();
+        qint64 count = level.at(1).toLongLong();
+        double amount = level.at(2).toDouble();
+
+        // A zero count removes the level from the side the amount sign points to
+        depthBook.updateLevel(amount < 0.0, priceDouble, count > 0 ? qAbs(amount) : 0.0);
+    }
 
-        if (newItem.isValid())
-            (*depthBids) << newItem;
+    if (!bookSubmitPending)
+    {
+        bookSubmitPending = true;
+        QTimer::singleShot(100, this, SLOT(bookSubmitSlot()));
     }
 }
 
-void Exchange_Bitfinex::depthSubmitOrder(QString symbol, QMap<double, double>* currentMap, double priceDouble,
-        double amount, bool isAsk)
+void Exchange_Bitfinex::tradesEventReceived(const JulyJsonValue& message)
 {
-    if (symbol != baseValues.currentPair.symbol)
-        return;
+    // Trades are [ID,MTS,AMOUNT,PRICE], a negative amount is a sell
+    QList<JulyJsonValue> tradeList;
+    JulyJsonValue body = message.at(1);
 
-    if (priceDouble == 0.0 || amount == 0.0)
+    if (body.isArray())
+    {
+        JulyJsonIterator tradeIterator(body);
+
+        while (tradeIterator.next())
+            tradeList << tradeIterator.value();
+    }
+    else if (body == "te")
+        tradeList << message.at(2);
+    else
         return;
 
-    if (orderBookItemIsDedicatedOrder)
-        amount += currentMap->value(priceDouble, 0.0);
+    QList<TradesItem>* newTradesItems = new QList<TradesItem>;
 
-    if (isAsk)
+    for (int n = tradeList.count() - 1; n >= 0; n--)
     {
-        (*currentMap)[priceDouble] = amount;
+        const JulyJsonValue& trade = tradeList.at(n);
+
+        if (trade.count() != 4)
+            continue;
+
+        qint64 tradeId = trade.at(0).toLongLong();
+        qint64 tradeDate = trade.at(1).toLongLong() / 1000;
+
+        if (tradeId <= lastTradesWsId || tradeDate < lastTradesDate)
+            continue;
+
+        lastTradesWsId = tradeId;
+
+        TradesItem newItem;
+        double amount = trade.at(2).toDouble();
+        newItem.amount = qAbs(amount);
+        newItem.price = trade.at(3).toDouble();
+        newItem.orderType = amount < 0.0 ? 1 : -1;
+        newItem.symbol = baseValues.currentPair.symbol;
+        newItem.date = tradeDate;
+
+        if (!newItem.isValid())
+        {
+            if (debugLevel)
+                logThread->writeLog("Invalid trade event:" + QByteArray(trade.data(), trade.size()), 2);
+
+            continue;
+        }
+
+        (*newTradesItems) << newItem;
 
-        if (lastDepthAsksMap.value(priceDouble, 0.0) != amount)
-            depthUpdateOrder(symbol, priceDouble, amount, true);
+        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                  IndicatorEngine::Last, newItem.price);
+        tickerLastDate = tradeDate;
+        lastTradesDate = tradeDate;
+        lastTradesDateCache = QByteArray::number(tickerLastDate + 1);
     }
+
+    if (newTradesItems->count())
+        emit addLastTrades(baseValues.currentPair.symbol, newTradesItems);
     else
+        delete newTradesItems;
+}
+
+void Exchange_Bitfinex::webSocketMessage(QByteArray message)
+{
+    if (debugLevel)
+        logThread->writeLog("WS RCV: " + message);
+
+    JulyJsonValue json = JulyJsonValue::fromData(message);
+
+    if (json.isObject())
     {
-        (*currentMap)[priceDouble] = amount;
+        JulyJsonValue event;
+        JulyJsonValue channel;
+        qint64 channelId = 0;
+        qint64 code = 0;
+        JulyJsonIterator fieldIterator(json);
+
+        while (fieldIterator.next())
+        {
+            const JulyJsonValue& key = fieldIterator.key();
+
+            if (key == "event")
+                event = fieldIterator.value();
+            else if (key == "channel")
+                channel = fieldIterator.value();
+            else if (key == "chanId")
+                channelId = fieldIterator.value().toLongLong();
+            else if (key == "code")
+                code = fieldIterator.value().toLongLong();
+        }
+
+        if (event == "subscribed")
+        {
+            if (channel == "book")
+                bookChannelId = channelId;
+            else if (channel == "trades")
+                tradesChannelId = channelId;
+        }
+        else if (event == "info" && code == 20051)
+            webSocket->open();
+        else if (event == "error" && debugLevel)
+            logThread->writeLog("WS error: " + message, 2);
 
-        if (lastDepthBidsMap.value(priceDouble, 0.0) != amount)
-            depthUpdateOrder(symbol, priceDouble, amount, false);
+        return;
     }
+
+    if (!json.isArray())
+        return;
+
+    qint64 channelId = json.at(0).toLongLong();
+    JulyJsonValue body = json.at(1);
+
+    if (!body.isValid() || body == "hb")
+        return;
+
+    if (channelId == bookChannelId)
+        bookEventReceived(body);
+    else if (channelId == tradesChannelId)
+        tradesEventReceived(json);
 }
 
-void Exchange_Bitfinex::reloadDepth()
+void Exchange_Bitfinex::webSocketClosed()
 {
-    lastDepthBidsMap.clear();
-    lastDepthAsksMap.clear();
-    lastDepthData.clear();
-    Exchange::reloadDepth();
+    bookChannelId = 0;
+    tradesChannelId = 0;
+    bookSynced = false;
+}
+
+void Exchange_Bitfinex::setupWebSocket()
+{
+    webSocketPair = baseValues.currentPair.currRequestPair;
+    QByteArray wsSymbol = "t" + webSocketPair.toUpper();
+
+    if (webSocket == nullptr)
+    {
+        webSocket = new JulyWebSocket("api.bitfinex.com", 443, "/ws/2", this);
+        connect(webSocket, SIGNAL(textMessageReceived(QByteArray)), this, SLOT(webSocketMessage(QByteArray)));
+        connect(webSocket, SIGNAL(closed()), this, SLOT(webSocketClosed()));
+        connect(webSocket, SIGNAL(sslErrorSignal(const QList<QSslError>&)), this, SLOT(sslErrors(const QList<QSslError>&)));
+    }
+
+    webSocket->setSubscriptions(QList<QByteArray>()
+                                << "{\"event\":\"subscribe\",\"channel\":\"book\",\"symbol\":\"" + wsSymbol +
+                                "\",\"prec\":\"P0\",\"len\":\"100\"}"
+                                << "{\"event\":\"subscribe\",\"channel\":\"trades\",\"symbol\":\"" + wsSymbol + "\"}");
+    webSocketClosed();
+    webSocket->open();
 }
 
 void Exchange_Bitfinex::dataReceivedAuth(QByteArray data, int reqType)
@@ -400,6 +582,7 @@ void Exchange_Bitfinex::dataReceivedAuth(QByteArray data, int reqType)
     if (data.size() && data.at(0) == QLatin1Char('<'))
         return;
 
+    JulyJsonValue json = JulyJsonValue::fromData(data);
     bool success = (data.startsWith("{") || data.startsWith("[")) && !data.startsWith("{\"message\"");
 
     switch (reqType)
@@ -410,76 +593,98 @@ void Exchange_Bitfinex::dataReceivedAuth(QByteArray data, int reqType)
 
         if (data.startsWith("{\"mid\":"))
         {
-            QByteArray tickerSell = getMidData("bid\":\"", "\"", &data);
+            JulyJsonValue tickerSell;
+            JulyJsonValue tickerBuy;
+            JulyJsonValue tickerLast;
+            JulyJsonValue tickerHigh;
+            JulyJsonValue tickerLow;
+            JulyJsonValue tickerVolume;
+            quint32 tickerNow = 0;
+            JulyJsonIterator tickerIterator(json);
+
+            while (tickerIterator.next())
+            {
+                const JulyJsonValue& key = tickerIterator.key();
+
+                if (key == "bid")
+                    tickerSell = tickerIterator.value();
+                else if (key == "ask")
+                    tickerBuy = tickerIterator.value();
+                else if (key == "last_price")
+                    tickerLast = tickerIterator.value();
+                else if (key == "high")
+                    tickerHigh = tickerIterator.value();
+                else if (key == "low")
+                    tickerLow = tickerIterator.value();
+                else if (key == "volume")
+                    tickerVolume = tickerIterator.value();
+                else if (key == "timestamp")
+                    tickerNow = quint32(tickerIterator.value().toDouble());
+            }
 
-            if (!tickerSell.isEmpty())
+            if (tickerSell.isValid())
             {
                 double newTickerSell = tickerSell.toDouble();
 
                 if (newTickerSell != lastTickerSell)
-                    IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Sell", newTickerSell);
+                    IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                              IndicatorEngine::Sell, newTickerSell);
 
                 lastTickerSell = newTickerSell;
             }
 
-            QByteArray tickerBuy = getMidData("ask\":\"", "\"", &data);
-
-            if (!tickerBuy.isEmpty())
+            if (tickerBuy.isValid())
             {
                 double newTickerBuy = tickerBuy.toDouble();
 
                 if (newTickerBuy != lastTickerBuy)
-                    IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Buy", newTickerBuy);
+                    IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                              IndicatorEngine::Buy, newTickerBuy);
 
                 lastTickerBuy = newTickerBuy;
             }
 
-            quint32 tickerNow = getMidData("timestamp\":\"", ".", &data).toUInt();
-
             if (tickerLastDate < tickerNow)
             {
-                QByteArray tickerLast = getMidData("last_price\":\"", "\"", &data);
                 double newTickerLast = tickerLast.toDouble();
 
                 if (newTickerLast > 0.0)
                 {
-                    IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Last", newTickerLast);
+                    IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                              IndicatorEngine::Last, newTickerLast);
                     tickerLastDate = tickerNow;
                 }
             }
 
-            QByteArray tickerHigh = getMidData("high\":\"", "\"", &data);
-
-            if (!tickerHigh.isEmpty())
+            if (tickerHigh.isValid())
             {
                 double newTickerHigh = tickerHigh.toDouble();
 
                 if (newTickerHigh != lastTickerHigh)
-                    IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "High", newTickerHigh);
+                    IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                              IndicatorEngine::High, newTickerHigh);
 
                 lastTickerHigh = newTickerHigh;
             }
 
-            QByteArray tickerLow = getMidData("\"low\":\"", "\"", &data);
-
-            if (!tickerLow.isEmpty())
+            if (tickerLow.isValid())
             {
                 double newTickerLow = tickerLow.toDouble();
 
                 if (newTickerLow != lastTickerLow)
-                    IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Low", newTickerLow);
+                    IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                              IndicatorEngine::Low, newTickerLow);
 
                 lastTickerLow = newTickerLow;
             }
 
-            QByteArray tickerVolume = getMidData("\"volume\":\"", "\"", &data);
-
-            if (!tickerVolume.isEmpty())
+            if (tickerVolume.isValid())
             {
                 double newTickerVolume = tickerVolume.toDouble();
 
                 if (newTickerVolume != lastTickerVolume)
-                    IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Volume", newTickerVolume);
+                    IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                              IndicatorEngine::Volume, newTickerVolume);
 
                 lastTickerVolume = newTickerVolume;
             }
@@ -492,33 +697,49 @@ void Exchange_Bitfinex::dataReceivedAuth(QByteArray data, int reqType)
     case 109: //money/trades/fetch
         if (success && data.size() > 32)
         {
-            QStringList tradeList = QString(data).split("},{");
+            QList<JulyJsonValue> tradeList;
+            JulyJsonIterator tradesIterator(json);
+
+            while (tradesIterator.next())
+                tradeList << tradesIterator.value();
+
             QList<TradesItem>* newTradesItems = new QList<TradesItem>;
 
             for (int n = tradeList.count() - 1; n >= 0; n--)
             {
-                QByteArray tradeData = tradeList.at(n).toLatin1();
-                qint64 currentTradeDate = getMidData("timestamp\":", ",", &tradeData).toLongLong();
+                TradesItem newItem;
+                JulyJsonIterator fieldIterator(tradeList.at(n));
+
+                while (fieldIterator.next())
+                {
+                    const JulyJsonValue& key = fieldIterator.key();
+
+                    if (key == "timestamp")
+                        newItem.date = fieldIterator.value().toLongLong();
+                    else if (key == "amount")
+                        newItem.amount = fieldIterator.value().toDouble();
+                    else if (key == "price")
+                        newItem.price = fieldIterator.value().toDouble();
+                    else if (key == "type")
+                        newItem.orderType = fieldIterator.value() == "sell" ? 1 : -1;
+                }
+
+                qint64 currentTradeDate = newItem.date;
 
                 if (lastTradesDate >= currentTradeDate || currentTradeDate == 0)
                     continue;
 
-                TradesItem newItem;
-                newItem.amount = getMidData("\"amount\":\"", "\",", &tradeData).toDouble();
-                newItem.price = getMidData("\"price\":\"", "\",", &tradeData).toDouble();
-                newItem.orderType = getMidData("\"type\":\"", "\"", &tradeData) == "sell" ? 1 : -1;
-
                 newItem.symbol = baseValues.currentPair.symbol;
-                newItem.date = currentTradeDate;
 
                 if (newItem.isValid())
                     (*newTradesItems) << newItem;
                 else if (debugLevel)
-                    logThread->writeLog("Invalid trades fetch data line:" + tradeData, 2);
+                    logThread->writeLog("Invalid trades fetch data line:" + tradeList.at(n).toByteArray(), 2);
 
                 if (n == 0)
                 {
-                    IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Last", newItem.price);
+                    IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                              IndicatorEngine::Last, newItem.price);
                     tickerLastDate = currentTradeDate;
                     lastTradesDate = currentTradeDate;
                     lastTradesDateCache = QByteArray::number(tickerLastDate + 1);
@@ -534,6 +755,9 @@ void Exchange_Bitfinex::dataReceivedAuth(QByteArray data, int reqType)
         break;
 
     case 111: //depth
+        if (bookSynced)
+            break;
+
         if (data.startsWith("{\"bids\""))
         {
             emit depthRequestReceived();
@@ -542,141 +766,29 @@ void Exchange_Bitfinex::dataReceivedAuth(QByteArray data, int reqType)
             {
                 lastDepthData = data;
 
-                depthAsks = new QList<DepthItem>;
-                depthBids = new QList<DepthItem>;
-
-                QMap<double, double> currentAsksMap;
-
-                QStringList asksList = QString(getMidData("asks\":[{", "}]", &data)).split("},{");
-                double groupedPrice = 0.0;
-                double groupedVolume = 0.0;
-                int rowCounter = 0;
-
-                for (int n = 0; n < asksList.count(); n++)
-                {
-                    if (baseValues.depthCountLimit && rowCounter >= baseValues.depthCountLimit)
-                        break;
-
-                    QByteArray currentRow = asksList.at(n).toLatin1();
-                    double priceDouble = getMidData("price\":\"", "\"", &currentRow).toDouble();
-                    double amount = getMidData("amount\":\"", "\"", &currentRow).toDouble();
-
-                    if (n == 0)
-                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Buy", priceDouble);
-
-                    if (baseValues.groupPriceValue > 0.0)
-                    {
-                        if (n == 0)
-                        {
-                            emit depthFirstOrder(baseValues.currentPair.symbol, priceDouble, amount, true);
-                            groupedPrice = baseValues.groupPriceValue * (int)(priceDouble / baseValues.groupPriceValue);
-                            groupedVolume = amount;
-                        }
-                        else
-                        {
-                            bool matchCurrentGroup = priceDouble < groupedPrice + baseValues.groupPriceValue;
-
-                            if (matchCurrentGroup)
-                                groupedVolume += amount;
-
-                            if (!matchCurrentGroup || n == asksList.count() - 1)
-                            {
-                                depthSubmitOrder(baseValues.currentPair.symbol,
-                                                 &currentAsksMap, groupedPrice + baseValues.groupPriceValue, groupedVolume, true);
-                                rowCounter++;
-                                groupedVolume = amount;
-                                groupedPrice += baseValues.groupPriceValue;
-                            }
-                        }
-                    }
-                    else
-                    {
-                        depthSubmitOrder(baseValues.currentPair.symbol,
-                                         &currentAsksMap, priceDouble, amount, true);
-                        rowCounter++;
-                    }
-                }
-
-                QList<double> currentAsksList = lastDepthAsksMap.keys();
-
-                for (int n = 0; n < currentAsksList.count(); n++)
-                    if (currentAsksMap.value(currentAsksList.at(n), 0) == 0)
-                        depthUpdateOrder(baseValues.currentPair.symbol,
-                                         currentAsksList.at(n), 0.0, true); //Remove price
-
-                lastDepthAsksMap = currentAsksMap;
+                JulyJsonValue asks = json.value("asks");
+                JulyJsonValue bids = json.value("bids");
+                JulyJsonIterator asksIterator(asks);
+                JulyJsonIterator bidsIterator(bids);
+                depthBook.clearLevels();
 
-                QMap<double, double> currentBidsMap;
-                QStringList bidsList = QString(getMidData("bids\":[{", "}]", &data)).split("},{");
-                groupedPrice = 0.0;
-                groupedVolume = 0.0;
-                rowCounter = 0;
+                while (!depthSnapshotFull(true) && asksIterator.next())
+                    depthBook.addLevel(true, asksIterator.value().value("price").toDouble(),
+                                       asksIterator.value().value("amount").toDouble());
 
-                for (int n = 0; n < bidsList.count(); n++)
-                {
-                    if (baseValues.depthCountLimit && rowCounter >= baseValues.depthCountLimit)
-                        break;
-
-                    QByteArray currentRow = bidsList.at(n).toLatin1();
-                    double priceDouble = getMidData("price\":\"", "\"", &currentRow).toDouble();
-                    double amount = getMidData("amount\":\"", "\"", &currentRow).toDouble();
-
-                    if (n == 0)
-                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Sell", priceDouble);
-
-                    if (baseValues.groupPriceValue > 0.0)
-                    {
-                        if (n == 0)
-                        {
-                            emit depthFirstOrder(baseValues.currentPair.symbol, priceDouble, amount, false);
-                            groupedPrice = baseValues.groupPriceValue * (int)(priceDouble / baseValues.groupPriceValue);
-                            groupedVolume = amount;
-                        }
-                        else
-                        {
-                            bool matchCurrentGroup = priceDouble > groupedPrice + baseValues.groupPriceValue;
-
-                            if (matchCurrentGroup)
-                                groupedVolume += amount;
-
-                            if (!matchCurrentGroup || n == bidsList.count() - 1)
-                            {
-                                depthSubmitOrder(baseValues.currentPair.symbol,
-                                                 &currentBidsMap, groupedPrice - baseValues.groupPriceValue, groupedVolume, false);
-                                rowCounter++;
-                                groupedVolume = amount;
-                                groupedPrice -= baseValues.groupPriceValue;
-                            }
-                        }
-                    }
-                    else
-                    {
-                        depthSubmitOrder(baseValues.currentPair.symbol,
-                                         &currentBidsMap, priceDouble, amount, false);
-                        rowCounter++;
-                    }
-                }
+                while (!depthSnapshotFull(false) && bidsIterator.next())
+                    depthBook.addLevel(false, bidsIterator.value().value("price").toDouble(),
+                                       bidsIterator.value().value("amount").toDouble());
 
-                QList<double> currentBidsList = lastDepthBidsMap.keys();
+                if (depthBook.count(true))
+                    IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                              IndicatorEngine::Buy, depthBook.level(true, 0).price.toDouble());
 
-                for (int n = 0; n < currentBidsList.count(); n++)
-                    if (currentBidsMap.value(currentBidsList.at(n), 0) == 0)
-                        depthUpdateOrder(baseValues.currentPair.symbol,
-                                         currentBidsList.at(n), 0.0, false); //Remove price
+                if (depthBook.count(false))
+                    IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                              IndicatorEngine::Sell, depthBook.level(false, 0).price.toDouble());
 
-                lastDepthBidsMap = currentBidsMap;
-
-                for (int n = depthAsks->count() - 1; n > 0; n--)
-                    if (depthAsks->at(n).price == depthAsks->at(n - 1).price)
-                        depthAsks->removeAt(--n);
-
-                for (int n = depthBids->count() - 1; n > 0; n--)
-                    if (depthBids->at(n).price == depthBids->at(n - 1).price)
-                        depthBids->removeAt(--n);
-
-                emit depthSubmitOrders(baseValues.currentPair.symbol, depthAsks, depthBids);
-                depthAsks = nullptr;
-                depthBids = nullptr;
+                depthSubmitBook();
             }
         }
         else if (debugLevel)
@@ -696,31 +808,42 @@ void Exchange_Bitfinex::dataReceivedAuth(QByteArray data, int reqType)
             if (debugLevel)
                 logThread->writeLog("Info: " + data);
 
-            QByteArray btcBalance;
-            QByteArray usdBalance;
+            JulyJsonValue btcBalance;
+            JulyJsonValue usdBalance;
+            QByteArray currA = baseValues.currentPair.currAStrLow.toLatin1();
+            QByteArray currB = baseValues.currentPair.currBStrLow.toLatin1();
+            JulyJsonIterator balanceIterator(json);
 
-            QStringList balances = QString(data).split("},{");
-
-            for (int n = 0; n < balances.count(); n++)
+            while (balanceIterator.next())
             {
-                QByteArray currentBalance = balances.at(n).toLatin1();
-                QByteArray balanceType = getMidData("type\":\"", "\"", &currentBalance);
+                JulyJsonValue balanceType;
+                JulyJsonValue balanceCurrency;
+                JulyJsonValue balanceAvailable;
+                JulyJsonIterator fieldIterator(balanceIterator.value());
 
-                if (balanceType != baseValues.currentPair.currRequestSecond)
-                    continue;
+                while (fieldIterator.next())
+                {
+                    const JulyJsonValue& key = fieldIterator.key();
+
+                    if (key == "type")
+                        balanceType = fieldIterator.value();
+                    else if (key == "currency")
+                        balanceCurrency = fieldIterator.value();
+                    else if (key == "available")
+                        balanceAvailable = fieldIterator.value();
+                }
 
-                QByteArray balanceCurrency = getMidData("currency\":\"", "\"", &currentBalance);
+                if (balanceType != baseValues.currentPair.currRequestSecond.constData())
+                    continue;
 
-                if (btcBalance.isEmpty() && balanceCurrency == baseValues.currentPair.currAStrLow)
-                    btcBalance = getMidData("available\":\"", "\"", &currentBalance);
+                if (!btcBalance.isValid() && balanceCurrency == currA.constData())
+                    btcBalance = balanceAvailable;
 
-                if (usdBalance.isEmpty() && balanceCurrency == baseValues.currentPair.currBStrLow)
-                {
-                    usdBalance = getMidData("available\":\"", "\"", &currentBalance);
-                }
+                if (!usdBalance.isValid() && balanceCurrency == currB.constData())
+                    usdBalance = balanceAvailable;
             }
 
-            if (!btcBalance.isEmpty())
+            if (btcBalance.isValid())
             {
                 double newBtcBalance = btcBalance.toDouble();
 
@@ -730,7 +853,7 @@ void Exchange_Bitfinex::dataReceivedAuth(QByteArray data, int reqType)
                 lastBtcBalance = newBtcBalance;
             }
 
-            if (!usdBalance.isEmpty())
+            if (usdBalance.isValid())
             {
                 double newUsdBalance = usdBalance.toDouble();
 
@@ -759,35 +882,45 @@ void Exchange_Bitfinex::dataReceivedAuth(QByteArray data, int reqType)
         if (lastOrders != data)
         {
             lastOrders = data;
-            QStringList ordersList = QString(data).split("},{");
             QList<OrderItem>* orders = new QList<OrderItem>;
             QByteArray filterType = "limit";
 
             if (baseValues.currentPair.currRequestSecond == "exchange")
                 filterType.prepend("exchange ");
 
-            for (int n = 0; n < ordersList.count(); n++)
-            {
-                if (!ordersList.at(n).contains("\"type\":\"" + filterType + "\""))
-                    continue;
+            JulyJsonIterator ordersIterator(json);
 
-                QByteArray currentOrderData = ordersList.at(n).toLatin1();
+            while (ordersIterator.next())
+            {
                 OrderItem currentOrder;
-                currentOrder.oid = getMidData("\"id\":", ",", &currentOrderData);
-                currentOrder.date = getMidData("timestamp\":\"", ".", &currentOrderData).toUInt();
-                currentOrder.type = getMidData("side\":\"", "\"", &currentOrderData).toLower() == "sell";
+                JulyJsonValue orderType;
+                JulyJsonIterator fieldIterator(ordersIterator.value());
 
-                bool isCanceled = getMidData("is_cancelled\":", ",", &currentOrderData) == "true";
-
-                //0=Canceled, 1=Open, 2=Pending, 3=Post-Pending
-                if (isCanceled)
-                    currentOrder.status = 0;
-                else
-                    currentOrder.status = 1;
+                while (fieldIterator.next())
+                {
+                    const JulyJsonValue& key = fieldIterator.key();
+                    const JulyJsonValue& value = fieldIterator.value();
+
+                    if (key == "type")
+                        orderType = value;
+                    else if (key == "id")
+                        currentOrder.oid = value.toByteArray();
+                    else if (key == "timestamp")
+                        currentOrder.date = qint64(value.toDouble());
+                    else if (key == "side")
+                        currentOrder.type = value.toByteArray().toLower() == "sell";
+                    else if (key == "is_cancelled")
+                        currentOrder.status = value.toBool() ? 0 : 1; //0=Canceled, 1=Open, 2=Pending, 3=Post-Pending
+                    else if (key == "original_amount")
+                        currentOrder.amount = value.toDouble();
+                    else if (key == "price")
+                        currentOrder.price = value.toDouble();
+                    else if (key == "symbol")
+                        currentOrder.symbol = value.toByteArray().toUpper();
+                }
 
-                currentOrder.amount = getMidData("original_amount\":\"", "\"", &currentOrderData).toDouble();
-                currentOrder.price = getMidData("price\":\"", "\"", &currentOrderData).toDouble();
-                currentOrder.symbol = getMidData("symbol\":\"", "\"", &currentOrderData).toUpper();
+                if (orderType != filterType.constData())
+                    continue;
 
                 if (currentOrder.isValid())
                     (*orders) << currentOrder;
@@ -812,7 +945,7 @@ void Exchange_Bitfinex::dataReceivedAuth(QByteArray data, int reqType)
         if (!success)
             break;
 
-        QByteArray oid = getMidData("\"id\":", ",", &data);
+        QByteArray oid = json.value("id").toByteArray();
 
         if (!oid.isEmpty())
             emit orderCanceled(baseValues.currentPair.symbol, oid);
@@ -854,15 +987,37 @@ void Exchange_Bitfinex::dataReceivedAuth(QByteArray data, int reqType)
                 lastHistory = data;
                 QList<HistoryItem>* historyItems = new QList<HistoryItem>;
                 bool firstTimestampReceived = false;
-                QStringList dataList = QString(data).split("},{");
-                quint64 currentId;
                 quint64 maxId = 0;
+                int n = 0;
+                JulyJsonIterator historyIterator(json);
 
-                for (int n = 0; n < dataList.count(); n++)
+                for (; historyIterator.next(); n++)
                 {
-                    QByteArray curLog(dataList.at(n).toLatin1() + "}");
+                    HistoryItem currentHistoryItem;
+                    quint64 currentId = 0;
+                    JulyJsonValue logType;
+                    JulyJsonValue exchange;
+                    QByteArray currentTimeStamp;
+                    JulyJsonIterator fieldIterator(historyIterator.value());
 
-                    currentId = getMidData("order_id\":", "}", &curLog).toULongLong();
+                    while (fieldIterator.next())
+                    {
+                        const JulyJsonValue& key = fieldIterator.key();
+                        const JulyJsonValue& value = fieldIterator.value();
+
+                        if (key == "order_id")
+                            currentId = quint64(value.toLongLong());
+                        else if (key == "type")
+                            logType = value;
+                        else if (key == "timestamp")
+                            currentTimeStamp = QByteArray::number(qint64(value.toDouble()));
+                        else if (key == "price")
+                            currentHistoryItem.price = value.toDouble();
+                        else if (key == "amount")
+                            currentHistoryItem.volume = value.toDouble();
+                        else if (key == "exchange")
+                            exchange = value;
+                    }
 
                     if (currentId <= lastHistoryId)
                         break;
@@ -870,10 +1025,6 @@ void Exchange_Bitfinex::dataReceivedAuth(QByteArray data, int reqType)
                     if (n == 0)
                         maxId = currentId;
 
-                    HistoryItem currentHistoryItem;
-                    QByteArray logType = getMidData("\"type\":\"", "\"", &curLog);
-                    QByteArray currentTimeStamp = getMidData("\"timestamp\":\"", ".", &curLog);
-
                     if (n == 0 || !firstTimestampReceived)
                         if (!currentTimeStamp.isEmpty())
                         {
@@ -894,14 +1045,12 @@ void Exchange_Bitfinex::dataReceivedAuth(QByteArray data, int reqType)
 
                     if (currentHistoryItem.type)
                     {
-                        currentHistoryItem.price = getMidData("\"price\":\"", "\"", &curLog).toDouble();
-                        currentHistoryItem.volume = getMidData("\"amount\":\"", "\"", &curLog).toDouble();
                         currentHistoryItem.dateTimeInt = currentTimeStamp.toUInt();
                         currentHistoryItem.symbol = baseValues.currentPair.symbol;
 
                         if (currentHistoryItem.isValid())
                         {
-                            currentHistoryItem.description += getMidData("exchange\":\"", "\"", &curLog);
+                            currentHistoryItem.description += exchange.toByteArray();
                             (*historyItems) << currentHistoryItem;
                         }
                     }
@@ -927,24 +1076,22 @@ void Exchange_Bitfinex::dataReceivedAuth(QByteArray data, int reqType)
             bool feeInit = false;
             double newFee(0.0);
 
-            QStringList feeList = QString(getMidData("[{\"pairs\":\"", "}]}]", &data)).split("},{\"pairs\":\"");
+            QByteArray currA = baseValues.currentPair.currAStr.toLatin1();
+            JulyJsonValue feeInfo = json.at(0);
+            JulyJsonIterator feeIterator(feeInfo.value("fees"));
 
-            for (int n = 0; n < feeList.count(); n++)
+            while (feeIterator.next())
             {
-                if (!feeList.at(n).startsWith(baseValues.currentPair.currAStr))
+                if (!feeIterator.value().value("pairs").toByteArray().startsWith(currA))
                     continue;
 
-                QByteArray currentFeeData = feeList.at(n).toLatin1();
-                newFee = getMidData("taker_fees\":\"", "\"", &currentFeeData).toDouble();
-
+                newFee = feeIterator.value().value("taker_fees").toDouble();
                 feeInit = true;
                 break;
             }
 
             if (!feeInit)
-            {
-                newFee = getMidData("taker_fees\":\"", "\"", &data).toDouble();
-            }
+                newFee = feeInfo.value("taker_fees").toDouble();
 
             if (!qFuzzyCompare(newFee + 1.0, lastFee + 1.0))
                 emit accFeeChanged(baseValues.currentPair.symbol, newFee);
@@ -968,7 +1115,7 @@ void Exchange_Bitfinex::dataReceivedAuth(QByteArray data, int reqType)
 
             if (authErrorCount > 2)
             {
-                QString authErrorString = getMidData("message\":\"", "\"", &data);
+                QString authErrorString = json.value("message").toByteArray();
 
                 if (debugLevel)
                     logThread->writeLog("API error: " + authErrorString.toLatin1() + " ReqType: " + QByteArray::number(reqType), 2);
@@ -995,7 +1142,7 @@ void Exchange_Bitfinex::dataReceivedAuth(QByteArray data, int reqType)
         if (errorCount < 3)
             return;
 
-        QString errorString = getMidData("\"message\":\"", "\"", &data);
+        QString errorString = json.value("message").toByteArray();
 
         if (errorString.isEmpty())
             errorString = data;
@@ -52,7 +52,15 @@ private:
     int apiDownCounter;
     int secondPart;
 
-    JulyHttp* julyHttp;
+    JulyHttpPool* julyHttp;
+    JulyWebSocket* webSocket;
+    QByteArray webSocketPair;
+
+    qint64 bookChannelId;
+    qint64 tradesChannelId;
+    qint64 lastTradesWsId;
+    bool bookSynced;
+    bool bookSubmitPending;
 
     QByteArray lastTradesDateCache;
 
@@ -60,12 +68,6 @@ private:
     qint64 tickerLastDate;
     quint64 lastHistoryId;
 
-    QList<DepthItem>* depthAsks;
-    QList<DepthItem>* depthBids;
-
-    QMap<double, double> lastDepthAsksMap;
-    QMap<double, double> lastDepthBidsMap;
-
     QString apiLogin;
 
     QTime authRequestTime;
@@ -73,11 +75,15 @@ private:
     quint32 privateNonce;
 
     void clearVariables();
-    void depthSubmitOrder(QString, QMap<double, double>*, double, double, bool);
-    void depthUpdateOrder(QString, double, double, bool);
+    void bookEventReceived(const JulyJsonValue& body);
+    void tradesEventReceived(const JulyJsonValue& message);
+    void setupWebSocket();
     void sendToApi(int reqType, QByteArray method, bool auth = false, bool sendNow = true, QByteArray commands = nullptr);
 private slots:
     void secondSlot();
+    void bookSubmitSlot();
+    void webSocketMessage(QByteArray);
+    void webSocketClosed();
 public slots:
     void dataReceivedAuth(QByteArray, int);
     void reloadDepth();
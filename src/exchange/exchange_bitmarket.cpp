@@ -46,8 +46,6 @@ Exchange_BitMarket::Exchange_BitMarket(QByteArray pRestSign, QByteArray pRestKey
     baseValues.currentPair.priceMin = qPow(0.1, baseValues.currentPair.priceDecimals);
     baseValues.currentPair.tradeVolumeMin = 0.01;
     baseValues.currentPair.tradePriceMin = 0.1;
-    depthAsks = 0;
-    depthBids = 0;
     forceDepthLoad = false;
     julyHttp = 0;
     isApiDown = false;
@@ -79,12 +77,6 @@ void Exchange_BitMarket::quitThread()
 {
     clearValues();
 
-    if (depthAsks)
-        delete depthAsks;
-
-    if (depthBids)
-        delete depthBids;
-
     if (julyHttp)
         delete julyHttp;
 }
@@ -114,14 +106,6 @@ void Exchange_BitMarket::clearValues()
         julyHttp->clearPendingData();
 }
 
-void Exchange_BitMarket::reloadDepth()
-{
-    lastDepthBidsMap.clear();
-    lastDepthAsksMap.clear();
-    lastDepthData.clear();
-    Exchange::reloadDepth();
-}
-
 void Exchange_BitMarket::dataReceivedAuth(QByteArray data, int reqType)
 {
     if (debugLevel)
@@ -145,7 +129,8 @@ void Exchange_BitMarket::dataReceivedAuth(QByteArray data, int reqType)
                     double newTickerHigh = tickerHigh.toDouble();
 
                     if (newTickerHigh != lastTickerHigh)
-                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "High", newTickerHigh);
+                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                                  IndicatorEngine::High, newTickerHigh);
 
                     lastTickerHigh = newTickerHigh;
                 }
@@ -157,7 +142,8 @@ void Exchange_BitMarket::dataReceivedAuth(QByteArray data, int reqType)
                     double newTickerLow = tickerLow.toDouble();
 
                     if (newTickerLow != lastTickerLow)
-                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Low", newTickerLow);
+                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                                  IndicatorEngine::Low, newTickerLow);
 
                     lastTickerLow = newTickerLow;
                 }
@@ -169,7 +155,8 @@ void Exchange_BitMarket::dataReceivedAuth(QByteArray data, int reqType)
                     double newTickerSell = tickerSell.toDouble();
 
                     if (newTickerSell != lastTickerSell)
-                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Sell", newTickerSell);
+                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                                  IndicatorEngine::Sell, newTickerSell);
 
                     lastTickerSell = newTickerSell;
                 }
@@ -181,7 +168,8 @@ void Exchange_BitMarket::dataReceivedAuth(QByteArray data, int reqType)
                     double newTickerBuy = tickerBuy.toDouble();
 
                     if (newTickerBuy != lastTickerBuy)
-                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Buy", newTickerBuy);
+                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                                  IndicatorEngine::Buy, newTickerBuy);
 
                     lastTickerBuy = newTickerBuy;
                 }
@@ -193,7 +181,8 @@ void Exchange_BitMarket::dataReceivedAuth(QByteArray data, int reqType)
                     double newTickerVolume = tickerVolume.toDouble();
 
                     if (newTickerVolume != lastTickerVolume)
-                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Volume", newTickerVolume);
+                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                                  IndicatorEngine::Volume, newTickerVolume);
 
                     lastTickerVolume = newTickerVolume;
                 }
@@ -205,7 +194,8 @@ void Exchange_BitMarket::dataReceivedAuth(QByteArray data, int reqType)
                     double newTickerLast = tickerLast.toDouble();
 
                     if (newTickerLast != lastTickerLast)
-                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Last", newTickerLast);
+                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                                  IndicatorEngine::Last, newTickerLast);
 
                     lastTickerLast = newTickerLast;
                 }
@@ -254,7 +244,8 @@ void Exchange_BitMarket::dataReceivedAuth(QByteArray data, int reqType)
                     if (n == 0 && lastTickerDate < newItem.date)
                     {
                         lastTickerDate = newItem.date;
-                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Last", newItem.price);
+                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                                  IndicatorEngine::Last, newItem.price);
                     }
                 }
 
@@ -282,20 +273,12 @@ void Exchange_BitMarket::dataReceivedAuth(QByteArray data, int reqType)
                 if (lastDepthData != data)
                 {
                     lastDepthData = data;
-                    depthAsks = new QList<DepthItem>;
-                    depthBids = new QList<DepthItem>;
+                    depthBook.clearLevels();
 
-                    QMap<double, double> currentAsksMap;
                     QStringList asksList = QString(getMidData("asks\":[[", "]]", &data)).split("],[");
-                    double groupedPrice = 0.0;
-                    double groupedVolume = 0.0;
-                    int rowCounter = 0;
 
-                    for (int n = 0; n < asksList.count(); n++)
+                    for (int n = 0; n < asksList.count() && !depthSnapshotFull(true); n++)
                     {
-                        if (baseValues.depthCountLimit && rowCounter >= baseValues.depthCountLimit)
-                            break;
-
                         QStringList currentPair = asksList.at(n).split(",");
 
                         if (currentPair.count() != 2)
@@ -303,60 +286,13 @@ void Exchange_BitMarket::dataReceivedAuth(QByteArray data, int reqType)
 
                         double priceDouble = currentPair.first().toDouble();
                         double amount = currentPair.last().toDouble();
-
-                        if (baseValues.groupPriceValue > 0.0)
-                        {
-                            if (n == 0)
-                            {
-                                emit depthFirstOrder(baseValues.currentPair.symbol, priceDouble, amount, true);
-                                groupedPrice = baseValues.groupPriceValue * (int)(priceDouble / baseValues.groupPriceValue);
-                                groupedVolume = amount;
-                            }
-                            else
-                            {
-                                bool matchCurrentGroup = priceDouble < groupedPrice + baseValues.groupPriceValue;
-
-                                if (matchCurrentGroup)
-                                    groupedVolume += amount;
-
-                                if (!matchCurrentGroup || n == asksList.count() - 1)
-                                {
-                                    depthSubmitOrder(baseValues.currentPair.symbol,
-                                                     &currentAsksMap, groupedPrice + baseValues.groupPriceValue, groupedVolume, true);
-                                    rowCounter++;
-                                    groupedVolume = amount;
-                                    groupedPrice += baseValues.groupPriceValue;
-                                }
-                            }
-                        }
-                        else
-                        {
-                            depthSubmitOrder(baseValues.currentPair.symbol,
-                                             &currentAsksMap, priceDouble, amount, true);
-                            rowCounter++;
-                        }
+                        depthBook.addLevel(true, priceDouble, amount);
                     }
 
-                    QList<double> currentAsksList = lastDepthAsksMap.keys();
-
-                    for (int n = 0; n < currentAsksList.count(); n++)
-                        if (currentAsksMap.value(currentAsksList.at(n), 0) == 0)
-                            depthUpdateOrder(baseValues.currentPair.symbol,
-                                             currentAsksList.at(n), 0.0, true);
-
-                    lastDepthAsksMap = currentAsksMap;
-
-                    QMap<double, double> currentBidsMap;
                     QStringList bidsList = QString(getMidData("bids\":[[", "]]", &data)).split("],[");
-                    groupedPrice = 0.0;
-                    groupedVolume = 0.0;
-                    rowCounter = 0;
 
-                    for (int n = 0; n < bidsList.count(); n++)
+                    for (int n = 0; n < bidsList.count() && !depthSnapshotFull(false); n++)
                     {
-                        if (baseValues.depthCountLimit && rowCounter >= baseValues.depthCountLimit)
-                            break;
-
                         QStringList currentPair = bidsList.at(n).split(",");
 
                         if (currentPair.count() != 2)
@@ -364,52 +300,10 @@ void Exchange_BitMarket::dataReceivedAuth(QByteArray data, int reqType)
 
                         double priceDouble = currentPair.first().toDouble();
                         double amount = currentPair.last().toDouble();
-
-                        if (baseValues.groupPriceValue > 0.0)
-                        {
-                            if (n == 0)
-                            {
-                                emit depthFirstOrder(baseValues.currentPair.symbol, priceDouble, amount, false);
-                                groupedPrice = baseValues.groupPriceValue * (int)(priceDouble / baseValues.groupPriceValue);
-                                groupedVolume = amount;
-                            }
-                            else
-                            {
-                                bool matchCurrentGroup = priceDouble > groupedPrice - baseValues.groupPriceValue;
-
-                                if (matchCurrentGroup)
-                                    groupedVolume += amount;
-
-                                if (!matchCurrentGroup || n == asksList.count() - 1)
-                                {
-                                    depthSubmitOrder(baseValues.currentPair.symbol,
-                                                     &currentBidsMap, groupedPrice - baseValues.groupPriceValue, groupedVolume, false);
-                                    rowCounter++;
-                                    groupedVolume = amount;
-                                    groupedPrice -= baseValues.groupPriceValue;
-                                }
-                            }
-                        }
-                        else
-                        {
-                            depthSubmitOrder(baseValues.currentPair.symbol,
-                                             &currentBidsMap, priceDouble, amount, false);
-                            rowCounter++;
-                        }
+                        depthBook.addLevel(false, priceDouble, amount);
                     }
 
-                    QList<double> currentBidsList = lastDepthBidsMap.keys();
-
-                    for (int n = 0; n < currentBidsList.count(); n++)
-                        if (currentBidsMap.value(currentBidsList.at(n), 0) == 0)
-                            depthUpdateOrder(baseValues.currentPair.symbol,
-                                             currentBidsList.at(n), 0.0, false);
-
-                    lastDepthBidsMap = currentBidsMap;
-
-                    emit depthSubmitOrders(baseValues.currentPair.symbol, depthAsks, depthBids);
-                    depthAsks = 0;
-                    depthBids = 0;
+                    depthSubmitBook();
                 }
             }
             else
@@ -683,62 +577,6 @@ void Exchange_BitMarket::dataReceivedAuth(QByteArray data, int reqType)
         errorCount = 0;
 }
 
-void Exchange_BitMarket::depthUpdateOrder(QString symbol, double price, double amount, bool isAsk)
-{
-    if (symbol != baseValues.currentPair.symbol)
-        return;
-
-    if (isAsk)
-    {
-        if (depthAsks == 0)
-            return;
-
-        DepthItem newItem;
-        newItem.price = price;
-        newItem.volume = amount;
-
-        if (newItem.isValid())
-            (*depthAsks) << newItem;
-    }
-    else
-    {
-        if (depthBids == 0)
-            return;
-
-        DepthItem newItem;
-        newItem.price = price;
-        newItem.volume = amount;
-
-        if (newItem.isValid())
-            (*depthBids) << newItem;
-    }
-}
-
-void Exchange_BitMarket::depthSubmitOrder(QString symbol, QMap<double, double>* currentMap, double priceDouble,
-        double amount, bool isAsk)
-{
-    if (symbol != baseValues.currentPair.symbol)
-        return;
-
-    if (priceDouble == 0.0 || amount == 0.0)
-        return;
-
-    if (isAsk)
-    {
-        (*currentMap)[priceDouble] = amount;
-
-        if (lastDepthAsksMap.value(priceDouble, 0.0) != amount)
-            depthUpdateOrder(symbol, priceDouble, amount, true);
-    }
-    else
-    {
-        (*currentMap)[priceDouble] = amount;
-
-        if (lastDepthBidsMap.value(priceDouble, 0.0) != amount)
-            depthUpdateOrder(symbol, priceDouble, amount, false);
-    }
-}
-
 bool Exchange_BitMarket::isReplayPending(int reqType)
 {
     if (julyHttp == 0)
@@ -875,7 +713,7 @@ void Exchange_BitMarket::sendToApi(int reqType, QByteArray method, bool auth, bo
 {
     if (julyHttp == 0)
     {
-        julyHttp = new JulyHttp("www.bitmarket.pl", "API-Key: " + getApiKey() + "\r\n", this);
+        julyHttp = new JulyHttpPool("www.bitmarket.pl", "API-Key: " + getApiKey() + "\r\n", this);
         connect(julyHttp, SIGNAL(anyDataReceived()), baseValues_->mainWindow_, SLOT(anyDataReceived()));
         connect(julyHttp, SIGNAL(apiDown(bool)), baseValues_->mainWindow_, SLOT(setApiDown(bool)));
         connect(julyHttp, SIGNAL(setDataPending(bool)), baseValues_->mainWindow_, SLOT(setDataPending(bool)));
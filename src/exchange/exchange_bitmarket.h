@@ -49,17 +49,12 @@ private:
     int apiDownCounter;
     int lastOpenedOrders;
 
-    JulyHttp* julyHttp;
+    JulyHttpPool* julyHttp;
 
     qint64 lastFetchTid;
 
-    QList<DepthItem>* depthAsks;
-    QList<DepthItem>* depthBids;
     QList<QByteArray> cancelingOrderIDs;
 
-    QMap<double, double> lastDepthAsksMap;
-    QMap<double, double> lastDepthBidsMap;
-
     QTime authRequestTime;
 
     qint64 lastTickerDate;
@@ -69,11 +64,8 @@ private:
     quint32 lastHistoryCount;
 
     void clearVariables();
-    void depthSubmitOrder(QString, QMap<double, double>* currentMap, double priceDouble, double amount, bool isAsk);
-    void depthUpdateOrder(QString, double, double, bool);
     void sendToApi(int reqType, QByteArray method, bool auth = false, bool sendNow = true);
 private slots:
-    void reloadDepth();
     void sslErrors(const QList<QSslError>&);
     void dataReceivedAuth(QByteArray, int);
     void secondSlot();
@@ -50,14 +50,15 @@ Exchange_Bitstamp::Exchange_Bitstamp(QByteArray pRestSign, QByteArray pRestKey)
     baseValues.currentPair.priceMin = qPow(0.1, baseValues.currentPair.priceDecimals);
     baseValues.currentPair.tradeVolumeMin = 0.01;
     baseValues.currentPair.tradePriceMin = 0.1;
-    depthAsks = 0;
-    depthBids = 0;
     forceDepthLoad = false;
     julyHttp = 0;
     tickerOnly = false;
     setApiKeySecret(pRestKey.split(':').last(), pRestSign);
     privateClientId = pRestKey.split(':').first();
 
+    rateLimiter.addBucket(0, 8000, 600000);
+    rateLimiter.addCost(100, 399, 0, 1);
+
     currencyMapFile = "Bitstamp";
     defaultCurrencyParams.currADecimals = 8;
     defaultCurrencyParams.currBDecimals = 5;
@@ -83,20 +84,14 @@ void Exchange_Bitstamp::quitThread()
 {
     clearValues();
 
-    if (depthAsks)
-        delete depthAsks;
-
-    if (depthBids)
-        delete depthBids;
-
     if (julyHttp)
         delete julyHttp;
 }
 void Exchange_Bitstamp::filterAvailableUSDAmountValue(double* amount)
 {
-    double decValue = JulyMath::cutDoubleDecimalsCopy((*amount) * mainWindow.floatFee, baseValues.currentPair.priceDecimals, false);
-    decValue += qPow(0.1, qMax(baseValues.currentPair.priceDecimals, 1));
-    *amount = JulyMath::cutDoubleDecimalsCopy((*amount) - decValue, baseValues.currentPair.currBDecimals, false);
+    JulyAmount decValue = JulyAmount::fromDouble((*amount) * mainWindow.floatFee).cut(baseValues.currentPair.priceDecimals);
+    decValue += JulyAmount::fromDouble(qPow(0.1, qMax(baseValues.currentPair.priceDecimals, 1)));
+    *amount = qMax((JulyAmount::fromDouble(*amount) - decValue).cut(baseValues.currentPair.currBDecimals).toDouble(), 0.0);
 }
 
 void Exchange_Bitstamp::clearVariables()
@@ -255,13 +250,14 @@ void Exchange_Bitstamp::sendToApi(int reqType, QByteArray method, bool auth, boo
 {
     if (julyHttp == 0)
     {
-        julyHttp = new JulyHttp("www.bitstamp.net", "", this);
+        julyHttp = new JulyHttpPool("www.bitstamp.net", "", this);
         connect(julyHttp, SIGNAL(anyDataReceived()), baseValues_->mainWindow_, SLOT(anyDataReceived()));
         connect(julyHttp, SIGNAL(setDataPending(bool)), baseValues_->mainWindow_, SLOT(setDataPending(bool)));
         connect(julyHttp, SIGNAL(apiDown(bool)), baseValues_->mainWindow_, SLOT(setApiDown(bool)));
         connect(julyHttp, SIGNAL(errorSignal(QString)), baseValues_->mainWindow_, SLOT(showErrorMessage(QString)));
         connect(julyHttp, SIGNAL(sslErrorSignal(const QList<QSslError>&)), this, SLOT(sslErrors(const QList<QSslError>&)));
         connect(julyHttp, SIGNAL(dataReceived(QByteArray, int)), this, SLOT(dataReceivedAuth(QByteArray, int)));
+        julyHttp->setRateLimiter(&rateLimiter);
     }
 
     if (auth)
@@ -288,70 +284,6 @@ void Exchange_Bitstamp::sendToApi(int reqType, QByteArray method, bool auth, boo
     }
 }
 
-void Exchange_Bitstamp::depthUpdateOrder(QString symbol, double price, double amount, bool isAsk)
-{
-    if (symbol != baseValues.currentPair.symbol)
-        return;
-
-    if (isAsk)
-    {
-        if (depthAsks == 0)
-            return;
-
-        DepthItem newItem;
-        newItem.price = price;
-        newItem.volume = amount;
-
-        if (newItem.isValid())
-            (*depthAsks) << newItem;
-    }
-    else
-    {
-        if (depthBids == 0)
-            return;
-
-        DepthItem newItem;
-        newItem.price = price;
-        newItem.volume = amount;
-
-        if (newItem.isValid())
-            (*depthBids) << newItem;
-    }
-}
-
-void Exchange_Bitstamp::depthSubmitOrder(QString symbol, QMap<double, double>* currentMap, double priceDouble,
-        double amount, bool isAsk)
-{
-    if (symbol != baseValues.currentPair.symbol)
-        return;
-
-    if (priceDouble == 0.0 || amount == 0.0)
-        return;
-
-    if (isAsk)
-    {
-        (*currentMap)[priceDouble] = amount;
-
-        if (lastDepthAsksMap.value(priceDouble, 0.0) != amount)
-            depthUpdateOrder(symbol, priceDouble, amount, true);
-    }
-    else
-    {
-        (*currentMap)[priceDouble] = amount;
-
-        if (lastDepthBidsMap.value(priceDouble, 0.0) != amount)
-            depthUpdateOrder(symbol, priceDouble, amount, false);
-    }
-}
-
-void Exchange_Bitstamp::reloadDepth()
-{
-    lastDepthBidsMap.clear();
-    lastDepthAsksMap.clear();
-    lastDepthData.clear();
-    Exchange::reloadDepth();
-}
-
 void Exchange_Bitstamp::dataReceivedAuth(QByteArray data, int reqType)
 {
     if (debugLevel)
@@ -360,6 +292,7 @@ void Exchange_Bitstamp::dataReceivedAuth(QByteArray data, int reqType)
     if (data.size() && data.at(0) == QLatin1Char('<'))
         return;
 
+    JulyJsonValue json = JulyJsonValue::fromData(data);
     bool success = ((!data.startsWith("{\"error\"") && (data.startsWith("{"))) || data.startsWith("[")) || data == "true" ||
                    data == "false";
 
@@ -371,78 +304,100 @@ void Exchange_Bitstamp::dataReceivedAuth(QByteArray data, int reqType)
 
         if (data.startsWith("{\"high\":"))
         {
-            quint32 tickerTimestamp = getMidData("\"timestamp\": \"", "\"", &data).toUInt();
-            QByteArray tickerHigh = getMidData("\"high\": \"", "\"", &data);
+            quint32 tickerTimestamp = 0;
+            JulyJsonValue tickerHigh;
+            JulyJsonValue tickerLow;
+            JulyJsonValue tickerVolume;
+            JulyJsonValue tickerLast;
+            JulyJsonValue tickerSell;
+            JulyJsonValue tickerBuy;
+            JulyJsonIterator tickerIterator(json);
+
+            while (tickerIterator.next())
+            {
+                const JulyJsonValue& key = tickerIterator.key();
+
+                if (key == "timestamp")
+                    tickerTimestamp = quint32(tickerIterator.value().toLongLong());
+                else if (key == "high")
+                    tickerHigh = tickerIterator.value();
+                else if (key == "low")
+                    tickerLow = tickerIterator.value();
+                else if (key == "volume")
+                    tickerVolume = tickerIterator.value();
+                else if (key == "last")
+                    tickerLast = tickerIterator.value();
+                else if (key == "bid")
+                    tickerSell = tickerIterator.value();
+                else if (key == "ask")
+                    tickerBuy = tickerIterator.value();
+            }
 
-            if (!tickerHigh.isEmpty())
+            if (tickerHigh.isValid())
             {
                 double newTickerHigh = tickerHigh.toDouble();
 
                 if (newTickerHigh != lastTickerHigh)
-                    IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "High", newTickerHigh);
+                    IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                              IndicatorEngine::High, newTickerHigh);
 
                 lastTickerHigh = newTickerHigh;
             }
 
-            QByteArray tickerLow = getMidData("\"low\": \"", "\"", &data);
-
-            if (!tickerLow.isEmpty())
+            if (tickerLow.isValid())
             {
                 double newTickerLow = tickerLow.toDouble();
 
                 if (newTickerLow != lastTickerLow)
-                    IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Low", newTickerLow);
+                    IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                              IndicatorEngine::Low, newTickerLow);
 
                 lastTickerLow = newTickerLow;
             }
 
-            QByteArray tickerVolume = getMidData("\"volume\": \"", "\"", &data);
-
-            if (!tickerVolume.isEmpty())
+            if (tickerVolume.isValid())
             {
                 double newTickerVolume = tickerVolume.toDouble();
 
                 if (newTickerVolume != lastTickerVolume)
-                    IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Volume", newTickerVolume);
+                    IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                              IndicatorEngine::Volume, newTickerVolume);
 
                 lastTickerVolume = newTickerVolume;
             }
 
-            QByteArray tickerLast = getMidData("\"last\": \"", "\"", &data);
-
-            if (!tickerLast.isEmpty() && lastTickerDate < tickerTimestamp)
+            if (tickerLast.isValid() && lastTickerDate < tickerTimestamp)
             {
                 double newTickerLast = tickerLast.toDouble();
 
                 if (newTickerLast > 0.0)
                 {
-                    IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Last", newTickerLast);
+                    IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                              IndicatorEngine::Last, newTickerLast);
                     lastTickerDate = tickerTimestamp;
                 }
             }
 
             if (tickerTimestamp > lastBidAskTimestamp)
             {
-                QByteArray tickerSell = getMidData("\"bid\": \"", "\"", &data);
-
-                if (!tickerSell.isEmpty())
+                if (tickerSell.isValid())
                 {
                     double newTickerSell = tickerSell.toDouble();
 
                     if (newTickerSell != lastTickerSell)
-                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Sell", newTickerSell);
+                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                                  IndicatorEngine::Sell, newTickerSell);
 
                     lastTickerSell = newTickerSell;
                 }
 
-                QByteArray tickerBuy = getMidData("\"ask\": \"", "\"", &data);
-
-                if (!tickerBuy.isEmpty())
+                if (tickerBuy.isValid())
                 {
                     double newTickerBuy = tickerBuy.toDouble();
 
                     if (newTickerBuy != lastTickerBuy)
-                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Buy", newTickerBuy);
+                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                                  IndicatorEngine::Buy, newTickerBuy);
 
                     lastTickerBuy = newTickerBuy;
                 }
@@ -460,22 +415,34 @@ void Exchange_Bitstamp::dataReceivedAuth(QByteArray data, int reqType)
         {
             if (data.startsWith("[{\"date\":"))
             {
-                QStringList tradeList = QString(data).split("}, {");
+                QList<JulyJsonValue> tradeList;
+                JulyJsonIterator tradesIterator(json);
+
+                while (tradesIterator.next())
+                    tradeList << tradesIterator.value();
+
                 QList<TradesItem>* newTradesItems = new QList<TradesItem>;
 
                 for (int n = tradeList.count() - 1; n >= 0; n--)
                 {
-                    QByteArray tradeData = tradeList.at(n).toLatin1();
                     TradesItem newItem;
-                    newItem.date = getMidData("\"date\": \"", "\"", &tradeData).toLongLong();
+                    JulyJsonIterator fieldIterator(tradeList.at(n));
+
+                    while (fieldIterator.next())
+                    {
+                        const JulyJsonValue& key = fieldIterator.key();
+
+                        if (key == "date")
+                            newItem.date = fieldIterator.value().toLongLong();
+                        else if (key == "amount")
+                            newItem.amount = fieldIterator.value().toDouble();
+                        else if (key == "price")
+                            newItem.price = fieldIterator.value().toDouble();
+                    }
 
                     if (newItem.date <= lastTradesDate)
                         continue;
 
-                    newItem.amount = getMidData("\"amount\": \"", "\"", &tradeData).toDouble();
-                    QByteArray priceBytes = getMidData("\"price\": \"", "\"", &tradeData);
-                    newItem.price = priceBytes.toDouble();
-
                     if (n == 0 && newItem.price > 0.0)
                     {
                         lastTradesDate = newItem.date;
@@ -483,7 +450,8 @@ void Exchange_Bitstamp::dataReceivedAuth(QByteArray data, int reqType)
                         if (lastTickerDate < newItem.date)
                         {
                             lastTickerDate = newItem.date;
-                            IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Last", newItem.price);
+                            IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                                      IndicatorEngine::Last, newItem.price);
                         }
                     }
 
@@ -494,7 +462,7 @@ void Exchange_Bitstamp::dataReceivedAuth(QByteArray data, int reqType)
                     if (newItem.isValid())
                         (*newTradesItems) << newItem;
                     else if (debugLevel)
-                        logThread->writeLog("Invalid trades fetch data line:" + tradeData, 2);
+                        logThread->writeLog("Invalid trades fetch data line:" + tradeList.at(n).toByteArray(), 2);
                 }
 
                 if (newTradesItems->count())
@@ -516,137 +484,48 @@ void Exchange_Bitstamp::dataReceivedAuth(QByteArray data, int reqType)
             if (lastDepthData != data)
             {
                 lastDepthData = data;
-                depthAsks = new QList<DepthItem>;
-                depthBids = new QList<DepthItem>;
-
-                quint32 tickerTimestamp = getMidData("\"timestamp\": \"", "\"", &data).toUInt();
-                QMap<double, double> currentAsksMap;
-                QStringList asksList = QString(getMidData("\"asks\": [[", "]]", &data)).split("], [");
-                double groupedPrice = 0.0;
-                double groupedVolume = 0.0;
-                int rowCounter = 0;
-                bool updateTicker = tickerTimestamp > lastBidAskTimestamp;
-
-                if (updateTicker)
-                    lastBidAskTimestamp = tickerTimestamp;
-
-                for (int n = 0; n < asksList.count(); n++)
-                {
-                    if (baseValues.depthCountLimit && rowCounter >= baseValues.depthCountLimit)
-                        break;
-
-                    QByteArray currentRow = asksList.at(n).toLatin1();
-                    double priceDouble = getMidData("\"", "\"", &currentRow).toDouble();
-                    double amount = getMidData(", \"", "\"", &currentRow).toDouble();
-
-                    if (n == 0 && updateTicker)
-                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Buy", priceDouble);
-
-                    if (baseValues.groupPriceValue > 0.0)
-                    {
-                        if (n == 0)
-                        {
-                            emit depthFirstOrder(baseValues.currentPair.symbol, priceDouble, amount, true);
-                            groupedPrice = baseValues.groupPriceValue * (int)(priceDouble / baseValues.groupPriceValue);
-                            groupedVolume = amount;
-                        }
-                        else
-                        {
-                            bool matchCurrentGroup = priceDouble < groupedPrice + baseValues.groupPriceValue;
 
-                            if (matchCurrentGroup)
-                                groupedVolume += amount;
+                quint32 tickerTimestamp = 0;
+                JulyJsonValue asks;
+                JulyJsonValue bids;
+                JulyJsonIterator depthIterator(json);
 
-                            if (!matchCurrentGroup || n == asksList.count() - 1)
-                            {
-                                depthSubmitOrder(baseValues.currentPair.symbol,
-                                                 &currentAsksMap, groupedPrice + baseValues.groupPriceValue, groupedVolume, true);
-                                rowCounter++;
-                                groupedVolume = amount;
-                                groupedPrice += baseValues.groupPriceValue;
-                            }
-                        }
-                    }
-                    else
-                    {
-                        depthSubmitOrder(baseValues.currentPair.symbol,
-                                         &currentAsksMap, priceDouble, amount, true);
-                        rowCounter++;
-                    }
+                while (depthIterator.next())
+                {
+                    const JulyJsonValue& key = depthIterator.key();
+
+                    if (key == "timestamp")
+                        tickerTimestamp = quint32(depthIterator.value().toLongLong());
+                    else if (key == "asks")
+                        asks = depthIterator.value();
+                    else if (key == "bids")
+                        bids = depthIterator.value();
                 }
 
-                QList<double> currentAsksList = lastDepthAsksMap.keys();
-
-                for (int n = 0; n < currentAsksList.count(); n++)
-                    if (currentAsksMap.value(currentAsksList.at(n), 0) == 0)
-                        depthUpdateOrder(baseValues.currentPair.symbol,
-                                         currentAsksList.at(n), 0.0, true); //Remove price
+                JulyJsonIterator asksIterator(asks);
+                JulyJsonIterator bidsIterator(bids);
+                depthBook.clearLevels();
 
-                lastDepthAsksMap = currentAsksMap;
+                while (!depthSnapshotFull(true) && asksIterator.next())
+                    depthBook.addLevel(true, asksIterator.value().at(0).toDouble(), asksIterator.value().at(1).toDouble());
 
-                QMap<double, double> currentBidsMap;
-                QStringList bidsList = QString(getMidData("\"bids\": [[", "]]", &data)).split("], [");
-                groupedPrice = 0.0;
-                groupedVolume = 0.0;
-                rowCounter = 0;
+                while (!depthSnapshotFull(false) && bidsIterator.next())
+                    depthBook.addLevel(false, bidsIterator.value().at(0).toDouble(), bidsIterator.value().at(1).toDouble());
 
-                for (int n = 0; n < bidsList.count(); n++)
+                if (tickerTimestamp > lastBidAskTimestamp)
                 {
-                    if (baseValues.depthCountLimit && rowCounter >= baseValues.depthCountLimit)
-                        break;
-
-                    QByteArray currentRow = bidsList.at(n).toLatin1();
-                    double priceDouble = getMidData("\"", "\"", &currentRow).toDouble();
-                    double amount = getMidData(", \"", "\"", &currentRow).toDouble();
-
-                    if (n == 0 && updateTicker)
-                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Sell", priceDouble);
-
-                    if (baseValues.groupPriceValue > 0.0)
-                    {
-                        if (n == 0)
-                        {
-                            emit depthFirstOrder(baseValues.currentPair.symbol, priceDouble, amount, false);
-                            groupedPrice = baseValues.groupPriceValue * (int)(priceDouble / baseValues.groupPriceValue);
-                            groupedVolume = amount;
-                        }
-                        else
-                        {
-                            bool matchCurrentGroup = priceDouble > groupedPrice - baseValues.groupPriceValue;
+                    lastBidAskTimestamp = tickerTimestamp;
 
-                            if (matchCurrentGroup)
-                                groupedVolume += amount;
+                    if (depthBook.count(true))
+                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                                  IndicatorEngine::Buy, depthBook.level(true, 0).price.toDouble());
 
-                            if (!matchCurrentGroup || n == bidsList.count() - 1)
-                            {
-                                depthSubmitOrder(baseValues.currentPair.symbol,
-                                                 &currentBidsMap, groupedPrice - baseValues.groupPriceValue, groupedVolume, false);
-                                rowCounter++;
-                                groupedVolume = amount;
-                                groupedPrice -= baseValues.groupPriceValue;
-                            }
-                        }
-                    }
-                    else
-                    {
-                        depthSubmitOrder(baseValues.currentPair.symbol,
-                                         &currentBidsMap, priceDouble, amount, false);
-                        rowCounter++;
-                    }
+                    if (depthBook.count(false))
+                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                                  IndicatorEngine::Sell, depthBook.level(false, 0).price.toDouble());
                 }
 
-                QList<double> currentBidsList = lastDepthBidsMap.keys();
-
-                for (int n = 0; n < currentBidsList.count(); n++)
-                    if (currentBidsMap.value(currentBidsList.at(n), 0) == 0)
-                        depthUpdateOrder(baseValues.currentPair.symbol,
-                                         currentBidsList.at(n), 0.0, false); //Remove price
-
-                lastDepthBidsMap = currentBidsMap;
-
-                emit depthSubmitOrders(baseValues.currentPair.symbol, depthAsks, depthBids);
-                depthAsks = 0;
-                depthBids = 0;
+                depthSubmitBook();
             }
         }
         else if (debugLevel)
@@ -666,7 +545,25 @@ void Exchange_Bitstamp::dataReceivedAuth(QByteArray data, int reqType)
             if (debugLevel)
                 logThread->writeLog("Info: " + data);
 
-            double accFee = getMidData(baseValues.currentPair.symbol.toLower() + "_fee\": \"", "\"", &data).toDouble();
+            QByteArray feeKey = baseValues.currentPair.symbol.toLower().toLatin1() + "_fee";
+            QByteArray btcKey = baseValues.currentPair.currAStrLow.toLatin1() + "_available";
+            QByteArray usdKey = baseValues.currentPair.currBStrLow.toLatin1() + "_available";
+            double accFee = 0.0;
+            JulyJsonValue btcBalance;
+            JulyJsonValue usdBalance;
+            JulyJsonIterator balanceIterator(json);
+
+            while (balanceIterator.next())
+            {
+                const JulyJsonValue& key = balanceIterator.key();
+
+                if (key == feeKey.constData())
+                    accFee = balanceIterator.value().toDouble();
+                else if (key == btcKey.constData())
+                    btcBalance = balanceIterator.value();
+                else if (key == usdKey.constData())
+                    usdBalance = balanceIterator.value();
+            }
 
             if (accFee > 0.0)
             {
@@ -674,9 +571,7 @@ void Exchange_Bitstamp::dataReceivedAuth(QByteArray data, int reqType)
                 accountFee = accFee;
             }
 
-            QByteArray btcBalance = getMidData("\"" + baseValues.currentPair.currAStrLow + "_available\": \"", "\"", &data);
-
-            if (!btcBalance.isEmpty())
+            if (btcBalance.isValid())
             {
                 double newBtcBalance = btcBalance.toDouble();
 
@@ -686,9 +581,7 @@ void Exchange_Bitstamp::dataReceivedAuth(QByteArray data, int reqType)
                 lastBtcBalance = newBtcBalance;
             }
 
-            QByteArray usdBalance = getMidData("\"" + baseValues.currentPair.currBStrLow + "_available\": \"", "\"", &data);
-
-            if (!usdBalance.isEmpty())
+            if (usdBalance.isValid())
             {
                 double newUsdBalance = usdBalance.toDouble();
 
@@ -728,29 +621,36 @@ void Exchange_Bitstamp::dataReceivedAuth(QByteArray data, int reqType)
             {
                 lastOrders = data;
 
-                if (data.size() > 3)
-                {
-                    data.remove(0, 2);
-                    data.remove(data.size() - 2, 2);
-                }
-
-                QStringList ordersList = QString(data).split("}, {");
                 QList<OrderItem>* orders = new QList<OrderItem>;
+                JulyJsonIterator ordersIterator(json);
 
-                for (int n = 0; n < ordersList.count(); n++)
+                while (ordersIterator.next())
                 {
                     OrderItem currentOrder;
-                    QByteArray currentOrderData = ordersList.at(n).toLatin1();
-                    currentOrder.oid = getMidData("\"id\": \"", "\",", &currentOrderData);
+                    JulyJsonIterator fieldIterator(ordersIterator.value());
+
+                    while (fieldIterator.next())
+                    {
+                        const JulyJsonValue& key = fieldIterator.key();
+                        const JulyJsonValue& value = fieldIterator.value();
+
+                        if (key == "id")
+                            currentOrder.oid = value.toByteArray();
+                        else if (key == "datetime")
+                        {
+                            QDateTime orderDateTime = QDateTime::fromString(value.toByteArray(), "yyyy-MM-dd HH:mm:ss");
+                            orderDateTime.setTimeSpec(Qt::UTC);
+                            currentOrder.date = orderDateTime.toTime_t();
+                        }
+                        else if (key == "type")
+                            currentOrder.type = value == "1";
+                        else if (key == "amount")
+                            currentOrder.amount = value.toDouble();
+                        else if (key == "price")
+                            currentOrder.price = value.toDouble();
+                    }
 
-                    QByteArray dateTimeData = getMidData("\"datetime\": \"", "\"", &currentOrderData);
-                    QDateTime orderDateTime = QDateTime::fromString(dateTimeData, "yyyy-MM-dd HH:mm:ss");
-                    orderDateTime.setTimeSpec(Qt::UTC);
-                    currentOrder.date = orderDateTime.toTime_t();
-                    currentOrder.type = getMidData("\"type\": \"", "\",", &currentOrderData) == "1";
                     currentOrder.status = 1;
-                    currentOrder.amount = getMidData("\"amount\": \"", "\"", &currentOrderData).toDouble();
-                    currentOrder.price = getMidData("\"price\": \"", "\"", &currentOrderData).toDouble();
                     currentOrder.symbol = baseValues.currentPair.symbol;
 
                     if (currentOrder.isValid())
@@ -820,24 +720,30 @@ void Exchange_Bitstamp::dataReceivedAuth(QByteArray data, int reqType)
                     break;
 
                 QList<HistoryItem>* historyItems = new QList<HistoryItem>;
-                QString newLog(data);
-                QStringList dataList = newLog.split("}, {");
-                newLog.clear();
+                QList<CurrencyPairItem>* pairList = IniEngine::getPairs();
+                QMap<QByteArray, JulyJsonValue> logFields;
+                JulyJsonIterator historyIterator(json);
 
-                for (int n = 0; n < dataList.count(); n++)
+                while (historyIterator.next())
                 {
                     HistoryItem currentHistoryItem;
-                    QByteArray curLog(dataList.at(n).toLatin1());
-                    QString firstCurrency = "";
+                    QByteArray firstCurrency;
 
-                    QDateTime orderDateTime = QDateTime::fromString(getMidData("\"datetime\": \"", "\"", &curLog), "yyyy-MM-dd HH:mm:ss");
+                    //Currency columns depend on the pair, so every field is collected once and looked up below
+                    logFields.clear();
+                    JulyJsonIterator fieldIterator(historyIterator.value());
+
+                    while (fieldIterator.next())
+                        logFields.insert(QByteArray::fromRawData(fieldIterator.key().data(), fieldIterator.key().size()),
+                                         fieldIterator.value());
+
+                    QDateTime orderDateTime = QDateTime::fromString(logFields.value("datetime").toByteArray(), "yyyy-MM-dd HH:mm:ss");
                     orderDateTime.setTimeSpec(Qt::UTC);
                     currentHistoryItem.dateTimeInt = orderDateTime.toTime_t();
 
-                    int logTypeInt = getMidData("\"type\": \"", "\"", &curLog).toInt();
+                    int logTypeInt = int(logFields.value("type").toLongLong());
                     QString bufferCurrency;
                     QStringList bufferCurrencies;
-                    QList<CurrencyPairItem>* pairList = IniEngine::getPairs();
 
                     if (logTypeInt == 0 || logTypeInt == 1)
                     {
@@ -850,7 +756,7 @@ void Exchange_Bitstamp::dataReceivedAuth(QByteArray data, int reqType)
                             if (!bufferCurrencies.contains(bufferCurrency))
                             {
                                 bufferCurrencies.append(bufferCurrency);
-                                bufferVolume = getMidData("\"" + bufferCurrency + "\": \"", "\"", &curLog).toDouble();
+                                bufferVolume = logFields.value(bufferCurrency.toLatin1()).toDouble();
 
                                 if (bufferVolume)
                                 {
@@ -866,7 +772,7 @@ void Exchange_Bitstamp::dataReceivedAuth(QByteArray data, int reqType)
                             if (!bufferCurrencies.contains(bufferCurrency))
                             {
                                 bufferCurrencies.append(bufferCurrency);
-                                bufferVolume = getMidData("\"" + bufferCurrency + "\": \"", "\"", &curLog).toDouble();
+                                bufferVolume = logFields.value(bufferCurrency.toLatin1()).toDouble();
 
                                 if (bufferVolume)
                                 {
@@ -887,16 +793,16 @@ void Exchange_Bitstamp::dataReceivedAuth(QByteArray data, int reqType)
                     {
                         for (int m = 0; m < IniEngine::getPairsCount(); ++m)
                         {
-                            QString request = IniEngine::getPairRequest(m).toLower();
+                            QByteArray request = IniEngine::getPairRequest(m).toLower().toLatin1();
 
-                            if (request.count() < 5)
+                            if (request.size() < 5)
                                 continue;
 
                             request.insert(3, '_');
 
-                            if (curLog.indexOf(request) != -1)
+                            if (logFields.contains(request))
                             {
-                                currentHistoryItem.price = getMidData(request + "\": ", ",", &curLog).toDouble();
+                                currentHistoryItem.price = logFields.value(request).toDouble();
                                 currentHistoryItem.symbol = IniEngine::getPairSymbol(m);
                                 firstCurrency = request.left(request.indexOf('_'));
                                 break;
@@ -906,15 +812,10 @@ void Exchange_Bitstamp::dataReceivedAuth(QByteArray data, int reqType)
                         if (firstCurrency.isEmpty())
                             continue;
 
-                        QByteArray btcAmount = getMidData("\"" + firstCurrency + "\": \"", "\"", &curLog);
-                        bool negativeAmount = btcAmount.startsWith("-");
-
-                        if (negativeAmount)
-                            btcAmount.remove(0, 1);
-
-                        currentHistoryItem.volume = btcAmount.toDouble();
+                        double btcAmount = logFields.value(firstCurrency).toDouble();
+                        currentHistoryItem.volume = qAbs(btcAmount);
 
-                        if (negativeAmount)
+                        if (btcAmount < 0.0)
                             currentHistoryItem.type = 1; //Sell
                         else
                             currentHistoryItem.type = 2; //Buy
@@ -948,7 +849,7 @@ void Exchange_Bitstamp::dataReceivedAuth(QByteArray data, int reqType)
 
             if (authErrorCount > 2)
             {
-                QString authErrorString = getMidData("error\": \"", "\"", &data);
+                QString authErrorString = json.value("error").toByteArray();
 
                 if (debugLevel)
                     logThread->writeLog("API error: " + authErrorString.toLatin1() + " ReqType: " + QByteArray::number(reqType), 2);
@@ -976,13 +877,13 @@ void Exchange_Bitstamp::dataReceivedAuth(QByteArray data, int reqType)
 
         if (!invalidMessage)
         {
-            errorString = getMidData("[\"", "\"]", &data);
+            //The error is either a string or an object of field name to a list of messages
+            JulyJsonValue errorValue = json.value("error");
 
-            if (errorString.isEmpty())
-            {
-                QByteArray nErrorString = getMidData("{\"error\":", "}", &data);
-                errorString = getMidData("\"", "\"", &nErrorString);
-            }
+            while (errorValue.isObject() || errorValue.isArray())
+                errorValue = errorValue.at(0);
+
+            errorString = errorValue.toByteArray();
         }
         else
             errorString = data;
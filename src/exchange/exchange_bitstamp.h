@@ -51,16 +51,12 @@ private:
     int apiDownCounter;
     int secondPart;
 
-    JulyHttp* julyHttp;
+    JulyHttpPool* julyHttp;
 
     QByteArray privateClientId;
 
-    QList<DepthItem>* depthAsks;
-    QList<DepthItem>* depthBids;
     QList<QByteArray> cancelingOrderIDs;
 
-    QMap<double, double> lastDepthAsksMap;
-    QMap<double, double> lastDepthBidsMap;
     QString apiLogin;
 
     QTime authRequestTime;
@@ -71,12 +67,9 @@ private:
     quint32 privateNonce;
 
     void clearVariables();
-    void depthSubmitOrder(QString, QMap<double, double>*, double, double, bool);
-    void depthUpdateOrder(QString, double, double, bool);
     void sendToApi(int reqType, QByteArray method, bool auth = false, bool sendNow = true, QByteArray commands = 0);
 
 private slots:
-    void reloadDepth();
     void sslErrors(const QList<QSslError>&);
     void dataReceivedAuth(QByteArray, int);
     void secondSlot();
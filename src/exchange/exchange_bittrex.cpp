@@ -41,11 +41,7 @@ Exchange_Bittrex::Exchange_Bittrex(QByteArray pRestSign, QByteArray pRestKey)
       lastHistoryTime(0),
       privateNonce((QDateTime::currentDateTime().toTime_t() - 1371854884) * 10),
       lastCanceledId(),
-      julyHttp(nullptr),
-      depthAsks(nullptr),
-      depthBids(nullptr),
-      lastDepthAsksMap(),
-      lastDepthBidsMap()
+      julyHttp(nullptr)
 {
     clearHistoryOnCurrencyChanged = true;
     calculatingFeeMode = 1;
@@ -84,12 +80,6 @@ void Exchange_Bittrex::quitThread()
 {
     clearValues();
 
-    if (depthAsks)
-        delete depthAsks;
-
-    if (depthBids)
-        delete depthBids;
-
     if (julyHttp)
         delete julyHttp;
 }
@@ -116,14 +106,6 @@ void Exchange_Bittrex::clearValues()
         julyHttp->clearPendingData();
 }
 
-void Exchange_Bittrex::reloadDepth()
-{
-    lastDepthBidsMap.clear();
-    lastDepthAsksMap.clear();
-    lastDepthData.clear();
-    Exchange::reloadDepth();
-}
-
 void Exchange_Bittrex::dataReceivedAuth(QByteArray data, int reqType)
 {
     if (debugLevel)
@@ -150,7 +132,8 @@ void Exchange_Bittrex::dataReceivedAuth(QByteArray data, int reqType)
 
                 if (tickerHigh > 0.0 && !qFuzzyCompare(tickerHigh, lastTickerHigh))
                 {
-                    IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "High", tickerHigh);
+                    IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                              IndicatorEngine::High, tickerHigh);
                     lastTickerHigh = tickerHigh;
                 }
 
@@ -158,7 +141,8 @@ void Exchange_Bittrex::dataReceivedAuth(QByteArray data, int reqType)
 
                 if (tickerLow > 0.0 && !qFuzzyCompare(tickerLow, lastTickerLow))
                 {
-                    IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Low", tickerLow);
+                    IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                              IndicatorEngine::Low, tickerLow);
                     lastTickerLow = tickerLow;
                 }
 
@@ -166,7 +150,8 @@ void Exchange_Bittrex::dataReceivedAuth(QByteArray data, int reqType)
 
                 if (tickerSell > 0.0 && !qFuzzyCompare(tickerSell, lastTickerSell))
                 {
-                    IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Sell", tickerSell);
+                    IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                              IndicatorEngine::Sell, tickerSell);
                     lastTickerSell = tickerSell;
                 }
 
@@ -174,7 +159,8 @@ void Exchange_Bittrex::dataReceivedAuth(QByteArray data, int reqType)
 
                 if (tickerBuy > 0.0 && !qFuzzyCompare(tickerBuy, lastTickerBuy))
                 {
-                    IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Buy", tickerBuy);
+                    IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                              IndicatorEngine::Buy, tickerBuy);
                     lastTickerBuy = tickerBuy;
                 }
 
@@ -182,7 +168,8 @@ void Exchange_Bittrex::dataReceivedAuth(QByteArray data, int reqType)
 
                 if (tickerVolume > 0.0 && !qFuzzyCompare(tickerVolume, lastTickerVolume))
                 {
-                    IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Volume", tickerVolume);
+                    IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                              IndicatorEngine::Volume, tickerVolume);
                     lastTickerVolume = tickerVolume;
                 }
 
@@ -195,7 +182,8 @@ void Exchange_Bittrex::dataReceivedAuth(QByteArray data, int reqType)
 
                     if (tickerLastDouble > 0.0 && !qFuzzyCompare(tickerLastDouble, lastTickerLast))
                     {
-                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Last", tickerLastDouble);
+                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                                  IndicatorEngine::Last, tickerLastDouble);
                         lastTickerLast = tickerLastDouble;
                     }
                 }
@@ -251,20 +239,12 @@ void Exchange_Bittrex::dataReceivedAuth(QByteArray data, int reqType)
                 if (data != lastDepthData)
                 {
                     lastDepthData = data;
-                    depthAsks = new QList<DepthItem>;
-                    depthBids = new QList<DepthItem>;
+                    depthBook.clearLevels();
 
-                    QMap<double, double> currentAsksMap;
                     QStringList asksList = QString(getMidData("\"sell\":[{\"Quantity\":", "}]}}", &data)).split("},{\"Quantity\":");
-                    double groupedPrice = 0.0;
-                    double groupedVolume = 0.0;
-                    int rowCounter = 0;
 
-                    for (int n = 0; n < asksList.count(); n++)
+                    for (int n = 0; n < asksList.count() && !depthSnapshotFull(true); n++)
                     {
-                        if (baseValues.depthCountLimit && rowCounter >= baseValues.depthCountLimit)
-                            break;
-
                         QStringList currentPair = asksList.at(n).split(",\"Rate\":");
 
                         if (currentPair.count() != 2)
@@ -272,60 +252,13 @@ void Exchange_Bittrex::dataReceivedAuth(QByteArray data, int reqType)
 
                         double priceDouble = currentPair.last().toDouble();
                         double amount      = currentPair.first().toDouble();
-
-                        if (baseValues.groupPriceValue > 0.0)
-                        {
-                            if (n == 0)
-                            {
-                                emit depthFirstOrder(baseValues.currentPair.symbol, priceDouble, amount, true);
-                                groupedPrice = baseValues.groupPriceValue * static_cast<int>(priceDouble / baseValues.groupPriceValue);
-                                groupedVolume = amount;
-                            }
-                            else
-                            {
-                                bool matchCurrentGroup = priceDouble < groupedPrice + baseValues.groupPriceValue;
-
-                                if (matchCurrentGroup)
-                                    groupedVolume += amount;
-
-                                if (!matchCurrentGroup || n == asksList.count() - 1)
-                                {
-                                    depthSubmitOrder(baseValues.currentPair.symbol,
-                                                     &currentAsksMap, groupedPrice + baseValues.groupPriceValue, groupedVolume, true);
-                                    rowCounter++;
-                                    groupedVolume = amount;
-                                    groupedPrice += baseValues.groupPriceValue;
-                                }
-                            }
-                        }
-                        else
-                        {
-                            depthSubmitOrder(baseValues.currentPair.symbol,
-                                             &currentAsksMap, priceDouble, amount, true);
-                            rowCounter++;
-                        }
+                        depthBook.addLevel(true, priceDouble, amount);
                     }
 
-                    QList<double> currentAsksList = lastDepthAsksMap.keys();
-
-                    for (int n = 0; n < currentAsksList.count(); n++)
-                        if (qFuzzyIsNull(currentAsksMap.value(currentAsksList.at(n), 0)))
-                            depthUpdateOrder(baseValues.currentPair.symbol,
-                                             currentAsksList.at(n), 0.0, true);
-
-                    lastDepthAsksMap = currentAsksMap;
-
-                    QMap<double, double> currentBidsMap;
                     QStringList bidsList = QString(getMidData("\"buy\":[{\"Quantity\":", "}],", &data)).split("},{\"Quantity\":");
-                    groupedPrice = 0.0;
-                    groupedVolume = 0.0;
-                    rowCounter = 0;
 
-                    for (int n = 0; n < bidsList.count(); n++)
+                    for (int n = 0; n < bidsList.count() && !depthSnapshotFull(false); n++)
                     {
-                        if (baseValues.depthCountLimit && rowCounter >= baseValues.depthCountLimit)
-                            break;
-
                         QStringList currentPair = bidsList.at(n).split(",\"Rate\":");
 
                         if (currentPair.count() != 2)
@@ -333,52 +266,10 @@ void Exchange_Bittrex::dataReceivedAuth(QByteArray data, int reqType)
 
                         double priceDouble = currentPair.last().toDouble();
                         double amount      = currentPair.first().toDouble();
-
-                        if (baseValues.groupPriceValue > 0.0)
-                        {
-                            if (n == 0)
-                            {
-                                emit depthFirstOrder(baseValues.currentPair.symbol, priceDouble, amount, false);
-                                groupedPrice = baseValues.groupPriceValue * static_cast<int>(priceDouble / baseValues.groupPriceValue);
-                                groupedVolume = amount;
-                            }
-                            else
-                            {
-                                bool matchCurrentGroup = priceDouble > groupedPrice - baseValues.groupPriceValue;
-
-                                if (matchCurrentGroup)
-                                    groupedVolume += amount;
-
-                                if (!matchCurrentGroup || n == asksList.count() - 1)
-                                {
-                                    depthSubmitOrder(baseValues.currentPair.symbol,
-                                                     &currentBidsMap, groupedPrice - baseValues.groupPriceValue, groupedVolume, false);
-                                    rowCounter++;
-                                    groupedVolume = amount;
-                                    groupedPrice -= baseValues.groupPriceValue;
-                                }
-                            }
-                        }
-                        else
-                        {
-                            depthSubmitOrder(baseValues.currentPair.symbol,
-                                             &currentBidsMap, priceDouble, amount, false);
-                            rowCounter++;
-                        }
+                        depthBook.addLevel(false, priceDouble, amount);
                     }
 
-                    QList<double> currentBidsList = lastDepthBidsMap.keys();
-
-                    for (int n = 0; n < currentBidsList.count(); n++)
-                        if (qFuzzyIsNull(currentBidsMap.value(currentBidsList.at(n), 0)))
-                            depthUpdateOrder(baseValues.currentPair.symbol,
-                                             currentBidsList.at(n), 0.0, false);
-
-                    lastDepthBidsMap = currentBidsMap;
-
-                    emit depthSubmitOrders(baseValues.currentPair.symbol, depthAsks, depthBids);
-                    depthAsks = nullptr;
-                    depthBids = nullptr;
+                    depthSubmitBook();
                 }
             }
             break;
@@ -582,62 +473,6 @@ void Exchange_Bittrex::dataReceivedAuth(QByteArray data, int reqType)
     }
 }
 
-void Exchange_Bittrex::depthUpdateOrder(QString symbol, double price, double amount, bool isAsk)
-{
-    if (symbol != baseValues.currentPair.symbol)
-        return;
-
-    if (isAsk)
-    {
-        if (depthAsks == nullptr)
-            return;
-
-        DepthItem newItem;
-        newItem.price = price;
-        newItem.volume = amount;
-
-        if (newItem.isValid())
-            (*depthAsks) << newItem;
-    }
-    else
-    {
-        if (depthBids == nullptr)
-            return;
-
-        DepthItem newItem;
-        newItem.price = price;
-        newItem.volume = amount;
-
-        if (newItem.isValid())
-            (*depthBids) << newItem;
-    }
-}
-
-void Exchange_Bittrex::depthSubmitOrder(QString symbol, QMap<double, double>* currentMap, double priceDouble,
-                                    double amount, bool isAsk)
-{
-    if (symbol != baseValues.currentPair.symbol)
-        return;
-
-    if (priceDouble == 0.0 || amount == 0.0)
-        return;
-
-    if (isAsk)
-    {
-        (*currentMap)[priceDouble] = amount;
-
-        if (!qFuzzyCompare(lastDepthAsksMap.value(priceDouble, 0.0), amount))
-            depthUpdateOrder(symbol, priceDouble, amount, true);
-    }
-    else
-    {
-        (*currentMap)[priceDouble] = amount;
-
-        if (!qFuzzyCompare(lastDepthBidsMap.value(priceDouble, 0.0), amount))
-            depthUpdateOrder(symbol, priceDouble, amount, false);
-    }
-}
-
 bool Exchange_Bittrex::isReplayPending(int reqType)
 {
     if (julyHttp == nullptr)
@@ -774,7 +609,7 @@ void Exchange_Bittrex::sendToApi(int reqType, QByteArray method, bool auth)
 {
     if (julyHttp == nullptr)
     {
-        julyHttp = new JulyHttp("bittrex.com", "apisign:", this);
+        julyHttp = new JulyHttpPool("bittrex.com", "apisign:", this);
         connect(julyHttp, SIGNAL(anyDataReceived()), baseValues_->mainWindow_, SLOT(anyDataReceived()));
         connect(julyHttp, SIGNAL(apiDown(bool)), baseValues_->mainWindow_, SLOT(setApiDown(bool)));
         connect(julyHttp, SIGNAL(setDataPending(bool)), baseValues_->mainWindow_, SLOT(setDataPending(bool)));
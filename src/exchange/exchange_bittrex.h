@@ -50,7 +50,6 @@ public slots:
     void cancelOrder(QString, QByteArray);
 
 private slots:
-    void reloadDepth();
     void sslErrors(const QList<QSslError>&);
     void dataReceivedAuth(QByteArray, int);
     void secondSlot();
@@ -58,8 +57,6 @@ private slots:
 
 private:
     void clearVariables();
-    void depthSubmitOrder(QString, QMap<double, double>* currentMap, double priceDouble, double amount, bool isAsk);
-    void depthUpdateOrder(QString, double, double, bool);
     void sendToApi(int reqType, QByteArray method, bool auth = false);
     bool isReplayPending(int);
 
@@ -72,13 +69,7 @@ private:
     qint64 privateNonce;
     QByteArray lastCanceledId;
 
-    JulyHttp* julyHttp;
-
-    QList<DepthItem>* depthAsks;
-    QList<DepthItem>* depthBids;
-
-    QMap<double, double> lastDepthAsksMap;
-    QMap<double, double> lastDepthBidsMap;
+    JulyHttpPool* julyHttp;
 };
 
 #endif // EXCHANGE_BITTREX_H
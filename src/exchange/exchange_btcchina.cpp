@@ -42,8 +42,6 @@ Exchange_BTCChina::Exchange_BTCChina(QByteArray pRestSign, QByteArray pRestKey)
     minimumRequestIntervalAllowed = 600;
     calculatingFeeMode = 1;
     baseValues.exchangeName = "BTC China";
-    depthAsks = 0;
-    depthBids = 0;
     forceDepthLoad = false;
     julyHttpAuth = 0;
     julyHttpPublic = 0;
@@ -83,12 +81,6 @@ void Exchange_BTCChina::quitThread()
 {
     clearValues();
 
-    if (depthAsks)
-        delete depthAsks;
-
-    if (depthBids)
-        delete depthBids;
-
     if (julyHttpAuth)
         delete julyHttpAuth;
 
@@ -373,7 +365,7 @@ void Exchange_BTCChina::sendToApi(int reqType, QByteArray method, bool auth, boo
     {
         if (julyHttpPublic == 0)
         {
-            julyHttpPublic = new JulyHttp("data.btcchina.com", "", this, true, true, "application/json-rpc");
+            julyHttpPublic = new JulyHttpPool("data.btcchina.com", "", this, true, true, "application/json-rpc");
             connect(julyHttpPublic, SIGNAL(anyDataReceived()), baseValues_->mainWindow_, SLOT(anyDataReceived()));
             connect(julyHttpPublic, SIGNAL(setDataPending(bool)), baseValues_->mainWindow_, SLOT(setDataPending(bool)));
             connect(julyHttpPublic, SIGNAL(apiDown(bool)), baseValues_->mainWindow_, SLOT(setApiDown(bool)));
@@ -390,70 +382,6 @@ void Exchange_BTCChina::sendToApi(int reqType, QByteArray method, bool auth, boo
     }
 }
 
-void Exchange_BTCChina::depthUpdateOrder(QString symbol, double price, double amount, bool isAsk)
-{
-    if (symbol != baseValues.currentPair.symbol)
-        return;
-
-    if (isAsk)
-    {
-        if (depthAsks == 0)
-            return;
-
-        DepthItem newItem;
-        newItem.price = price;
-        newItem.volume = amount;
-
-        if (newItem.isValid())
-            (*depthAsks) << newItem;
-    }
-    else
-    {
-        if (depthBids == 0)
-            return;
-
-        DepthItem newItem;
-        newItem.price = price;
-        newItem.volume = amount;
-
-        if (newItem.isValid())
-            (*depthBids) << newItem;
-    }
-}
-
-void Exchange_BTCChina::depthSubmitOrder(QString symbol, QMap<double, double>* currentMap, double priceDouble,
-        double amount, bool isAsk)
-{
-    if (symbol != baseValues.currentPair.symbol)
-        return;
-
-    if (priceDouble == 0.0 || amount == 0.0)
-        return;
-
-    if (isAsk)
-    {
-        (*currentMap)[priceDouble] = amount;
-
-        if (lastDepthAsksMap.value(priceDouble, 0.0) != amount)
-            depthUpdateOrder(symbol, priceDouble, amount, true);
-    }
-    else
-    {
-        (*currentMap)[priceDouble] = amount;
-
-        if (lastDepthBidsMap.value(priceDouble, 0.0) != amount)
-            depthUpdateOrder(symbol, priceDouble, amount, false);
-    }
-}
-
-void Exchange_BTCChina::reloadDepth()
-{
-    lastDepthBidsMap.clear();
-    lastDepthAsksMap.clear();
-    lastDepthData.clear();
-    Exchange::reloadDepth();
-}
-
 void Exchange_BTCChina::dataReceivedAuth(QByteArray data, int reqType)
 {
     if (debugLevel)
@@ -482,7 +410,8 @@ void Exchange_BTCChina::dataReceivedAuth(QByteArray data, int reqType)
                     double newTickerHigh = tickerHigh.toDouble();
 
                     if (newTickerHigh != lastTickerHigh)
-                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "High", newTickerHigh);
+                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                                  IndicatorEngine::High, newTickerHigh);
 
                     lastTickerHigh = newTickerHigh;
                 }
@@ -494,7 +423,8 @@ void Exchange_BTCChina::dataReceivedAuth(QByteArray data, int reqType)
                     double newTickerLow = tickerLow.toDouble();
 
                     if (newTickerLow != lastTickerLow)
-                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Low", newTickerLow);
+                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                                  IndicatorEngine::Low, newTickerLow);
 
                     lastTickerLow = newTickerLow;
                 }
@@ -506,7 +436,8 @@ void Exchange_BTCChina::dataReceivedAuth(QByteArray data, int reqType)
                     double newTickerVolume = tickerVolume.toDouble();
 
                     if (newTickerVolume != lastTickerVolume)
-                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Volume", newTickerVolume);
+                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                                  IndicatorEngine::Volume, newTickerVolume);
 
                     lastTickerVolume = newTickerVolume;
                 }
@@ -518,7 +449,8 @@ void Exchange_BTCChina::dataReceivedAuth(QByteArray data, int reqType)
                     double newTickerLast = tickerLast.toDouble();
 
                     if (newTickerLast != lastTickerLast)
-                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Last", newTickerLast);
+                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                                  IndicatorEngine::Last, newTickerLast);
 
                     lastTickerLast = newTickerLast;
                 }
@@ -530,7 +462,8 @@ void Exchange_BTCChina::dataReceivedAuth(QByteArray data, int reqType)
                     double newTickerSell = tickerSell.toDouble();
 
                     if (newTickerSell != lastTickerSell)
-                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Sell", newTickerSell);
+                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                                  IndicatorEngine::Sell, newTickerSell);
 
                     lastTickerSell = newTickerSell;
                 }
@@ -542,7 +475,8 @@ void Exchange_BTCChina::dataReceivedAuth(QByteArray data, int reqType)
                     double newTickerBuy = tickerBuy.toDouble();
 
                     if (newTickerBuy != lastTickerBuy)
-                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Buy", newTickerBuy);
+                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                                  IndicatorEngine::Buy, newTickerBuy);
 
                     lastTickerBuy = newTickerBuy;
                 }
@@ -603,9 +537,6 @@ void Exchange_BTCChina::dataReceivedAuth(QByteArray data, int reqType)
                 if (lastDepthData != data)
                 {
                     lastDepthData = data;
-                    depthAsks = new QList<DepthItem>;
-                    depthBids = new QList<DepthItem>;
-
                     int asksStart = data.indexOf("\"ask\":");
 
                     if (asksStart == -1)
@@ -614,133 +545,42 @@ void Exchange_BTCChina::dataReceivedAuth(QByteArray data, int reqType)
                     QByteArray bidsData = data.mid(35, asksStart - 38);
                     data.remove(0, asksStart + 8);
                     data.remove(data.size() - 14, 14);
+                    depthBook.clearLevels();
 
-                    QMap<double, double> currentBidsMap;
                     QStringList bidsList = QString(bidsData).split("},{");
-                    double groupedPrice = 0.0;
-                    double groupedVolume = 0.0;
-                    int rowCounter = 0;
 
-                    for (int n = 0; n < bidsList.count(); n++)
+                    for (int n = 0; n < bidsList.count() && !depthSnapshotFull(false); n++)
                     {
-                        if (baseValues.depthCountLimit && rowCounter >= baseValues.depthCountLimit)
-                            break;
-
                         QByteArray currentRow = bidsList.at(n).toLatin1() + "}";
                         double priceDouble = getMidData("price\":", ",", &currentRow).toDouble();
                         double amount = getMidData("amount\":", "}", &currentRow).toDouble();
 
                         if (n == 0)
-                            IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Sell", priceDouble);
+                            IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                                      IndicatorEngine::Sell, priceDouble);
 
-                        if (baseValues.groupPriceValue > 0.0)
-                        {
-                            if (n == 0)
-                            {
-                                emit depthFirstOrder(baseValues.currentPair.symbol, priceDouble, amount, false);
-                                groupedPrice = baseValues.groupPriceValue * (int)(priceDouble / baseValues.groupPriceValue);
-                                groupedVolume = amount;
-                            }
-                            else
-                            {
-                                bool matchCurrentGroup = priceDouble > groupedPrice - baseValues.groupPriceValue;
-
-                                if (matchCurrentGroup)
-                                    groupedVolume += amount;
-
-                                if (!matchCurrentGroup || n == bidsList.count() - 1)
-                                {
-                                    depthSubmitOrder(baseValues.currentPair.symbol,
-                                                     &currentBidsMap, groupedPrice - baseValues.groupPriceValue, groupedVolume, false);
-                                    rowCounter++;
-                                    groupedVolume = amount;
-                                    groupedPrice -= baseValues.groupPriceValue;
-                                }
-                            }
-                        }
-                        else
-                        {
-                            depthSubmitOrder(baseValues.currentPair.symbol,
-                                             &currentBidsMap, priceDouble, amount, false);
-                            rowCounter++;
-                        }
+                        depthBook.addLevel(false, priceDouble, amount);
                     }
 
-                    QList<double> currentBidsList = lastDepthBidsMap.keys();
-
-                    for (int n = 0; n < currentBidsList.count(); n++)
-                        if (currentBidsMap.value(currentBidsList.at(n), 0) == 0)
-                            depthUpdateOrder(baseValues.currentPair.symbol,
-                                             currentBidsList.at(n), 0.0, false); //Remove price
-
-                    lastDepthBidsMap = currentBidsMap;
-
-                    QMap<double, double> currentAsksMap;
                     QStringList asksList = QString(data).split("},{");
-                    groupedPrice = 0.0;
-                    groupedVolume = 0.0;
-                    rowCounter = 0;
 
-                    for (int n = 0; n < asksList.count(); n++)
+                    for (int n = 0; n < asksList.count() && !depthSnapshotFull(true); n++)
                     {
-                        if (baseValues.depthCountLimit && rowCounter >= baseValues.depthCountLimit)
-                            break;
-
                         QByteArray currentRow = asksList.at(n).toLatin1() + "}";
                         double priceDouble = getMidData("price\":", ",", &currentRow).toDouble();
                         double amount = getMidData("amount\":", "}", &currentRow).toDouble();
 
                         if (n == 0)
-                            IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Buy", priceDouble);
+                            IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                                      IndicatorEngine::Buy, priceDouble);
 
                         if (priceDouble > 99999)
                             break;
 
-                        if (baseValues.groupPriceValue > 0.0)
-                        {
-                            if (n == 0)
-                            {
-                                emit depthFirstOrder(baseValues.currentPair.symbol, priceDouble, amount, true);
-                                groupedPrice = baseValues.groupPriceValue * (int)(priceDouble / baseValues.groupPriceValue);
-                                groupedVolume = amount;
-                            }
-                            else
-                            {
-                                bool matchCurrentGroup = priceDouble < groupedPrice + baseValues.groupPriceValue;
-
-                                if (matchCurrentGroup)
-                                    groupedVolume += amount;
-
-                                if (!matchCurrentGroup || n == asksList.count() - 1)
-                                {
-                                    depthSubmitOrder(baseValues.currentPair.symbol,
-                                                     &currentAsksMap, groupedPrice + baseValues.groupPriceValue, groupedVolume, true);
-                                    rowCounter++;
-                                    groupedVolume = amount;
-                                    groupedPrice += baseValues.groupPriceValue;
-                                }
-                            }
-                        }
-                        else
-                        {
-                            depthSubmitOrder(baseValues.currentPair.symbol,
-                                             &currentAsksMap, priceDouble, amount, true);
-                            rowCounter++;
-                        }
+                        depthBook.addLevel(true, priceDouble, amount);
                     }
 
-                    QList<double> currentAsksList = lastDepthAsksMap.keys();
-
-                    for (int n = 0; n < currentAsksList.count(); n++)
-                        if (currentAsksMap.value(currentAsksList.at(n), 0) == 0)
-                            depthUpdateOrder(baseValues.currentPair.symbol,
-                                             currentAsksList.at(n), 0.0, true); //Remove price
-
-                    lastDepthAsksMap = currentAsksMap;
-
-                    emit depthSubmitOrders(baseValues.currentPair.symbol, depthAsks, depthBids);
-                    depthAsks = 0;
-                    depthBids = 0;
+                    depthSubmitBook();
                 }
             }
             else if (debugLevel)
@@ -50,7 +50,7 @@ private:
     int secondPart;
 
     JulyHttp* julyHttpAuth;
-    JulyHttp* julyHttpPublic;
+    JulyHttpPool* julyHttpPublic;
 
     QByteArray historyLastDate;
     QByteArray historyLastID;
@@ -58,23 +58,15 @@ private:
     QByteArray historyLastTradesRequest;
     QByteArray getMidData(QString a, QString b, QByteArray* data);
 
-    QList<DepthItem>* depthAsks;
-    QList<DepthItem>* depthBids;
     QList<QByteArray> cancelingOrderIDs;
 
-    QMap<double, double> lastDepthAsksMap;
-    QMap<double, double> lastDepthBidsMap;
-
     QString apiLogin;
 
     QTime authRequestTime;
 
     void clearVariables();
-    void depthSubmitOrder(QString, QMap<double, double>*, double, double, bool);
-    void depthUpdateOrder(QString, double, double, bool);
     void sendToApi(int reqType, QByteArray method, bool auth = false, bool sendNow = true, QByteArray commands = 0);
 private slots:
-    void reloadDepth();
     void sslErrors(const QList<QSslError>&);
     void dataReceivedAuth(QByteArray, int);
     void secondSlot();
@@ -47,8 +47,6 @@ Exchange_Indacoin::Exchange_Indacoin(QByteArray pRestSign, QByteArray pRestKey)
     baseValues.currentPair.priceMin = qPow(0.1, baseValues.currentPair.priceDecimals);
     baseValues.currentPair.tradeVolumeMin = 0.01;
     baseValues.currentPair.tradePriceMin = 0.1;
-    depthAsks = 0;
-    depthBids = 0;
     forceDepthLoad = false;
     julyHttp = 0;
     isApiDown = false;
@@ -82,12 +80,6 @@ void Exchange_Indacoin::quitThread()
 {
     clearValues();
 
-    if (depthAsks)
-        delete depthAsks;
-
-    if (depthBids)
-        delete depthBids;
-
     if (julyHttp)
         delete julyHttp;
 }
@@ -115,14 +107,6 @@ void Exchange_Indacoin::clearValues()
         julyHttp->clearPendingData();
 }
 
-void Exchange_Indacoin::reloadDepth()
-{
-    lastDepthBidsMap.clear();
-    lastDepthAsksMap.clear();
-    lastDepthData.clear();
-    Exchange::reloadDepth();
-}
-
 void Exchange_Indacoin::dataReceivedAuth(QByteArray data, int reqType)
 {
     if (debugLevel)
@@ -155,7 +139,8 @@ void Exchange_Indacoin::dataReceivedAuth(QByteArray data, int reqType)
                     double newTickerHigh = tickerHigh.toDouble();
 
                     if (newTickerHigh != lastTickerHigh)
-                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "High", newTickerHigh);
+                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                                  IndicatorEngine::High, newTickerHigh);
 
                     lastTickerHigh = newTickerHigh;
                 }
@@ -167,7 +152,8 @@ void Exchange_Indacoin::dataReceivedAuth(QByteArray data, int reqType)
                     double newTickerLow = tickerLow.toDouble();
 
                     if (newTickerLow != lastTickerLow)
-                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Low", newTickerLow);
+                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                                  IndicatorEngine::Low, newTickerLow);
 
                     lastTickerLow = newTickerLow;
                 }
@@ -179,7 +165,8 @@ void Exchange_Indacoin::dataReceivedAuth(QByteArray data, int reqType)
                     double newTickerLast = tickerLast.toDouble();
 
                     if (newTickerLast != lastTickerLast)
-                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Last", newTickerLast);
+                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                                  IndicatorEngine::Last, newTickerLast);
 
                     lastTickerLast = newTickerLast;
                 }
@@ -191,7 +178,8 @@ void Exchange_Indacoin::dataReceivedAuth(QByteArray data, int reqType)
                     double newTickerVolume = tickerVolume.toDouble();
 
                     if (newTickerVolume != lastTickerVolume)
-                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Volume", newTickerVolume);
+                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                                  IndicatorEngine::Volume, newTickerVolume);
 
                     lastTickerVolume = newTickerVolume;
                 }
@@ -238,7 +226,8 @@ void Exchange_Indacoin::dataReceivedAuth(QByteArray data, int reqType)
                 if (lastTickerDate < newItem.date)
                 {
                     lastTickerDate = newItem.date;
-                    IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Last", newItem.price);
+                    IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                              IndicatorEngine::Last, newItem.price);
                 }
 
                 if (newTradesItems->count())
@@ -256,23 +245,16 @@ void Exchange_Indacoin::dataReceivedAuth(QByteArray data, int reqType)
                 if (lastDepthData != data)
                 {
                     lastDepthData = data;
-                    depthAsks = new QList<DepthItem>;
-                    depthBids = new QList<DepthItem>;
+                    depthBook.clearLevels();
 
-                    QMap<double, double> currentAsksMap;
                     QStringList asksList = QString(getMidData("asks\":[[", "]]", &data)).split("],[");
-                    double groupedPrice = 0.0;
-                    double groupedVolume = 0.0;
-                    int rowCounter = 0;
 
                     if (asksList.count() == 0)
-                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Buy", 0);
+                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                                  IndicatorEngine::Buy, 0);
 
-                    for (int n = 0; n < asksList.count(); n++)
+                    for (int n = 0; n < asksList.count() && !depthSnapshotFull(true); n++)
                     {
-                        if (baseValues.depthCountLimit && rowCounter >= baseValues.depthCountLimit)
-                            break;
-
                         QStringList currentPair = asksList.at(n).split(",");
 
                         if (currentPair.count() != 2)
@@ -284,67 +266,23 @@ void Exchange_Indacoin::dataReceivedAuth(QByteArray data, int reqType)
                         if (n == 0)
                         {
                             if (priceDouble != lastTickerBuy)
-                                IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Buy", priceDouble);
+                                IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                                          IndicatorEngine::Buy, priceDouble);
 
                             lastTickerBuy = priceDouble;
                         }
 
-                        if (baseValues.groupPriceValue > 0.0)
-                        {
-                            if (n == 0)
-                            {
-                                emit depthFirstOrder(baseValues.currentPair.symbol, priceDouble, amount, true);
-                                groupedPrice = baseValues.groupPriceValue * (int)(priceDouble / baseValues.groupPriceValue);
-                                groupedVolume = amount;
-                            }
-                            else
-                            {
-                                bool matchCurrentGroup = priceDouble < groupedPrice + baseValues.groupPriceValue;
-
-                                if (matchCurrentGroup)
-                                    groupedVolume += amount;
-
-                                if (!matchCurrentGroup || n == asksList.count() - 1)
-                                {
-                                    depthSubmitOrder(baseValues.currentPair.symbol,
-                                                     &currentAsksMap, groupedPrice + baseValues.groupPriceValue, groupedVolume, true);
-                                    rowCounter++;
-                                    groupedVolume = amount;
-                                    groupedPrice += baseValues.groupPriceValue;
-                                }
-                            }
-                        }
-                        else
-                        {
-                            depthSubmitOrder(baseValues.currentPair.symbol,
-                                             &currentAsksMap, priceDouble, amount, true);
-                            rowCounter++;
-                        }
+                        depthBook.addLevel(true, priceDouble, amount);
                     }
 
-                    QList<double> currentAsksList = lastDepthAsksMap.keys();
-
-                    for (int n = 0; n < currentAsksList.count(); n++)
-                        if (currentAsksMap.value(currentAsksList.at(n), 0) == 0)
-                            depthUpdateOrder(baseValues.currentPair.symbol,
-                                             currentAsksList.at(n), 0.0, true);
-
-                    lastDepthAsksMap = currentAsksMap;
-
-                    QMap<double, double> currentBidsMap;
                     QStringList bidsList = QString(getMidData("bids\":[[", "]]", &data)).split("],[");
-                    groupedPrice = 0.0;
-                    groupedVolume = 0.0;
-                    rowCounter = 0;
 
                     if (bidsList.count() == 0)
-                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Sell", 0);
+                        IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                                  IndicatorEngine::Sell, 0);
 
-                    for (int n = 0; n < bidsList.count(); n++)
+                    for (int n = 0; n < bidsList.count() && !depthSnapshotFull(false); n++)
                     {
-                        if (baseValues.depthCountLimit && rowCounter >= baseValues.depthCountLimit)
-                            break;
-
                         QStringList currentPair = bidsList.at(n).split(",");
 
                         if (currentPair.count() != 2)
@@ -356,56 +294,16 @@ void Exchange_Indacoin::dataReceivedAuth(QByteArray data, int reqType)
                         if (n == 0)
                         {
                             if (priceDouble != lastTickerSell)
-                                IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Sell", priceDouble);
+                                IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                                          IndicatorEngine::Sell, priceDouble);
 
                             lastTickerSell = priceDouble;
                         }
 
-                        if (baseValues.groupPriceValue > 0.0)
-                        {
-                            if (n == 0)
-                            {
-                                emit depthFirstOrder(baseValues.currentPair.symbol, priceDouble, amount, false);
-                                groupedPrice = baseValues.groupPriceValue * (int)(priceDouble / baseValues.groupPriceValue);
-                                groupedVolume = amount;
-                            }
-                            else
-                            {
-                                bool matchCurrentGroup = priceDouble > groupedPrice - baseValues.groupPriceValue;
-
-                                if (matchCurrentGroup)
-                                    groupedVolume += amount;
-
-                                if (!matchCurrentGroup || n == asksList.count() - 1)
-                                {
-                                    depthSubmitOrder(baseValues.currentPair.symbol,
-                                                     &currentBidsMap, groupedPrice - baseValues.groupPriceValue, groupedVolume, false);
-                                    rowCounter++;
-                                    groupedVolume = amount;
-                                    groupedPrice -= baseValues.groupPriceValue;
-                                }
-                            }
-                        }
-                        else
-                        {
-                            depthSubmitOrder(baseValues.currentPair.symbol,
-                                             &currentBidsMap, priceDouble, amount, false);
-                            rowCounter++;
-                        }
+                        depthBook.addLevel(false, priceDouble, amount);
                     }
 
-                    QList<double> currentBidsList = lastDepthBidsMap.keys();
-
-                    for (int n = 0; n < currentBidsList.count(); n++)
-                        if (currentBidsMap.value(currentBidsList.at(n), 0) == 0)
-                            depthUpdateOrder(baseValues.currentPair.symbol,
-                                             currentBidsList.at(n), 0.0, false);
-
-                    lastDepthBidsMap = currentBidsMap;
-
-                    emit depthSubmitOrders(baseValues.currentPair.symbol, depthAsks, depthBids);
-                    depthAsks = 0;
-                    depthBids = 0;
+                    depthSubmitBook();
                 }
             }
             else if (debugLevel)
@@ -666,62 +564,6 @@ void Exchange_Indacoin::dataReceivedAuth(QByteArray data, int reqType)
         errorCount = 0;
 }
 
-void Exchange_Indacoin::depthUpdateOrder(QString symbol, double price, double amount, bool isAsk)
-{
-    if (symbol != baseValues.currentPair.symbol)
-        return;
-
-    if (isAsk)
-    {
-        if (depthAsks == 0)
-            return;
-
-        DepthItem newItem;
-        newItem.price = price;
-        newItem.volume = amount;
-
-        if (newItem.isValid())
-            (*depthAsks) << newItem;
-    }
-    else
-    {
-        if (depthBids == 0)
-            return;
-
-        DepthItem newItem;
-        newItem.price = price;
-        newItem.volume = amount;
-
-        if (newItem.isValid())
-            (*depthBids) << newItem;
-    }
-}
-
-void Exchange_Indacoin::depthSubmitOrder(QString symbol, QMap<double, double>* currentMap, double priceDouble,
-        double amount, bool isAsk)
-{
-    if (symbol != baseValues.currentPair.symbol)
-        return;
-
-    if (priceDouble == 0.0 || amount == 0.0)
-        return;
-
-    if (isAsk)
-    {
-        (*currentMap)[priceDouble] = amount;
-
-        if (lastDepthAsksMap.value(priceDouble, 0.0) != amount)
-            depthUpdateOrder(symbol, priceDouble, amount, true);
-    }
-    else
-    {
-        (*currentMap)[priceDouble] = amount;
-
-        if (lastDepthBidsMap.value(priceDouble, 0.0) != amount)
-            depthUpdateOrder(symbol, priceDouble, amount, false);
-    }
-}
-
 bool Exchange_Indacoin::isReplayPending(int reqType)
 {
     if (julyHttp == 0)
@@ -878,7 +720,7 @@ void Exchange_Indacoin::sendToApi(int reqType, QByteArray method, bool auth, boo
 {
     if (julyHttp == 0)
     {
-        julyHttp = new JulyHttp("indacoin.com", "", this, true, true, "application/json; charset=UTF-8");
+        julyHttp = new JulyHttpPool("indacoin.com", "", this, true, true, "application/json; charset=UTF-8");
         connect(julyHttp, SIGNAL(anyDataReceived()), baseValues_->mainWindow_, SLOT(anyDataReceived()));
         connect(julyHttp, SIGNAL(apiDown(bool)), baseValues_->mainWindow_, SLOT(setApiDown(bool)));
         connect(julyHttp, SIGNAL(setDataPending(bool)), baseValues_->mainWindow_, SLOT(setDataPending(bool)));
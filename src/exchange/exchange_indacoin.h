@@ -52,18 +52,13 @@ private:
     int apiDownCounter;
     int lastOpenedOrders;
 
-    JulyHttp* julyHttp;
+    JulyHttpPool* julyHttp;
 
     qint64 lastFetchTid;
     qint64 lastFetchDate;
 
-    QList<DepthItem>* depthAsks;
-    QList<DepthItem>* depthBids;
     QList<QByteArray> cancelingOrderIDs;
 
-    QMap<double, double> lastDepthAsksMap;
-    QMap<double, double> lastDepthBidsMap;
-
     QTime authRequestTime;
 
     quint32 lastPriceDate;
@@ -72,11 +67,8 @@ private:
     quint32 lastHistoryTs;
 
     void clearVariables();
-    void depthSubmitOrder(QString, QMap<double, double>* currentMap, double priceDouble, double amount, bool isAsk);
-    void depthUpdateOrder(QString, double, double, bool);
     void sendToApi(int reqType, QByteArray method, bool auth = false, bool sendNow = true, QByteArray commands = 0);
 private slots:
-    void reloadDepth();
     void sslErrors(const QList<QSslError>&);
     void dataReceivedAuth(QByteArray, int);
     void secondSlot();
@@ -47,8 +47,6 @@ Exchange_OKCoin::Exchange_OKCoin(QByteArray pRestSign, QByteArray pRestKey)
     baseValues.currentPair.priceMin = qPow(0.1, baseValues.currentPair.priceDecimals);
     baseValues.currentPair.tradeVolumeMin = 0.001;
     baseValues.currentPair.tradePriceMin = 0.1;
-    depthAsks = 0;
-    depthBids = 0;
     forceDepthLoad = false;
     julyHttp = 0;
     isApiDown = false;
@@ -80,12 +78,6 @@ void Exchange_OKCoin::quitThread()
 {
     clearValues();
 
-    if (depthAsks)
-        delete depthAsks;
-
-    if (depthBids)
-        delete depthBids;
-
     if (julyHttp)
         delete julyHttp;
 }
@@ -117,14 +109,6 @@ void Exchange_OKCoin::clearValues()
         julyHttp->clearPendingData();
 }
 
-void Exchange_OKCoin::reloadDepth()
-{
-    lastDepthBidsMap.clear();
-    lastDepthAsksMap.clear();
-    lastDepthData.clear();
-    Exchange::reloadDepth();
-}
-
 void Exchange_OKCoin::dataReceivedAuth(QByteArray data, int reqType)
 {
     if (debugLevel)
@@ -148,7 +132,8 @@ void Exchange_OKCoin::dataReceivedAuth(QByteArray data, int reqType)
                         double newTickerHigh = tickerHigh.toDouble();
 
                         if (newTickerHigh != lastTickerHigh)
-                            IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "High", newTickerHigh);
+                            IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                                      IndicatorEngine::High, newTickerHigh);
 
                         lastTickerHigh = newTickerHigh;
                     }
@@ -160,7 +145,8 @@ void Exchange_OKCoin::dataReceivedAuth(QByteArray data, int reqType)
                         double newTickerLow = tickerLow.toDouble();
 
                         if (newTickerLow != lastTickerLow)
-                            IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Low", newTickerLow);
+                            IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                                      IndicatorEngine::Low, newTickerLow);
 
                         lastTickerLow = newTickerLow;
                     }
@@ -172,7 +158,8 @@ void Exchange_OKCoin::dataReceivedAuth(QByteArray data, int reqType)
                         double newTickerSell = tickerSell.toDouble();
 
                         if (newTickerSell != lastTickerSell)
-                            IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Buy", newTickerSell);
+                            IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                                      IndicatorEngine::Buy, newTickerSell);
 
                         lastTickerSell = newTickerSell;
                     }
@@ -184,7 +171,8 @@ void Exchange_OKCoin::dataReceivedAuth(QByteArray data, int reqType)
                         double newTickerBuy = tickerBuy.toDouble();
 
                         if (newTickerBuy != lastTickerBuy)
-                            IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Sell", newTickerBuy);
+                            IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                                      IndicatorEngine::Sell, newTickerBuy);
 
                         lastTickerBuy = newTickerBuy;
                     }
@@ -196,7 +184,8 @@ void Exchange_OKCoin::dataReceivedAuth(QByteArray data, int reqType)
                         double newTickerVolume = tickerVolume.toDouble();
 
                         if (newTickerVolume != lastTickerVolume)
-                            IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Volume", newTickerVolume);
+                            IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                                      IndicatorEngine::Volume, newTickerVolume);
 
                         lastTickerVolume = newTickerVolume;
                     }
@@ -210,7 +199,8 @@ void Exchange_OKCoin::dataReceivedAuth(QByteArray data, int reqType)
                         double tickerLastDouble = tickerLast.toDouble();
 
                         if (tickerLastDouble > 0.0)
-                            IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Last", tickerLastDouble);
+                            IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                                      IndicatorEngine::Last, tickerLastDouble);
                     }
                 }
                 else
@@ -289,7 +279,8 @@ void Exchange_OKCoin::dataReceivedAuth(QByteArray data, int reqType)
                         if (lastTickerDate < newItem.date)
                         {
                             lastTickerDate = newItem.date;
-                            IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol, "Last", newTradesItems->last().price);
+                            IndicatorEngine::setValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                                                      IndicatorEngine::Last, newTradesItems->last().price);
                         }
 
                         emit addLastTrades(baseValues.currentPair.symbol, newTradesItems);
@@ -310,20 +301,12 @@ void Exchange_OKCoin::dataReceivedAuth(QByteArray data, int reqType)
                     if (lastDepthData != data)
                     {
                         lastDepthData = data;
-                        depthAsks = new QList<DepthItem>;
-                        depthBids = new QList<DepthItem>;
+                        depthBook.clearLevels();
 
-                        QMap<double, double> currentAsksMap;
                         QStringList asksList = QString(getMidData("asks\":[[", "]]", &data)).split("],[");
-                        double groupedPrice = 0.0;
-                        double groupedVolume = 0.0;
-                        int rowCounter = 0;
 
-                        for (int n = 0; n < asksList.count(); n++)
+                        for (int n = 0; n < asksList.count() && !depthSnapshotFull(true); n++)
                         {
-                            if (baseValues.depthCountLimit && rowCounter >= baseValues.depthCountLimit)
-                                break;
-
                             QStringList currentPair = asksList.at(n).split(",");
 
                             if (currentPair.count() != 2)
@@ -331,60 +314,13 @@ void Exchange_OKCoin::dataReceivedAuth(QByteArray data, int reqType)
 
                             double priceDouble = currentPair.first().toDouble();
                             double amount = currentPair.last().toDouble();
-
-                            if (baseValues.groupPriceValue > 0.0)
-                            {
-                                if (n == 0)
-                                {
-                                    emit depthFirstOrder(baseValues.currentPair.symbol, priceDouble, amount, true);
-                                    groupedPrice = baseValues.groupPriceValue * (int)(priceDouble / baseValues.groupPriceValue);
-                                    groupedVolume = amount;
-                                }
-                                else
-                                {
-                                    bool matchCurrentGroup = priceDouble < groupedPrice + baseValues.groupPriceValue;
-
-                                    if (matchCurrentGroup)
-                                        groupedVolume += amount;
-
-                                    if (!matchCurrentGroup || n == asksList.count() - 1)
-                                    {
-                                        depthSubmitOrder(baseValues.currentPair.symbol,
-                                                         &currentAsksMap, groupedPrice + baseValues.groupPriceValue, groupedVolume, true);
-                                        rowCounter++;
-                                        groupedVolume = amount;
-                                        groupedPrice += baseValues.groupPriceValue;
-                                    }
-                                }
-                            }
-                            else
-                            {
-                                depthSubmitOrder(baseValues.currentPair.symbol,
-                                                 &currentAsksMap, priceDouble, amount, true);
-                                rowCounter++;
-                            }
+                            depthBook.addLevel(true, priceDouble, amount);
                         }
 
-                        QList<double> currentAsksList = lastDepthAsksMap.keys();
-
-                        for (int n = 0; n < currentAsksList.count(); n++)
-                            if (currentAsksMap.value(currentAsksList.at(n), 0) == 0)
-                                depthUpdateOrder(baseValues.currentPair.symbol,
-                                                 currentAsksList.at(n), 0.0, true);
-
-                        lastDepthAsksMap = currentAsksMap;
-
-                        QMap<double, double> currentBidsMap;
                         QStringList bidsList = QString(getMidData("bids\":[[", "]]", &data)).split("],[");
-                        groupedPrice = 0.0;
-                        groupedVolume = 0.0;
-                        rowCounter = 0;
 
-                        for (int n = 0; n < bidsList.count(); n++)
+                        for (int n = 0; n < bidsList.count() && !depthSnapshotFull(false); n++)
                         {
-                            if (baseValues.depthCountLimit && rowCounter >= baseValues.depthCountLimit)
-                                break;
-
                             QStringList currentPair = bidsList.at(n).split(",");
 
                             if (currentPair.count() != 2)
@@ -392,52 +328,10 @@ void Exchange_OKCoin::dataReceivedAuth(QByteArray data, int reqType)
 
                             double priceDouble = currentPair.first().toDouble();
                             double amount = currentPair.last().toDouble();
-
-                            if (baseValues.groupPriceValue > 0.0)
-                            {
-                                if (n == 0)
-                                {
-                                    emit depthFirstOrder(baseValues.currentPair.symbol, priceDouble, amount, false);
-                                    groupedPrice = baseValues.groupPriceValue * (int)(priceDouble / baseValues.groupPriceValue);
-                                    groupedVolume = amount;
-                                }
-                                else
-                                {
-                                    bool matchCurrentGroup = priceDouble > groupedPrice - baseValues.groupPriceValue;
-
-                                    if (matchCurrentGroup)
-                                        groupedVolume += amount;
-
-                                    if (!matchCurrentGroup || n == asksList.count() - 1)
-                                    {
-                                        depthSubmitOrder(baseValues.currentPair.symbol,
-                                                         &currentBidsMap, groupedPrice - baseValues.groupPriceValue, groupedVolume, false);
-                                        rowCounter++;
-                                        groupedVolume = amount;
-                                        groupedPrice -= baseValues.groupPriceValue;
-                                    }
-                                }
-                            }
-                            else
-                            {
-                                depthSubmitOrder(baseValues.currentPair.symbol,
-                                                 &currentBidsMap, priceDouble, amount, false);
-                                rowCounter++;
-                            }
+                            depthBook.addLevel(false, priceDouble, amount);
                         }
 
-                        QList<double> currentBidsList = lastDepthBidsMap.keys();
-
-                        for (int n = 0; n < currentBidsList.count(); n++)
-                            if (currentBidsMap.value(currentBidsList.at(n), 0) == 0)
-                                depthUpdateOrder(baseValues.currentPair.symbol,
-                                                 currentBidsList.at(n), 0.0, false);
-
-                        lastDepthBidsMap = currentBidsMap;
-
-                        emit depthSubmitOrders(baseValues.currentPair.symbol, depthAsks, depthBids);
-                        depthAsks = 0;
-                        depthBids = 0;
+                        depthSubmitBook();
                     }
                 }
                 else
@@ -662,62 +556,6 @@ void Exchange_OKCoin::dataReceivedAuth(QByteArray data, int reqType)
     }
 }
 
-void Exchange_OKCoin::depthUpdateOrder(QString symbol, double price, double amount, bool isAsk)
-{
-    if (symbol != baseValues.currentPair.symbol)
-        return;
-
-    if (isAsk)
-    {
-        if (depthAsks == 0)
-            return;
-
-        DepthItem newItem;
-        newItem.price = price;
-        newItem.volume = amount;
-
-        if (newItem.isValid())
-            (*depthAsks) << newItem;
-    }
-    else
-    {
-        if (depthBids == 0)
-            return;
-
-        DepthItem newItem;
-        newItem.price = price;
-        newItem.volume = amount;
-
-        if (newItem.isValid())
-            (*depthBids) << newItem;
-    }
-}
-
-void Exchange_OKCoin::depthSubmitOrder(QString symbol, QMap<double, double>* currentMap, double priceDouble,
-                                       double amount, bool isAsk)
-{
-    if (symbol != baseValues.currentPair.symbol)
-        return;
-
-    if (priceDouble == 0.0 || amount == 0.0)
-        return;
-
-    if (isAsk)
-    {
-        (*currentMap)[priceDouble] = amount;
-
-        if (lastDepthAsksMap.value(priceDouble, 0.0) != amount)
-            depthUpdateOrder(symbol, priceDouble, amount, true);
-    }
-    else
-    {
-        (*currentMap)[priceDouble] = amount;
-
-        if (lastDepthBidsMap.value(priceDouble, 0.0) != amount)
-            depthUpdateOrder(symbol, priceDouble, amount, false);
-    }
-}
-
 bool Exchange_OKCoin::isReplayPending(int reqType)
 {
     if (julyHttp == 0)
@@ -857,7 +695,7 @@ void Exchange_OKCoin::sendToApi(int reqType, QByteArray method, bool auth, QByte
 {
     if (julyHttp == 0)
     {
-        julyHttp = new JulyHttp("www.okcoin.cn", "Key: " + getApiKey() + "\r\n", this);
+        julyHttp = new JulyHttpPool("www.okcoin.cn", "Key: " + getApiKey() + "\r\n", this);
         connect(julyHttp, SIGNAL(anyDataReceived()), baseValues_->mainWindow_, SLOT(anyDataReceived()));
         connect(julyHttp, SIGNAL(apiDown(bool)), baseValues_->mainWindow_, SLOT(setApiDown(bool)));
         connect(julyHttp, SIGNAL(setDataPending(bool)), baseValues_->mainWindow_, SLOT(setDataPending(bool)));
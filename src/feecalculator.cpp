@@ -53,7 +53,7 @@ FeeCalculator::FeeCalculator()
     ui.feeValue->setValue(mainWindow.ui.accountFee->value());
     fee = 1 - (ui.feeValue->value() / 100);
 
-    buyPrice = IndicatorEngine::getValue(baseValues.exchangeName + '_' + baseValues.currentPair.symbol + "_Sell");
+    buyPrice = IndicatorEngine::getValue(baseValues.exchangeName, baseValues.currentPair.symbol, IndicatorEngine::Sell);
     ui.buyPrice->setValue(buyPrice);
     double btcVal = mainWindow.getAvailableUSD() / buyPrice;
 
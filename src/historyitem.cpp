@@ -33,6 +33,7 @@
 #include "main.h"
 #include "julymath.h"
 #include "iniengine.h"
+#include "rowtextcache.h"
 
 HistoryItem::HistoryItem()
 {
@@ -42,70 +43,82 @@ HistoryItem::HistoryItem()
     price = 0.0;
     total = 0.0;
     type = 0;
+    generation = RowTextCache::newGeneration();
 }
 
-void HistoryItem::cacheStrings()
+QString HistoryItem::timeText() const
 {
-    QDateTime cachedDateTime = QDateTime::fromTime_t(dateTimeInt);
+    QDateTime itemDateTime = QDateTime::fromTime_t(dateTimeInt);
 
     if (baseValues_->use24HourTimeFormat)
-    {
-        timeStr = cachedDateTime.toString(baseValues.timeFormat);
-        dateTimeStr = cachedDateTime.toString(baseValues.dateTimeFormat);
-    }
-    else
-    {
-        QString mmssTemp = cachedDateTime.toString("mm:ss");
-        QString hTemp = cachedDateTime.toString("H");
-        qint16 hTempInt = hTemp.toInt();
+        return itemDateTime.toString(baseValues.timeFormat);
 
-        if (hTempInt <= 12)
-            timeStr = hTemp + ':' + mmssTemp + " am";
-        else
-            timeStr = QString::number(hTempInt - 12) + ':' + mmssTemp + " pm";
+    QString mmssTemp = itemDateTime.toString("mm:ss");
+    QString hTemp = itemDateTime.toString("H");
+    qint16 hTempInt = hTemp.toInt();
 
-        dateTimeStr = cachedDateTime.toString("dd.MM.yyyy") + ' ' + timeStr;
-    }
+    if (hTempInt <= 12)
+        return hTemp + ':' + mmssTemp + " am";
+
+    return QString::number(hTempInt - 12) + ':' + mmssTemp + " pm";
+}
+
+QString HistoryItem::dateTimeText() const
+{
+    if (baseValues_->use24HourTimeFormat)
+        return QDateTime::fromTime_t(dateTimeInt).toString(baseValues.dateTimeFormat);
 
-    cachedDateTime.setTime(QTime(0, 0, 0, 0));
-    dateInt = cachedDateTime.toTime_t();
+    return QDateTime::fromTime_t(dateTimeInt).toString("dd.MM.yyyy") + ' ' + timeText();
+}
 
-    QString currAStr, currBStr;
+static QString currencySign(const QString& symbol, bool currencyA)
+{
     int posSplitter = symbol.indexOf('/');
 
     if (posSplitter == -1)
-    {
-        currAStr = symbol.left(3);
-        currBStr = symbol.right(3);
-    }
-    else
-    {
-        currAStr = symbol.left(posSplitter);
-        currBStr = symbol.right(symbol.size() - posSplitter - 1);
-    }
+        return IniEngine::getCurrencyInfo(currencyA ? symbol.left(3) : symbol.right(3)).sign;
 
-    QString usdSign = IniEngine::getCurrencyInfo(currBStr).sign;
+    return IniEngine::getCurrencyInfo(currencyA ? symbol.left(posSplitter) :
+                                      symbol.right(symbol.size() - posSplitter - 1)).sign;
+}
 
-    if (price > 0.0)
-        priceStr = usdSign + JulyMath::textFromDouble(price, baseValues.decimalsPriceMyTransactions);
+QString HistoryItem::volumeText() const
+{
+    if (volume <= 0.0)
+        return QString();
 
-    if (volume > 0.0)
-    {
-        volumeStr = IniEngine::getCurrencyInfo(currAStr).sign +
-                    JulyMath::textFromDouble(volume, baseValues.decimalsAmountMyTransactions);
-    }
+    QString volumeStr = currencySign(symbol, true) + JulyMath::textFromDouble(volume, baseValues.decimalsAmountMyTransactions);
 
-    if (volume > 0.0 && price > 0.0)
-    {
-        totalStr = JulyMath::textFromDouble(price * volume, baseValues.decimalsTotalMyTransactions);
-
-        if (!baseValues.forceDotInSpinBoxes)
-        {
-            priceStr.replace(".", ",");
-            volumeStr.replace(".", ",");
-            totalStr.replace(".", ",");
-        }
-    }
+    if (price > 0.0 && !baseValues.forceDotInSpinBoxes)
+        volumeStr.replace(".", ",");
+
+    return volumeStr;
+}
+
+QString HistoryItem::priceText() const
+{
+    if (price <= 0.0)
+        return QString();
+
+    QString priceStr = currencySign(symbol, false) + JulyMath::textFromDouble(price, baseValues.decimalsPriceMyTransactions);
+
+    if (volume > 0.0 && !baseValues.forceDotInSpinBoxes)
+        priceStr.replace(".", ",");
+
+    return priceStr;
+}
+
+QString HistoryItem::totalText() const
+{
+    if (volume <= 0.0 || price <= 0.0)
+        return QString();
+
+    QString totalStr = JulyMath::textFromDouble(price * volume, baseValues.decimalsTotalMyTransactions);
+
+    if (!baseValues.forceDotInSpinBoxes)
+        totalStr.replace(".", ",");
+
+    return totalStr;
 }
 
 bool HistoryItem::isValid()
@@ -113,7 +126,11 @@ bool HistoryItem::isValid()
     bool valid = dateTimeInt > 0 && symbol.size() >= 5;
 
     if (valid)
-        cacheStrings();
+    {
+        QDateTime itemDate = QDateTime::fromTime_t(dateTimeInt);
+        itemDate.setTime(QTime(0, 0, 0, 0));
+        dateInt = itemDate.toTime_t();
+    }
 
     return valid;
 }
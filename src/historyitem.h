@@ -42,24 +42,25 @@ public:
     bool displayFullDate;
     qint64  dateTimeInt;
     quint32 dateInt;
-    QString dateTimeStr;
-    QString timeStr;
     QString description;
 
     double volume;
-    QString volumeStr;
 
     double price;
-    QString priceStr;
 
     double total;
-    QString totalStr;
 
     QString symbol;
 
     int type; //0=General, 1=Sell, 2=Buy, 3=Fee, 4=Deposit, 5=Withdraw
 
-    void cacheStrings();
+    quint64 generation;//Identifies the formatted texts in the models cache
+
+    QString timeText() const;
+    QString dateTimeText() const;
+    QString volumeText() const;
+    QString priceText() const;
+    QString totalText() const;
 
     bool isValid();
 };
@@ -55,6 +55,7 @@ void HistoryModel::clear()
     beginResetModel();
     lastDate = 0;
     itemsList.clear();
+    textCache.clear();
     endResetModel();
 }
 
@@ -183,6 +184,43 @@ int HistoryModel::getRowType(int row)
     return itemsList.at(row).type;
 }
 
+QString HistoryModel::rowText(int row, TextField field) const
+{
+    const HistoryItem& item = itemsList.at(row);
+    const QString* cachedText = textCache.find(item.generation, field);
+
+    if (cachedText)
+        return *cachedText;
+
+    QString text;
+
+    switch (field)
+    {
+    case TimeText:
+        text = item.timeText();
+        break;
+
+    case DateTimeText:
+        text = item.dateTimeText();
+        break;
+
+    case VolumeText:
+        text = item.volumeText();
+        break;
+
+    case PriceText:
+        text = item.priceText();
+        break;
+
+    case TotalText:
+        text = item.totalText();
+        break;
+    }
+
+    textCache.insert(item.generation, field, text);
+    return text;
+}
+
 int HistoryModel::rowCount(const QModelIndex&) const
 {
     return itemsList.count();
@@ -202,14 +240,15 @@ QVariant HistoryModel::data(const QModelIndex& index, int role) const
 
     if (role == Qt::WhatsThisRole)
     {
-        return itemsList.at(currentRow).dateTimeStr + " " + typesLabels.at(itemsList.at(currentRow).type) + " " + itemsList.at(
-                   currentRow).priceStr + " " + itemsList.at(currentRow).totalStr;
+        return rowText(currentRow, DateTimeText) + " " + typesLabels.at(itemsList.at(currentRow).type) + " " +
+               rowText(currentRow, PriceText) + " " + rowText(currentRow, TotalText);
     }
 
     if (role == Qt::StatusTipRole)
     {
-        return itemsList.at(currentRow).dateTimeStr + "\t" + itemsList.at(currentRow).volumeStr + "\t" + typesLabels.at(
-                   itemsList.at(currentRow).type) + "\t" + itemsList.at(currentRow).priceStr + "\t" + itemsList.at(currentRow).totalStr;
+        return rowText(currentRow, DateTimeText) + "\t" + rowText(currentRow, VolumeText) + "\t" +
+               typesLabels.at(itemsList.at(currentRow).type) + "\t" + rowText(currentRow, PriceText) + "\t" +
+               rowText(currentRow, TotalText);
     }
 
     if (role != Qt::DisplayRole && role != Qt::ToolTipRole && role != Qt::ForegroundRole && role != Qt::TextAlignmentRole)
@@ -286,22 +325,22 @@ QVariant HistoryModel::data(const QModelIndex& index, int role) const
     {
         //Date
         if (role == Qt::ToolTipRole || itemsList.at(currentRow).displayFullDate)
-            return itemsList.at(currentRow).dateTimeStr;//DateTime
+            return rowText(currentRow, DateTimeText);//DateTime
 
-        return itemsList.at(currentRow).timeStr;//Time
+        return rowText(currentRow, TimeText);//Time
     }
 
     case 2:
-        return itemsList.at(currentRow).volumeStr;//Volume
+        return rowText(currentRow, VolumeText);//Volume
 
     case 3:
         return typesLabels.at(itemsList.at(currentRow).type);//Type
 
     case 4:
-        return itemsList.at(currentRow).priceStr;//Price
+        return rowText(currentRow, PriceText);//Price
 
     case 5:
-        return itemsList.at(currentRow).totalStr;//Total
+        return rowText(currentRow, TotalText);//Total
 
     case 6:
         return itemsList.at(currentRow).description;//Description
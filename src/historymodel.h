@@ -35,6 +35,7 @@
 #include <QAbstractItemModel>
 #include <QStringList>
 #include "historyitem.h"
+#include "rowtextcache.h"
 
 class HistoryModel : public QAbstractItemModel
 {
@@ -63,6 +64,10 @@ public:
     int rowCount(const QModelIndex& parent = QModelIndex()) const;
     int columnCount(const QModelIndex& parent = QModelIndex()) const;
 private:
+    enum TextField {TimeText, DateTimeText, VolumeText, PriceText, TotalText};
+    QString rowText(int row, TextField field) const;
+    mutable RowTextCache textCache;
+
     int dateWidth = 0;
     int typeWidth = 0;
     quint32 lastDate;
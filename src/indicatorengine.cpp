@@ -29,13 +29,24 @@
 //  You should have received a copy of the GNU General Public License
 //  along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
-#include <QThread>
 #include "indicatorengine.h"
+#include "indicatorsubscriber.h"
 #include "main.h"
 
-IndicatorEngine::IndicatorEngine() : QObject()
+static const char* tickerNames[IndicatorEngine::TickersCount] = {"High", "Low", "Sell", "Buy", "Last", "Volume"};
+
+IndicatorEngine::IndicatorEngine()
+    : QObject(),
+      idsCount(0)
 {
-    connect(this, &IndicatorEngine::indicatorChanged, this, &IndicatorEngine::setValueSlot);
+    for (qint32 n = 0; n < chunksCount; n++)
+        chunks[n].store(nullptr);
+
+    // Changes are sent once per batch interval, whatever thread stored them
+    batchTimer.setSingleShot(true);
+    batchTimer.setInterval(batchInterval);
+    connect(this, &IndicatorEngine::batchPending, &batchTimer, static_cast<void (QTimer::*)()>(&QTimer::start));
+    connect(&batchTimer, &QTimer::timeout, this, &IndicatorEngine::sendBatch);
 
     connect(this, &IndicatorEngine::indicatorHighChanged, baseValues.mainWindow_, &QtBitcoinTrader::indicatorHighChanged);
     connect(this, &IndicatorEngine::indicatorLowChanged, baseValues.mainWindow_, &QtBitcoinTrader::indicatorLowChanged);
@@ -44,16 +55,12 @@ IndicatorEngine::IndicatorEngine() : QObject()
     connect(this, &IndicatorEngine::indicatorLastChanged, baseValues.mainWindow_, &QtBitcoinTrader::indicatorLastChanged);
     connect(this, &IndicatorEngine::indicatorVolumeChanged,
             baseValues.mainWindow_, &QtBitcoinTrader::indicatorVolumeChanged);
-
-    QThread* indicatorEngineThread = new QThread;
-    connect(this, SIGNAL(finishThread()), indicatorEngineThread, SLOT(quit()));
-    this->moveToThread(indicatorEngineThread);
-    indicatorEngineThread->start();
 }
 
 IndicatorEngine::~IndicatorEngine()
 {
-    emit finishThread();
+    for (qint32 n = 0; n < chunksCount; n++)
+        delete[] chunks[n].load();
 }
 
 //---------------------------------------- Static ----------------------------------------
@@ -63,56 +70,212 @@ IndicatorEngine* IndicatorEngine::global()
     return &instance;
 }
 
-void IndicatorEngine::setValue(QString exchange, QString symbol, QString indicator, double value)
+qint32 IndicatorEngine::indicatorId(const QString& exchange, const QString& symbol, const QString& name)
 {
-    emit IndicatorEngine::global()->indicatorChanged(exchange, symbol, indicator, value);
+    IndicatorEngine* engine = IndicatorEngine::global();
+    QMutexLocker lock(&engine->locker);
+    return engine->registerId(exchange, symbol, name);
 }
 
-double IndicatorEngine::getValue(QString index)
+qint32 IndicatorEngine::indicatorId(const QString& index)
 {
-    IndicatorEngine::global()->locker.lock();
-    double value = IndicatorEngine::global()->indicators[index.toLatin1()];
-    IndicatorEngine::global()->locker.unlock();
+    int symbolStart = index.indexOf('_') + 1;
+    int nameStart = index.indexOf('_', symbolStart) + 1;
+
+    if (symbolStart == 0 || nameStart == 0)
+        return -1;
+
+    return indicatorId(index.left(symbolStart - 1), index.mid(symbolStart, nameStart - symbolStart - 1),
+                       index.mid(nameStart));
+}
+
+qint32 IndicatorEngine::tickerId(const QString& exchange, const QString& symbol, Ticker ticker)
+{
+    IndicatorEngine* engine = IndicatorEngine::global();
+    QMutexLocker lock(&engine->locker);
+    QHash<QString, TickerIds>& exchangeIds = engine->tickerIds[exchange];
+    QHash<QString, TickerIds>::const_iterator found = exchangeIds.constFind(symbol);
+
+    if (found != exchangeIds.constEnd())
+        return found.value().ids[ticker];
+
+    TickerIds& symbolIds = exchangeIds[symbol];
+
+    for (qint32 n = 0; n < TickersCount; n++)
+        symbolIds.ids[n] = engine->registerId(exchange, symbol, tickerNames[n]);
 
-    return value;
+    return symbolIds.ids[ticker];
+}
+
+void IndicatorEngine::setValue(qint32 id, double value)
+{
+    IndicatorEngine::global()->storeValue(id, value);
+}
+
+void IndicatorEngine::setValue(const QString& exchange, const QString& symbol, Ticker ticker, double value)
+{
+    setValue(tickerId(exchange, symbol, ticker), value);
+}
+
+void IndicatorEngine::setValue(const QString& exchange, const QString& symbol, const QString& name, double value)
+{
+    setValue(indicatorId(exchange, symbol, name), value);
+}
+
+double IndicatorEngine::getValue(qint32 id)
+{
+    Slot* valueSlot = IndicatorEngine::global()->slot(id);
+
+    if (valueSlot == nullptr)
+        return 0.0;
+
+    return valueSlot->value.load(std::memory_order_relaxed);
+}
+
+double IndicatorEngine::getValue(const QString& exchange, const QString& symbol, Ticker ticker)
+{
+    return getValue(tickerId(exchange, symbol, ticker));
+}
+
+double IndicatorEngine::getValue(const QString& index)
+{
+    return getValue(indicatorId(index));
+}
+
+IndicatorEngine::Key IndicatorEngine::indicatorKey(qint32 id)
+{
+    IndicatorEngine* engine = IndicatorEngine::global();
+    QMutexLocker lock(&engine->locker);
+    return engine->keys.value(id);
+}
+
+//---------------------------------------- Public ----------------------------------------
+void IndicatorEngine::addSubscriber(IndicatorSubscriber* subscriber)
+{
+    subscribers << subscriber;
+}
+
+void IndicatorEngine::removeSubscriber(IndicatorSubscriber* subscriber)
+{
+    subscribers.removeAll(subscriber);
 }
 
 //---------------------------------------- Private ----------------------------------------
-void IndicatorEngine::setValueSlot(QString exchange, QString symbol, QString name, double value)
+qint32 IndicatorEngine::registerId(const QString& exchange, const QString& symbol, const QString& name)
 {
-    if (exchange == baseValues.exchangeName && symbol == baseValues.currentPair.symbol)
+    QByteArray index = (exchange + '_' + symbol + '_' + name).toLatin1();
+    QHash<QByteArray, qint32>::const_iterator found = ids.constFind(index);
+
+    if (found != ids.constEnd())
+        return found.value();
+
+    qint32 chunk = idsCount / slotsPerChunk;
+
+    if (chunk >= chunksCount)
+        return -1;
+
+    // Chunks are never moved or freed while the engine lives, so readers use them without the lock
+    if (chunks[chunk].load(std::memory_order_relaxed) == nullptr)
+        chunks[chunk].store(new Slot[slotsPerChunk], std::memory_order_release);
+
+    Key key;
+    key.exchange = exchange;
+    key.symbol = symbol;
+    key.name = name;
+    keys << key;
+
+    ids.insert(index, idsCount);
+    return idsCount++;
+}
+
+IndicatorEngine::Slot* IndicatorEngine::slot(qint32 id) const
+{
+    if (id < 0 || id >= slotsPerChunk * chunksCount)
+        return nullptr;
+
+    Slot* chunk = chunks[id / slotsPerChunk].load(std::memory_order_acquire);
+
+    if (chunk == nullptr)
+        return nullptr;
+
+    return chunk + id % slotsPerChunk;
+}
+
+void IndicatorEngine::storeValue(qint32 id, double value)
+{
+    Slot* valueSlot = slot(id);
+
+    if (valueSlot == nullptr || valueSlot->value.exchange(value, std::memory_order_relaxed) == value)
+        return;
+
+    // An id waits in the batch once, however many times it changes before the batch is sent
+    if (valueSlot->pending.exchange(true))
+        return;
+
+    QMutexLocker lock(&pendingLocker);
+    pendingIds << id;
+
+    if (pendingIds.count() == 1)
+        emit batchPending();
+}
+
+void IndicatorEngine::sendBatch()
+{
+    QList<qint32> batchIds;
+
     {
-        QByteArray index = (exchange + '_' + symbol + '_' + name).toLatin1();
+        QMutexLocker lock(&pendingLocker);
+        batchIds.swap(pendingIds);
+    }
 
-        if (indicators.contains(index))
-        {
-            if (indicators[index] == value)
-                return;
-            else
-            {
-                locker.lock();
-                indicators[index] = value;
-                locker.unlock();
-            }
-        }
-        else
+    for (int n = 0; n < batchIds.count(); n++)
+        slot(batchIds.at(n))->pending.store(false);
+
+    emit valuesChanged(batchIds);
+
+    for (int n = 0; n < subscribers.count(); n++)
+        subscribers.at(n)->sendBatch(batchIds);
+
+    // The market widgets only show the current pair
+    QString symbol = baseValues.currentPair.symbol;
+
+    for (qint32 ticker = 0; ticker < TickersCount; ticker++)
+    {
+        qint32 id = tickerId(baseValues.exchangeName, symbol, Ticker(ticker));
+
+        if (!batchIds.contains(id))
+            continue;
+
+        double value = getValue(id);
+
+        switch (ticker)
         {
-            locker.lock();
-            indicators.insert(index, value);
-            locker.unlock();
-        }
+            case High:
+                emit indicatorHighChanged(symbol, value);
+                break;
+
+            case Low:
+                emit indicatorLowChanged(symbol, value);
+                break;
 
-        if (name == "High")
-            emit indicatorHighChanged(symbol, value);
-        else if (name == "Low")
-            emit indicatorLowChanged(symbol, value);
-        else if (name == "Sell")
-            emit indicatorSellChanged(symbol, value);
-        else if (name == "Buy")
-            emit indicatorBuyChanged(symbol, value);
-        else if (name == "Last")
-            emit indicatorLastChanged(symbol, value);
-        else if (name == "Volume")
-            emit indicatorVolumeChanged(symbol, value);
+            case Sell:
+                emit indicatorSellChanged(symbol, value);
+                break;
+
+            case Buy:
+                emit indicatorBuyChanged(symbol, value);
+                break;
+
+            case Last:
+                emit indicatorLastChanged(symbol, value);
+                break;
+
+            case Volume:
+                emit indicatorVolumeChanged(symbol, value);
+                break;
+
+            default:
+                break;
+        }
     }
 }
@@ -35,27 +35,85 @@
 #include <QObject>
 #include <QMutex>
 #include <QHash>
+#include <QTimer>
+#include <QVector>
+#include <atomic>
+
+class IndicatorSubscriber;
 
 class IndicatorEngine : public QObject
 {
     Q_OBJECT
 public:
+    enum Ticker {High, Low, Sell, Buy, Last, Volume, TickersCount};
+
+    struct Key
+    {
+        QString exchange;
+        QString symbol;
+        QString name;
+    };
+
     IndicatorEngine();
     ~IndicatorEngine();
 
     static IndicatorEngine* global();
-    static void setValue(QString, QString, QString, double);
-    static double getValue(QString);
+
+    // Ids are given once per exchange, symbol and name and never change, reading a value by id takes no lock
+    static qint32 indicatorId(const QString&, const QString&, const QString&);
+    static qint32 indicatorId(const QString&);
+    static qint32 tickerId(const QString&, const QString&, Ticker);
+
+    static void setValue(qint32, double);
+    static void setValue(const QString&, const QString&, Ticker, double);
+    static void setValue(const QString&, const QString&, const QString&, double);
+    static double getValue(qint32);
+    static double getValue(const QString&, const QString&, Ticker);
+    static double getValue(const QString&);
+    static Key indicatorKey(qint32);
+
+    void addSubscriber(IndicatorSubscriber*);
+    void removeSubscriber(IndicatorSubscriber*);
 
 private:
+    struct Slot
+    {
+        Slot() : value(0.0), pending(false) {}
+        std::atomic<double> value;
+        std::atomic<bool> pending;
+    };
+
+    struct TickerIds
+    {
+        qint32 ids[TickersCount];
+    };
+
+    static const qint32 slotsPerChunk = 256;
+    static const qint32 chunksCount = 256;
+    static const qint32 batchInterval = 40;
+
     QMutex locker;
-    QHash<QByteArray, double> indicators;
+    QHash<QByteArray, qint32> ids;
+    QVector<Key> keys;
+    QHash<QString, QHash<QString, TickerIds> > tickerIds;
+    std::atomic<Slot*> chunks[chunksCount];
+    qint32 idsCount;
+
+    QMutex pendingLocker;
+    QList<qint32> pendingIds;
+    QTimer batchTimer;
+    QList<IndicatorSubscriber*> subscribers;
+
+    qint32 registerId(const QString&, const QString&, const QString&);
+    Slot* slot(qint32) const;
+    void storeValue(qint32, double);
 
 private slots:
-    void setValueSlot(QString, QString, QString, double);
+    void sendBatch();
 
 signals:
-    void indicatorChanged(QString, QString, QString, double);
+    void batchPending();
+    void valuesChanged(QList<qint32>);
 
     void indicatorHighChanged(QString, double);
     void indicatorLowChanged(QString, double);
@@ -63,8 +121,6 @@ signals:
     void indicatorBuyChanged(QString, double);
     void indicatorLastChanged(QString, double);
     void indicatorVolumeChanged(QString, double);
-
-    void finishThread();
 };
 
 #endif // INDICATORENGINE_H
@@ -0,0 +1,85 @@
+//  This file is part of Qt Bitcoin Trader
+//      https://github.com/JulyIGHOR/QtBitcoinTrader
+//  Copyright (C) 2013-2018 July IGHOR <julyighor@gmail.com>
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  In addition, as a special exception, the copyright holders give
+//  permission to link the code of portions of this program with the
+//  OpenSSL library under certain conditions as described in each
+//  individual source file, and distribute linked combinations including
+//  the two.
+//
+//  You must obey the GNU General Public License in all respects for all
+//  of the code used other than OpenSSL. If you modify file(s) with this
+//  exception, you may extend this exception to your version of the
+//  file(s), but you are not obligated to do so. If you do not wish to do
+//  so, delete this exception statement from your version. If you delete
+//  this exception statement from all source files in the program, then
+//  also delete it here.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "indicatorsubscriber.h"
+#include "indicatorengine.h"
+
+IndicatorSubscriber::IndicatorSubscriber(const QString& exchange, const QString& symbol, QObject* parent)
+    : QObject(parent),
+      filterExchange(exchange),
+      filterSymbol(symbol)
+{
+    IndicatorEngine::global()->addSubscriber(this);
+}
+
+IndicatorSubscriber::~IndicatorSubscriber()
+{
+    IndicatorEngine::global()->removeSubscriber(this);
+}
+
+void IndicatorSubscriber::setFilter(const QString& exchange, const QString& symbol)
+{
+    filterExchange = exchange;
+    filterSymbol = symbol;
+    matches.clear();
+}
+
+bool IndicatorSubscriber::accepts(qint32 id)
+{
+    if (id < 0)
+        return false;
+
+    // Ids never change their key, so each one is compared with the filter only once
+    if (id >= matches.count())
+        matches.resize(id + 1);
+
+    if (matches.at(id) == 0)
+    {
+        IndicatorEngine::Key key = IndicatorEngine::indicatorKey(id);
+        bool accepted = (filterExchange.isEmpty() || key.exchange == filterExchange) &&
+                        (filterSymbol.isEmpty() || key.symbol == filterSymbol);
+        matches[id] = accepted ? 1 : -1;
+    }
+
+    return matches.at(id) > 0;
+}
+
+void IndicatorSubscriber::sendBatch(const QList<qint32>& ids)
+{
+    QList<qint32> acceptedIds;
+
+    for (int n = 0; n < ids.count(); n++)
+        if (accepts(ids.at(n)))
+            acceptedIds << ids.at(n);
+
+    if (!acceptedIds.isEmpty())
+        emit indicatorsChanged(acceptedIds);
+}
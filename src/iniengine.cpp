@@ -122,7 +122,6 @@ void IniEngine::runThread()
 
     julyHttp = new JulyHttp("centrabit.com", "", this, true, false);
     connect(julyHttp, &JulyHttp::dataReceived, this, &IniEngine::dataReceived);
-    julyHttp->secondTimer->stop();
     julyHttp->noReconnect = true;
     julyHttp->ignoreError = true;
     julyHttp->sendData(170, "GET /Downloads/QBT_Resources/Currencies.ini", 0, 0, 0);
@@ -275,7 +274,6 @@ void IniEngine::loadExchange(QString exchangeIniFileName)
     {
         julyHttp = new JulyHttp("centrabit.com", "", this, true, false);
         connect(julyHttp, &JulyHttp::dataReceived, this, &IniEngine::dataReceived);
-        julyHttp->secondTimer->stop();
         julyHttp->noReconnect = true;
         julyHttp->ignoreError = true;
     }
@@ -0,0 +1,264 @@
+//  This file is part of Qt Bitcoin Trader
+//      https://github.com/JulyIGHOR/QtBitcoinTrader
+//  Copyright (C) 2013-2018 July IGHOR <julyighor@gmail.com>
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  In addition, as a special exception, the copyright holders give
+//  permission to link the code of portions of this program with the
+//  OpenSSL library under certain conditions as described in each
+//  individual source file, and distribute linked combinations including
+//  the two.
+//
+//  You must obey the GNU General Public License in all respects for all
+//  of the code used other than OpenSSL. If you modify file(s) with this
+//  exception, you may extend this exception to your version of the
+//  file(s), but you are not obligated to do so. If you do not wish to do
+//  so, delete this exception statement from your version. If you delete
+//  this exception statement from all source files in the program, then
+//  also delete it here.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "julydecimal.h"
+#include <QByteArray>
+#include <limits>
+
+namespace
+{
+    // Up to 19 significant digits are kept, that always fits in quint64
+    const int maxMantissaDigits = 19;
+
+    const quint64 powersOf10[] =
+    {
+        1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL,
+        10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL, 100000000000000ULL,
+        1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL, 1000000000000000000ULL,
+        10000000000000000000ULL
+    };
+
+    // Every power of 10 up to 1e22 is exact in a double
+    const double exactPowersOf10[] =
+    {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    struct DecimalText
+    {
+        const char* begin;
+        const char* end;
+        quint64 mantissa;
+        int exponent;
+        bool negative;
+        bool truncated;
+    };
+
+    bool isSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    bool isDigit(char c)
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    bool readDecimal(const char* begin, const char* end, DecimalText* text)
+    {
+        if (begin == nullptr)
+            return false;
+
+        while (begin < end && isSpace(*begin))
+            ++begin;
+
+        while (end > begin && isSpace(end[-1]))
+            --end;
+
+        if (end - begin >= 2 && *begin == '"' && end[-1] == '"')
+        {
+            ++begin;
+            --end;
+        }
+
+        text->begin = begin;
+        text->end = end;
+        text->mantissa = 0;
+        text->exponent = 0;
+        text->negative = false;
+        text->truncated = false;
+
+        const char* pos = begin;
+
+        if (pos < end && (*pos == '-' || *pos == '+'))
+            text->negative = *pos++ == '-';
+
+        int digits = 0;
+        bool anyDigit = false;
+
+        for (; pos < end && isDigit(*pos); ++pos)
+        {
+            anyDigit = true;
+
+            if (digits < maxMantissaDigits)
+            {
+                text->mantissa = text->mantissa * 10 + quint64(*pos - '0');
+
+                if (text->mantissa)
+                    ++digits;
+            }
+            else
+            {
+                ++text->exponent;
+
+                if (*pos != '0')
+                    text->truncated = true;
+            }
+        }
+
+        if (pos < end && *pos == '.')
+        {
+            for (++pos; pos < end && isDigit(*pos); ++pos)
+            {
+                anyDigit = true;
+
+                if (digits < maxMantissaDigits)
+                {
+                    text->mantissa = text->mantissa * 10 + quint64(*pos - '0');
+                    --text->exponent;
+
+                    if (text->mantissa)
+                        ++digits;
+                }
+                else if (*pos != '0')
+                    text->truncated = true;
+            }
+        }
+
+        if (!anyDigit)
+            return false;
+
+        if (pos < end && (*pos == 'e' || *pos == 'E'))
+        {
+            ++pos;
+            bool negativeExponent = false;
+
+            if (pos < end && (*pos == '-' || *pos == '+'))
+                negativeExponent = *pos++ == '-';
+
+            if (pos == end || !isDigit(*pos))
+                return false;
+
+            int exponent = 0;
+
+            for (; pos < end && isDigit(*pos); ++pos)
+                if (exponent < 100000)
+                    exponent = exponent * 10 + (*pos - '0');
+
+            text->exponent += negativeExponent ? -exponent : exponent;
+        }
+
+        return pos == end;
+    }
+}
+
+double JulyDecimal::toDouble(const char* begin, const char* end, bool* ok)
+{
+    DecimalText text;
+
+    if (!readDecimal(begin, end, &text))
+    {
+        if (ok)
+            *ok = false;
+
+        return 0.0;
+    }
+
+    if (ok)
+        *ok = true;
+
+    double result;
+
+    if (text.mantissa == 0)
+        result = 0.0;
+    else if (!text.truncated && text.mantissa <= (1ULL << 53) && text.exponent >= -22 && text.exponent <= 22)
+    {
+        // Both operands are exact, so a single rounding gives the correctly rounded value
+        result = double(text.mantissa);
+
+        if (text.exponent < 0)
+            result /= exactPowersOf10[-text.exponent];
+        else
+            result *= exactPowersOf10[text.exponent];
+    }
+    else
+    {
+        // Long mantissas and huge exponents are rare in replies, let Qt round those
+        return QByteArray(text.begin, int(text.end - text.begin)).toDouble(ok);
+    }
+
+    return text.negative ? -result : result;
+}
+
+qint64 JulyDecimal::toScaled(const char* begin, const char* end, int decimals, bool* ok)
+{
+    DecimalText text;
+    bool valid = readDecimal(begin, end, &text);
+    quint64 result = 0;
+
+    if (valid && text.mantissa)
+    {
+        int shift = text.exponent + decimals;
+        quint64 limit = quint64(std::numeric_limits<qint64>::max()) + (text.negative ? 1 : 0);
+
+        if (shift >= 0)
+        {
+            if (shift > maxMantissaDigits || text.mantissa > limit / powersOf10[shift])
+                valid = false;
+            else
+                result = text.mantissa * powersOf10[shift];
+        }
+        else if (-shift <= maxMantissaDigits)
+            result = text.mantissa / powersOf10[-shift];
+
+        if (result > limit)
+            valid = false;
+    }
+
+    if (ok)
+        *ok = valid;
+
+    if (!valid)
+        return 0;
+
+    return text.negative ? qint64(0 - result) : qint64(result);
+}
+
+qint64 JulyDecimal::toLongLong(const char* begin, const char* end, bool* ok)
+{
+    DecimalText text;
+    bool valid = readDecimal(begin, end, &text);
+
+    // Only whole numbers, "12.50" is not an integer but "1574694475.0" is
+    if (valid && text.mantissa && text.exponent < 0)
+        valid = -text.exponent <= maxMantissaDigits && text.mantissa % powersOf10[-text.exponent] == 0;
+
+    if (!valid)
+    {
+        if (ok)
+            *ok = false;
+
+        return 0;
+    }
+
+    return toScaled(begin, end, 0, ok);
+}
@@ -0,0 +1,50 @@
+//  This file is part of Qt Bitcoin Trader
+//      https://github.com/JulyIGHOR/QtBitcoinTrader
+//  Copyright (C) 2013-2018 July IGHOR <julyighor@gmail.com>
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  In addition, as a special exception, the copyright holders give
+//  permission to link the code of portions of this program with the
+//  OpenSSL library under certain conditions as described in each
+//  individual source file, and distribute linked combinations including
+//  the two.
+//
+//  You must obey the GNU General Public License in all respects for all
+//  of the code used other than OpenSSL. If you modify file(s) with this
+//  exception, you may extend this exception to your version of the
+//  file(s), but you are not obligated to do so. If you do not wish to do
+//  so, delete this exception statement from your version. If you delete
+//  this exception statement from all source files in the program, then
+//  also delete it here.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef JULYDECIMAL_H
+#define JULYDECIMAL_H
+
+#include <QtGlobal>
+
+// Reads decimal numbers straight from reply bytes without building a QByteArray or QString.
+// Accepts optional surrounding quotes and spaces, a sign, a fraction and an exponent,
+// so "0.00100000", -12, 1.5e-7 and "\"7254.6\"" all parse. Anything else sets ok to false.
+namespace JulyDecimal
+{
+    double toDouble(const char* begin, const char* end, bool* ok = nullptr);
+    qint64 toLongLong(const char* begin, const char* end, bool* ok = nullptr);
+
+    // Value multiplied by 10^decimals, extra digits are cut like JulyMath::cutDoubleDecimals does.
+    // With CurrencyPairItem::priceDecimals this gives the price in ticks.
+    qint64 toScaled(const char* begin, const char* end, int decimals, bool* ok = nullptr);
+}
+
+#endif // JULYDECIMAL_H
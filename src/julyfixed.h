@@ -0,0 +1,382 @@
+//  This file is part of Qt Bitcoin Trader
+//      https://github.com/JulyIGHOR/QtBitcoinTrader
+//  Copyright (C) 2013-2018 July IGHOR <julyighor@gmail.com>
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  In addition, as a special exception, the copyright holders give
+//  permission to link the code of portions of this program with the
+//  OpenSSL library under certain conditions as described in each
+//  individual source file, and distribute linked combinations including
+//  the two.
+//
+//  You must obey the GNU General Public License in all respects for all
+//  of the code used other than OpenSSL. If you modify file(s) with this
+//  exception, you may extend this exception to your version of the
+//  file(s), but you are not obligated to do so. If you do not wish to do
+//  so, delete this exception statement from your version. If you delete
+//  this exception statement from all source files in the program, then
+//  also delete it here.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef JULYFIXED_H
+#define JULYFIXED_H
+
+#include <QHash>
+#include <QString>
+#include <cmath>
+#include <limits>
+#include "julydecimal.h"
+
+// Decimal number kept as an integer count of 10^-decimals() steps.
+// decimals() is Decimals for every value below maxRaw / 10^Decimals, 4e10 for prices and amounts.
+// Larger values, like a level of a high supply token, keep as many decimals as fit instead of overflowing,
+// so they still carry 18 significant digits. A value has only one form, the most decimals that fit,
+// so equal values compare and hash equal and fewer decimals always mean a larger magnitude.
+// The storage scale is fixed at compile time; pair precision such as
+// CurrencyPairItem::priceDecimals is applied with cut() and toString().
+template <int Decimals>
+class JulyFixed
+{
+public:
+    JulyFixed()
+        : rawValue(0),
+          decimalsValue(Decimals)
+    {
+    }
+
+    // Raw in 10^-Decimals steps
+    static JulyFixed fromRaw(qint64 raw)
+    {
+        return normalized(raw, Decimals);
+    }
+
+    // NaN and infinity give zero, like JulyMath::validDouble rejects them
+    static JulyFixed fromDouble(double value)
+    {
+        return fromScaledDouble(value, false);
+    }
+
+    // Drops the digits past the scale instead of rounding, so an affordable amount never grows
+    static JulyFixed fromDoubleFloor(double value)
+    {
+        return fromScaledDouble(value, true);
+    }
+
+    static JulyFixed fromText(const char* begin, const char* end)
+    {
+        for (int decimals = Decimals; decimals >= 0; decimals--)
+        {
+            bool ok = false;
+            qint64 raw = JulyDecimal::toScaled(begin, end, decimals, &ok);
+
+            if (ok && magnitude(raw) < quint64(maxRaw))
+                return normalized(raw, decimals);
+        }
+
+        return JulyFixed();
+    }
+
+    qint64 raw() const
+    {
+        return rawValue;
+    }
+
+    int decimals() const
+    {
+        return decimalsValue;
+    }
+
+    double toDouble() const
+    {
+        // The raw integer is exact, so one division gives the double nearest to the decimal
+        if (decimalsValue >= 0)
+            return double(rawValue) / double(powerOf10(decimalsValue));
+
+        return double(rawValue) * double(powerOf10(-decimalsValue));
+    }
+
+    bool isNull() const
+    {
+        return rawValue == 0;
+    }
+
+    // Same result as JulyMath::cutDoubleDecimals, computed on the integer
+    JulyFixed cut(int decimals, bool roundUp = false) const
+    {
+        decimals = qMax(decimals, 0);
+
+        if (decimals >= decimalsValue)
+            return *this;
+
+        qint64 step = powerOf10(decimalsValue - decimals);
+        qint64 steps = rawValue / step;
+        qint64 remainder = rawValue % step;
+
+        if (remainder < 0)
+        {
+            steps--;
+            remainder += step;
+        }
+
+        if (roundUp && remainder * 2 >= step)
+            steps++;
+
+        return normalized(steps * step, decimalsValue);
+    }
+
+    // The multiple of step at or below the value, at or above it with roundUp
+    JulyFixed roundToStep(const JulyFixed& step, bool roundUp = false) const
+    {
+        int decimals = qMin(decimalsValue, step.decimalsValue);
+        qint64 stepRaw = rescaled(step.rawValue, step.decimalsValue - decimals);
+
+        if (stepRaw <= 0)
+            return *this;
+
+        qint64 valueRaw = rescaled(rawValue, decimalsValue - decimals);
+        qint64 steps = valueRaw / stepRaw;
+        qint64 remainder = valueRaw % stepRaw;
+
+        if (remainder < 0)
+        {
+            steps--;
+            remainder += stepRaw;
+        }
+
+        if (roundUp && remainder)
+            steps++;
+
+        return normalized(steps * stepRaw, decimals);
+    }
+
+    // Like JulyMath::textFromDouble, digits past maxDecimals are dropped, zeros trimmed down to minDecimals
+    QString toString(int maxDecimals, int minDecimals = 1) const
+    {
+        maxDecimals = qBound(0, maxDecimals, Decimals);
+        minDecimals = qBound(0, minDecimals, maxDecimals);
+
+        quint64 rawMagnitude = magnitude(rawValue);
+        quint64 intPart = rawMagnitude;
+        quint64 fracPart = 0;
+        int fracDigits = qBound(0, decimalsValue, maxDecimals);
+        int intZeros = qMax(-decimalsValue, 0);
+
+        if (decimalsValue > 0)
+        {
+            intPart = rawMagnitude / quint64(powerOf10(decimalsValue));
+            fracPart = (rawMagnitude % quint64(powerOf10(decimalsValue))) /
+                       quint64(powerOf10(decimalsValue - fracDigits));
+        }
+
+        bool negative = rawValue < 0 && (intPart || fracPart);
+
+        while (fracDigits > minDecimals && fracPart % 10 == 0)
+        {
+            fracPart /= 10;
+            fracDigits--;
+        }
+
+        // A large value keeps fewer decimals than asked for, the missing ones are zeros
+        while (fracDigits < minDecimals)
+        {
+            fracPart *= 10;
+            fracDigits++;
+        }
+
+        char buffer[64];
+        char* end = buffer + sizeof(buffer);
+        char* pos = end;
+
+        for (int n = 0; n < fracDigits; n++)
+        {
+            *--pos = char('0' + fracPart % 10);
+            fracPart /= 10;
+        }
+
+        if (fracDigits)
+            *--pos = '.';
+
+        for (int n = 0; n < intZeros; n++)
+            *--pos = '0';
+
+        do
+        {
+            *--pos = char('0' + intPart % 10);
+            intPart /= 10;
+        }
+        while (intPart);
+
+        if (negative)
+            *--pos = '-';
+
+        return QString::fromLatin1(pos, int(end - pos));
+    }
+
+    JulyFixed operator-() const
+    {
+        JulyFixed result = *this;
+        result.rawValue = -rawValue;
+        return result;
+    }
+    JulyFixed operator+(const JulyFixed& other) const
+    {
+        // Both are below maxRaw, so the sum of the same scale always fits
+        if (decimalsValue == other.decimalsValue)
+            return normalized(rawValue + other.rawValue, decimalsValue);
+
+        int decimals = qMin(decimalsValue, other.decimalsValue);
+        return normalized(rescaled(rawValue, decimalsValue - decimals) +
+                          rescaled(other.rawValue, other.decimalsValue - decimals), decimals);
+    }
+    JulyFixed operator-(const JulyFixed& other) const
+    {
+        return *this + -other;
+    }
+    JulyFixed& operator+=(const JulyFixed& other)
+    {
+        *this = *this + other;
+        return *this;
+    }
+    JulyFixed& operator-=(const JulyFixed& other)
+    {
+        *this = *this + -other;
+        return *this;
+    }
+
+    bool operator==(const JulyFixed& other) const
+    {
+        return rawValue == other.rawValue && decimalsValue == other.decimalsValue;
+    }
+    bool operator!=(const JulyFixed& other) const
+    {
+        return !(*this == other);
+    }
+    bool operator<(const JulyFixed& other) const
+    {
+        if (decimalsValue == other.decimalsValue)
+            return rawValue < other.rawValue;
+
+        // The one with fewer decimals is the larger magnitude and decides by its sign
+        if (decimalsValue < other.decimalsValue)
+            return rawValue < 0;
+
+        return other.rawValue > 0;
+    }
+    bool operator<=(const JulyFixed& other) const
+    {
+        return !(other < *this);
+    }
+    bool operator>(const JulyFixed& other) const
+    {
+        return other < *this;
+    }
+    bool operator>=(const JulyFixed& other) const
+    {
+        return !(*this < other);
+    }
+
+private:
+    qint64 rawValue;
+    int decimalsValue;
+
+    // Half of the qint64 range, two raws of one scale add without overflow
+    static const qint64 maxRaw = Q_INT64_C(4000000000000000000);
+    static const int lowestDecimals = -18;
+
+    static qint64 powerOf10(int exponent)
+    {
+        qint64 result = 1;
+
+        while (exponent-- > 0)
+            result *= 10;
+
+        return result;
+    }
+
+    static quint64 magnitude(qint64 raw)
+    {
+        return raw < 0 ? quint64(0) - quint64(raw) : quint64(raw);
+    }
+
+    // Drops digits steps, the last one rounded half away from zero
+    static qint64 rescaled(qint64 raw, int digits)
+    {
+        if (digits <= 0)
+            return raw;
+
+        if (digits > 18)
+            return 0;
+
+        qint64 divisor = powerOf10(digits);
+        qint64 result = raw / divisor;
+        qint64 remainder = raw % divisor;
+
+        if (remainder >= divisor - remainder)
+            result++;
+        else if (-remainder >= divisor + remainder)
+            result--;
+
+        return result;
+    }
+
+    static JulyFixed normalized(qint64 raw, int decimals)
+    {
+        while (magnitude(raw) >= quint64(maxRaw) && decimals > lowestDecimals)
+        {
+            raw = rescaled(raw, 1);
+            decimals--;
+        }
+
+        while (decimals < Decimals && magnitude(raw) < quint64(maxRaw / 10))
+        {
+            raw *= 10;
+            decimals++;
+        }
+
+        JulyFixed result;
+        result.rawValue = raw;
+        result.decimalsValue = decimals;
+        return result;
+    }
+
+    static JulyFixed fromScaledDouble(double value, bool roundDown)
+    {
+        if (!(qAbs(value) <= std::numeric_limits<double>::max()))
+            return JulyFixed();
+
+        for (int decimals = Decimals; decimals >= lowestDecimals; decimals--)
+        {
+            double scaled = decimals >= 0 ? value * double(powerOf10(decimals)) :
+                            value / double(powerOf10(-decimals));
+
+            // Doubles this large are 512 apart, rounding never reaches maxRaw
+            if (qAbs(scaled) < double(maxRaw))
+                return normalized(roundDown ? qint64(std::floor(scaled)) : qRound64(scaled), decimals);
+        }
+
+        return JulyFixed();
+    }
+};
+
+template <int Decimals>
+inline uint qHash(const JulyFixed<Decimals>& value, uint seed = 0)
+{
+    return qHash(value.raw(), seed) ^ uint(Decimals - value.decimals());
+}
+
+// Eight decimals covers the prices and amounts the exchanges send, values past 4e10 keep fewer
+typedef JulyFixed<8> JulyPrice;
+typedef JulyFixed<8> JulyAmount;
+
+#endif // JULYFIXED_H
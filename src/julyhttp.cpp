@@ -31,11 +31,10 @@
 
 #include "julyhttp.h"
 #include "main.h"
+#include "julyratelimiter.h"
 #include <QTimer>
 #include <zlib.h>
 #include <QFile>
-#include <QMutex>
-#include <QWaitCondition>
 
 #ifdef Q_OS_WIN
     #include <WinSock2.h>
@@ -67,6 +66,19 @@ JulyHttp::JulyHttp(const QString& hostN, const QByteArray& restLine, QObject* pa
     isDisabled = false;
     outGoingPacketsCount = 0;
     contentGzipped = false;
+    gzipStream = nullptr;
+    gzipStreamEnded = true;
+    currentPendingRequest = nullptr;
+    scheduledCount = 0;
+    deadlineTimer.start();
+    rateLimiter = nullptr;
+    rateLimitWaiting = false;
+    buffer.reserve(16 * 1024);
+    readBuffer.reserve(16 * 1024);
+
+    timeoutTimer = new QTimer(this);
+    timeoutTimer->setSingleShot(true);
+    connect(timeoutTimer, SIGNAL(timeout()), this, SLOT(timeoutSlot()));
 
     setupSocket();
 
@@ -113,16 +125,19 @@ JulyHttp::JulyHttp(const QString& hostN, const QByteArray& restLine, QObject* pa
     }
 
     saveCookies();
-
-    secondTimer = new QTimer(this);
-    connect(secondTimer, SIGNAL(timeout()), this, SLOT(sendPendingData()));
-    secondTimer->start(300);
 }
 
 JulyHttp::~JulyHttp()
 {
-    delete secondTimer;
+    delete timeoutTimer;
     abortSocket();
+    qDeleteAll(freePacketsList);
+
+    if (gzipStream)
+    {
+        inflateEnd(gzipStream);
+        delete gzipStream;
+    }
 }
 
 void JulyHttp::setupSocket()
@@ -165,6 +180,12 @@ void JulyHttp::setupSocket()
 
     setPeerVerifyMode(QSslSocket::VerifyPeer);
     connect(this, SIGNAL(readyRead()), SLOT(readSocket()));
+
+    if (secureConnection)
+        connect(this, SIGNAL(encrypted()), this, SLOT(socketConnected()));
+    else
+        connect(this, SIGNAL(connected()), this, SLOT(socketConnected()));
+
     connect(this, SIGNAL(error(QAbstractSocket::SocketError)), this, SLOT(errorSlot(QAbstractSocket::SocketError)));
     connect(this, SIGNAL(sslErrors(const QList<QSslError>&)), this, SLOT(sslErrorsSlot(const QList<QSslError>&)));
 
@@ -173,9 +194,12 @@ void JulyHttp::setupSocket()
 
 void JulyHttp::clearPendingData()
 {
+    clearScheduledRequests();
+
     for (int n = requestList.count() - 1; n >= 0; n--)
         takeRequestAt(n);
 
+    updateDataPending();
     reConnect();
 }
 
@@ -207,22 +231,91 @@ void JulyHttp::reconnectSocket(bool forceAbort)
 
     if (state() == QAbstractSocket::UnconnectedState)
     {
+        currentPendingRequest = nullptr;
+
         if (secureConnection)
             connectToHostEncrypted(hostName, forcedPort ? forcedPort : 443, QIODevice::ReadWrite);
         else
             connectToHost(hostName, forcedPort ? forcedPort : 80, QIODevice::ReadWrite);
 
-        waitForConnected(((noReconnect && noReconnectCount++ > 5) ? 1000 : baseValues.httpRequestTimeout));
+        startTimeoutTimer();
+    }
+}
 
+void JulyHttp::socketConnected()
+{
 #ifdef Q_OS_WIN
-        setsockopt(this->socketDescriptor(), SOL_SOCKET, SO_RCVTIMEO, (const char*)&baseValues.httpRequestTimeout, sizeof(int));
+    setsockopt(this->socketDescriptor(), SOL_SOCKET, SO_RCVTIMEO, (const char*)&baseValues.httpRequestTimeout, sizeof(int));
 #else
-        struct timeval vtime;
-        vtime.tv_sec = baseValues.httpRequestTimeout / 1000;
-        vtime.tv_usec = baseValues.httpRequestTimeout * 1000 - vtime.tv_sec * 1000000;
-        setsockopt(this->socketDescriptor(), SOL_SOCKET, SO_RCVTIMEO, &vtime, sizeof(struct timeval));
+    struct timeval vtime;
+    vtime.tv_sec = baseValues.httpRequestTimeout / 1000;
+    vtime.tv_usec = baseValues.httpRequestTimeout * 1000 - vtime.tv_sec * 1000000;
+    setsockopt(this->socketDescriptor(), SOL_SOCKET, SO_RCVTIMEO, &vtime, sizeof(struct timeval));
 #endif
+
+    timeoutTimer->stop();
+    sendPendingData();
+}
+
+void JulyHttp::delayedReconnect()
+{
+    reconnectSocket(false);
+}
+
+void JulyHttp::rateLimitSlot()
+{
+    rateLimitWaiting = false;
+    sendPendingData();
+}
+
+int JulyHttp::requestTimeoutValue()
+{
+    return (noReconnect && noReconnectCount++ > 5) ? 1000 : baseValues.httpRequestTimeout;
+}
+
+void JulyHttp::startTimeoutTimer()
+{
+    requestTimeOut.restart();
+    timeoutTimer->start(requestTimeoutValue());
+}
+
+void JulyHttp::timeoutSlot()
+{
+    if (isDisabled)
+        return;
+
+    if (!isSocketConnected())
+    {
+        if (state() == QAbstractSocket::UnconnectedState)
+            return;
+
+        if (debugLevel)
+            logThread->writeLog(QString("Connection timeout: %0>%1").arg(requestTimeOut.elapsed()).arg(
+                                    baseValues.httpRequestTimeout).toLatin1(), 2);
+
+        setApiDown(true);
+        reconnectSocket(true);
+        return;
+    }
+
+    if (requestList.count() == 0 || currentPendingRequest != requestList.first().data)
+        return;
+
+    if (debugLevel)
+        logThread->writeLog(QString("Request timeout: %0>%1").arg(requestTimeOut.elapsed()).arg(
+                                baseValues.httpRequestTimeout).toLatin1(), 2);
+
+    setApiDown(true);
+
+    if (requestList.first().retryCount > 0)
+    {
+        if (debugLevel)
+            logThread->writeLog("Warning: Request resent due timeout", 2);
+
+        requestList[0].retryCount--;
     }
+
+    reconnectSocket(true);
 }
 
 void JulyHttp::setApiDown(bool httpError)
@@ -270,12 +363,15 @@ void JulyHttp::readSocket()
 
     requestTimeOut.restart();
 
+    if (timeoutTimer->isActive())
+        timeoutTimer->start();
+
     if (!waitingReplay)
     {
         httpState = 999;
         bytesDone = 0;
         connectionClose = false;
-        buffer.clear();
+        buffer.resize(0);
         contentGzipped = false;
         waitingReplay = true;
         readingHeader = true;
@@ -370,6 +466,8 @@ void JulyHttp::readSocket()
                 else if (currentLineLow.startsWith(QLatin1String("content-encoding")) &&
                          currentLineLow.contains(QLatin1String("gzip")))
                     contentGzipped = true;
+                else if (rateLimiter)
+                    rateLimiter->readHeader(currentLine);
             }
         }
 
@@ -389,6 +487,12 @@ void JulyHttp::readSocket()
         }
 
         readingHeader = false;
+
+        if (rateLimiter)
+            rateLimiter->responseReceived(httpState);
+
+        if (contentGzipped)
+            gzipBegin();
     }
 
     if (httpState < 400)
@@ -400,7 +504,13 @@ void JulyHttp::readSocket()
 
     addSpeedSize(readSize);
 
-    QScopedPointer<QByteArray> dataArray;
+    //Body bytes go straight to the response buffer; gzip data passes through readBuffer first
+    QByteArray& target = contentGzipped ? readBuffer : buffer;
+
+    if (contentGzipped)
+        readBuffer.resize(0);
+
+    int targetStart = target.size();
 
     if (chunkedSize != -1)
     {
@@ -463,13 +573,10 @@ void JulyHttp::readSocket()
 
             qint64 bytesToRead = chunkedSize < 0 ? readSize : qMin(readSize, chunkedSize);
 
-            if (!dataArray)
-                dataArray.reset(new QByteArray);
-
-            quint32 oldDataSize = dataArray->size();
-            dataArray->resize(oldDataSize + bytesToRead);
-            qint64 read = this->read(dataArray->data() + oldDataSize, bytesToRead);
-            dataArray->resize(oldDataSize + read);
+            int oldDataSize = target.size();
+            target.resize(oldDataSize + bytesToRead);
+            qint64 read = this->read(target.data() + oldDataSize, bytesToRead);
+            target.resize(oldDataSize + qMax(read, qint64(0)));
 
             chunkedSize -= read;
 
@@ -495,9 +602,8 @@ void JulyHttp::readSocket()
 
         if (readSize > 0)
         {
-            dataArray.reset(new QByteArray);
-            dataArray->resize(readSize);
-            dataArray->resize(read(dataArray->data(), readSize));
+            target.resize(targetStart + readSize);
+            target.resize(targetStart + qMax(read(target.data() + targetStart, readSize), qint64(0)));
         }
 
         if (bytesDone + bytesAvailable() + readSize == contentLength)
@@ -505,18 +611,16 @@ void JulyHttp::readSocket()
     }
     else if (readSize > 0)
     {
-        if (!dataArray)
-            dataArray.reset(new QByteArray(readAll()));
+        target.resize(targetStart + readSize);
+        target.resize(targetStart + qMax(read(target.data() + targetStart, readSize), qint64(0)));
     }
 
-    if (dataArray)
-    {
-        readSize = dataArray->size();
-
-        if (readSize > 0)
-            buffer.append(*dataArray);
+    readSize = target.size() - targetStart;
 
-        dataArray.reset();
+    if (readSize > 0)
+    {
+        if (contentGzipped)
+            gzipInflate(readBuffer);
 
         if (contentLength > 0)
         {
@@ -525,15 +629,10 @@ void JulyHttp::readSocket()
         }
     }
 
-    dataArray.reset();
-
     if (allDataReaded)
     {
         if (!buffer.isEmpty() && requestList.count())
         {
-            if (contentGzipped)
-                gzipUncompress(&buffer);
-
             bool apiMaybeDown = buffer[0] == '<';
             setApiDown(apiMaybeDown);
 
@@ -545,12 +644,19 @@ void JulyHttp::readSocket()
 
         waitingReplay = false;
         readingHeader = true;
+        timeoutTimer->stop();
 
         if (requestList.count())
             requestList[0].retryCount = 0;
 
         takeFirstRequest();
+
+        //gzipBegin may reserve up to 16 MB, a pooled connection keeps only what the last response needed
+        if (buffer.capacity() > qMax(buffer.size() * 4, 64 * 1024))
+            buffer.squeeze();
+
         clearRequest();
+        currentPendingRequest = nullptr;
 
         if (connectionClose)
         {
@@ -564,59 +670,80 @@ void JulyHttp::readSocket()
     }
 }
 
-void JulyHttp::gzipUncompress(QByteArray* data)
+void JulyHttp::gzipBegin()
 {
-    if (data->size() <= 4)
+    if (gzipStream == nullptr)
     {
-        if (debugLevel)
-            logThread->writeLog("GZIP: Input data is truncated", 2);
-
-        return;
+        gzipStream = new z_stream;
+        gzipStream->zalloc = nullptr;
+        gzipStream->zfree = nullptr;
+        gzipStream->opaque = nullptr;
+        gzipStream->avail_in = 0;
+        gzipStream->next_in = nullptr;
+
+        if (inflateInit2(gzipStream, 47) != Z_OK)
+        {
+            delete gzipStream;
+            gzipStream = nullptr;
+            gzipStreamEnded = true;
+            return;
+        }
     }
+    else
+        inflateReset(gzipStream);
 
-    QByteArray result;
+    gzipStreamEnded = false;
 
-    static const int CHUNK_SIZE = 1024;
-    char out[CHUNK_SIZE];
+    //JSON usually compresses 5-10 times, so reserve the expected output at once
+    static const int MAX_RESERVE_SIZE = 16 * 1024 * 1024;
+    buffer.reserve(contentLength > 0 ? int(qMin(quint64(contentLength) * 8, quint64(MAX_RESERVE_SIZE))) : 64 * 1024);
+}
 
-    z_stream strm;
-    strm.zalloc = nullptr;
-    strm.zfree = nullptr;
-    strm.opaque = nullptr;
-    strm.avail_in = data->size();
-    strm.next_in = (Bytef*)(data->data());
+void JulyHttp::gzipInflate(const QByteArray& data)
+{
+    if (gzipStreamEnded || gzipStream == nullptr)
+        return;
 
-    int ret = inflateInit2(&strm, 47);
+    static const int CHUNK_SIZE = 16 * 1024;
 
-    if (ret != Z_OK)
-        return;
+    gzipStream->avail_in = data.size();
+    gzipStream->next_in = (Bytef*)(data.constData());
 
     do
     {
-        strm.avail_out = CHUNK_SIZE;
-        strm.next_out = (Bytef*)(out);
+        int outSize = buffer.size();
+
+        if (buffer.capacity() - outSize < CHUNK_SIZE)
+            buffer.reserve(qMax(buffer.capacity() * 2, outSize + CHUNK_SIZE));
 
-        ret = inflate(&strm, Z_NO_FLUSH);
-        Q_ASSERT(ret != Z_STREAM_ERROR);
+        int freeSize = buffer.capacity() - outSize;
+        buffer.resize(outSize + freeSize);
 
-        switch (ret)
+        gzipStream->avail_out = freeSize;
+        gzipStream->next_out = (Bytef*)(buffer.data() + outSize);
+
+        int ret = inflate(gzipStream, Z_NO_FLUSH);
+        buffer.resize(outSize + freeSize - gzipStream->avail_out);
+
+        if (ret == Z_STREAM_END)
         {
-        case Z_NEED_DICT:
-            ret = Z_DATA_ERROR;
+            gzipStreamEnded = true;
             break;
-
-        case Z_DATA_ERROR:
-        case Z_MEM_ERROR:
-            (void)inflateEnd(&strm);
-            return;
         }
 
-        result.append(out, CHUNK_SIZE - strm.avail_out);
-    }
-    while (strm.avail_out == 0);
+        if (ret == Z_BUF_ERROR)
+            break;
+
+        if (ret != Z_OK)
+        {
+            if (debugLevel)
+                logThread->writeLog("GZIP: Invalid compressed data", 2);
 
-    inflateEnd(&strm);
-    (*data) = result;
+            gzipStreamEnded = true;
+            break;
+        }
+    }
+    while (gzipStream->avail_in > 0 || gzipStream->avail_out == 0);
 }
 
 bool JulyHttp::isReqTypePending(int val)
@@ -639,34 +766,96 @@ void JulyHttp::retryRequest()
         requestList[0].retryCount--;
     }
 
+    currentPendingRequest = nullptr;
     sendPendingData();
 }
 
 void JulyHttp::clearRequest()
 {
-    buffer.clear();
+    buffer.resize(0);
     chunkedSize = -1;
     nextPacketMustBeSize = false;
     endOfPacket = false;
 }
 
-void JulyHttp::prepareData(int reqType, const QByteArray& method, QByteArray postData, const QByteArray& restSignLine,
-                           const int& forceRetryCount)
+QByteArray* JulyHttp::takePacketData()
 {
-    if (isDisabled)
+    if (freePacketsList.isEmpty())
+        return new QByteArray;
+
+    return freePacketsList.takeLast();
+}
+
+void JulyHttp::releasePacketData(QByteArray* data)
+{
+    if (data == nullptr)
         return;
 
-    QByteArray* data = new QByteArray(method + httpHeader + cookieLine);
+    if (currentPendingRequest == data)
+        currentPendingRequest = nullptr;
+
+    static const int MAX_FREE_PACKETS = 32;
+
+    if (freePacketsList.count() >= MAX_FREE_PACKETS)
+    {
+        delete data;
+        return;
+    }
+
+    data->resize(0);
+    freePacketsList << data;
+}
+
+QByteArray* JulyHttp::buildRequest(const QByteArray& method, const QByteArray& postData, const QByteArray& restSignLine,
+                                   bool finishHeader)
+{
+    char contentLengthText[16];
+    int contentLengthSize = 0;
+
+    if (!postData.isEmpty())
+        contentLengthSize = qsnprintf(contentLengthText, sizeof(contentLengthText), "%d", postData.size());
+
+    int requestSize = method.size() + httpHeader.size() + cookieLine.size() + 2;
+
+    if (!restSignLine.isEmpty())
+        requestSize += restKeyLine.size() + restSignLine.size();
+
+    if (!postData.isEmpty())
+        requestSize += contentTypeLine.size() + 16 + contentLengthSize + 4 + postData.size();
+
+    QByteArray* data = takePacketData();
+    data->reserve(requestSize);
+    data->append(method);
+    data->append(httpHeader);
+    data->append(cookieLine);
 
     if (!restSignLine.isEmpty())
-        data->append(restKeyLine + restSignLine);
+    {
+        data->append(restKeyLine);
+        data->append(restSignLine);
+    }
 
     if (!postData.isEmpty())
     {
         data->append(contentTypeLine);
-        data->append("Content-Length: " + QByteArray::number(postData.size()) + "\r\n\r\n");
+        data->append("Content-Length: ", 16);
+        data->append(contentLengthText, contentLengthSize);
+        data->append("\r\n\r\n", 4);
         data->append(postData);
     }
+    else if (finishHeader)
+        data->append("\r\n", 2);
+
+    return data;
+}
+
+void JulyHttp::prepareData(int reqType, const QByteArray& method, QByteArray postData, const QByteArray& restSignLine,
+                           const int& forceRetryCount)
+{
+    if (isDisabled)
+        return;
+
+    QByteArray* data = buildRequest(method, postData, restSignLine, false);
 
     PacketItem newPacket;
     newPacket.data = data;
@@ -701,16 +890,9 @@ void JulyHttp::prepareDataSend()
         preparedList[n].skipOnce = true;
     }
 
-    for (int n = 0; n < preparedList.count(); n++)
-        requestList << preparedList.at(n);
-
+    schedulePackets(preparedList);
     preparedList.clear();
-
-    if (isDataPending != true)
-    {
-        emit setDataPending(true);
-        isDataPending = true;
-    }
+    sendPendingData();
 }
 
 void JulyHttp::prepareDataClear()
@@ -724,7 +906,7 @@ void JulyHttp::prepareDataClear()
         reqTypePending[preparingPacket.reqType] = reqTypePending.value(preparingPacket.reqType, 1) - 1;
 
         if (preparingPacket.data)
-            delete preparingPacket.data;
+            releasePacketData(preparingPacket.data);
     }
 
     preparedList.clear();
@@ -736,24 +918,7 @@ void JulyHttp::sendData(int reqType, const QByteArray& method, QByteArray postDa
     if (isDisabled)
         return;
 
-    QByteArray* data = new QByteArray(method + httpHeader + cookieLine);
-
-    if (!restSignLine.isEmpty())
-        data->append(restKeyLine + restSignLine);
-
-    if (!postData.isEmpty())
-    {
-        data->append(contentTypeLine);
-        data->append("Content-Length: " + QByteArray::number(postData.size()) + "\r\n\r\n");
-        data->append(postData);
-    }
-    else
-        data->append("\r\n");
-
-    if (reqType > 300)
-        for (int n = requestList.count() - 1; n >= 1; n--)
-            if (requestList.at(n).reqType < 300 && requestList[n].skipOnce != true)
-                takeRequestAt(n);
+    QByteArray* data = buildRequest(method, postData, restSignLine, true);
 
     PacketItem newPacket;
     newPacket.data = data;
@@ -774,16 +939,170 @@ void JulyHttp::sendData(int reqType, const QByteArray& method, QByteArray postDa
     if (newPacket.retryCount > 0 && debugLevel && newPacket.reqType > 299)
         logThread->writeLog("Added to Query RetryCount=" + QByteArray::number(newPacket.retryCount), 2);
 
-    requestList << newPacket;
+    scheduleRequest(newPacket);
+    sendPendingData();
+}
+
+void JulyHttp::scheduleRequest(PacketItem& packet)
+{
+    reqTypePending[packet.reqType] = reqTypePending.value(packet.reqType, 0) + 1;
+
+    QList<PacketItem> packets;
+    packets << packet;
+    schedulePackets(packets);
+}
+
+void JulyHttp::schedulePackets(QList<PacketItem>& packets)
+{
+    if (packets.isEmpty())
+        return;
+
+    bool isSigned = false;
+    bool isTrading = false;
 
-    if (isDataPending != true)
+    for (int n = 0; n < packets.count(); n++)
     {
-        emit setDataPending(true);
-        isDataPending = true;
+        isSigned = isSigned || packets.at(n).reqType >= 200;
+        isTrading = isTrading || packets.at(n).reqType > 300;
     }
 
-    reqTypePending[reqType] = reqTypePending.value(reqType, 0) + 1;
-    sendPendingData();
+    // Signed requests carry an increasing nonce, so they all share one queue and leave in signing order
+    QList<PacketItem>& queue = scheduledList[isSigned ? PrioritySigned : PriorityPublic];
+
+    if (isTrading)
+    {
+        for (int n = queue.count() - 1; n >= 0; n--)
+        {
+            if (queue.at(n).skipOnce)
+                continue;
+
+            bool isPoll = true;
+
+            for (int k = n; k <= n + queue.at(n).batchCount; k++)
+                isPoll = isPoll && queue.at(k).reqType < 300;
+
+            if (isPoll)
+            {
+                if (debugLevel)
+                    logThread->writeLog("Dropped poll before trade ID: " + QByteArray::number(queue.at(n).reqType), 2);
+
+                dropScheduledAt(queue, n);
+            }
+        }
+    }
+    else
+        packets[0].deadline = deadlineTimer.elapsed() + qMax(baseValues.httpRequestTimeout,
+                                                             baseValues.httpRequestInterval);
+
+    packets[0].batchCount = packets.count() - 1;
+    queue << packets;
+    scheduledCount += packets.count();
+    updateDataPending();
+}
+
+void JulyHttp::dropScheduledAt(QList<PacketItem>& queue, int pos)
+{
+    int packetsCount = 1 + queue.at(pos).batchCount;
+
+    for (int n = 0; n < packetsCount; n++)
+    {
+        PacketItem packet = queue.takeAt(pos);
+        reqTypePending[packet.reqType] = reqTypePending.value(packet.reqType, 1) - 1;
+        releasePacketData(packet.data);
+    }
+
+    scheduledCount -= packetsCount;
+}
+
+bool JulyHttp::takeScheduledRequest()
+{
+    qint64 currentTime = deadlineTimer.elapsed();
+    int rateLimitWait = 0;
+
+    for (int priority = 0; priority < PriorityCount; priority++)
+    {
+        QList<PacketItem>& queue = scheduledList[priority];
+
+        while (!queue.isEmpty())
+        {
+            const PacketItem& packet = queue.first();
+
+            if (packet.deadline != 0 && packet.deadline < currentTime)
+            {
+                if (debugLevel)
+                    logThread->writeLog("Dropped stale request ID: " + QByteArray::number(packet.reqType), 2);
+
+                dropScheduledAt(queue, 0);
+                continue;
+            }
+
+            //Out of budget: signed requests keep waiting in order, only unsigned ones may go meanwhile
+            if (rateLimiter && !rateLimiter->tryAcquire(packet.reqType))
+            {
+                int wait = rateLimiter->waitTime(packet.reqType);
+
+                if (rateLimitWait == 0 || wait < rateLimitWait)
+                    rateLimitWait = wait;
+
+                break;
+            }
+
+            int packetsCount = 1 + packet.batchCount;
+
+            for (int n = 0; n < packetsCount; n++)
+            {
+                //Pipelined requests are written at once, each still takes its cost from the budget
+                if (n > 0 && rateLimiter)
+                    rateLimiter->tryAcquire(queue.first().reqType);
+
+                requestList << queue.takeFirst();
+            }
+
+            scheduledCount -= packetsCount;
+            return true;
+        }
+    }
+
+    if (rateLimitWait > 0 && !rateLimitWaiting)
+    {
+        rateLimitWaiting = true;
+        QTimer::singleShot(rateLimitWait, this, SLOT(rateLimitSlot()));
+    }
+
+    updateDataPending();
+    return false;
+}
+
+void JulyHttp::clearScheduledRequests()
+{
+    for (int priority = 0; priority < PriorityCount; priority++)
+    {
+        QList<PacketItem>& queue = scheduledList[priority];
+
+        for (int n = 0; n < queue.count(); n++)
+        {
+            reqTypePending[queue.at(n).reqType] = reqTypePending.value(queue.at(n).reqType, 1) - 1;
+            releasePacketData(queue.at(n).data);
+        }
+
+        queue.clear();
+    }
+
+    scheduledCount = 0;
+}
+
+void JulyHttp::updateDataPending()
+{
+    bool currentDataPending = requestList.count() > 0 || scheduledCount > 0;
+
+    if (!currentDataPending)
+        reqTypePending.clear();
+
+    if (isDataPending != currentDataPending)
+    {
+        isDataPending = currentDataPending;
+        emit setDataPending(isDataPending);
+    }
 }
 
 void JulyHttp::takeRequestAt(int pos)
@@ -794,20 +1113,12 @@ void JulyHttp::takeRequestAt(int pos)
     PacketItem packetTake = requestList.at(pos);
     reqTypePending[packetTake.reqType] = reqTypePending.value(packetTake.reqType, 1) - 1;
 
-    delete packetTake.data;
+    releasePacketData(packetTake.data);
     packetTake.data = 0;
     requestList.removeAt(pos);
 
     if (requestList.count() == 0)
-    {
-        reqTypePending.clear();
-
-        if (isDataPending != false)
-        {
-            emit setDataPending(false);
-            isDataPending = false;
-        }
-    }
+        updateDataPending();
 }
 
 void JulyHttp::takeFirstRequest()
@@ -844,21 +1155,15 @@ void JulyHttp::errorSlot(QAbstractSocket::SocketError socketError)
     }
     else
     {
-        QMutex mutex;
-        mutex.lock();
-
-        QWaitCondition waitCondition;
-        waitCondition.wait(&mutex, 1000);
-
-        mutex.unlock();
-
-        reconnectSocket(false);
+        currentPendingRequest = nullptr;
+        timeoutTimer->stop();
+        QTimer::singleShot(1000, this, SLOT(delayedReconnect()));
     }
 }
 
 bool JulyHttp::isSocketConnected()
 {
-    return state() == QAbstractSocket::ConnectedState;
+    return state() == QAbstractSocket::ConnectedState && (!secureConnection || isEncrypted());
 }
 
 void JulyHttp::sendPendingData()
@@ -866,70 +1171,29 @@ void JulyHttp::sendPendingData()
     if (isDisabled)
         return;
 
-    if (requestList.count() == 0)
+    if (requestList.count() == 0 && scheduledCount == 0)
         return;
 
     if (!isSocketConnected())
-        reconnectSocket(false);
-
-    if (state() != QAbstractSocket::UnconnectedState)
     {
-        if (state() == QAbstractSocket::ConnectingState || state() == QAbstractSocket::HostLookupState)
-            waitForConnected(((noReconnect && noReconnectCount++ > 5) ? 1000 : baseValues.httpRequestTimeout + 1000));
-    }
-
-    if (!noReconnect)
-    {
-        if (!isSocketConnected())
-        {
-            setApiDown(true);
-
-            if (debugLevel)
-                logThread->writeLog("Socket state: " + errorString().toUtf8(), 2);
-
-            reconnectSocket(false);
-
-            if (state() == QAbstractSocket::ConnectingState)
-                waitForConnected(baseValues.httpRequestTimeout + 1000);
-        }
-        else
-            reconnectSocket(false);
+        reconnectSocket(false);
+        return;
     }
 
-    if (!isSocketConnected())
+    if (requestList.count() == 0 && !takeScheduledRequest())
         return;
 
     if (currentPendingRequest == requestList.first().data)
-    {
-        if (requestTimeOut.elapsed() < ((noReconnect && noReconnectCount++ > 5) ? 1000 : baseValues.httpRequestTimeout))
-            return;
-        else
-        {
-            if (debugLevel)
-                logThread->writeLog(QString("Request timeout: %0>%1").arg(requestTimeOut.elapsed()).arg(
-                                        baseValues.httpRequestTimeout).toLatin1(), 2);
-
-            reconnectSocket(true);
-            setApiDown(true);
+        return;
 
-            if (requestList.first().retryCount > 0)
-            {
-                retryRequest();
-                return;
-            }
-        }
-    }
-    else
-    {
-        currentPendingRequest = requestList.first().data;
+    currentPendingRequest = requestList.first().data;
 
-        if (debugLevel && requestList.first().reqType > 299)
-            logThread->writeLog("Sending request ID: " + QByteArray::number(requestList.first().reqType), 2);
-    }
+    if (debugLevel && requestList.first().reqType > 299)
+        logThread->writeLog("Sending request ID: " + QByteArray::number(requestList.first().reqType), 2);
 
     clearRequest();
 
-    requestTimeOut.restart();
+    startTimeoutTimer();
 
     if (debugLevel && currentPendingRequest)
         logThread->writeLog("SND: " + QByteArray(*currentPendingRequest).replace(baseValues.restKey, "REST_KEY"));
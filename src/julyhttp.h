@@ -35,19 +35,24 @@
 #include <QObject>
 #include <QSslSocket>
 #include <QTime>
+#include <QElapsedTimer>
 #include <QNetworkCookie>
 
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
 
 class QTimer;
+class JulyRateLimiter;
+struct z_stream_s;
 
 struct PacketItem
 {
     QByteArray* data = nullptr;
     int reqType = 0;
     int retryCount = 0;
+    qint64 deadline = 0;//0: never expires
     bool skipOnce = false;
+    int batchCount = 0;//Pipelined packets that follow and are written together with this one
 };
 
 class JulyHttp : public QSslSocket
@@ -58,11 +63,14 @@ public:
     bool noReconnect;
     bool destroyClass;
     bool ignoreError;
-    QTimer* secondTimer;
     uint getCurrentPacketContentLength() const
     {
         return contentLength;
     }
+    int pendingRequestsCount() const
+    {
+        return requestList.count() + scheduledCount;
+    }
     void clearPendingData();
     void reConnect(bool forceAbort = true);
     bool isReqTypePending(int);
@@ -83,10 +91,21 @@ public:
         forcedPort = port;
     }
 
+    void setRateLimiter(JulyRateLimiter* limiter)
+    {
+        rateLimiter = limiter;
+    }
+
     static bool requestWait(const QUrl& url, QByteArray& result, QString* errorString = nullptr);
 private:
     quint16 forcedPort;
     QByteArray outBuffer;
+    QByteArray readBuffer;
+    QList<QByteArray*> freePacketsList;
+    QByteArray* takePacketData();
+    void releasePacketData(QByteArray* data);
+    QByteArray* buildRequest(const QByteArray& method, const QByteArray& postData, const QByteArray& restSignLine,
+                             bool finishHeader);
     QByteArray contentTypeLine;
     int noReconnectCount;
     void addSpeedSize(qint64);
@@ -95,7 +114,10 @@ private:
     int apiDownCounter;
     bool secureConnection;
     bool isDataPending;
-    void gzipUncompress(QByteArray* data);
+    void gzipBegin();
+    void gzipInflate(const QByteArray& data);
+    z_stream_s* gzipStream;
+    bool gzipStreamEnded;
     bool contentGzipped;
     QByteArray* currentPendingRequest;
     bool connectionClose;
@@ -107,6 +129,9 @@ private:
     qint64 chunkedSize;
 
     void abortSocket();
+    int requestTimeoutValue();
+    void startTimeoutTimer();
+    QTimer* timeoutTimer;
     bool isDisabled;
     QByteArray cookieLine;
     int outGoingPacketsCount;
@@ -126,6 +151,25 @@ private:
     QList<PacketItem>requestList;
     QMap<int, int> reqTypePending;
 
+    enum RequestPriority
+    {
+        PrioritySigned = 0,
+        PriorityPublic,
+        PriorityCount
+    };
+
+    void scheduleRequest(PacketItem& packet);
+    void schedulePackets(QList<PacketItem>& packets);
+    void dropScheduledAt(QList<PacketItem>& queue, int pos);
+    bool takeScheduledRequest();
+    void clearScheduledRequests();
+    void updateDataPending();
+    QList<PacketItem> scheduledList[PriorityCount];
+    int scheduledCount;
+    QElapsedTimer deadlineTimer;
+    JulyRateLimiter* rateLimiter;
+    bool rateLimitWaiting;
+
     QList<PacketItem>preparedList;
 
     void takeFirstRequest();
@@ -139,6 +183,10 @@ private slots:
     void errorSlot(QAbstractSocket::SocketError);
     void sendPendingData();
     void readSocket();
+    void socketConnected();
+    void timeoutSlot();
+    void delayedReconnect();
+    void rateLimitSlot();
 
 signals:
     void setDataPending(bool);
@@ -0,0 +1,277 @@
+//  This file is part of Qt Bitcoin Trader
+//      https://github.com/JulyIGHOR/QtBitcoinTrader
+//  Copyright (C) 2013-2018 July IGHOR <julyighor@gmail.com>
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  In addition, as a special exception, the copyright holders give
+//  permission to link the code of portions of this program with the
+//  OpenSSL library under certain conditions as described in each
+//  individual source file, and distribute linked combinations including
+//  the two.
+//
+//  You must obey the GNU General Public License in all respects for all
+//  of the code used other than OpenSSL. If you modify file(s) with this
+//  exception, you may extend this exception to your version of the
+//  file(s), but you are not obligated to do so. If you do not wish to do
+//  so, delete this exception statement from your version. If you delete
+//  this exception statement from all source files in the program, then
+//  also delete it here.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "julyhttppool.h"
+#include "main.h"
+
+JulyHttpPool::JulyHttpPool(const QString& hostName, const QByteArray& restKeyLine, QObject* parent, const bool& secure,
+                           const bool& keepAlive, const QByteArray& contentType)
+    : QObject(parent),
+      fastLane(nullptr),
+      requestsLimit(qMax(1, baseValues.httpConnectionRequestsLimit)),
+      isDataPending(false),
+      apiDownState(false)
+{
+    fastLane = createConnection(hostName, restKeyLine, secure, keepAlive, contentType);
+
+    int publicCount = baseValues.httpConnectionsCount - 1;
+
+    for (int n = 0; n < publicCount; n++)
+        publicLanes << createConnection(hostName, restKeyLine, secure, keepAlive, contentType);
+
+    if (publicLanes.isEmpty())
+        publicLanes << fastLane;
+}
+
+JulyHttpPool::~JulyHttpPool()
+{
+    for (int n = 0; n < publicLanes.count(); n++)
+        if (publicLanes.at(n) != fastLane)
+            delete publicLanes.at(n);
+
+    delete fastLane;
+}
+
+JulyHttp* JulyHttpPool::createConnection(const QString& hostName, const QByteArray& restKeyLine, const bool& secure,
+                                         const bool& keepAlive, const QByteArray& contentType)
+{
+    JulyHttp* connection = new JulyHttp(hostName, restKeyLine, this, secure, keepAlive, contentType);
+    connect(connection, SIGNAL(anyDataReceived()), this, SIGNAL(anyDataReceived()));
+    connect(connection, SIGNAL(errorSignal(QString)), this, SIGNAL(errorSignal(QString)));
+    connect(connection, SIGNAL(sslErrorSignal(const QList<QSslError>&)), this, SIGNAL(sslErrorSignal(const QList<QSslError>&)));
+    connect(connection, SIGNAL(apiDown(bool)), this, SLOT(connectionApiDown(bool)));
+    connect(connection, SIGNAL(setDataPending(bool)), this, SLOT(connectionDataPending(bool)));
+    connect(connection, SIGNAL(dataReceived(QByteArray, int)), this, SLOT(connectionDataReceived(QByteArray, int)));
+    return connection;
+}
+
+void JulyHttpPool::setPortForced(quint16 port)
+{
+    fastLane->setPortForced(port);
+
+    for (int n = 0; n < publicLanes.count(); n++)
+        publicLanes.at(n)->setPortForced(port);
+}
+
+void JulyHttpPool::setRateLimiter(JulyRateLimiter* limiter)
+{
+    fastLane->setRateLimiter(limiter);
+
+    for (int n = 0; n < publicLanes.count(); n++)
+        publicLanes.at(n)->setRateLimiter(limiter);
+}
+
+void JulyHttpPool::clearPendingData()
+{
+    pendingList.clear();
+    fastLane->clearPendingData();
+
+    for (int n = 0; n < publicLanes.count(); n++)
+        if (publicLanes.at(n) != fastLane)
+            publicLanes.at(n)->clearPendingData();
+
+    updateDataPending();
+}
+
+bool JulyHttpPool::isReqTypePending(int reqType)
+{
+    for (int n = 0; n < pendingList.count(); n++)
+        if (pendingList.at(n).reqType == reqType)
+            return true;
+
+    for (int n = 0; n < preparedList.count(); n++)
+        if (preparedList.at(n).reqType == reqType)
+            return true;
+
+    if (fastLane->isReqTypePending(reqType))
+        return true;
+
+    for (int n = 0; n < publicLanes.count(); n++)
+        if (publicLanes.at(n)->isReqTypePending(reqType))
+            return true;
+
+    return false;
+}
+
+JulyHttp* JulyHttpPool::freePublicConnection()
+{
+    JulyHttp* result = nullptr;
+
+    for (int n = 0; n < publicLanes.count(); n++)
+    {
+        JulyHttp* connection = publicLanes.at(n);
+
+        if (connection->pendingRequestsCount() >= requestsLimit)
+            continue;
+
+        if (result == nullptr || connection->pendingRequestsCount() < result->pendingRequestsCount())
+            result = connection;
+    }
+
+    return result;
+}
+
+JulyHttp* JulyHttpPool::connectionForRequest(int reqType)
+{
+    if (reqType >= 200)
+        return fastLane;
+
+    return freePublicConnection();
+}
+
+void JulyHttpPool::sendData(int reqType, const QByteArray& method, QByteArray postData, const QByteArray& restSignLine,
+                            const int& forceRetryCount)
+{
+    JulyHttp* connection = nullptr;
+
+    if (pendingList.isEmpty() || reqType >= 200)
+        connection = connectionForRequest(reqType);
+
+    if (connection)
+    {
+        connection->sendData(reqType, method, postData, restSignLine, forceRetryCount);
+        return;
+    }
+
+    PoolItem newItem;
+    newItem.reqType = reqType;
+    newItem.method = method;
+    newItem.postData = postData;
+    newItem.restSignLine = restSignLine;
+    newItem.forceRetryCount = forceRetryCount;
+    pendingList << newItem;
+
+    updateDataPending();
+}
+
+void JulyHttpPool::prepareData(int reqType, const QByteArray& method, QByteArray postData, const QByteArray& restSignLine,
+                               const int& forceRetryCount)
+{
+    PoolItem newItem;
+    newItem.reqType = reqType;
+    newItem.method = method;
+    newItem.postData = postData;
+    newItem.restSignLine = restSignLine;
+    newItem.forceRetryCount = forceRetryCount;
+    preparedList << newItem;
+}
+
+void JulyHttpPool::prepareDataSend()
+{
+    if (preparedList.isEmpty())
+        return;
+
+    JulyHttp* connection = nullptr;
+
+    for (int n = 0; n < preparedList.count(); n++)
+        if (preparedList.at(n).reqType >= 200)
+            connection = fastLane;
+
+    if (connection == nullptr)
+        connection = freePublicConnection();
+
+    if (connection == nullptr)
+        connection = publicLanes.first();
+
+    for (int n = 0; n < preparedList.count(); n++)
+    {
+        const PoolItem& item = preparedList.at(n);
+        connection->prepareData(item.reqType, item.method, item.postData, item.restSignLine, item.forceRetryCount);
+    }
+
+    preparedList.clear();
+    connection->prepareDataSend();
+}
+
+void JulyHttpPool::prepareDataClear()
+{
+    preparedList.clear();
+}
+
+void JulyHttpPool::dispatchPending()
+{
+    while (!pendingList.isEmpty())
+    {
+        JulyHttp* connection = freePublicConnection();
+
+        if (connection == nullptr)
+            break;
+
+        PoolItem item = pendingList.takeFirst();
+        connection->sendData(item.reqType, item.method, item.postData, item.restSignLine, item.forceRetryCount);
+    }
+
+    updateDataPending();
+}
+
+void JulyHttpPool::updateDataPending()
+{
+    bool currentDataPending = !pendingList.isEmpty() || fastLane->pendingRequestsCount() > 0;
+
+    for (int n = 0; !currentDataPending && n < publicLanes.count(); n++)
+        currentDataPending = publicLanes.at(n)->pendingRequestsCount() > 0;
+
+    if (isDataPending != currentDataPending)
+    {
+        isDataPending = currentDataPending;
+        emit setDataPending(isDataPending);
+    }
+}
+
+void JulyHttpPool::connectionDataReceived(QByteArray data, int reqType)
+{
+    emit dataReceived(data, reqType);
+    dispatchPending();
+}
+
+void JulyHttpPool::connectionDataPending(bool pending)
+{
+    if (pending)
+        updateDataPending();
+    else
+        dispatchPending();
+}
+
+void JulyHttpPool::connectionApiDown(bool down)
+{
+    if (down)
+        apiDownSet.insert(sender());
+    else
+        apiDownSet.remove(sender());
+
+    bool currentApiDownState = !apiDownSet.isEmpty();
+
+    if (apiDownState != currentApiDownState)
+    {
+        apiDownState = currentApiDownState;
+        emit apiDown(apiDownState);
+    }
+}
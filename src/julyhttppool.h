@@ -0,0 +1,105 @@
+//  This file is part of Qt Bitcoin Trader
+//      https://github.com/JulyIGHOR/QtBitcoinTrader
+//  Copyright (C) 2013-2018 July IGHOR <julyighor@gmail.com>
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  In addition, as a special exception, the copyright holders give
+//  permission to link the code of portions of this program with the
+//  OpenSSL library under certain conditions as described in each
+//  individual source file, and distribute linked combinations including
+//  the two.
+//
+//  You must obey the GNU General Public License in all respects for all
+//  of the code used other than OpenSSL. If you modify file(s) with this
+//  exception, you may extend this exception to your version of the
+//  file(s), but you are not obligated to do so. If you do not wish to do
+//  so, delete this exception statement from your version. If you delete
+//  this exception statement from all source files in the program, then
+//  also delete it here.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef JULYHTTPPOOL_H
+#define JULYHTTPPOOL_H
+
+#include <QObject>
+#include <QSet>
+#include "julyhttp.h"
+
+struct PoolItem
+{
+    int reqType = 0;
+    QByteArray method;
+    QByteArray postData;
+    QByteArray restSignLine;
+    int forceRetryCount = -1;
+};
+
+// Keeps several keep-alive JulyHttp connections to one host.
+// Private and trading requests (reqType >= 200) always go through the dedicated
+// fast lane connection in order, so nonces stay monotonic and orders never wait
+// behind market data. Public requests are spread over the remaining connections.
+class JulyHttpPool : public QObject
+{
+    Q_OBJECT
+
+public:
+    void clearPendingData();
+    bool isReqTypePending(int);
+    void sendData(int reqType, const QByteArray& method, QByteArray postData = nullptr, const QByteArray& restSignLine = nullptr,
+                  const int& forceRetryCount = -1);
+
+    void prepareData(int reqType, const QByteArray& method, QByteArray postData = nullptr, const QByteArray& restSignLine = nullptr,
+                     const int& forceRetryCount = -1);
+    void prepareDataSend();
+    void prepareDataClear();
+
+    void setPortForced(quint16 port);
+    void setRateLimiter(JulyRateLimiter* limiter);
+
+    JulyHttpPool(const QString& hostName, const QByteArray& restKeyLine, QObject* parent, const bool& secure = true,
+                 const bool& keepAlive = true, const QByteArray& contentType = "application/x-www-form-urlencoded");
+    ~JulyHttpPool();
+
+private:
+    JulyHttp* createConnection(const QString& hostName, const QByteArray& restKeyLine, const bool& secure,
+                               const bool& keepAlive, const QByteArray& contentType);
+    JulyHttp* connectionForRequest(int reqType);
+    JulyHttp* freePublicConnection();
+    void dispatchPending();
+    void updateDataPending();
+
+    JulyHttp* fastLane;
+    QList<JulyHttp*> publicLanes;
+    QList<PoolItem> pendingList;
+    QList<PoolItem> preparedList;
+    QSet<QObject*> apiDownSet;
+    int requestsLimit;
+    bool isDataPending;
+    bool apiDownState;
+
+private slots:
+    void connectionDataReceived(QByteArray, int);
+    void connectionDataPending(bool);
+    void connectionApiDown(bool);
+
+signals:
+    void setDataPending(bool);
+    void anyDataReceived();
+    void errorSignal(QString);
+    void sslErrorSignal(const QList<QSslError>&);
+    void apiDown(bool);
+    void dataReceived(QByteArray, int);
+};
+
+#endif // JULYHTTPPOOL_H
@@ -0,0 +1,315 @@
+//  This file is part of Qt Bitcoin Trader
+//      https://github.com/JulyIGHOR/QtBitcoinTrader
+//  Copyright (C) 2013-2018 July IGHOR <julyighor@gmail.com>
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  In addition, as a special exception, the copyright holders give
+//  permission to link the code of portions of this program with the
+//  OpenSSL library under certain conditions as described in each
+//  individual source file, and distribute linked combinations including
+//  the two.
+//
+//  You must obey the GNU General Public License in all respects for all
+//  of the code used other than OpenSSL. If you modify file(s) with this
+//  exception, you may extend this exception to your version of the
+//  file(s), but you are not obligated to do so. If you do not wish to do
+//  so, delete this exception statement from your version. If you delete
+//  this exception statement from all source files in the program, then
+//  also delete it here.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "julyjson.h"
+#include "julydecimal.h"
+#include <cstring>
+
+JulyJsonValue::JulyJsonValue()
+    : valueBegin(nullptr),
+      valueEnd(nullptr),
+      valueType(Invalid)
+{
+}
+
+JulyJsonValue JulyJsonValue::fromData(const QByteArray& data)
+{
+    JulyJsonValue result;
+    const char* end = data.constData() + data.size();
+
+    if (parseValue(data.constData(), end, &result) == nullptr)
+        return JulyJsonValue();
+
+    return result;
+}
+
+const char* JulyJsonValue::skipSpaces(const char* pos, const char* end)
+{
+    while (pos < end && (*pos == ' ' || *pos == '\n' || *pos == '\r' || *pos == '\t'))
+        ++pos;
+
+    return pos;
+}
+
+const char* JulyJsonValue::parseValue(const char* pos, const char* end, JulyJsonValue* result)
+{
+    pos = skipSpaces(pos, end);
+
+    if (pos >= end)
+        return nullptr;
+
+    const char* start = pos;
+    Type type = Invalid;
+
+    switch (*pos)
+    {
+        case '"':
+            {
+                ++pos;
+
+                while (pos < end && *pos != '"')
+                    pos += *pos == '\\' ? 2 : 1;
+
+                if (pos >= end)
+                    return nullptr;
+
+                result->valueBegin = start + 1;
+                result->valueEnd = pos;
+                result->valueType = String;
+                return pos + 1;
+            }
+
+        case '{':
+        case '[':
+            {
+                // One pass over the container, strings are skipped so their brackets do not count
+                int depth = 0;
+                type = *pos == '{' ? Object : Array;
+
+                for (; pos < end; ++pos)
+                {
+                    if (*pos == '"')
+                    {
+                        ++pos;
+
+                        while (pos < end && *pos != '"')
+                            pos += *pos == '\\' ? 2 : 1;
+
+                        if (pos >= end)
+                            return nullptr;
+                    }
+                    else if (*pos == '{' || *pos == '[')
+                        ++depth;
+                    else if ((*pos == '}' || *pos == ']') && --depth == 0)
+                        break;
+                }
+
+                if (pos >= end)
+                    return nullptr;
+
+                ++pos;
+                break;
+            }
+
+        case 't':
+        case 'f':
+        case 'n':
+            type = *pos == 'n' ? Null : Bool;
+
+            while (pos < end && *pos >= 'a' && *pos <= 'z')
+                ++pos;
+
+            break;
+
+        default:
+            type = Number;
+
+            while (pos < end && ((*pos >= '0' && *pos <= '9') || *pos == '-' || *pos == '+' || *pos == '.' || *pos == 'e' ||
+                                 *pos == 'E'))
+                ++pos;
+
+            if (pos == start)
+                return nullptr;
+
+            break;
+    }
+
+    result->valueBegin = start;
+    result->valueEnd = pos;
+    result->valueType = type;
+    return pos;
+}
+
+bool JulyJsonValue::operator==(const char* text) const
+{
+    int textSize = int(qstrlen(text));
+    return textSize == size() && (textSize == 0 || memcmp(valueBegin, text, textSize) == 0);
+}
+
+QByteArray JulyJsonValue::toByteArray() const
+{
+    if (valueType != String)
+        return QByteArray(valueBegin, size());
+
+    QByteArray result;
+    result.reserve(size());
+
+    for (const char* pos = valueBegin; pos < valueEnd; ++pos)
+    {
+        if (*pos == '\\' && pos + 1 < valueEnd)
+        {
+            ++pos;
+
+            switch (*pos)
+            {
+                case 'n':
+                    result.append('\n');
+                    break;
+
+                case 't':
+                    result.append('\t');
+                    break;
+
+                case 'r':
+                    result.append('\r');
+                    break;
+
+                case 'u':
+                    //Unicode escapes are left for Exchange::translateUnicodeStr
+                    result.append("\\u");
+                    break;
+
+                default:
+                    result.append(*pos);
+                    break;
+            }
+        }
+        else
+            result.append(*pos);
+    }
+
+    return result;
+}
+
+double JulyJsonValue::toDouble() const
+{
+    if (valueType != Number && valueType != String)
+        return 0.0;
+
+    return JulyDecimal::toDouble(valueBegin, valueEnd);
+}
+
+qint64 JulyJsonValue::toLongLong() const
+{
+    if (valueType != Number && valueType != String)
+        return 0;
+
+    return JulyDecimal::toLongLong(valueBegin, valueEnd);
+}
+
+qint64 JulyJsonValue::toScaled(int decimals) const
+{
+    if (valueType != Number && valueType != String)
+        return 0;
+
+    return JulyDecimal::toScaled(valueBegin, valueEnd, decimals);
+}
+
+bool JulyJsonValue::toBool() const
+{
+    return valueType == Bool && *valueBegin == 't';
+}
+
+JulyJsonValue JulyJsonValue::value(const char* key) const
+{
+    JulyJsonIterator iterator(*this);
+
+    while (iterator.next())
+        if (iterator.key() == key)
+            return iterator.value();
+
+    return JulyJsonValue();
+}
+
+JulyJsonValue JulyJsonValue::at(int index) const
+{
+    JulyJsonIterator iterator(*this);
+
+    while (iterator.next())
+        if (index-- == 0)
+            return iterator.value();
+
+    return JulyJsonValue();
+}
+
+int JulyJsonValue::count() const
+{
+    int result = 0;
+    JulyJsonIterator iterator(*this);
+
+    while (iterator.next())
+        ++result;
+
+    return result;
+}
+
+JulyJsonIterator::JulyJsonIterator(const JulyJsonValue& container)
+    : pos(nullptr),
+      end(nullptr),
+      isObject(container.isObject())
+{
+    if (container.isObject() || container.isArray())
+    {
+        pos = container.valueBegin + 1;
+        end = container.valueEnd - 1;
+    }
+}
+
+bool JulyJsonIterator::next()
+{
+    if (pos == nullptr)
+        return false;
+
+    pos = JulyJsonValue::skipSpaces(pos, end);
+
+    if (pos < end && *pos == ',')
+        pos = JulyJsonValue::skipSpaces(pos + 1, end);
+
+    if (pos >= end)
+    {
+        pos = nullptr;
+        return false;
+    }
+
+    if (isObject)
+    {
+        pos = JulyJsonValue::parseValue(pos, end, &currentKey);
+
+        if (pos == nullptr || !currentKey.isString())
+        {
+            pos = nullptr;
+            return false;
+        }
+
+        pos = JulyJsonValue::skipSpaces(pos, end);
+
+        if (pos >= end || *pos != ':')
+        {
+            pos = nullptr;
+            return false;
+        }
+
+        ++pos;
+    }
+
+    pos = JulyJsonValue::parseValue(pos, end, &currentValue);
+    return pos != nullptr;
+}
@@ -0,0 +1,138 @@
+//  This file is part of Qt Bitcoin Trader
+//      https://github.com/JulyIGHOR/QtBitcoinTrader
+//  Copyright (C) 2013-2018 July IGHOR <julyighor@gmail.com>
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  In addition, as a special exception, the copyright holders give
+//  permission to link the code of portions of this program with the
+//  OpenSSL library under certain conditions as described in each
+//  individual source file, and distribute linked combinations including
+//  the two.
+//
+//  You must obey the GNU General Public License in all respects for all
+//  of the code used other than OpenSSL. If you modify file(s) with this
+//  exception, you may extend this exception to your version of the
+//  file(s), but you are not obligated to do so. If you do not wish to do
+//  so, delete this exception statement from your version. If you delete
+//  this exception statement from all source files in the program, then
+//  also delete it here.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef JULYJSON_H
+#define JULYJSON_H
+
+#include <QByteArray>
+
+// Read-only view of one JSON value inside a reply.
+// Nothing is copied, so the QByteArray it was made from must outlive every view of it.
+// String views point at the text between the quotes, numbers and literals at their own bytes.
+class JulyJsonValue
+{
+public:
+    enum Type
+    {
+        Invalid = 0,
+        Null,
+        Bool,
+        Number,
+        String,
+        Array,
+        Object
+    };
+
+    JulyJsonValue();
+    static JulyJsonValue fromData(const QByteArray& data);
+
+    Type type() const
+    {
+        return valueType;
+    }
+    bool isValid() const
+    {
+        return valueType != Invalid;
+    }
+    bool isObject() const
+    {
+        return valueType == Object;
+    }
+    bool isArray() const
+    {
+        return valueType == Array;
+    }
+    bool isString() const
+    {
+        return valueType == String;
+    }
+    const char* data() const
+    {
+        return valueBegin;
+    }
+    int size() const
+    {
+        return int(valueEnd - valueBegin);
+    }
+
+    bool operator==(const char* text) const;
+    bool operator!=(const char* text) const
+    {
+        return !operator==(text);
+    }
+
+    QByteArray toByteArray() const;
+    double toDouble() const;
+    qint64 toLongLong() const;
+    qint64 toScaled(int decimals) const;
+    bool toBool() const;
+
+    JulyJsonValue value(const char* key) const;
+    JulyJsonValue at(int index) const;
+    int count() const;
+
+private:
+    friend class JulyJsonIterator;
+
+    const char* valueBegin;
+    const char* valueEnd;
+    Type valueType;
+
+    static const char* skipSpaces(const char* pos, const char* end);
+    static const char* parseValue(const char* pos, const char* end, JulyJsonValue* result);
+};
+
+// Walks the members of an object or the items of an array once, front to back.
+// For arrays key() stays invalid.
+class JulyJsonIterator
+{
+public:
+    explicit JulyJsonIterator(const JulyJsonValue& container);
+
+    bool next();
+    const JulyJsonValue& key() const
+    {
+        return currentKey;
+    }
+    const JulyJsonValue& value() const
+    {
+        return currentValue;
+    }
+
+private:
+    const char* pos;
+    const char* end;
+    bool isObject;
+    JulyJsonValue currentKey;
+    JulyJsonValue currentValue;
+};
+
+#endif // JULYJSON_H
@@ -0,0 +1,224 @@
+//  This file is part of Qt Bitcoin Trader
+//      https://github.com/JulyIGHOR/QtBitcoinTrader
+//  Copyright (C) 2013-2018 July IGHOR <julyighor@gmail.com>
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  In addition, as a special exception, the copyright holders give
+//  permission to link the code of portions of this program with the
+//  OpenSSL library under certain conditions as described in each
+//  individual source file, and distribute linked combinations including
+//  the two.
+//
+//  You must obey the GNU General Public License in all respects for all
+//  of the code used other than OpenSSL. If you modify file(s) with this
+//  exception, you may extend this exception to your version of the
+//  file(s), but you are not obligated to do so. If you do not wish to do
+//  so, delete this exception statement from your version. If you delete
+//  this exception statement from all source files in the program, then
+//  also delete it here.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "julyratelimiter.h"
+#include "main.h"
+
+JulyRateLimiter::JulyRateLimiter()
+    : blockedUntil(0),
+      retryAfter(0)
+{
+    clock.start();
+}
+
+void JulyRateLimiter::addBucket(int bucketId, double capacity, int intervalMs)
+{
+    RateBucket bucket;
+    bucket.capacity = capacity;
+    bucket.tokens = capacity;
+    bucket.refillPerMs = capacity / qMax(intervalMs, 1);
+    bucket.lastRefill = clock.elapsed();
+    bucketMap[bucketId] = bucket;
+}
+
+void JulyRateLimiter::addCost(int reqTypeFrom, int reqTypeTo, int bucketId, double cost)
+{
+    RateCostRule rule;
+    rule.reqTypeFrom = reqTypeFrom;
+    rule.reqTypeTo = reqTypeTo;
+    rule.bucketId = bucketId;
+    rule.cost = cost;
+    costList << rule;
+}
+
+void JulyRateLimiter::addUsageHeader(const QByteArray& headerName, int bucketId)
+{
+    usageHeaderMap[headerName.toLower()] = bucketId;
+}
+
+void JulyRateLimiter::refill(RateBucket& bucket, qint64 currentTime)
+{
+    bucket.tokens = qMin(bucket.capacity, bucket.tokens + (currentTime - bucket.lastRefill) * bucket.refillPerMs);
+    bucket.lastRefill = currentTime;
+}
+
+double JulyRateLimiter::reserveFor(int reqType, const RateBucket& bucket) const
+{
+    if (reqType >= 300)
+        return 0.0;
+
+    return bucket.capacity * 0.1;
+}
+
+bool JulyRateLimiter::tryAcquire(int reqType)
+{
+    if (bucketMap.isEmpty())
+        return true;
+
+    qint64 currentTime = clock.elapsed();
+
+    if (currentTime < blockedUntil)
+        return false;
+
+    for (int n = 0; n < costList.count(); n++)
+    {
+        const RateCostRule& rule = costList.at(n);
+
+        if (reqType < rule.reqTypeFrom || reqType > rule.reqTypeTo || !bucketMap.contains(rule.bucketId))
+            continue;
+
+        RateBucket& bucket = bucketMap[rule.bucketId];
+        refill(bucket, currentTime);
+
+        if (bucket.tokens - rule.cost < reserveFor(reqType, bucket))
+            return false;
+    }
+
+    for (int n = 0; n < costList.count(); n++)
+    {
+        const RateCostRule& rule = costList.at(n);
+
+        if (reqType < rule.reqTypeFrom || reqType > rule.reqTypeTo || !bucketMap.contains(rule.bucketId))
+            continue;
+
+        RateBucket& bucket = bucketMap[rule.bucketId];
+        bucket.tokens -= rule.cost;
+        bucket.averageCost = qFuzzyIsNull(bucket.averageCost) ? rule.cost : bucket.averageCost * 0.9 + rule.cost * 0.1;
+    }
+
+    return true;
+}
+
+int JulyRateLimiter::waitTime(int reqType)
+{
+    qint64 currentTime = clock.elapsed();
+    qint64 wait = qMax(blockedUntil - currentTime, qint64(0));
+
+    for (int n = 0; n < costList.count(); n++)
+    {
+        const RateCostRule& rule = costList.at(n);
+
+        if (reqType < rule.reqTypeFrom || reqType > rule.reqTypeTo || !bucketMap.contains(rule.bucketId))
+            continue;
+
+        RateBucket& bucket = bucketMap[rule.bucketId];
+        refill(bucket, currentTime);
+        double missing = rule.cost + reserveFor(reqType, bucket) - bucket.tokens;
+
+        if (missing > 0.0 && bucket.refillPerMs > 0.0)
+            wait = qMax(wait, qint64(missing / bucket.refillPerMs) + 1);
+    }
+
+    return int(qMax(wait, qint64(1)));
+}
+
+void JulyRateLimiter::readHeader(const QByteArray& headerLine)
+{
+    int separator = headerLine.indexOf(':');
+
+    if (separator < 1)
+        return;
+
+    QByteArray headerName = headerLine.left(separator).trimmed().toLower();
+
+    if (headerName == "retry-after")
+    {
+        retryAfter = headerLine.mid(separator + 1).trimmed().toInt();
+        return;
+    }
+
+    int bucketId = usageHeaderMap.value(headerName, -1);
+
+    if (bucketId == -1 || !bucketMap.contains(bucketId))
+        return;
+
+    // The exchange knows the real usage, including requests it counted that we did not see
+    RateBucket& bucket = bucketMap[bucketId];
+    refill(bucket, clock.elapsed());
+    bucket.tokens = qMin(bucket.tokens, bucket.capacity - headerLine.mid(separator + 1).trimmed().toDouble());
+}
+
+void JulyRateLimiter::responseReceived(int httpState)
+{
+    if (httpState == 429 || httpState == 418)
+    {
+        int blockSeconds = retryAfter > 0 ? retryAfter : 10;
+        blockedUntil = clock.elapsed() + blockSeconds * 1000;
+
+        if (debugLevel)
+            logThread->writeLog("Rate limit reached, requests paused for " + QByteArray::number(blockSeconds) + " seconds", 2);
+
+        for (QMap<int, RateBucket>::iterator it = bucketMap.begin(); it != bucketMap.end(); ++it)
+            it.value().tokens = 0.0;
+    }
+
+    retryAfter = 0;
+}
+
+int JulyRateLimiter::suggestedInterval(int baseInterval, int minInterval)
+{
+    if (bucketMap.isEmpty())
+        return baseInterval;
+
+    qint64 currentTime = clock.elapsed();
+
+    if (currentTime < blockedUntil)
+        return qMax(baseInterval, int(blockedUntil - currentTime));
+
+    // Every timer tick sends about one request, so a bucket sustains one tick per averageCost / refillPerMs
+    int interval = minInterval;
+    bool budgetIsFull = true;
+
+    for (QMap<int, RateBucket>::iterator it = bucketMap.begin(); it != bucketMap.end(); ++it)
+    {
+        RateBucket& bucket = it.value();
+
+        if (qFuzzyIsNull(bucket.averageCost) || qFuzzyIsNull(bucket.refillPerMs))
+            continue;
+
+        refill(bucket, currentTime);
+        double fill = bucket.tokens / bucket.capacity;
+        double sustainedInterval = bucket.averageCost / bucket.refillPerMs;
+
+        if (fill < 0.8)
+            budgetIsFull = false;
+
+        if (fill < 0.5)
+            sustainedInterval *= 1.0 + (0.5 - fill) * 2.0;
+
+        interval = qMax(interval, int(sustainedInterval));
+    }
+
+    if (!budgetIsFull)
+        interval = qMax(interval, baseInterval);
+
+    return interval;
+}
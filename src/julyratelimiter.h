@@ -0,0 +1,92 @@
+//  This file is part of Qt Bitcoin Trader
+//      https://github.com/JulyIGHOR/QtBitcoinTrader
+//  Copyright (C) 2013-2018 July IGHOR <julyighor@gmail.com>
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  In addition, as a special exception, the copyright holders give
+//  permission to link the code of portions of this program with the
+//  OpenSSL library under certain conditions as described in each
+//  individual source file, and distribute linked combinations including
+//  the two.
+//
+//  You must obey the GNU General Public License in all respects for all
+//  of the code used other than OpenSSL. If you modify file(s) with this
+//  exception, you may extend this exception to your version of the
+//  file(s), but you are not obligated to do so. If you do not wish to do
+//  so, delete this exception statement from your version. If you delete
+//  this exception statement from all source files in the program, then
+//  also delete it here.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef JULYRATELIMITER_H
+#define JULYRATELIMITER_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QList>
+#include <QMap>
+
+struct RateBucket
+{
+    double capacity = 0.0;
+    double tokens = 0.0;
+    double refillPerMs = 0.0;
+    double averageCost = 0.0;
+    qint64 lastRefill = 0;
+};
+
+struct RateCostRule
+{
+    int reqTypeFrom = 0;
+    int reqTypeTo = 0;
+    int bucketId = 0;
+    double cost = 1.0;
+};
+
+// Token buckets for the request budgets of one exchange.
+// Every request takes its cost from all buckets whose rule matches its reqType.
+// Buckets refill continuously and are corrected from usage headers when the exchange sends them.
+// Public and private requests leave a reserve in each bucket for trading requests.
+class JulyRateLimiter
+{
+public:
+    JulyRateLimiter();
+
+    void addBucket(int bucketId, double capacity, int intervalMs);
+    void addCost(int reqTypeFrom, int reqTypeTo, int bucketId, double cost);
+    void addUsageHeader(const QByteArray& headerName, int bucketId);
+    bool isEmpty() const
+    {
+        return bucketMap.isEmpty();
+    }
+
+    bool tryAcquire(int reqType);
+    int waitTime(int reqType);
+    void readHeader(const QByteArray& headerLine);
+    void responseReceived(int httpState);
+    int suggestedInterval(int baseInterval, int minInterval);
+
+private:
+    QMap<int, RateBucket> bucketMap;
+    QList<RateCostRule> costList;
+    QMap<QByteArray, int> usageHeaderMap;
+    QElapsedTimer clock;
+    qint64 blockedUntil;
+    int retryAfter;
+
+    void refill(RateBucket& bucket, qint64 currentTime);
+    double reserveFor(int reqType, const RateBucket& bucket) const;
+};
+
+#endif // JULYRATELIMITER_H
@@ -0,0 +1,124 @@
+//  This file is part of Qt Bitcoin Trader
+//      https://github.com/JulyIGHOR/QtBitcoinTrader
+//  Copyright (C) 2013-2018 July IGHOR <julyighor@gmail.com>
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  In addition, as a special exception, the copyright holders give
+//  permission to link the code of portions of this program with the
+//  OpenSSL library under certain conditions as described in each
+//  individual source file, and distribute linked combinations including
+//  the two.
+//
+//  You must obey the GNU General Public License in all respects for all
+//  of the code used other than OpenSSL. If you modify file(s) with this
+//  exception, you may extend this exception to your version of the
+//  file(s), but you are not obligated to do so. If you do not wish to do
+//  so, delete this exception statement from your version. If you delete
+//  this exception statement from all source files in the program, then
+//  also delete it here.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef JULYRINGBUFFER_H
+#define JULYRINGBUFFER_H
+
+#include <QVector>
+
+// Queue of values kept in one power of two array, index 0 is the oldest item.
+// Appending and dropping from the front never move the stored items,
+// the array doubles only when it is full.
+template <typename T>
+class JulyRingBuffer
+{
+public:
+    JulyRingBuffer()
+        : head(0),
+          used(0)
+    {
+    }
+
+    int count() const
+    {
+        return used;
+    }
+
+    bool isEmpty() const
+    {
+        return used == 0;
+    }
+
+    const T& at(int index) const
+    {
+        return items.at((head + index) & (items.count() - 1));
+    }
+
+    T& operator[](int index)
+    {
+        return items[(head + index) & (items.count() - 1)];
+    }
+
+    const T& first() const
+    {
+        return at(0);
+    }
+
+    const T& last() const
+    {
+        return at(used - 1);
+    }
+
+    void append(const T& item)
+    {
+        if (used == items.count())
+            grow();
+
+        items[(head + used) & (items.count() - 1)] = item;
+        used++;
+    }
+
+    void removeFirst(int removeCount = 1)
+    {
+        removeCount = qBound(0, removeCount, used);
+
+        for (int n = 0; n < removeCount; n++)
+            items[(head + n) & (items.count() - 1)] = T();
+
+        head = (head + removeCount) & qMax(0, items.count() - 1);
+        used -= removeCount;
+    }
+
+    void clear()
+    {
+        items.clear();
+        head = 0;
+        used = 0;
+    }
+
+private:
+    QVector<T> items;
+    int head;
+    int used;
+
+    void grow()
+    {
+        QVector<T> grownItems(qMax(16, items.count() * 2));
+
+        for (int n = 0; n < used; n++)
+            grownItems[n] = at(n);
+
+        items.swap(grownItems);
+        head = 0;
+    }
+};
+
+#endif // JULYRINGBUFFER_H
@@ -0,0 +1,465 @@
+//  This file is part of Qt Bitcoin Trader
+//      https://github.com/JulyIGHOR/QtBitcoinTrader
+//  Copyright (C) 2013-2018 July IGHOR <julyighor@gmail.com>
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  In addition, as a special exception, the copyright holders give
+//  permission to link the code of portions of this program with the
+//  OpenSSL library under certain conditions as described in each
+//  individual source file, and distribute linked combinations including
+//  the two.
+//
+//  You must obey the GNU General Public License in all respects for all
+//  of the code used other than OpenSSL. If you modify file(s) with this
+//  exception, you may extend this exception to your version of the
+//  file(s), but you are not obligated to do so. If you do not wish to do
+//  so, delete this exception statement from your version. If you delete
+//  this exception statement from all source files in the program, then
+//  also delete it here.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "julywebsocket.h"
+#include "main.h"
+#include <QTimer>
+#include <QCryptographicHash>
+#include <QtEndian>
+#include <openssl/rand.h>
+
+JulyWebSocket::JulyWebSocket(const QString& hostN, quint16 portN, const QByteArray& pathN, QObject* parent,
+                             const bool& secure)
+    : QSslSocket(parent),
+      hostName(hostN),
+      port(portN),
+      path(pathN),
+      secureConnection(secure),
+      isStopped(true),
+      handshakeDone(false),
+      reconnectDelay(1000),
+      maxMessageSize(64 * 1024 * 1024),
+      fragmentOpcode(OpcodeText),
+      pingTimer(new QTimer(this)),
+      reconnectTimer(new QTimer(this))
+{
+    setPeerVerifyMode(QSslSocket::VerifyPeer);
+
+    if (secureConnection)
+        connect(this, SIGNAL(encrypted()), this, SLOT(socketConnected()));
+    else
+        connect(this, SIGNAL(connected()), this, SLOT(socketConnected()));
+
+    connect(this, SIGNAL(readyRead()), this, SLOT(readSocket()));
+    connect(this, SIGNAL(disconnected()), this, SLOT(disconnectedSlot()));
+    connect(this, SIGNAL(error(QAbstractSocket::SocketError)), this, SLOT(errorSlot(QAbstractSocket::SocketError)));
+    connect(this, SIGNAL(sslErrors(const QList<QSslError>&)), this, SIGNAL(sslErrorSignal(const QList<QSslError>&)));
+
+    pingTimer->setInterval(15000);
+    connect(pingTimer, SIGNAL(timeout()), this, SLOT(pingSlot()));
+
+    reconnectTimer->setSingleShot(true);
+    connect(reconnectTimer, SIGNAL(timeout()), this, SLOT(reconnectSlot()));
+}
+
+JulyWebSocket::~JulyWebSocket()
+{
+    blockSignals(true);
+    stop();
+}
+
+void JulyWebSocket::setPath(const QByteArray& newPath)
+{
+    path = newPath;
+}
+
+void JulyWebSocket::setSubscriptions(const QList<QByteArray>& list)
+{
+    subscriptionList = list;
+}
+
+void JulyWebSocket::setMaxMessageSize(int size)
+{
+    maxMessageSize = size;
+}
+
+void JulyWebSocket::open()
+{
+    bool wasOpened = handshakeDone;
+    isStopped = false;
+    handshakeDone = false;
+    pingTimer->stop();
+    readBuffer.clear();
+    fragmentBuffer.clear();
+
+    blockSignals(true);
+    abort();
+    blockSignals(false);
+
+    if (wasOpened)
+        emit closed();
+
+    lastReceivedTime.restart();
+
+    if (secureConnection)
+        connectToHostEncrypted(hostName, port, QIODevice::ReadWrite);
+    else
+        connectToHost(hostName, port, QIODevice::ReadWrite);
+}
+
+void JulyWebSocket::stop()
+{
+    isStopped = true;
+    pingTimer->stop();
+    reconnectTimer->stop();
+
+    if (handshakeDone && state() == QAbstractSocket::ConnectedState)
+    {
+        sendFrame(OpcodeClose, QByteArray());
+        flush();
+    }
+
+    bool wasOpened = handshakeDone;
+    handshakeDone = false;
+
+    blockSignals(true);
+    abort();
+    blockSignals(false);
+
+    if (wasOpened)
+        emit closed();
+}
+
+void JulyWebSocket::socketConnected()
+{
+    QByteArray keyBytes(16, 0);
+    RAND_bytes(reinterpret_cast<unsigned char*>(keyBytes.data()), keyBytes.size());
+    handshakeKey = keyBytes.toBase64();
+
+    QByteArray request = "GET " + path + " HTTP/1.1\r\n";
+    request.append("Host: " + hostName.toLatin1() + "\r\n");
+
+    if (baseValues.customUserAgent.length() > 0)
+        request.append("User-Agent: " + baseValues.customUserAgent.toLatin1() + "\r\n");
+    else
+        request.append("User-Agent: Qt Bitcoin Trader v" + baseValues.appVerStr + "\r\n");
+
+    request.append("Upgrade: websocket\r\n");
+    request.append("Connection: Upgrade\r\n");
+    request.append("Sec-WebSocket-Key: " + handshakeKey + "\r\n");
+    request.append("Sec-WebSocket-Version: 13\r\n\r\n");
+
+    if (debugLevel)
+        logThread->writeLog("WS SND: " + request);
+
+    write(request);
+    flush();
+}
+
+bool JulyWebSocket::readHandshake()
+{
+    int headerEnd = readBuffer.indexOf("\r\n\r\n");
+
+    if (headerEnd == -1)
+    {
+        if (readBuffer.size() > 30000)
+        {
+            readBuffer.clear();
+            scheduleReconnect();
+        }
+
+        return false;
+    }
+
+    QByteArray header = readBuffer.left(headerEnd).toLower();
+    readBuffer.remove(0, headerEnd + 4);
+
+    QByteArray expectedAccept = QCryptographicHash::hash(handshakeKey + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11",
+                                QCryptographicHash::Sha1).toBase64().toLower();
+
+    if (!header.startsWith("http/1.1 101") || !header.contains("sec-websocket-accept: " + expectedAccept))
+    {
+        if (debugLevel)
+            logThread->writeLog("WS: Invalid handshake: " + header, 2);
+
+        scheduleReconnect();
+        return false;
+    }
+
+    handshakeDone = true;
+    reconnectDelay = 1000;
+    pingTimer->start();
+
+    emit opened();
+
+    for (int n = 0; n < subscriptionList.count(); n++)
+        sendTextMessage(subscriptionList.at(n));
+
+    return true;
+}
+
+void JulyWebSocket::readSocket()
+{
+    lastReceivedTime.restart();
+    qint64 readSize = bytesAvailable();
+    baseValues.trafficSpeed += readSize;
+
+    int oldSize = readBuffer.size();
+    readBuffer.resize(oldSize + readSize);
+    readBuffer.resize(oldSize + qMax(read(readBuffer.data() + oldSize, readSize), qint64(0)));
+
+    if (!handshakeDone && !readHandshake())
+        return;
+
+    readFrames();
+}
+
+void JulyWebSocket::readFrames()
+{
+    int pos = 0;
+    const uchar* bytes = reinterpret_cast<const uchar*>(readBuffer.constData());
+    int size = readBuffer.size();
+
+    while (handshakeDone && size - pos >= 2)
+    {
+        bool fin = bytes[pos] & 0x80;
+        int opcode = bytes[pos] & 0x0F;
+        bool masked = bytes[pos + 1] & 0x80;
+        quint64 payloadSize = bytes[pos + 1] & 0x7F;
+        int headerSize = 2;
+
+        if (payloadSize == 126)
+        {
+            if (size - pos < 4)
+                break;
+
+            payloadSize = qFromBigEndian<quint16>(bytes + pos + 2);
+            headerSize = 4;
+        }
+        else if (payloadSize == 127)
+        {
+            if (size - pos < 10)
+                break;
+
+            payloadSize = qFromBigEndian<quint64>(bytes + pos + 2);
+            headerSize = 10;
+        }
+
+        // RFC 6455 5.1, a client must close the connection on any masked frame from the server
+        if (masked)
+        {
+            if (debugLevel)
+                logThread->writeLog("WS: Masked frame from server", 2);
+
+            closeWithStatus(1002);
+            return;
+        }
+
+        if (payloadSize > quint64(maxMessageSize))
+        {
+            if (debugLevel)
+                logThread->writeLog("WS: Frame is too big", 2);
+
+            closeWithStatus(1009);
+            return;
+        }
+
+        // The header is complete here, so the remaining size never goes negative
+        if (quint64(size - pos - headerSize) < payloadSize)
+            break;
+
+        QByteArray payload(readBuffer.constData() + pos + headerSize, int(payloadSize));
+        pos += headerSize + int(payloadSize);
+        processFrame(opcode, fin, payload);
+
+        if (readBuffer.isEmpty())
+            return;
+    }
+
+    readBuffer.remove(0, pos);
+}
+
+void JulyWebSocket::processFrame(int opcode, bool fin, const QByteArray& payload)
+{
+    switch (opcode)
+    {
+        case OpcodeText:
+        case OpcodeBinary:
+            if (fin)
+                emit textMessageReceived(payload);
+            else
+            {
+                fragmentOpcode = opcode;
+                fragmentBuffer = payload;
+            }
+
+            break;
+
+        case OpcodeContinuation:
+            if (fragmentBuffer.size() + payload.size() > maxMessageSize)
+            {
+                if (debugLevel)
+                    logThread->writeLog("WS: Message is too big", 2);
+
+                closeWithStatus(1009);
+                break;
+            }
+
+            fragmentBuffer.append(payload);
+
+            if (fin)
+            {
+                QByteArray message = fragmentBuffer;
+                fragmentBuffer.clear();
+                emit textMessageReceived(message);
+            }
+
+            break;
+
+        case OpcodePing:
+            sendFrame(OpcodePong, payload);
+            break;
+
+        case OpcodePong:
+            break;
+
+        case OpcodeClose:
+            if (debugLevel)
+                logThread->writeLog("WS: Closed by server", 2);
+
+            sendFrame(OpcodeClose, payload.left(2));
+            flush();
+            readBuffer.clear();
+            scheduleReconnect();
+            break;
+
+        default:
+            break;
+    }
+}
+
+void JulyWebSocket::closeWithStatus(quint16 status)
+{
+    uchar statusBytes[2];
+    qToBigEndian<quint16>(status, statusBytes);
+    sendFrame(OpcodeClose, QByteArray(reinterpret_cast<const char*>(statusBytes), 2));
+    flush();
+
+    readBuffer.clear();
+    fragmentBuffer.clear();
+    scheduleReconnect();
+}
+
+void JulyWebSocket::sendTextMessage(const QByteArray& message)
+{
+    if (!isOpened())
+        return;
+
+    if (debugLevel)
+        logThread->writeLog("WS SND: " + message);
+
+    sendFrame(OpcodeText, message);
+}
+
+void JulyWebSocket::sendFrame(int opcode, const QByteArray& payload)
+{
+    QByteArray frame;
+    frame.reserve(payload.size() + 14);
+    frame.append(char(0x80 | opcode));
+
+    if (payload.size() < 126)
+        frame.append(char(0x80 | payload.size()));
+    else if (payload.size() < 65536)
+    {
+        uchar sizeBytes[2];
+        qToBigEndian<quint16>(quint16(payload.size()), sizeBytes);
+        frame.append(char(0x80 | 126));
+        frame.append(reinterpret_cast<const char*>(sizeBytes), 2);
+    }
+    else
+    {
+        uchar sizeBytes[8];
+        qToBigEndian<quint64>(quint64(payload.size()), sizeBytes);
+        frame.append(char(0x80 | 127));
+        frame.append(reinterpret_cast<const char*>(sizeBytes), 8);
+    }
+
+    uchar mask[4];
+    RAND_bytes(mask, 4);
+    frame.append(reinterpret_cast<const char*>(mask), 4);
+
+    int payloadStart = frame.size();
+    frame.append(payload);
+
+    for (int n = 0; n < payload.size(); n++)
+        frame[payloadStart + n] = frame.at(payloadStart + n) ^ mask[n % 4];
+
+    baseValues.trafficSpeed += frame.size();
+    write(frame);
+}
+
+void JulyWebSocket::pingSlot()
+{
+    if (!isOpened())
+        return;
+
+    if (lastReceivedTime.elapsed() > pingTimer->interval() * 3)
+    {
+        if (debugLevel)
+            logThread->writeLog("WS: Connection timeout", 2);
+
+        scheduleReconnect();
+        return;
+    }
+
+    sendFrame(OpcodePing, QByteArray());
+}
+
+void JulyWebSocket::scheduleReconnect()
+{
+    bool wasOpened = handshakeDone;
+    handshakeDone = false;
+    pingTimer->stop();
+
+    blockSignals(true);
+    abort();
+    blockSignals(false);
+
+    if (wasOpened)
+        emit closed();
+
+    if (isStopped || reconnectTimer->isActive())
+        return;
+
+    reconnectTimer->start(reconnectDelay);
+    reconnectDelay = qMin(reconnectDelay * 2, 30000);
+}
+
+void JulyWebSocket::reconnectSlot()
+{
+    if (isStopped)
+        return;
+
+    open();
+}
+
+void JulyWebSocket::errorSlot(QAbstractSocket::SocketError)
+{
+    if (debugLevel)
+        logThread->writeLog("WS SocketError: " + errorString().toUtf8(), 2);
+
+    scheduleReconnect();
+}
+
+void JulyWebSocket::disconnectedSlot()
+{
+    scheduleReconnect();
+}
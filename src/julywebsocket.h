@@ -0,0 +1,114 @@
+//  This file is part of Qt Bitcoin Trader
+//      https://github.com/JulyIGHOR/QtBitcoinTrader
+//  Copyright (C) 2013-2018 July IGHOR <julyighor@gmail.com>
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  In addition, as a special exception, the copyright holders give
+//  permission to link the code of portions of this program with the
+//  OpenSSL library under certain conditions as described in each
+//  individual source file, and distribute linked combinations including
+//  the two.
+//
+//  You must obey the GNU General Public License in all respects for all
+//  of the code used other than OpenSSL. If you modify file(s) with this
+//  exception, you may extend this exception to your version of the
+//  file(s), but you are not obligated to do so. If you do not wish to do
+//  so, delete this exception statement from your version. If you delete
+//  this exception statement from all source files in the program, then
+//  also delete it here.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef JULYWEBSOCKET_H
+#define JULYWEBSOCKET_H
+
+#include <QObject>
+#include <QSslSocket>
+#include <QTime>
+
+class QTimer;
+
+// Minimal RFC 6455 client on top of QSslSocket.
+// Reconnects on its own and sends the subscription messages again after every handshake.
+class JulyWebSocket : public QSslSocket
+{
+    Q_OBJECT
+
+public:
+    JulyWebSocket(const QString& hostName, quint16 port, const QByteArray& path, QObject* parent, const bool& secure = true);
+    ~JulyWebSocket();
+
+    void setPath(const QByteArray& path);
+    void setSubscriptions(const QList<QByteArray>& list);
+    void setMaxMessageSize(int size);
+    void open();
+    void stop();
+    bool isOpened() const
+    {
+        return handshakeDone && state() == QAbstractSocket::ConnectedState;
+    }
+    void sendTextMessage(const QByteArray& message);
+
+private:
+    enum Opcode
+    {
+        OpcodeContinuation = 0x0,
+        OpcodeText = 0x1,
+        OpcodeBinary = 0x2,
+        OpcodeClose = 0x8,
+        OpcodePing = 0x9,
+        OpcodePong = 0xA
+    };
+
+    QString hostName;
+    quint16 port;
+    QByteArray path;
+    bool secureConnection;
+    bool isStopped;
+    bool handshakeDone;
+    int reconnectDelay;
+    int maxMessageSize;
+
+    QByteArray handshakeKey;
+    QByteArray readBuffer;
+    QByteArray fragmentBuffer;
+    int fragmentOpcode;
+    QList<QByteArray> subscriptionList;
+
+    QTimer* pingTimer;
+    QTimer* reconnectTimer;
+    QTime lastReceivedTime;
+
+    void sendFrame(int opcode, const QByteArray& payload);
+    bool readHandshake();
+    void readFrames();
+    void processFrame(int opcode, bool fin, const QByteArray& payload);
+    void closeWithStatus(quint16 status);
+    void scheduleReconnect();
+
+private slots:
+    void socketConnected();
+    void readSocket();
+    void errorSlot(QAbstractSocket::SocketError);
+    void disconnectedSlot();
+    void pingSlot();
+    void reconnectSlot();
+
+signals:
+    void opened();
+    void closed();
+    void textMessageReceived(QByteArray);
+    void sslErrorSignal(const QList<QSslError>&);
+};
+
+#endif // JULYWEBSOCKET_H
@@ -165,6 +165,9 @@ void BaseValues::Construct()
     httpRequestInterval = 400;
     httpRequestTimeout = 5000;
     httpRetryCount = 5;
+    httpConnectionsCount = 3;
+    httpConnectionRequestsLimit = 1;
+    webSocketsEnabled = true;
     apiDownCount = 0;
     groupPriceValue = 0.0;
     defaultHeightForRow_ = 22;
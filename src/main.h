@@ -111,6 +111,9 @@ struct BaseValues
     int httpRetryCount;
     int httpRequestInterval;
     int httpRequestTimeout;
+    int httpConnectionsCount;
+    int httpConnectionRequestsLimit;
+    bool webSocketsEnabled;
     Exchange* currentExchange_;
     QString scriptFolder;
     QString themeFolder;
@@ -0,0 +1,350 @@
+//  This file is part of Qt Bitcoin Trader
+//      https://github.com/JulyIGHOR/QtBitcoinTrader
+//  Copyright (C) 2013-2018 July IGHOR <julyighor@gmail.com>
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  In addition, as a special exception, the copyright holders give
+//  permission to link the code of portions of this program with the
+//  OpenSSL library under certain conditions as described in each
+//  individual source file, and distribute linked combinations including
+//  the two.
+//
+//  You must obey the GNU General Public License in all respects for all
+//  of the code used other than OpenSSL. If you modify file(s) with this
+//  exception, you may extend this exception to your version of the
+//  file(s), but you are not obligated to do so. If you do not wish to do
+//  so, delete this exception statement from your version. If you delete
+//  this exception statement from all source files in the program, then
+//  also delete it here.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "orderbook.h"
+#include "depthitem.h"
+#include <algorithm>
+
+namespace
+{
+    struct BetterAsk
+    {
+        bool operator()(const OrderBookLevel& a, const OrderBookLevel& b) const
+        {
+            return a.price < b.price;
+        }
+    };
+
+    struct BetterBid
+    {
+        bool operator()(const OrderBookLevel& a, const OrderBookLevel& b) const
+        {
+            return a.price > b.price;
+        }
+    };
+
+    bool isBetter(bool isAsk, const JulyPrice& a, const JulyPrice& b)
+    {
+        return isAsk ? a < b : a > b;
+    }
+
+    // Asks are grouped up to the next step, bids down to the previous one
+    JulyPrice bucketPrice(bool isAsk, const JulyPrice& price, const JulyPrice& step)
+    {
+        return price.roundToStep(step, isAsk);
+    }
+
+    void appendChange(const JulyPrice& price, const JulyAmount& volume, QVector<DepthItem>* changes)
+    {
+        DepthItem newItem;
+        newItem.price = price.toDouble();
+        newItem.volume = volume.toDouble();
+
+        if (newItem.isValid())
+            (*changes) << newItem;
+    }
+}
+
+OrderBook::OrderBook()
+{
+    asks.sorted = true;
+    bids.sorted = true;
+}
+
+void OrderBook::clear()
+{
+    clearLevels();
+    resetPublished();
+    aggregations.clear();
+}
+
+void OrderBook::resetPublished()
+{
+    asks.published.clear();
+    bids.published.clear();
+}
+
+void OrderBook::clearLevels()
+{
+    asks.levels.clear();
+    bids.levels.clear();
+    asks.sorted = true;
+    bids.sorted = true;
+    invalidateAggregations();
+}
+
+void OrderBook::addLevel(bool isAsk, double price, double volume)
+{
+    if (price <= 0.0 || volume <= 0.0)
+        return;
+
+    Side& currentSide = side(isAsk);
+    OrderBookLevel newLevel;
+    newLevel.price = JulyPrice::fromDouble(price);
+    newLevel.volume = JulyAmount::fromDouble(volume);
+
+    if (newLevel.volume.raw() <= 0)
+        return;
+
+    if (!currentSide.levels.isEmpty() && !isBetter(isAsk, currentSide.levels.last().price, newLevel.price))
+        currentSide.sorted = false;
+
+    currentSide.levels.append(newLevel);
+    invalidateAggregations();
+}
+
+void OrderBook::updateLevel(bool isAsk, double price, double volume)
+{
+    if (price <= 0.0)
+        return;
+
+    sortLevels(isAsk);
+
+    QVector<OrderBookLevel>& levels = side(isAsk).levels;
+    OrderBookLevel newLevel;
+    newLevel.price = JulyPrice::fromDouble(price);
+    newLevel.volume = JulyAmount::fromDouble(volume);
+
+    QVector<OrderBookLevel>::iterator position = isAsk ?
+            std::lower_bound(levels.begin(), levels.end(), newLevel, BetterAsk()) :
+            std::lower_bound(levels.begin(), levels.end(), newLevel, BetterBid());
+    bool found = position != levels.end() && position->price == newLevel.price;
+    JulyAmount volumeDelta = newLevel.volume.raw() > 0 ? newLevel.volume : JulyAmount();
+
+    if (found)
+        volumeDelta -= position->volume;
+
+    if (newLevel.volume.raw() > 0)
+    {
+        if (found)
+            position->volume = newLevel.volume;
+        else
+            levels.insert(position, newLevel);
+    }
+    else if (found)
+        levels.erase(position);
+
+    if (!volumeDelta.isNull())
+        aggregateVolume(isAsk, newLevel.price, volumeDelta);
+}
+
+bool OrderBook::isEmpty() const
+{
+    return asks.levels.isEmpty() && bids.levels.isEmpty();
+}
+
+int OrderBook::count(bool isAsk) const
+{
+    return side(isAsk).levels.count();
+}
+
+const OrderBookLevel& OrderBook::level(bool isAsk, int index)
+{
+    sortLevels(isAsk);
+    return side(isAsk).levels.at(index);
+}
+
+void OrderBook::sortLevels(bool isAsk)
+{
+    Side& currentSide = side(isAsk);
+
+    if (currentSide.sorted)
+        return;
+
+    QVector<OrderBookLevel>& levels = currentSide.levels;
+
+    if (isAsk)
+        std::stable_sort(levels.begin(), levels.end(), BetterAsk());
+    else
+        std::stable_sort(levels.begin(), levels.end(), BetterBid());
+
+    // Stable sort keeps arrival order of equal prices, so the last one wins
+    int uniqueCount = 0;
+
+    for (int n = 0; n < levels.count(); n++)
+    {
+        if (uniqueCount && levels.at(uniqueCount - 1).price == levels.at(n).price)
+            levels[uniqueCount - 1].volume = levels.at(n).volume;
+        else
+            levels[uniqueCount++] = levels.at(n);
+    }
+
+    levels.resize(uniqueCount);
+    currentSide.sorted = true;
+}
+
+void OrderBook::invalidateAggregations()
+{
+    for (int n = 0; n < aggregations.count(); n++)
+        aggregations[n].valid = false;
+}
+
+void OrderBook::buildAggregation(Aggregation* aggregation)
+{
+    for (int sideIndex = 0; sideIndex < 2; sideIndex++)
+    {
+        bool isAsk = sideIndex == 0;
+        sortLevels(isAsk);
+
+        const QVector<OrderBookLevel>& levels = side(isAsk).levels;
+        QVector<OrderBookLevel>& rows = isAsk ? aggregation->asks : aggregation->bids;
+        rows.clear();
+
+        // Levels are sorted best price first, so levels of one step are next to each other
+        for (int n = 0; n < levels.count(); n++)
+        {
+            JulyPrice groupedPrice = bucketPrice(isAsk, levels.at(n).price, aggregation->step);
+
+            if (!rows.isEmpty() && rows.last().price == groupedPrice)
+            {
+                rows.last().volume += levels.at(n).volume;
+                continue;
+            }
+
+            OrderBookLevel groupedLevel;
+            groupedLevel.price = groupedPrice;
+            groupedLevel.volume = levels.at(n).volume;
+            rows.append(groupedLevel);
+        }
+    }
+
+    aggregation->valid = true;
+}
+
+void OrderBook::aggregateVolume(bool isAsk, JulyPrice price, JulyAmount volumeDelta)
+{
+    for (int n = 0; n < aggregations.count(); n++)
+    {
+        Aggregation& aggregation = aggregations[n];
+
+        if (!aggregation.valid)
+            continue;
+
+        QVector<OrderBookLevel>& rows = isAsk ? aggregation.asks : aggregation.bids;
+        OrderBookLevel groupedLevel;
+        groupedLevel.price = bucketPrice(isAsk, price, aggregation.step);
+        groupedLevel.volume = volumeDelta;
+
+        QVector<OrderBookLevel>::iterator position = isAsk ?
+                std::lower_bound(rows.begin(), rows.end(), groupedLevel, BetterAsk()) :
+                std::lower_bound(rows.begin(), rows.end(), groupedLevel, BetterBid());
+
+        if (position != rows.end() && position->price == groupedLevel.price)
+        {
+            position->volume += volumeDelta;
+
+            if (position->volume.raw() <= 0)
+                rows.erase(position);
+        }
+        else if (volumeDelta.raw() > 0)
+            rows.insert(position, groupedLevel);
+    }
+}
+
+const QVector<OrderBookLevel>& OrderBook::groupedLevels(bool isAsk, JulyPrice groupPrice)
+{
+    if (groupPrice.raw() <= 0)
+    {
+        sortLevels(isAsk);
+        return side(isAsk).levels;
+    }
+
+    int index = aggregations.count() - 1;
+
+    while (index >= 0 && aggregations.at(index).step != groupPrice)
+        index--;
+
+    if (index < 0)
+    {
+        if (aggregations.count() >= maxAggregations)
+            aggregations.removeFirst();
+
+        Aggregation newAggregation;
+        newAggregation.step = groupPrice;
+        newAggregation.valid = false;
+        aggregations.append(newAggregation);
+    }
+    else if (index != aggregations.count() - 1)
+    {
+        Aggregation usedAggregation = aggregations.at(index);
+        aggregations.remove(index);
+        aggregations.append(usedAggregation);
+    }
+
+    Aggregation& aggregation = aggregations.last();
+
+    if (!aggregation.valid)
+        buildAggregation(&aggregation);
+
+    return isAsk ? aggregation.asks : aggregation.bids;
+}
+
+void OrderBook::takeChanges(bool isAsk, double groupPrice, int rowLimit, QVector<DepthItem>* changes)
+{
+    sortLevels(isAsk);
+
+    Side& currentSide = side(isAsk);
+    JulyPrice groupStep = JulyPrice::fromDouble(groupPrice);
+    QVector<OrderBookLevel> rows = groupStep.raw() > 0 ? groupedLevels(isAsk, groupStep) : currentSide.levels;
+
+    if (rowLimit && rows.count() > rowLimit)
+        rows.resize(rowLimit);
+
+    // Both arrays are sorted best price first, so one merge pass finds every difference
+    const QVector<OrderBookLevel>& published = currentSide.published;
+    int rowIndex = 0;
+    int publishedIndex = 0;
+
+    while (rowIndex < rows.count() || publishedIndex < published.count())
+    {
+        if (publishedIndex == published.count() ||
+            (rowIndex < rows.count() && isBetter(isAsk, rows.at(rowIndex).price, published.at(publishedIndex).price)))
+        {
+            appendChange(rows.at(rowIndex).price, rows.at(rowIndex).volume, changes);
+            rowIndex++;
+        }
+        else if (rowIndex == rows.count() || isBetter(isAsk, published.at(publishedIndex).price, rows.at(rowIndex).price))
+        {
+            appendChange(published.at(publishedIndex).price, JulyAmount(), changes);
+            publishedIndex++;
+        }
+        else
+        {
+            if (rows.at(rowIndex).volume != published.at(publishedIndex).volume)
+                appendChange(rows.at(rowIndex).price, rows.at(rowIndex).volume, changes);
+
+            rowIndex++;
+            publishedIndex++;
+        }
+    }
+
+    currentSide.published.swap(rows);
+}
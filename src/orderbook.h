@@ -0,0 +1,121 @@
+//  This file is part of Qt Bitcoin Trader
+//      https://github.com/JulyIGHOR/QtBitcoinTrader
+//  Copyright (C) 2013-2018 July IGHOR <julyighor@gmail.com>
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  In addition, as a special exception, the copyright holders give
+//  permission to link the code of portions of this program with the
+//  OpenSSL library under certain conditions as described in each
+//  individual source file, and distribute linked combinations including
+//  the two.
+//
+//  You must obey the GNU General Public License in all respects for all
+//  of the code used other than OpenSSL. If you modify file(s) with this
+//  exception, you may extend this exception to your version of the
+//  file(s), but you are not obligated to do so. If you do not wish to do
+//  so, delete this exception statement from your version. If you delete
+//  this exception statement from all source files in the program, then
+//  also delete it here.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ORDERBOOK_H
+#define ORDERBOOK_H
+
+#include <QVector>
+#include "julyfixed.h"
+
+struct DepthItem;
+
+struct OrderBookLevel
+{
+    JulyPrice price;
+    JulyAmount volume;
+};
+
+// One side pair of a market's depth kept as flat arrays sorted best price first.
+// Prices and volumes are fixed point, so levels compare and sum exactly.
+// Adapters fill it from a snapshot or patch it with diffs, takeChanges() then
+// groups the book and returns only the rows that differ from the last call.
+// Every group step asked for is kept as its own aggregated view, diffs patch those
+// views in place and snapshots rebuild them once, so switching steps costs no refetch.
+class OrderBook
+{
+public:
+    OrderBook();
+
+    // Forgets the levels and what was published, the next takeChanges() sends every row
+    void clear();
+
+    // Drops the levels but keeps what was published, call before refilling from a snapshot
+    void clearLevels();
+
+    // Keeps the levels, the next takeChanges() sends every row again
+    void resetPublished();
+
+    // Snapshot filling, any order. A later level with the same price replaces the earlier one
+    void addLevel(bool isAsk, double price, double volume);
+
+    // Diff from a stream, zero volume removes the level
+    void updateLevel(bool isAsk, double price, double volume);
+
+    bool isEmpty() const;
+    int count(bool isAsk) const;
+    const OrderBookLevel& level(bool isAsk, int index);
+
+    // Levels summed into groupPrice steps, asks rounded up and bids down, best price first
+    const QVector<OrderBookLevel>& groupedLevels(bool isAsk, JulyPrice groupPrice);
+
+    // Groups levels to groupPrice steps (asks up, bids down), keeps rowLimit rows when it is set
+    // and appends to changes every row that differs from the previous call, vanished rows with zero volume
+    void takeChanges(bool isAsk, double groupPrice, int rowLimit, QVector<DepthItem>* changes);
+
+private:
+    struct Side
+    {
+        QVector<OrderBookLevel> levels;
+        QVector<OrderBookLevel> published;
+        bool sorted;
+    };
+
+    Side asks;
+    Side bids;
+
+    struct Aggregation
+    {
+        JulyPrice step;
+        QVector<OrderBookLevel> asks;
+        QVector<OrderBookLevel> bids;
+        bool valid;
+    };
+
+    // Least recently used first
+    QVector<Aggregation> aggregations;
+    static const int maxAggregations = 8;
+
+    Side& side(bool isAsk)
+    {
+        return isAsk ? asks : bids;
+    }
+    const Side& side(bool isAsk) const
+    {
+        return isAsk ? asks : bids;
+    }
+
+    void sortLevels(bool isAsk);
+    void invalidateAggregations();
+    void buildAggregation(Aggregation* aggregation);
+    void aggregateVolume(bool isAsk, JulyPrice price, JulyAmount volumeDelta);
+};
+
+#endif // ORDERBOOK_H
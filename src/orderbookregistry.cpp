@@ -0,0 +1,286 @@
+//  This file is part of Qt Bitcoin Trader
+//      https://github.com/JulyIGHOR/QtBitcoinTrader
+//  Copyright (C) 2013-2018 July IGHOR <julyighor@gmail.com>
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  In addition, as a special exception, the copyright holders give
+//  permission to link the code of portions of this program with the
+//  OpenSSL library under certain conditions as described in each
+//  individual source file, and distribute linked combinations including
+//  the two.
+//
+//  You must obey the GNU General Public License in all respects for all
+//  of the code used other than OpenSSL. If you modify file(s) with this
+//  exception, you may extend this exception to your version of the
+//  file(s), but you are not obligated to do so. If you do not wish to do
+//  so, delete this exception statement from your version. If you delete
+//  this exception statement from all source files in the program, then
+//  also delete it here.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "orderbookregistry.h"
+#include <QMutexLocker>
+#include <algorithm>
+
+namespace
+{
+    struct AtOrBetter
+    {
+        bool isAsk;
+
+        bool operator()(const JulyPrice& price, const OrderBookLevel& level) const
+        {
+            return isAsk ? price < level.price : price > level.price;
+        }
+    };
+}
+
+OrderBookRegistry::OrderBookRegistry()
+{
+    maxBooks = 8;
+    maxLevels = 500;
+    clock.start();
+}
+
+OrderBookRegistry* OrderBookRegistry::global()
+{
+    static OrderBookRegistry instance;
+    return &instance;
+}
+
+void OrderBookRegistry::setLimits(int booksLimit, int levelsLimit)
+{
+    QMutexLocker lock(&locker);
+    maxBooks = qMax(1, booksLimit);
+    maxLevels = qMax(1, levelsLimit);
+    removeUnused();
+}
+
+void OrderBookRegistry::setWatched(const QStringList& symbols)
+{
+    QMutexLocker lock(&locker);
+    watchedList.clear();
+
+    for (int n = 0; n < symbols.count(); n++)
+        if (!symbols.at(n).isEmpty())
+            watchedList << symbols.at(n).toUpper();
+
+    watchedList.removeDuplicates();
+}
+
+void OrderBookRegistry::watch(const QString& symbol)
+{
+    QMutexLocker lock(&locker);
+    requestedTime[symbol.toUpper()] = clock.elapsed();
+}
+
+QStringList OrderBookRegistry::watchedSymbols()
+{
+    QMutexLocker lock(&locker);
+    QStringList result = watchedList;
+    qint64 currentTime = clock.elapsed();
+    QMutableHashIterator<QString, qint64> requestedIterator(requestedTime);
+
+    while (requestedIterator.hasNext())
+    {
+        requestedIterator.next();
+
+        if (currentTime - requestedIterator.value() > requestTimeout)
+            requestedIterator.remove();
+        else if (!result.contains(requestedIterator.key()))
+            result << requestedIterator.key();
+    }
+
+    return result;
+}
+
+bool OrderBookRegistry::isWatched(const QString& symbol)
+{
+    QMutexLocker lock(&locker);
+    QString upperSymbol = symbol.toUpper();
+
+    if (watchedList.contains(upperSymbol))
+        return true;
+
+    QHash<QString, qint64>::const_iterator requested = requestedTime.constFind(upperSymbol);
+    return requested != requestedTime.constEnd() && clock.elapsed() - requested.value() <= requestTimeout;
+}
+
+void OrderBookRegistry::publish(const QString& symbol, OrderBook& book)
+{
+    if (symbol.isEmpty())
+        return;
+
+    int levelsLimit;
+
+    {
+        QMutexLocker lock(&locker);
+        levelsLimit = maxLevels;
+    }
+
+    // Copies and running sizes are made before locking, readers only wait for the swap
+    Book newBook;
+
+    for (int sideIndex = 0; sideIndex < 2; sideIndex++)
+    {
+        bool isAsk = sideIndex == 0;
+        Side& newSide = isAsk ? newBook.asks : newBook.bids;
+        const QVector<OrderBookLevel>& levels = book.groupedLevels(isAsk, JulyPrice());
+
+        if (levels.count() > levelsLimit)
+            newSide.levels = levels.mid(0, levelsLimit);
+        else
+            newSide.levels = levels;
+
+        newSide.sizes.resize(newSide.levels.count());
+        JulyAmount size;
+
+        for (int n = 0; n < newSide.levels.count(); n++)
+        {
+            size += newSide.levels.at(n).volume;
+            newSide.sizes[n] = size;
+        }
+    }
+
+    QMutexLocker lock(&locker);
+    newBook.lastUsed = clock.elapsed();
+    books[symbol.toUpper()] = newBook;
+    removeUnused();
+}
+
+bool OrderBookRegistry::restore(const QString& symbol, OrderBook* book)
+{
+    QMutexLocker lock(&locker);
+    QHash<QString, Book>::iterator found = books.find(symbol.toUpper());
+
+    if (found == books.end())
+        return false;
+
+    found->lastUsed = clock.elapsed();
+
+    for (int n = 0; n < found->asks.levels.count(); n++)
+        book->addLevel(true, found->asks.levels.at(n).price.toDouble(), found->asks.levels.at(n).volume.toDouble());
+
+    for (int n = 0; n < found->bids.levels.count(); n++)
+        book->addLevel(false, found->bids.levels.at(n).price.toDouble(), found->bids.levels.at(n).volume.toDouble());
+
+    return !book->isEmpty();
+}
+
+double OrderBookRegistry::volumeByPrice(const QString& symbol, double price, bool isAsk)
+{
+    QMutexLocker lock(&locker);
+    const Side* side = findSide(symbol, isAsk);
+
+    if (side == nullptr)
+        return 0.0;
+
+    JulyPrice requestedPrice = JulyPrice::fromDouble(price);
+    int rows = rowsThrough(*side, isAsk, requestedPrice);
+
+    if (rows == 0)
+        return 0.0;
+
+    double result = side->sizes.at(rows - 1).toDouble();
+
+    if (rows == side->levels.count() && side->levels.last().price != requestedPrice)
+        return -result;
+
+    return result;
+}
+
+double OrderBookRegistry::priceByVolume(const QString& symbol, double volume, bool isAsk)
+{
+    QMutexLocker lock(&locker);
+    const Side* side = findSide(symbol, isAsk);
+
+    if (side == nullptr)
+        return 0.0;
+
+    JulyAmount requestedSize = JulyAmount::fromDouble(volume);
+    int row = std::lower_bound(side->sizes.constBegin(), side->sizes.constEnd(), requestedSize) - side->sizes.constBegin();
+
+    if (row >= side->levels.count())
+        return -side->levels.last().price.toDouble();
+
+    return side->levels.at(row).price.toDouble();
+}
+
+double OrderBookRegistry::volumeByGroup(const QString& symbol, double price, double step, bool isAsk)
+{
+    JulyPrice groupStep = JulyPrice::fromDouble(step);
+    JulyPrice requestedPrice = JulyPrice::fromDouble(price);
+
+    if (groupStep.raw() <= 0 || requestedPrice.raw() <= 0)
+        return 0.0;
+
+    QMutexLocker lock(&locker);
+    const Side* side = findSide(symbol, isAsk);
+
+    if (side == nullptr)
+        return 0.0;
+
+    JulyPrice groupPrice = requestedPrice.roundToStep(groupStep, isAsk);
+    int firstRow = rowsThrough(*side, isAsk, isAsk ? groupPrice - groupStep : groupPrice + groupStep);
+    int endRow = rowsThrough(*side, isAsk, groupPrice);
+
+    if (endRow <= firstRow)
+        return 0.0;
+
+    JulyAmount size = side->sizes.at(endRow - 1);
+
+    if (firstRow > 0)
+        size -= side->sizes.at(firstRow - 1);
+
+    return size.toDouble();
+}
+
+const OrderBookRegistry::Side* OrderBookRegistry::findSide(const QString& symbol, bool isAsk)
+{
+    QHash<QString, Book>::iterator found = books.find(symbol.toUpper());
+
+    if (found == books.end())
+        return nullptr;
+
+    found->lastUsed = clock.elapsed();
+    const Side* side = isAsk ? &found->asks : &found->bids;
+
+    if (side->levels.isEmpty())
+        return nullptr;
+
+    return side;
+}
+
+int OrderBookRegistry::rowsThrough(const Side& side, bool isAsk, JulyPrice price) const
+{
+    AtOrBetter atOrBetter;
+    atOrBetter.isAsk = isAsk;
+
+    return std::upper_bound(side.levels.constBegin(), side.levels.constEnd(), price, atOrBetter) -
+           side.levels.constBegin();
+}
+
+void OrderBookRegistry::removeUnused()
+{
+    while (books.count() > maxBooks)
+    {
+        QHash<QString, Book>::iterator oldest = books.begin();
+
+        for (QHash<QString, Book>::iterator book = books.begin(); book != books.end(); ++book)
+            if (book->lastUsed < oldest->lastUsed)
+                oldest = book;
+
+        books.erase(oldest);
+    }
+}
@@ -0,0 +1,98 @@
+//  This file is part of Qt Bitcoin Trader
+//      https://github.com/JulyIGHOR/QtBitcoinTrader
+//  Copyright (C) 2013-2018 July IGHOR <julyighor@gmail.com>
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  In addition, as a special exception, the copyright holders give
+//  permission to link the code of portions of this program with the
+//  OpenSSL library under certain conditions as described in each
+//  individual source file, and distribute linked combinations including
+//  the two.
+//
+//  You must obey the GNU General Public License in all respects for all
+//  of the code used other than OpenSSL. If you modify file(s) with this
+//  exception, you may extend this exception to your version of the
+//  file(s), but you are not obligated to do so. If you do not wish to do
+//  so, delete this exception statement from your version. If you delete
+//  this exception statement from all source files in the program, then
+//  also delete it here.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ORDERBOOKREGISTRY_H
+#define ORDERBOOKREGISTRY_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QStringList>
+#include "orderbook.h"
+
+// Last known depth of every pair the exchange thread has published, keyed by symbol.
+// Books are copied here best price first with running sizes, so scripts and rules can
+// ask about any kept pair from their own thread and a pair switch can start from the kept book.
+// At most maxBooks books of maxLevels rows a side are kept, the least recently used goes first.
+class OrderBookRegistry
+{
+public:
+    OrderBookRegistry();
+
+    static OrderBookRegistry* global();
+
+    void setLimits(int maxBooks, int maxLevels);
+    void setWatched(const QStringList& symbols);
+
+    // Scripts asking about a pair keep it polled for as long as they keep asking
+    void watch(const QString& symbol);
+    QStringList watchedSymbols();
+    bool isWatched(const QString& symbol);
+
+    // Exchange thread only, the shown pair is published on every change only while watched
+    void publish(const QString& symbol, OrderBook& book);
+    bool restore(const QString& symbol, OrderBook* book);
+
+    // Same results as the depth models, negative when the answer lies past the kept rows
+    double volumeByPrice(const QString& symbol, double price, bool isAsk);
+    double priceByVolume(const QString& symbol, double volume, bool isAsk);
+    double volumeByGroup(const QString& symbol, double price, double step, bool isAsk);
+
+private:
+    struct Side
+    {
+        QVector<OrderBookLevel> levels;
+        QVector<JulyAmount> sizes;
+    };
+
+    struct Book
+    {
+        Side asks;
+        Side bids;
+        qint64 lastUsed;
+    };
+
+    QMutex locker;
+    QHash<QString, Book> books;
+    QStringList watchedList;
+    QHash<QString, qint64> requestedTime;
+    QElapsedTimer clock;
+    int maxBooks;
+    int maxLevels;
+
+    static const qint64 requestTimeout = 60000;
+
+    const Side* findSide(const QString& symbol, bool isAsk);
+    int rowsThrough(const Side& side, bool isAsk, JulyPrice price) const;
+    void removeUnused();
+};
+
+#endif // ORDERBOOKREGISTRY_H
@@ -30,57 +30,13 @@
 //  along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "orderitem.h"
-#include "main.h"
-#include "julymath.h"
-#include "iniengine.h"
 
 bool OrderItem::isValid()
 {
     bool isVal = date > 0 && price > 0.0 && symbol.size() >= 5;
 
     if (isVal)
-    {
-        QDateTime itemDate = QDateTime::fromTime_t(date);
-
-        if (baseValues_->use24HourTimeFormat)
-        {
-            dateStr = itemDate.toString(baseValues.dateTimeFormat);
-        }
-        else
-        {
-            QString mmssTemp = itemDate.toString("mm:ss");
-            QString hTemp = itemDate.toString("H");
-            qint16 hTempInt = hTemp.toShort();
-            QString timeStr;
-
-            if (hTempInt <= 12)
-                timeStr = hTemp + ':' + mmssTemp + " am";
-            else
-                timeStr = QString::number(hTempInt - 12) + ':' + mmssTemp + " pm";
-
-            dateStr = itemDate.toString("dd.MM.yyyy") + ' ' + timeStr;
-        }
-
-        QString currAStr, currBStr;
-        int posSplitter = symbol.indexOf('/');
-
-        if (posSplitter == -1)
-        {
-            currAStr = symbol.left(3);
-            currBStr = symbol.right(3);
-        }
-        else
-        {
-            currAStr = symbol.left(posSplitter);
-            currBStr = symbol.right(symbol.size() - posSplitter - 1);
-        }
-
-        QString priceSign = IniEngine::getCurrencyInfo(currBStr).sign;
-        amountStr = IniEngine::getCurrencyInfo(currAStr).sign + JulyMath::textFromDouble(amount);
-        priceStr = priceSign + JulyMath::textFromDouble(price);
         total = price * amount;
-        totalStr = priceSign + JulyMath::textFromDouble(total, baseValues.currentPair.currBDecimals);
-    }
 
     return isVal;
 }
@@ -32,6 +32,8 @@
 #include "ordersmodel.h"
 #include "main.h"
 #include "exchange/exchange.h"
+#include "julymath.h"
+#include "iniengine.h"
 
 OrdersModel::OrdersModel()
     : QAbstractItemModel()
@@ -83,16 +85,14 @@ void OrdersModel::clear()
     currentBidsPrices.clear();
     oidList.clear();
     dateList.clear();
-    dateStrList.clear();
     typesList.clear();
     statusList.clear();
     amountList.clear();
-    amountStrList.clear();
     priceList.clear();
-    priceStrList.clear();
     totalList.clear();
-    totalStrList.clear();
     symbolList.clear();
+    generationList.clear();
+    textCache.clear();
 
     haveOrders = false;
 
@@ -171,9 +171,9 @@ void OrdersModel::orderBookChanged(QList<OrderItem>* ordersRcv)
         if (ordersRcv->at(n).status > 0 && orderSymbol == baseValues.currentPair.symbol)
         {
             if (isAsk)
-                currentAsksPrices[ordersRcv->at(n).price] = true;
+                currentAsksPrices.insert(JulyPrice::fromDouble(ordersRcv->at(n).price));
             else
-                currentBidsPrices[ordersRcv->at(n).price] = true;
+                currentBidsPrices.insert(JulyPrice::fromDouble(ordersRcv->at(n).price));
         }
 
         existingOids.insert(ordersRcv->at(n).oid, true);
@@ -206,13 +206,10 @@ void OrdersModel::orderBookChanged(QList<OrderItem>* ordersRcv)
                 statusList[currentIndex] = ordersRcv->at(n).status;
 
                 amountList[currentIndex] = ordersRcv->at(n).amount;
-                amountStrList[currentIndex] = ordersRcv->at(n).amountStr;
-
                 priceList[currentIndex] = ordersRcv->at(n).price;
-                priceStrList[currentIndex] = ordersRcv->at(n).priceStr;
-
                 totalList[currentIndex] = ordersRcv->at(n).total;
-                totalStrList[currentIndex] = ordersRcv->at(n).totalStr;
+
+                generationList[currentIndex] = RowTextCache::newGeneration();
             }
         }
         else
@@ -223,21 +220,15 @@ void OrdersModel::orderBookChanged(QList<OrderItem>* ordersRcv)
             oidList.insert(currentIndex, ordersRcv->at(n).oid);
 
             dateList.insert(currentIndex, ordersRcv->at(n).date);
-            dateStrList.insert(currentIndex, ordersRcv->at(n).dateStr);
 
             typesList.insert(currentIndex, ordersRcv->at(n).type);
             statusList.insert(currentIndex, ordersRcv->at(n).status);
 
             amountList.insert(currentIndex, ordersRcv->at(n).amount);
-            amountStrList.insert(currentIndex, ordersRcv->at(n).amountStr);
-
             priceList.insert(currentIndex, ordersRcv->at(n).price);
-            priceStrList.insert(currentIndex, ordersRcv->at(n).priceStr);
-
             totalList.insert(currentIndex, ordersRcv->at(n).total);
-            totalStrList.insert(currentIndex, ordersRcv->at(n).totalStr);
-
             symbolList.insert(currentIndex, ordersRcv->at(n).symbol);
+            generationList.insert(currentIndex, RowTextCache::newGeneration());
 
             if (checkDuplicatedOID)
                 oidMapForCheckingDuplicates.insert(ordersRcv->at(n).oid, ordersRcv->at(n).date);
@@ -258,16 +249,13 @@ void OrdersModel::orderBookChanged(QList<OrderItem>* ordersRcv)
 
             oidList.removeAt(n);
             dateList.removeAt(n);
-            dateStrList.removeAt(n);
             typesList.removeAt(n);
             statusList.removeAt(n);
             amountList.removeAt(n);
-            amountStrList.removeAt(n);
             priceList.removeAt(n);
-            priceStrList.removeAt(n);
             totalList.removeAt(n);
-            totalStrList.removeAt(n);
             symbolList.removeAt(n);
+            generationList.removeAt(n);
             endRemoveRows();
         }
 
@@ -317,6 +305,76 @@ void OrdersModel::ordersBidsCountChanged()
     }
 }
 
+QString OrdersModel::rowText(int row, TextField field) const
+{
+    const QString* cachedText = textCache.find(generationList.at(row), field);
+
+    if (cachedText)
+        return *cachedText;
+
+    QString text;
+
+    if (field == DateText)
+    {
+        QDateTime itemDate = QDateTime::fromTime_t(dateList.at(row));
+
+        if (baseValues_->use24HourTimeFormat)
+        {
+            text = itemDate.toString(baseValues.dateTimeFormat);
+        }
+        else
+        {
+            QString mmssTemp = itemDate.toString("mm:ss");
+            QString hTemp = itemDate.toString("H");
+            qint16 hTempInt = hTemp.toShort();
+            QString timeStr;
+
+            if (hTempInt <= 12)
+                timeStr = hTemp + ':' + mmssTemp + " am";
+            else
+                timeStr = QString::number(hTempInt - 12) + ':' + mmssTemp + " pm";
+
+            text = itemDate.toString("dd.MM.yyyy") + ' ' + timeStr;
+        }
+    }
+    else
+    {
+        const QString& symbol = symbolList.at(row);
+        QString currAStr, currBStr;
+        int posSplitter = symbol.indexOf('/');
+
+        if (posSplitter == -1)
+        {
+            currAStr = symbol.left(3);
+            currBStr = symbol.right(3);
+        }
+        else
+        {
+            currAStr = symbol.left(posSplitter);
+            currBStr = symbol.right(symbol.size() - posSplitter - 1);
+        }
+
+        switch (field)
+        {
+            case AmountText:
+                text = IniEngine::getCurrencyInfo(currAStr).sign + JulyMath::textFromDouble(amountList.at(row));
+                break;
+
+            case PriceText:
+                text = IniEngine::getCurrencyInfo(currBStr).sign + JulyMath::textFromDouble(priceList.at(row));
+                break;
+
+            default:
+                text = IniEngine::getCurrencyInfo(currBStr).sign + JulyMath::textFromDouble(totalList.at(row),
+                        baseValues.currentPair.currBDecimals);
+                break;
+        }
+    }
+
+    textCache.insert(generationList.at(row), field, text);
+    return text;
+}
+
 QVariant OrdersModel::data(const QModelIndex& index, int role) const
 {
     if (!index.isValid())
@@ -379,7 +437,7 @@ QVariant OrdersModel::data(const QModelIndex& index, int role) const
 
     if (role == Qt::StatusTipRole)
     {
-        QString copyText = dateStrList.at(currentRow) + "\t" + (typesList.at(currentRow) ? textAsk : textBid) + "\t";
+        QString copyText = rowText(currentRow, DateText) + "\t" + (typesList.at(currentRow) ? textAsk : textBid) + "\t";
 
         switch (statusList.at(currentRow))
         {
@@ -404,9 +462,9 @@ QVariant OrdersModel::data(const QModelIndex& index, int role) const
                 break;
         }
 
-        copyText += amountStrList.at(currentRow) + "\t";
-        copyText += priceStrList.at(currentRow) + "\t";
-        copyText += totalStrList.at(currentRow);
+        copyText += rowText(currentRow, AmountText) + "\t";
+        copyText += rowText(currentRow, PriceText) + "\t";
+        copyText += rowText(currentRow, TotalText);
 
         return copyText;
     }
@@ -467,7 +525,7 @@ QVariant OrdersModel::data(const QModelIndex& index, int role) const
         case 0:
             {
                 //Date
-                return dateStrList.at(currentRow);
+                return rowText(currentRow, DateText);
             }
             break;
 
@@ -509,21 +567,21 @@ QVariant OrdersModel::data(const QModelIndex& index, int role) const
         case 3:
             {
                 //Amount
-                return amountStrList.at(currentRow);
+                return rowText(currentRow, AmountText);
             }
             break;
 
         case 4:
             {
                 //Price
-                return priceStrList.at(currentRow);
+                return rowText(currentRow, PriceText);
             }
             break;
 
         case 5:
             {
                 //Total
-                return totalStrList.at(currentRow);
+                return rowText(currentRow, TotalText);
             }
             break;
 
@@ -571,9 +629,9 @@ void OrdersModel::setOrderCanceled(QByteArray oid)
             if (symbolList.at(n) == baseValues.currentPair.symbol)
             {
                 if (typesList.at(n))
-                    currentAsksPrices.remove(priceList.at(n));
+                    currentAsksPrices.remove(JulyPrice::fromDouble(priceList.at(n)));
                 else
-                    currentBidsPrices.remove(priceList.at(n));
+                    currentBidsPrices.remove(JulyPrice::fromDouble(priceList.at(n)));
             }
 
             break;
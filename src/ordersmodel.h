@@ -34,7 +34,10 @@
 
 #include <QAbstractItemModel>
 #include <QStringList>
+#include <QSet>
 #include "orderitem.h"
+#include "julyfixed.h"
+#include "rowtextcache.h"
 
 class OrdersModel : public QAbstractItemModel
 {
@@ -51,8 +54,8 @@ public:
     double getRowVolume(int row);
     double getRowTotal(int row);
 
-    QMap<double, bool> currentAsksPrices;
-    QMap<double, bool> currentBidsPrices;
+    QSet<JulyPrice> currentAsksPrices;
+    QSet<JulyPrice> currentBidsPrices;
 
     bool checkDuplicatedOID;
     void ordersCancelAll(QString pair = 0);
@@ -89,6 +92,10 @@ signals:
     void volumeAmountChanged(double, double);
 
 private:
+    enum TextField {DateText, AmountText, PriceText, TotalText};
+    QString rowText(int row, TextField field) const;
+    mutable RowTextCache textCache;
+
     void ordersCountChanged();
     void ordersAsksCountChanged();
     void ordersBidsCountChanged();
@@ -117,22 +124,20 @@ private:
     QList<QByteArray> oidList;
 
     QList<quint32> dateList;
-    QStringList dateStrList;
 
     QList<bool> typesList;
 
     QList<int> statusList;
 
     QList<double> amountList;
-    QStringList amountStrList;
 
     QList<double> priceList;
-    QStringList priceStrList;
 
     QList<double> totalList;
-    QStringList totalStrList;
 
     QStringList symbolList;
+
+    QList<quint64> generationList;
 };
 
 #endif // ORDERSMODEL_H
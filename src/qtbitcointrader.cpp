@@ -30,6 +30,7 @@
 //  along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "julyspinboxpicker.h"
+#include "julyfixed.h"
 #include <QTableWidget>
 #include <QTimeLine>
 #include <QScrollBar>
@@ -81,6 +82,11 @@
 #include "utils/utils.h"
 #include "settings/settingsdialog.h"
 #include "indicatorengine.h"
+#include "barengine.h"
+#include "technicalindicators.h"
+#include "tickstore.h"
+#include "storedtradesreader.h"
+#include "orderbookregistry.h"
 #include "charts/chartsmodel.h"
 #include "menu/networkmenu.h"
 #include "menu/currencymenu.h"
@@ -130,6 +136,7 @@ QtBitcoinTrader::QtBitcoinTrader() :
     historyModel(nullptr),
     isDataPending(false),
     waitingDepthLag(false),
+    depthDrainScheduled(false),
     trayMenu(nullptr),
     trayIcon(nullptr),
     checkForUpdates(true),
@@ -156,6 +163,9 @@ QtBitcoinTrader::QtBitcoinTrader() :
     networkMenu(nullptr),
     currencyMenu(nullptr),
     currencySignLoader(new CurrencySignLoader),
+    storedTradesReader(new StoredTradesReader),
+    storedTradesReadId(0),
+    storedTradesPending(false),
 
     lockedDocks(false),
     actionExit(nullptr),
@@ -176,6 +186,7 @@ QtBitcoinTrader::QtBitcoinTrader() :
     dockLogo(nullptr)
 {
     depthLagTime.restart();
+    depthDrainTime.restart();
     softLagTime.restart();
 
     ui.setupUi(this);
@@ -225,6 +236,26 @@ QtBitcoinTrader::QtBitcoinTrader() :
             SLOT(checkValidOrdersButtons()));
 
     tradesModel = new TradesModel;
+    tradesModel->setWindowSeconds(iniSettings->value("UI/TradesWindowSeconds", 600).toInt());
+    iniSettings->setValue("UI/TradesWindowSeconds", tradesModel->windowSeconds());
+
+    int barsHistoryLimit = iniSettings->value("UI/BarsHistoryLimit", 1000).toInt();
+
+    if (barsHistoryLimit < 1)
+        barsHistoryLimit = 1000;
+
+    iniSettings->setValue("UI/BarsHistoryLimit", barsHistoryLimit);
+    BarEngine::global()->setHistoryLimit(barsHistoryLimit);
+
+    int tickStoreRetentionDays = iniSettings->value("UI/TickStoreRetentionDays", 7).toInt();
+
+    if (tickStoreRetentionDays < 1)
+        tickStoreRetentionDays = 7;
+
+    iniSettings->setValue("UI/TickStoreRetentionDays", tickStoreRetentionDays);
+    TickStore::global()->setRetentionDays(tickStoreRetentionDays);
+    TickStore::global()->setEnabled(iniSettings->value("UI/TickStoreEnabled", true).toBool());
+    iniSettings->setValue("UI/TickStoreEnabled", TickStore::global()->isEnabled());
     ui.tableTrades->setModel(tradesModel);
     setColumnResizeMode(ui.tableTrades, 0, QHeaderView::Stretch);
     setColumnResizeMode(ui.tableTrades, 1, QHeaderView::ResizeToContents);
@@ -376,6 +407,22 @@ QtBitcoinTrader::QtBitcoinTrader() :
 
     ui.depthComboBoxLimitRows->setCurrentIndex(currentDepthComboBoxLimitIndex);
 
+    int depthKeptBooks = iniSettings->value("UI/DepthKeptBooks", 8).toInt();
+    int depthKeptLevels = iniSettings->value("UI/DepthKeptLevels", 500).toInt();
+    QStringList depthWatchSymbols = iniSettings->value("UI/DepthWatchSymbols", QStringList()).toStringList();
+
+    if (depthKeptBooks < 1)
+        depthKeptBooks = 8;
+
+    if (depthKeptLevels < 1)
+        depthKeptLevels = 500;
+
+    iniSettings->setValue("UI/DepthKeptBooks", depthKeptBooks);
+    iniSettings->setValue("UI/DepthKeptLevels", depthKeptLevels);
+    iniSettings->setValue("UI/DepthWatchSymbols", depthWatchSymbols);
+    OrderBookRegistry::global()->setLimits(depthKeptBooks, depthKeptLevels);
+    OrderBookRegistry::global()->setWatched(depthWatchSymbols);
+
     baseValues.apiDownCount = iniSettings->value("Network/ApiDownCounterMax", 5).toInt();
 
     if (baseValues.apiDownCount < 0)
@@ -402,6 +449,23 @@ QtBitcoinTrader::QtBitcoinTrader() :
 
     iniSettings->setValue("Network/HttpRetryCount", baseValues.httpRetryCount);
 
+    baseValues.httpConnectionsCount = iniSettings->value("Network/HttpConnectionsCount", 3).toInt();
+
+    if (baseValues.httpConnectionsCount < 1 || baseValues.httpConnectionsCount > 8)
+        baseValues.httpConnectionsCount = 3;
+
+    iniSettings->setValue("Network/HttpConnectionsCount", baseValues.httpConnectionsCount);
+
+    baseValues.httpConnectionRequestsLimit = iniSettings->value("Network/HttpConnectionRequestsLimit", 1).toInt();
+
+    if (baseValues.httpConnectionRequestsLimit < 1 || baseValues.httpConnectionRequestsLimit > 10)
+        baseValues.httpConnectionRequestsLimit = 1;
+
+    iniSettings->setValue("Network/HttpConnectionRequestsLimit", baseValues.httpConnectionRequestsLimit);
+
+    baseValues.webSocketsEnabled = iniSettings->value("Network/WebSocketsEnabled", true).toBool();
+    iniSettings->setValue("Network/WebSocketsEnabled", baseValues.webSocketsEnabled);
+
     baseValues.uiUpdateInterval = iniSettings->value("UI/UiUpdateInterval", 100).toInt();
 
     if (baseValues.uiUpdateInterval < 1)
@@ -599,6 +663,12 @@ QtBitcoinTrader::QtBitcoinTrader() :
     connect(tradesModel, &TradesModel::addChartsTrades, chartsView->chartsModel.data(), &ChartsModel::addLastTrades);
     connect(this, &QtBitcoinTrader::clearCharts, chartsView->chartsModel.data(), &ChartsModel::clearCharts);
     connect(this, &QtBitcoinTrader::addBound, chartsView->chartsModel.data(), &ChartsModel::addBound);
+    connect(storedTradesReader.data(), &StoredTradesReader::barsTradesRead, this,
+            &QtBitcoinTrader::storedBarsTradesRead);
+    connect(storedTradesReader.data(), &StoredTradesReader::chartsTradesRead, this,
+            &QtBitcoinTrader::storedChartsTradesRead);
+    connect(storedTradesReader.data(), &StoredTradesReader::readFinished, this,
+            &QtBitcoinTrader::storedTradesReadFinished);
     ui.chartsLayout->addWidget(chartsView);
 
     newsView = new NewsView();
@@ -1432,11 +1502,10 @@ void QtBitcoinTrader::anyDataReceived()
 
 double QtBitcoinTrader::getFeeForUSDDec(double usd)
 {
-    double result = JulyMath::cutDoubleDecimalsCopy(usd, baseValues.currentPair.currBDecimals, false);
-    double calcFee = JulyMath::cutDoubleDecimalsCopy(result, baseValues.currentPair.priceDecimals, true) * floatFee;
-    calcFee = JulyMath::cutDoubleDecimalsCopy(calcFee, baseValues.currentPair.priceDecimals, true);
-    result = result - calcFee;
-    return result;
+    JulyAmount result = JulyAmount::fromDouble(qMax(usd, 0.0)).cut(baseValues.currentPair.currBDecimals);
+    JulyAmount calcFee = JulyAmount::fromDouble(result.cut(baseValues.currentPair.priceDecimals, true).toDouble() * floatFee);
+    result -= calcFee.cut(baseValues.currentPair.priceDecimals, true);
+    return result.toDouble();
 }
 
 void QtBitcoinTrader::addPopupDialog(int val)
@@ -1565,6 +1634,12 @@ void QtBitcoinTrader::addLastTrades(QString symbol, QList<TradesItem>* newItems)
         return;
     }
 
+    // Bars of the pair whose history is still being read take these after it
+    if (storedTradesPending && baseValues.currentPair.symbol == symbol)
+        heldBarsTrades << *newItems;
+    else
+        BarEngine::global()->addTrades(*newItems);
+
     if (baseValues.currentPair.symbol != symbol)
     {
         delete newItems;
@@ -1599,7 +1674,7 @@ void QtBitcoinTrader::clearTimeOutedTrades()
         return;
 
     int lastSliderValue = ui.tableTrades->verticalScrollBar()->value();
-    tradesModel->removeDataOlderThen(TimeSync::getTimeT() - 600);
+    tradesModel->removeDataOlderThen(TimeSync::getTimeT() - tradesModel->windowSeconds());
     ui.tableTrades->verticalScrollBar()->setValue(qMin(lastSliderValue, ui.tableTrades->verticalScrollBar()->maximum()));
 }
 
@@ -2115,8 +2190,6 @@ void QtBitcoinTrader::currencyMenuChanged(int val)
         emit clearValues();
     }
 
-    clearDepth();
-
     marketPricesNotLoaded = true;
     balanceNotLoaded = true;
     fixDecimals(this);
@@ -2124,6 +2197,9 @@ void QtBitcoinTrader::currencyMenuChanged(int val)
     iniSettings->sync();
 
     baseValues.currentPair = nextCurrencyPair;
+
+    // The exchange picks the kept book of the new pair on reload, so the pair has to be set first
+    clearDepth();
     depthAsksModel->fixTitleWidths();
     depthBidsModel->fixTitleWidths();
 
@@ -2146,19 +2222,20 @@ void QtBitcoinTrader::currencyMenuChanged(int val)
     emit getHistory(true);
     emit clearCharts();
     chartsView->clearCharts();
-
-    setSpinValue(ui.marketHigh, IndicatorEngine::getValue(baseValues.exchangeName +
-                 '_' + baseValues.currentPair.symbol + "_High"));
-    setSpinValue(ui.marketLow, IndicatorEngine::getValue(baseValues.exchangeName +
-                 '_' + baseValues.currentPair.symbol + "_Low"));
-    setSpinValue(ui.marketLast, IndicatorEngine::getValue(baseValues.exchangeName +
-                 '_' + baseValues.currentPair.symbol + "_Last"));
-    setSpinValue(ui.marketVolume, IndicatorEngine::getValue(baseValues.exchangeName +
-                 '_' + baseValues.currentPair.symbol + "_Volume"));
-    setSpinValue(ui.marketAsk, IndicatorEngine::getValue(baseValues.exchangeName +
-                 '_' + baseValues.currentPair.symbol + "_Buy"));
-    setSpinValue(ui.marketBid, IndicatorEngine::getValue(baseValues.exchangeName +
-                 '_' + baseValues.currentPair.symbol + "_Sell"));
+    loadStoredTrades();
+
+    setSpinValue(ui.marketHigh, IndicatorEngine::getValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                 IndicatorEngine::High));
+    setSpinValue(ui.marketLow, IndicatorEngine::getValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                 IndicatorEngine::Low));
+    setSpinValue(ui.marketLast, IndicatorEngine::getValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                 IndicatorEngine::Last));
+    setSpinValue(ui.marketVolume, IndicatorEngine::getValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                 IndicatorEngine::Volume));
+    setSpinValue(ui.marketAsk, IndicatorEngine::getValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                 IndicatorEngine::Buy));
+    setSpinValue(ui.marketBid, IndicatorEngine::getValue(baseValues.exchangeName, baseValues.currentPair.symbol,
+                 IndicatorEngine::Sell));
 
     if (qFuzzyIsNull(ui.marketAsk->value()))
         ui.buyPricePerCoin->setValue(100.0);
@@ -2172,10 +2249,77 @@ void QtBitcoinTrader::currencyMenuChanged(int val)
 }
 
 void QtBitcoinTrader::clearDepth()
+{
+    clearDepthModels();
+    emit reloadDepth();
+}
+
+void QtBitcoinTrader::loadStoredTrades()
+{
+    // Trades held for a pair left before its history arrived are not waiting for anything now
+    if (!heldBarsTrades.isEmpty())
+    {
+        BarEngine::global()->addTrades(heldBarsTrades);
+        heldBarsTrades.clear();
+    }
+
+    QString symbol = baseValues.currentPair.symbol;
+
+    // Bars of a pair shown before are still warm, the first time they start from the last day
+    bool withBars = BarEngine::global()->barsCount(symbol, BarEngine::Minute1) == 0;
+    qint32 chartsSpan = 0;
+
+    if (chartsView)
+    {
+        chartsSpan = chartsView->chartsModel->historySpan();
+        chartsView->chartsModel->holdLastTrades(true);
+    }
+
+    storedTradesPending = true;
+    storedTradesReadId = storedTradesReader->read(baseValues.exchangeName, symbol, TimeSync::getTimeT(), withBars,
+                                                  chartsSpan);
+}
+
+void QtBitcoinTrader::storedBarsTradesRead(quint32 readId, QString symbol, QList<TradesItem>* trades)
+{
+    if (readId == storedTradesReadId)
+        BarEngine::global()->addStoredTrades(symbol, *trades);
+
+    delete trades;
+}
+
+void QtBitcoinTrader::storedChartsTradesRead(quint32 readId, QList<TradesItem>* trades)
+{
+    if (readId != storedTradesReadId || chartsView == nullptr)
+    {
+        delete trades;
+        return;
+    }
+
+    chartsView->chartsModel->addStoredTrades(trades);
+}
+
+void QtBitcoinTrader::storedTradesReadFinished(quint32 readId)
+{
+    if (readId != storedTradesReadId)
+        return;
+
+    storedTradesPending = false;
+    BarEngine::global()->addTrades(heldBarsTrades);
+    heldBarsTrades.clear();
+
+    if (chartsView)
+        chartsView->chartsModel->holdLastTrades(false);
+}
+
+void QtBitcoinTrader::clearDepthModels()
 {
     depthAsksModel->clear();
     depthBidsModel->clear();
-    emit reloadDepth();
+
+    // Deltas already queued were made against the rows just dropped
+    if (currentExchange)
+        currentExchange->depthQueue.requestResync();
 }
 
 void QtBitcoinTrader::volumeAmountChanged(double volumeTotal, double amountTotal)
@@ -3614,13 +3758,8 @@ void QtBitcoinTrader::on_widgetStaysOnTop_toggled(bool on)
     windowWidget->show();
 }
 
-void QtBitcoinTrader::depthFirstOrder(QString symbol, double price, double volume, bool isAsk)
+void QtBitcoinTrader::depthFirstOrder(double price, double volume, bool isAsk)
 {
-    if (symbol != baseValues.currentPair.symbol)
-        return;
-
-    waitingDepthLag = false;
-
     if (price == 0.0 || ui.comboBoxGroupByPrice->currentIndex() == 0)
         return;
 
@@ -3653,16 +3792,98 @@ void QtBitcoinTrader::fixDepthBidsTable()
     ui.tabDepth->setMinimumWidth(qMax(ui.gridLayout_31->minimumSize().width(), asksWidth + bidsWidth + 24));
 }
 
-void QtBitcoinTrader::depthSubmitOrders(QString symbol, QList<DepthItem>* asks, QList<DepthItem>* bids)
+void QtBitcoinTrader::depthDeltasReady()
 {
-    if (symbol != baseValues.currentPair.symbol)
+    if (depthDrainScheduled)
+        return;
+
+    // At most one drain per frame, deltas arriving in between wait in the queue
+    static const int depthFrameInterval = 33;
+    depthDrainScheduled = true;
+    QTimer::singleShot(qMax(0, depthFrameInterval - depthDrainTime.elapsed()), this, SLOT(drainDepthDeltas()));
+}
+
+void QtBitcoinTrader::drainDepthDeltas()
+{
+    depthDrainScheduled = false;
+    depthDrainTime.restart();
+
+    if (currentExchange == nullptr)
+        return;
+
+    DepthDeltaQueue& depthQueue = currentExchange->depthQueue;
+    depthQueue.readerWoken();
+
+    bool resetBook = false;
+    bool haveFirstLevel[2] = {false, false};
+    DepthItem firstLevel[2];
+    QHash<double, int> batchIndex[2];
+    depthAsksBatch.clear();
+    depthBidsBatch.clear();
+
+    DepthDelta delta;
+
+    while (depthQueue.pop(&delta))
+    {
+        int side = delta.isAsk ? 0 : 1;
+        QVector<DepthItem>& batch = delta.isAsk ? depthAsksBatch : depthBidsBatch;
+
+        switch (delta.kind)
+        {
+            case DepthDelta::Reset:
+                resetBook = true;
+                haveFirstLevel[0] = haveFirstLevel[1] = false;
+                batchIndex[0].clear();
+                batchIndex[1].clear();
+                depthAsksBatch.clear();
+                depthBidsBatch.clear();
+                break;
+
+            case DepthDelta::FirstLevel:
+                haveFirstLevel[side] = true;
+                firstLevel[side].price = delta.price;
+                firstLevel[side].volume = delta.volume;
+                break;
+
+            default:
+                {
+                    // Only the last state of a level within one frame is shown
+                    int batchRow = batchIndex[side].value(delta.price, -1);
+
+                    if (batchRow < 0)
+                    {
+                        DepthItem newItem;
+                        newItem.price = delta.price;
+                        newItem.volume = delta.volume;
+                        batchIndex[side].insert(delta.price, batch.count());
+                        batch.append(newItem);
+                    }
+                    else
+                        batch[batchRow].volume = delta.volume;
+                }
+                break;
+        }
+    }
+
+    if (!resetBook && !haveFirstLevel[0] && !haveFirstLevel[1] && depthAsksBatch.isEmpty() && depthBidsBatch.isEmpty())
         return;
 
     waitingDepthLag = false;
+
+    if (resetBook)
+    {
+        depthAsksModel->clear();
+        depthBidsModel->clear();
+    }
+
+    for (int side = 0; side < 2; side++)
+        if (haveFirstLevel[side])
+            depthFirstOrder(firstLevel[side].price, firstLevel[side].volume, side == 0);
+
     int currentAsksScroll = ui.depthAsksTable->verticalScrollBar()->value();
     int currentBidsScroll = ui.depthBidsTable->verticalScrollBar()->value();
-    depthAsksModel->depthUpdateOrders(asks);
-    depthBidsModel->depthUpdateOrders(bids);
+    depthAsksModel->depthUpdateOrders(depthAsksBatch);
+    depthBidsModel->depthUpdateOrders(depthBidsBatch);
     ui.depthAsksTable->verticalScrollBar()->setValue(qMin(currentAsksScroll,
             ui.depthAsksTable->verticalScrollBar()->maximum()));
     ui.depthBidsTable->verticalScrollBar()->setValue(qMin(currentBidsScroll,
@@ -3730,7 +3951,8 @@ void QtBitcoinTrader::on_comboBoxGroupByPrice_currentIndexChanged(int val)
     baseValues.groupPriceValue = ui.comboBoxGroupByPrice->itemData(val, Qt::UserRole).toDouble();
     iniSettings->setValue("UI/DepthGroupByPrice", baseValues.groupPriceValue);
     iniSettings->sync();
-    clearDepth();
+    clearDepthModels();
+    emit regroupDepth();
 }
 
 void QtBitcoinTrader::on_depthAutoResize_toggled(bool on)
@@ -3797,18 +4019,22 @@ double QtBitcoinTrader::getAvailableUSD()
 
 double QtBitcoinTrader::getAvailableUSDtoBTC(double priceToBuy)
 {
+    if (priceToBuy <= 0.0)
+        return 0.0;
+
     double avUSD = getAvailableUSD();
-    double decValue = 0.0;
+    JulyAmount decValue;
 
     if (floatFee > 0.0)
     {
         if (currentExchange->calculatingFeeMode == 1)
-            decValue = qPow(0.1, qMax(baseValues.currentPair.currADecimals, 1));
+            decValue = JulyAmount::fromDouble(qPow(0.1, qMax(baseValues.currentPair.currADecimals, 1)));
         else if (currentExchange->calculatingFeeMode == 2)
-            decValue = 2.0 * qPow(0.1, qMax(baseValues.currentPair.currADecimals, 1));
+            decValue = JulyAmount::fromDouble(2.0 * qPow(0.1, qMax(baseValues.currentPair.currADecimals, 1)));
     }
 
-    return JulyMath::cutDoubleDecimalsCopy(avUSD / priceToBuy - decValue, baseValues.currentPair.currADecimals, false);
+    JulyAmount result = JulyAmount::fromDoubleFloor(avUSD / priceToBuy) - decValue;
+    return qMax(result.cut(baseValues.currentPair.currADecimals).toDouble(), 0.0);
 }
 
 void QtBitcoinTrader::apiSellSend(QString symbol, double btc, double price)
@@ -3968,18 +4194,39 @@ void QtBitcoinTrader::setSpinValue(QDoubleSpinBox* spin, double val)
     setSpinValueP(spin, val);
 }
 
+QString QtBitcoinTrader::watchDepthSymbol(QString symbol)
+{
+    CurrencyPairItem pairItem;
+    pairItem = baseValues.currencyPairMap.value(symbol.toUpper(), pairItem);
+
+    if (!pairItem.symbol.isEmpty())
+        OrderBookRegistry::global()->watch(pairItem.symbol);
+
+    return pairItem.symbol;
+}
+
 double QtBitcoinTrader::getVolumeByPrice(QString symbol, double price, bool isAsk)
 {
     if (!baseValues.currentPair.symbolSecond().startsWith(symbol, Qt::CaseInsensitive))
-        return 0.0;
+        return OrderBookRegistry::global()->volumeByPrice(watchDepthSymbol(symbol), price, isAsk);
 
     return (isAsk ? depthAsksModel : depthBidsModel)->getVolumeByPrice(price, isAsk);
 }
 
+double QtBitcoinTrader::getVolumeByGroup(QString symbol, double price, double step, bool isAsk)
+{
+    // The depth models only hold the rows shown with the current grouping, so the shown pair is
+    // answered from its ungrouped copy in the registry too, published on every change while watched
+    if (baseValues.currentPair.symbolSecond().startsWith(symbol, Qt::CaseInsensitive))
+        symbol = baseValues.currentPair.symbol;
+
+    return OrderBookRegistry::global()->volumeByGroup(watchDepthSymbol(symbol), price, step, isAsk);
+}
+
 double QtBitcoinTrader::getPriceByVolume(QString symbol, double size, bool isAsk)
 {
     if (!baseValues.currentPair.symbolSecond().startsWith(symbol, Qt::CaseInsensitive))
-        return 0.0;
+        return OrderBookRegistry::global()->priceByVolume(watchDepthSymbol(symbol), size, isAsk);
 
     return (isAsk ? depthAsksModel : depthBidsModel)->getPriceByVolume(size);
 }
@@ -4337,6 +4584,8 @@ bool QtBitcoinTrader::confirmExitApp()
 void QtBitcoinTrader::exitApp()
 {
     secondTimer.reset();
+    storedTradesReader->stopThread();
+    TechnicalIndicators::global()->stopThread();
 
     saveAppState();
     ::config->save("");
@@ -67,6 +67,7 @@ class DockHost;
 class NetworkMenu;
 class CurrencyMenu;
 class CurrencySignLoader;
+class StoredTradesReader;
 
 struct GroupStateItem
 {
@@ -172,6 +173,7 @@ public:
 
     double getVolumeByPrice(QString symbol, double price, bool isAsk);
     double getPriceByVolume(QString symbol, double size, bool isAsk);
+    double getVolumeByGroup(QString symbol, double price, double step, bool isAsk);
 
     bool closeToTray;
 
@@ -197,6 +199,9 @@ private:
     HistoryModel* historyModel;
     void fixDepthBidsTable();
     void clearDepth();
+    void clearDepthModels();
+    void loadStoredTrades();
+    QString watchDepthSymbol(QString symbol);
     void calcOrdersTotalValues();
     void ruleTotalToBuyValueChanged();
     void ruleAmountToReceiveValueChanged();
@@ -206,6 +211,11 @@ private:
     QTime softLagTime;
     QTime depthLagTime;
     bool waitingDepthLag;
+    QTime depthDrainTime;
+    bool depthDrainScheduled;
+    QVector<DepthItem> depthAsksBatch;
+    QVector<DepthItem> depthBidsBatch;
+    void depthFirstOrder(double price, double volume, bool isAsk);
 
     QMenu* trayMenu;
     QString windowTitleP;
@@ -262,6 +272,10 @@ private:
     NetworkMenu* networkMenu;
     CurrencyMenu* currencyMenu;
     QScopedPointer<CurrencySignLoader> currencySignLoader;
+    QScopedPointer<StoredTradesReader> storedTradesReader;
+    quint32 storedTradesReadId;
+    bool storedTradesPending;
+    QList<TradesItem> heldBarsTrades;
 
 public slots:
     void sendIndicatorEvent(QString symbol, QString name, double value);
@@ -317,8 +331,8 @@ public slots:
     void tradesDoubleClicked(QModelIndex);
     void setDataPending(bool);
     void anyDataReceived();
-    void depthFirstOrder(QString, double, double, bool);
-    void depthSubmitOrders(QString, QList<DepthItem>*, QList<DepthItem>*);
+    void depthDeltasReady();
+    void drainDepthDeltas();
     void showErrorMessage(QString);
     void saveAppState();
     void on_widgetStaysOnTop_toggled(bool);
@@ -331,6 +345,9 @@ public slots:
     void tabTradesIndexChanged(int);
     void tabTradesScrollUp();
     void addLastTrades(QString symbol, QList<TradesItem>* newItems);
+    void storedBarsTradesRead(quint32 readId, QString symbol, QList<TradesItem>* trades);
+    void storedChartsTradesRead(quint32 readId, QList<TradesItem>* trades);
+    void storedTradesReadFinished(quint32 readId);
 
     void sayText(QString);
 
@@ -420,6 +437,7 @@ signals:
     void indicatorEventSignal(QString symbol, QString name, double value);
     void themeChanged();
     void reloadDepth();
+    void regroupDepth();
     void cancelOrderByOid(QString, QByteArray);
     void apiSell(QString symbol, double btc, double price);
     void apiBuy(QString symbol, double btc, double price);
@@ -44,6 +44,7 @@
 #include <QDoubleSpinBox>
 #include "rulewidget.h"
 #include "iniengine.h"
+#include "technicalindicators.h"
 
 AddRuleDialog::AddRuleDialog(QString grName, QWidget* par) :
     QDialog(par),
@@ -92,6 +93,16 @@ AddRuleDialog::AddRuleDialog(QString grName, QWidget* par) :
         usedSpinBoxes << spinBox;
     }
 
+    QStringList technicalCodes;
+    technicalCodes << "EMA(14,1m)" << "SMA(20,1m)" << "RSI(14,1m)" << "MACD(12,26,9,1m)" << "MACDSignal(12,26,9,1m)" <<
+                   "BBUpper(20,2,1m)" << "BBLower(20,2,1m)" << "ATR(14,1m)";
+
+    Q_FOREACH (const QString& technicalCode, technicalCodes)
+    {
+        ui->variableA->insertItem(ui->variableA->count(), technicalCode, technicalCode);
+        ui->variableB->insertItem(ui->variableB->count(), technicalCode, technicalCode);
+    }
+
     ui->variableA->insertItem(ui->variableA->count(), julyTr("RULE_IMMEDIATELY_EXECUTION", "Execute Immediately"),
                               "IMMEDIATELY");
 
@@ -31,6 +31,7 @@
 
 #include "ruleholder.h"
 #include "main.h"
+#include "technicalindicators.h"
 
 RuleHolder::RuleHolder()
 {
@@ -78,7 +79,8 @@ bool RuleHolder::isValidCode(const QString& code)
            code == QLatin1String("IMMEDIATELY") ||
            code == QLatin1String("LastTrade") ||
            code == QLatin1String("MyLastTrade") ||
-           mainWindow.indicatorsMap.value(code, nullptr) != nullptr;
+           mainWindow.indicatorsMap.value(code, nullptr) != nullptr ||
+           TechnicalIndicators::isValidName(code);
 }
 
 bool RuleHolder::isTradingRule() const
@@ -33,6 +33,7 @@
 #include "main.h"
 #include <QSettings>
 #include "julymath.h"
+#include "technicalindicators.h"
 
 RuleScriptParser::RuleScriptParser()
 {
@@ -376,6 +377,15 @@ QString RuleScriptParser::holderToScript(RuleHolder& holder, bool testMode)
                 eventName = "Balance\",\"" + currBStr;
         }
 
+        TechnicalIndicators::Spec technicalSpec;
+
+        // Events come under the canonical name and only after the indicator is read once
+        if (TechnicalIndicators::parseName(eventName, &technicalSpec))
+        {
+            eventName = TechnicalIndicators::specName(technicalSpec);
+            script += "\n\ntrader.get(\"" + holder.valueASymbolCode + "\" , \"" + eventName + "\");";
+        }
+
         script += "\n\ntrader.on(\"" + eventName + "\").changed()\n"
                   "{\n"
                   " if(executed)return;\n"
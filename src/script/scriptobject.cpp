@@ -35,6 +35,10 @@
 #include <QStringList>
 #include <QTime>
 #include "exchange/exchange.h"
+#include "barengine.h"
+#include "indicatorengine.h"
+#include "indicatorsubscriber.h"
+#include "technicalindicators.h"
 #include "main.h"
 #include "time.h"
 #include <QMetaMethod>
@@ -54,6 +58,8 @@ ScriptObject::ScriptObject(const QString& _scriptName) :
     isRunningFlag = false;
     engine = nullptr;
     testMode = true;
+    indicatorSubscriber = new IndicatorSubscriber(baseValues.exchangeName, QString(), this);
+    connect(indicatorSubscriber, &IndicatorSubscriber::indicatorsChanged, this, &ScriptObject::indicatorsChanged);
 
     for (int n = staticMetaObject.methodOffset(); n < staticMetaObject.methodCount(); n++)
     {
@@ -102,6 +108,14 @@ ScriptObject::ScriptObject(const QString& _scriptName) :
     indicatorList << "trader.on(\"Time\").changed";
     indicatorList << "trader.on(\"LastTrade\").changed";
     indicatorList << "trader.on(\"MyLastTrade\").changed";
+
+    for (int timeframe = 0; timeframe < BarEngine::TimeframesCount; timeframe++)
+        indicatorList << "trader.on(\"ClosedBar" + BarEngine::timeframeName(timeframe) + "Time\").changed";
+
+    indicatorList << "trader.on(\"EMA(14,1m)\").changed";
+    indicatorList << "trader.on(\"RSI(14,1m)\").changed";
+    indicatorList << "trader.on(\"MACD(12,26,9,1m)\").changed";
+
     indicatorList << "trader.on(\"OpenOrdersCount\").changed";
     indicatorList << "trader.on(\"OpenAsksCount\").changed";
     indicatorList << "trader.on(\"OpenBidsCount\").changed";
@@ -112,6 +126,22 @@ ScriptObject::ScriptObject(const QString& _scriptName) :
     functionsList << "trader.get(\"AsksVolume\",price)";
     functionsList << "trader.get(\"BidsPrice\",volume)";
     functionsList << "trader.get(\"BidsVolume\",price)";
+    functionsList << "trader.get(\"AsksGroupVolume\",price,step)";
+    functionsList << "trader.get(\"BidsGroupVolume\",price,step)";
+
+    functionsList << "trader.getBar(\"1m\",barsBack,\"Close\")";
+    functionsList << "trader.getBarsCount(\"1m\")";
+
+    functionsList << "trader.get(\"EMA(14,1m)\")";
+    functionsList << "trader.get(\"SMA(20,1m)\")";
+    functionsList << "trader.get(\"RSI(14,1m)\")";
+    functionsList << "trader.get(\"MACD(12,26,9,1m)\")";
+    functionsList << "trader.get(\"MACDSignal(12,26,9,1m)\")";
+    functionsList << "trader.get(\"MACDHist(12,26,9,1m)\")";
+    functionsList << "trader.get(\"BBUpper(20,2,1m)\")";
+    functionsList << "trader.get(\"BBMiddle(20,2,1m)\")";
+    functionsList << "trader.get(\"BBLower(20,2,1m)\")";
+    functionsList << "trader.get(\"ATR(14,1m)\")";
 
     functionsList << "trader.get(\"OpenOrdersCount\")";
     functionsList << "trader.get(\"OpenAsksCount\")";
@@ -224,6 +254,23 @@ double ScriptObject::getBidsVolByPrice(const QString& symbol, double volume)
     return orderBookInfo(symbol, volume, false, false);
 }
 
+double ScriptObject::getAsksVolByGroup(double price, double step)
+{
+    return getAsksVolByGroup(baseValues.currentPair.symbolSecond(), price, step);
+}
+double ScriptObject::getBidsVolByGroup(double price, double step)
+{
+    return getBidsVolByGroup(baseValues.currentPair.symbolSecond(), price, step);
+}
+double ScriptObject::getAsksVolByGroup(const QString& symbol, double price, double step)
+{
+    return mainWindow.getVolumeByGroup(symbol, price, step, true);
+}
+double ScriptObject::getBidsVolByGroup(const QString& symbol, double price, double step)
+{
+    return mainWindow.getVolumeByGroup(symbol, price, step, false);
+}
+
 double ScriptObject::orderBookInfo(const QString& symbol, double& value, bool isAsk, bool getPrice)
 {
     double result = 0.0;
@@ -244,6 +291,60 @@ double ScriptObject::orderBookInfo(const QString& symbol, double& value, bool is
     return result;
 }
 
+double ScriptObject::getBar(const QString& timeframe, int barsBack, const QString& field)
+{
+    return getBar(baseValues.currentPair.symbol, timeframe, barsBack, field);
+}
+double ScriptObject::getBar(const QString& symbol, const QString& timeframe, int barsBack, const QString& field)
+{
+    CurrencyPairItem pairItem;
+    pairItem = baseValues.currencyPairMap.value(symbol.toUpper(), pairItem);
+
+    BarItem barItem;
+
+    if (!BarEngine::global()->bar(pairItem.symbol.isEmpty() ? symbol : pairItem.symbol,
+                                  BarEngine::timeframeFromName(timeframe), barsBack, &barItem))
+        return 0.0;
+
+    QString fieldLower = field.toLower();
+
+    if (fieldLower == QLatin1String("open"))
+        return barItem.open;
+
+    if (fieldLower == QLatin1String("high"))
+        return barItem.high;
+
+    if (fieldLower == QLatin1String("low"))
+        return barItem.low;
+
+    if (fieldLower == QLatin1String("close"))
+        return barItem.close;
+
+    if (fieldLower == QLatin1String("volume"))
+        return barItem.volume;
+
+    if (fieldLower == QLatin1String("vwap"))
+        return barItem.vwap();
+
+    if (fieldLower == QLatin1String("time"))
+        return barItem.date;
+
+    return 0.0;
+}
+
+int ScriptObject::getBarsCount(const QString& timeframe)
+{
+    return getBarsCount(baseValues.currentPair.symbol, timeframe);
+}
+int ScriptObject::getBarsCount(const QString& symbol, const QString& timeframe)
+{
+    CurrencyPairItem pairItem;
+    pairItem = baseValues.currencyPairMap.value(symbol.toUpper(), pairItem);
+
+    return BarEngine::global()->barsCount(pairItem.symbol.isEmpty() ? symbol : pairItem.symbol,
+                                          BarEngine::timeframeFromName(timeframe));
+}
+
 double ScriptObject::get(const QString& indicator)
 {
     return get(baseValues.currentPair.symbolSecond(), indicator);
@@ -322,6 +423,13 @@ double ScriptObject::get(const QString& symbol, const QString& indicator)
     if (indicatorLower == QLatin1String("openbidscount"))
         return getOpenBidsCount();
 
+    // Technical indicators like EMA(14,1m) are computed natively, the first read registers them
+    if (indicator.contains(QLatin1Char('(')))
+    {
+        qint32 id = TechnicalIndicators::global()->registerIndicator(symbol, indicator);
+        return id < 0 ? 0.0 : IndicatorEngine::getValue(id);
+    }
+
     QString symbolCopy = symbol;
 
     if (indicator.length() >= 8 && indicatorLower.startsWith(QLatin1String("balance")))
@@ -747,6 +855,18 @@ void ScriptObject::initValueChanged(const QString& symbol, QString scriptNameInd
     initValueChangedPrivate(symbol, scriptNameInd, val, false);
 }
 
+void ScriptObject::indicatorsChanged(QList<qint32> ids)
+{
+    // Values of the current pair come from the market widgets, other pairs only from the engine
+    for (int n = 0; n < ids.count(); n++)
+    {
+        IndicatorEngine::Key key = IndicatorEngine::indicatorKey(ids.at(n));
+
+        if (key.symbol != baseValues.currentPair.symbol)
+            initValueChanged(key.symbol, key.name, IndicatorEngine::getValue(ids.at(n)));
+    }
+}
+
 void ScriptObject::indicatorValueChanged(double val)
 {
     if (!isRunningFlag)
@@ -925,6 +1045,18 @@ bool ScriptObject::executeScript(QString script, bool _testMode)
 
         bool scriptContainsBalance = script.contains("Balance", Qt::CaseInsensitive);
 
+        // A technical indicator sends its events only once registered, even if the script never reads it
+        if (!testMode)
+        {
+            QRegExp technicalName("[A-Za-z]+\\([0-9A-Za-z., ]+\\)");
+
+            for (int pos = technicalName.indexIn(script); pos != -1;
+                 pos = technicalName.indexIn(script, pos + technicalName.matchedLength()))
+                if (TechnicalIndicators::isValidName(technicalName.cap(0)))
+                    TechnicalIndicators::global()->registerIndicator(baseValues.currentPair.symbolSecond(),
+                                                                     technicalName.cap(0));
+        }
+
         Q_FOREACH (QDoubleSpinBox* spinBox, spinBoxList)
         {
             QString spinProperty = spinBox->property("ScriptName").toString();
@@ -980,6 +1112,22 @@ QString ScriptObject::sourceToScript(QString text)
 
     text.replace(").changed()", ")", Qt::CaseInsensitive);
 
+    // Technical indicators send events under the canonical name only, so EMA(14) waits for EMA(14,1m)
+    QRegExp technicalEvent("(trader\\.on\\([\"'])([A-Za-z]+\\([0-9A-Za-z., ]+\\))([\"'])", Qt::CaseInsensitive);
+
+    for (int pos = technicalEvent.indexIn(text); pos != -1; pos = technicalEvent.indexIn(text, pos))
+    {
+        TechnicalIndicators::Spec technicalSpec;
+        QString eventName = technicalEvent.cap(2);
+
+        if (TechnicalIndicators::parseName(eventName, &technicalSpec))
+            eventName = TechnicalIndicators::specName(technicalSpec);
+
+        QString canonicalEvent = technicalEvent.cap(1) + eventName + technicalEvent.cap(3);
+        text.replace(pos, technicalEvent.matchedLength(), canonicalEvent);
+        pos += canonicalEvent.length();
+    }
+
     while (replaceString("trader.on('",
                          "trader['valueChanged(QString,QString,double)'].connect(function(symbol,name,value){if(name=='", text, true));
 
@@ -994,6 +1142,10 @@ QString ScriptObject::sourceToScript(QString text)
     text.replace("trader.get('AsksVolume',", "trader.getAsksVolByPrice(", Qt::CaseInsensitive);
     text.replace("trader.get('BidsPrice',", "trader.getBidsPriceByVol(", Qt::CaseInsensitive);
     text.replace("trader.get('BidsVolume',", "trader.getBidsVolByPrice(", Qt::CaseInsensitive);
+    text.replace("trader.get(\"AsksGroupVolume\",", "trader.getAsksVolByGroup(", Qt::CaseInsensitive);
+    text.replace("trader.get(\"BidsGroupVolume\",", "trader.getBidsVolByGroup(", Qt::CaseInsensitive);
+    text.replace("trader.get('AsksGroupVolume',", "trader.getAsksVolByGroup(", Qt::CaseInsensitive);
+    text.replace("trader.get('BidsGroupVolume',", "trader.getBidsVolByGroup(", Qt::CaseInsensitive);
 
     return text;
 }
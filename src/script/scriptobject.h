@@ -44,6 +44,8 @@ class QScriptEngine;
 #include <QTimer>
 #include "scriptobjectthread.h"
 
+class IndicatorSubscriber;
+
 class ScriptObject : public QObject
 {
     Q_OBJECT
@@ -88,6 +90,7 @@ private:
     QHash<quint32, QString> arrayFileReadResult;
     quint32 fileOperationNumber;
     qint32 fileOpenCount;
+    IndicatorSubscriber* indicatorSubscriber;
 public slots:
     void sendEvent(const QString& symbol, const QString& name, double value);
     void sendEvent(const QString& name, double value);
@@ -155,6 +158,16 @@ public slots:
     double getBidsVolByPrice(const QString& symbol, double price);
     double getBidsPriceByVol(const QString& symbol, double volume);
 
+    double getAsksVolByGroup(double price, double step);
+    double getBidsVolByGroup(double price, double step);
+    double getAsksVolByGroup(const QString& symbol, double price, double step);
+    double getBidsVolByGroup(const QString& symbol, double price, double step);
+
+    double getBar(const QString& timeframe, int barsBack, const QString& field);
+    double getBar(const QString& symbol, const QString& timeframe, int barsBack, const QString& field);
+    int getBarsCount(const QString& timeframe);
+    int getBarsCount(const QString& symbol, const QString& timeframe);
+
     quint32 getTimeT();
     double get(const QString& indicator);
     double get(const QString& symbol, const QString& indicator);
@@ -171,6 +184,7 @@ private slots:
     void timerOut();
     void secondSlot();
     void indicatorValueChanged(double);
+    void indicatorsChanged(QList<qint32>);
     void fileReadResult(const QByteArray& data, quint32);
 signals:
     void eventSignal(const QString& symbol, const QString& name, double value);
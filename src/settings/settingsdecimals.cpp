@@ -31,6 +31,7 @@
 
 #include "settingsdecimals.h"
 #include "main.h"
+#include "rowtextcache.h"
 
 SettingsDecimals::SettingsDecimals()
     : QWidget()
@@ -120,6 +121,8 @@ void SettingsDecimals::activateDecimals()
     baseValues.decimalsAmountLastTrades = ui.amountLastTradesSpinBox->value();
     baseValues.decimalsPriceLastTrades = ui.priceLastTradesSpinBox->value();
     baseValues.decimalsTotalLastTrades = ui.totalLastTradesSpinBox->value();
+
+    RowTextCache::invalidateAll();
 }
 
 void SettingsDecimals::on_saveButton_clicked()
@@ -32,6 +32,7 @@
 #include "settingsgeneral.h"
 #include "main.h"
 #include "translationmessage.h"
+#include "rowtextcache.h"
 #include <QDir>
 
 SettingsGeneral::SettingsGeneral()
@@ -180,6 +181,7 @@ void SettingsGeneral::saveTime()
     mainSettings->setValue("TimeSynchronization", ui.timeSynchronizationCheckBox->isChecked());
 
     baseValues_->use24HourTimeFormat = ui.use24HourTimeFormatCheckBox->isChecked();
+    RowTextCache::invalidateAll();
 }
 
 void SettingsGeneral::on_revertChangesButton_clicked()
@@ -0,0 +1,102 @@
+//  This file is part of Qt Bitcoin Trader
+//      https://github.com/JulyIGHOR/QtBitcoinTrader
+//  Copyright (C) 2013-2018 July IGHOR <julyighor@gmail.com>
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  In addition, as a special exception, the copyright holders give
+//  permission to link the code of portions of this program with the
+//  OpenSSL library under certain conditions as described in each
+//  individual source file, and distribute linked combinations including
+//  the two.
+//
+//  You must obey the GNU General Public License in all respects for all
+//  of the code used other than OpenSSL. If you modify file(s) with this
+//  exception, you may extend this exception to your version of the
+//  file(s), but you are not obligated to do so. If you do not wish to do
+//  so, delete this exception statement from your version. If you delete
+//  this exception statement from all source files in the program, then
+//  also delete it here.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <QThread>
+#include "storedtradesreader.h"
+#include "tickstore.h"
+
+StoredTradesReader::StoredTradesReader()
+    : QObject(),
+      readerThread(new QThread),
+      lastReadId(0)
+{
+    qRegisterMetaType<QList<TradesItem>*>("QList<TradesItem>*");
+    moveToThread(readerThread);
+    readerThread->start();
+}
+
+StoredTradesReader::~StoredTradesReader()
+{
+    stopThread();
+}
+
+void StoredTradesReader::stopThread()
+{
+    if (readerThread == nullptr)
+        return;
+
+    // A newer id makes the read in progress stop after its current hour
+    ++lastReadId;
+    readerThread->quit();
+    readerThread->wait();
+    delete readerThread;
+    readerThread = nullptr;
+}
+
+quint32 StoredTradesReader::read(const QString& exchange, const QString& symbol, qint64 nowTime, bool withBars,
+                                 qint32 chartsSpan)
+{
+    quint32 readId = ++lastReadId;
+    QMetaObject::invokeMethod(this, "readThread", Qt::QueuedConnection, Q_ARG(quint32, readId),
+                              Q_ARG(QString, exchange), Q_ARG(QString, symbol), Q_ARG(qint64, nowTime),
+                              Q_ARG(bool, withBars), Q_ARG(qint32, chartsSpan));
+    return readId;
+}
+
+void StoredTradesReader::readThread(quint32 readId, QString exchange, QString symbol, qint64 nowTime, bool withBars,
+                                    qint32 chartsSpan)
+{
+    if (withBars && readId == lastReadId)
+    {
+        // Hour by hour like the charts, so the exchange thread never waits for the store lock for a whole day
+        QList<TradesItem>* dayTrades = new QList<TradesItem>;
+
+        for (qint64 fromTime = nowTime - 86400; fromTime <= nowTime && readId == lastReadId; fromTime += 3600)
+            TickStore::global()->readTrades(exchange, symbol, fromTime * 1000,
+                                            qMin(fromTime + 3600, nowTime + 1) * 1000, dayTrades);
+
+        if (readId == lastReadId)
+            emit barsTradesRead(readId, symbol, dayTrades);
+        else
+            delete dayTrades;
+    }
+
+    for (qint64 fromTime = nowTime - chartsSpan; fromTime <= nowTime && readId == lastReadId; fromTime += 3600)
+    {
+        QList<TradesItem>* chartsTrades = new QList<TradesItem>;
+        TickStore::global()->readTrades(exchange, symbol, fromTime * 1000, qMin(fromTime + 3600, nowTime + 1) * 1000,
+                                        chartsTrades);
+        emit chartsTradesRead(readId, chartsTrades);
+    }
+
+    emit readFinished(readId);
+}
@@ -0,0 +1,73 @@
+//  This file is part of Qt Bitcoin Trader
+//      https://github.com/JulyIGHOR/QtBitcoinTrader
+//  Copyright (C) 2013-2018 July IGHOR <julyighor@gmail.com>
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  In addition, as a special exception, the copyright holders give
+//  permission to link the code of portions of this program with the
+//  OpenSSL library under certain conditions as described in each
+//  individual source file, and distribute linked combinations including
+//  the two.
+//
+//  You must obey the GNU General Public License in all respects for all
+//  of the code used other than OpenSSL. If you modify file(s) with this
+//  exception, you may extend this exception to your version of the
+//  file(s), but you are not obligated to do so. If you do not wish to do
+//  so, delete this exception statement from your version. If you delete
+//  this exception statement from all source files in the program, then
+//  also delete it here.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef STOREDTRADESREADER_H
+#define STOREDTRADESREADER_H
+
+#include <QObject>
+#include <atomic>
+#include "tradesitem.h"
+
+class QThread;
+
+// Reads the TickStore history of a pair in its own thread, so a pair switch never waits for the disk.
+// Bars get the last day in one piece, charts get the history an hour at a time so a long retention
+// never sits in memory at once. Both read the store an hour per call, which keeps its lock short for
+// the exchange thread. A newer read makes the older one stop, every read ends with readFinished.
+class StoredTradesReader : public QObject
+{
+    Q_OBJECT
+
+public:
+    StoredTradesReader();
+    ~StoredTradesReader();
+
+    quint32 read(const QString& exchange, const QString& symbol, qint64 nowTime, bool withBars, qint32 chartsSpan);
+
+    // Waits for the read in progress, reads asked for after this never start
+    void stopThread();
+
+signals:
+    void barsTradesRead(quint32 readId, QString symbol, QList<TradesItem>* trades);
+    void chartsTradesRead(quint32 readId, QList<TradesItem>* trades);
+    void readFinished(quint32 readId);
+
+private slots:
+    void readThread(quint32 readId, QString exchange, QString symbol, qint64 nowTime, bool withBars,
+                    qint32 chartsSpan);
+
+private:
+    QThread* readerThread;
+    std::atomic<quint32> lastReadId;
+};
+
+#endif // STOREDTRADESREADER_H
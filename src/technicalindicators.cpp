@@ -0,0 +1,488 @@
+//  This file is part of Qt Bitcoin Trader
+//      https://github.com/JulyIGHOR/QtBitcoinTrader
+//  Copyright (C) 2013-2018 July IGHOR <julyighor@gmail.com>
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  In addition, as a special exception, the copyright holders give
+//  permission to link the code of portions of this program with the
+//  OpenSSL library under certain conditions as described in each
+//  individual source file, and distribute linked combinations including
+//  the two.
+//
+//  You must obey the GNU General Public License in all respects for all
+//  of the code used other than OpenSSL. If you modify file(s) with this
+//  exception, you may extend this exception to your version of the
+//  file(s), but you are not obligated to do so. If you do not wish to do
+//  so, delete this exception statement from your version. If you delete
+//  this exception statement from all source files in the program, then
+//  also delete it here.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "technicalindicators.h"
+#include <QThread>
+#include <QStringList>
+#include <qmath.h>
+#include "main.h"
+#include "indicatorengine.h"
+
+namespace
+{
+    int numbersCount(int kind)
+    {
+        switch (kind)
+        {
+            case TechnicalIndicators::MACD:
+            case TechnicalIndicators::MACDSignal:
+            case TechnicalIndicators::MACDHistogram:
+                return 3;
+
+            case TechnicalIndicators::BollingerUpper:
+            case TechnicalIndicators::BollingerMiddle:
+            case TechnicalIndicators::BollingerLower:
+                return 2;
+        }
+
+        return 1;
+    }
+
+    bool isBollinger(int kind)
+    {
+        return kind == TechnicalIndicators::BollingerUpper || kind == TechnicalIndicators::BollingerMiddle ||
+               kind == TechnicalIndicators::BollingerLower;
+    }
+}
+
+TechnicalIndicators::Spec::Spec()
+{
+    kind = -1;
+    timeframe = BarEngine::Minute1;
+    periods[0] = 0;
+    periods[1] = 0;
+    periods[2] = 0;
+    width = 0.0;
+}
+
+TechnicalIndicators::State::State()
+{
+    id = -1;
+    lastDate = 0;
+    barsCount = 0;
+    previousClose = 0.0;
+    windowPosition = 0;
+    sum = 0.0;
+    sumSquares = 0.0;
+
+    for (int n = 0; n < 3; n++)
+    {
+        averages[n] = 0.0;
+        averagesCount[n] = 0;
+    }
+}
+
+TechnicalIndicators::TechnicalIndicators()
+    : QObject(),
+      indicatorsThread(new QThread)
+{
+    qRegisterMetaType<BarItem>();
+    qRegisterMetaType<QList<BarItem> >();
+
+    // Registration waits for the warm up, so the first read of an indicator already has its value
+    connect(this, &TechnicalIndicators::registerSignal, this, &TechnicalIndicators::registerSlot,
+            Qt::BlockingQueuedConnection);
+    connect(this, &TechnicalIndicators::closedBarSignal, this, &TechnicalIndicators::closedBarSlot);
+
+    moveToThread(indicatorsThread);
+    indicatorsThread->start();
+}
+
+TechnicalIndicators::~TechnicalIndicators()
+{
+    stopThread();
+}
+
+void TechnicalIndicators::stopThread()
+{
+    if (indicatorsThread == nullptr)
+        return;
+
+    indicatorsThread->quit();
+    indicatorsThread->wait();
+    delete indicatorsThread;
+    indicatorsThread = nullptr;
+}
+
+TechnicalIndicators* TechnicalIndicators::global()
+{
+    static TechnicalIndicators instance;
+    return &instance;
+}
+
+QString TechnicalIndicators::kindName(int kind)
+{
+    switch (kind)
+    {
+        case EMA:
+            return QLatin1String("EMA");
+
+        case SMA:
+            return QLatin1String("SMA");
+
+        case RSI:
+            return QLatin1String("RSI");
+
+        case MACD:
+            return QLatin1String("MACD");
+
+        case MACDSignal:
+            return QLatin1String("MACDSignal");
+
+        case MACDHistogram:
+            return QLatin1String("MACDHist");
+
+        case BollingerUpper:
+            return QLatin1String("BBUpper");
+
+        case BollingerMiddle:
+            return QLatin1String("BBMiddle");
+
+        case BollingerLower:
+            return QLatin1String("BBLower");
+
+        case ATR:
+            return QLatin1String("ATR");
+    }
+
+    return QString();
+}
+
+bool TechnicalIndicators::parseName(const QString& name, Spec* spec)
+{
+    QString trimmedName = name.trimmed();
+    int openPos = trimmedName.indexOf(QLatin1Char('('));
+
+    if (openPos < 1 || !trimmedName.endsWith(QLatin1Char(')')))
+        return false;
+
+    Spec result;
+    QString kindText = trimmedName.left(openPos).trimmed();
+
+    for (int kind = 0; kind < KindsCount && result.kind < 0; kind++)
+        if (kindText.compare(kindName(kind), Qt::CaseInsensitive) == 0)
+            result.kind = kind;
+
+    if (result.kind < 0)
+        return false;
+
+    QStringList arguments = trimmedName.mid(openPos + 1, trimmedName.size() - openPos - 2).split(QLatin1Char(','));
+    int numbers = numbersCount(result.kind);
+
+    if (arguments.count() == numbers + 1)
+    {
+        result.timeframe = BarEngine::timeframeFromName(arguments.takeLast().trimmed());
+
+        if (result.timeframe < 0)
+            return false;
+    }
+
+    if (arguments.count() != numbers)
+        return false;
+
+    for (int n = 0; n < numbers; n++)
+    {
+        bool ok = false;
+
+        // Bollinger Bands take the width in standard deviations after the period
+        if (n == 1 && isBollinger(result.kind))
+        {
+            result.width = arguments.at(n).trimmed().toDouble(&ok);
+
+            if (!ok || result.width <= 0.0)
+                return false;
+
+            continue;
+        }
+
+        result.periods[n] = arguments.at(n).trimmed().toInt(&ok);
+
+        if (!ok || result.periods[n] < 1 || result.periods[n] > maxPeriod)
+            return false;
+    }
+
+    *spec = result;
+    return true;
+}
+
+QString TechnicalIndicators::specName(const Spec& spec)
+{
+    QString result = kindName(spec.kind) + QLatin1Char('(') + QString::number(spec.periods[0]);
+
+    if (isBollinger(spec.kind))
+        result += QLatin1Char(',') + QString::number(spec.width);
+    else if (numbersCount(spec.kind) == 3)
+        result += QLatin1Char(',') + QString::number(spec.periods[1]) + QLatin1Char(',') +
+                  QString::number(spec.periods[2]);
+
+    return result + QLatin1Char(',') + BarEngine::timeframeName(spec.timeframe) + QLatin1Char(')');
+}
+
+bool TechnicalIndicators::isValidName(const QString& name)
+{
+    Spec spec;
+    return parseName(name, &spec);
+}
+
+qint32 TechnicalIndicators::registerIndicator(const QString& symbol, const QString& name)
+{
+    QString key = symbol + QLatin1Char('_') + name;
+    QHash<QString, qint32>::const_iterator found = registeredIds.constFind(key);
+
+    if (found != registeredIds.constEnd())
+        return found.value();
+
+    CurrencyPairItem pairItem;
+    pairItem = baseValues.currencyPairMap.value(symbol.toUpper(), pairItem);
+    Spec spec;
+
+    // Registration blocks until the indicators thread takes it, there is none to take it after stopThread
+    if (indicatorsThread == nullptr || pairItem.symbol.isEmpty() || !parseName(name, &spec))
+        return -1;
+
+    // Scripts and rules see the pair by its second symbol, bars are kept by the trades symbol
+    QString publishSymbol = pairItem.symbolSecond();
+    QString canonicalName = specName(spec);
+    QString canonicalKey = publishSymbol + QLatin1Char('_') + canonicalName;
+    qint32 id = registeredIds.value(canonicalKey, -1);
+
+    if (id < 0)
+    {
+        id = IndicatorEngine::indicatorId(baseValues.exchangeName, publishSymbol, canonicalName);
+
+        // Closed bars only, the oldest first
+        QList<BarItem> history;
+        BarItem bar;
+        int closedCount = BarEngine::global()->barsCount(pairItem.symbol, spec.timeframe) - 1;
+
+        for (int barsBack = closedCount; barsBack > 0; barsBack--)
+            if (BarEngine::global()->bar(pairItem.symbol, spec.timeframe, barsBack, &bar))
+                history << bar;
+
+        usedTimeframes[pairItem.symbol] |= 1u << spec.timeframe;
+        registeredIds.insert(canonicalKey, id);
+        emit registerSignal(pairItem.symbol, publishSymbol, canonicalName, id, history);
+    }
+
+    registeredIds.insert(key, id);
+    return id;
+}
+
+void TechnicalIndicators::addClosedBar(const QString& symbol, int timeframe, const BarItem& bar)
+{
+    if (indicatorsThread == nullptr || (usedTimeframes.value(symbol) & (1u << timeframe)) == 0)
+        return;
+
+    emit closedBarSignal(symbol, timeframe, bar);
+}
+
+QString TechnicalIndicators::statesKey(const QString& symbol, int timeframe)
+{
+    return symbol + QLatin1Char('_') + BarEngine::timeframeName(timeframe);
+}
+
+void TechnicalIndicators::publish(const State& state, double value)
+{
+    IndicatorEngine::setValue(state.id, value);
+    mainWindow.sendIndicatorEvent(state.symbol, state.name, value);
+}
+
+void TechnicalIndicators::registerSlot(QString symbol, QString publishSymbol, QString name, qint32 id,
+                                       QList<BarItem> history)
+{
+    State state;
+
+    if (!parseName(name, &state.spec))
+        return;
+
+    state.symbol = publishSymbol;
+    state.name = name;
+    state.id = id;
+
+    double value = 0.0;
+    bool ready = false;
+
+    for (int n = 0; n < history.count(); n++)
+        ready = state.update(history.at(n), &value);
+
+    if (ready)
+        publish(state, value);
+
+    states[statesKey(symbol, state.spec.timeframe)].append(state);
+}
+
+void TechnicalIndicators::closedBarSlot(QString symbol, int timeframe, BarItem bar)
+{
+    QHash<QString, QVector<State> >::iterator found = states.find(statesKey(symbol, timeframe));
+
+    if (found == states.end())
+        return;
+
+    QVector<State>& symbolStates = found.value();
+
+    for (int n = 0; n < symbolStates.count(); n++)
+    {
+        double value = 0.0;
+
+        if (symbolStates[n].update(bar, &value))
+            publish(symbolStates.at(n), value);
+    }
+}
+
+bool TechnicalIndicators::State::update(const BarItem& bar, double* value)
+{
+    // A bar given both by the warm up history and by a late close is counted once
+    if (bar.date <= lastDate)
+        return false;
+
+    lastDate = bar.date;
+    barsCount++;
+
+    bool ready = false;
+    int period = spec.periods[0];
+    *value = 0.0;
+
+    switch (spec.kind)
+    {
+        case EMA:
+            ready = addAverage(0, bar.close, period, 2.0 / (period + 1));
+            *value = averages[0];
+            break;
+
+        case SMA:
+            addWindow(bar.close);
+            ready = barsCount >= period;
+            *value = sum / period;
+            break;
+
+        case RSI:
+            if (barsCount > 1)
+            {
+                // Wilder smoothing of gains and losses
+                double change = bar.close - previousClose;
+                addAverage(0, qMax(change, 0.0), period, 1.0 / period);
+                ready = addAverage(1, qMax(-change, 0.0), period, 1.0 / period);
+
+                if (averages[1] > 0.0)
+                    *value = 100.0 - 100.0 / (1.0 + averages[0] / averages[1]);
+                else
+                    *value = averages[0] > 0.0 ? 100.0 : 50.0;
+            }
+
+            break;
+
+        case MACD:
+        case MACDSignal:
+        case MACDHistogram:
+            {
+                bool fastReady = addAverage(0, bar.close, period, 2.0 / (period + 1));
+                bool slowReady = addAverage(1, bar.close, spec.periods[1], 2.0 / (spec.periods[1] + 1));
+
+                if (!fastReady || !slowReady)
+                    break;
+
+                double macd = averages[0] - averages[1];
+                bool signalReady = addAverage(2, macd, spec.periods[2], 2.0 / (spec.periods[2] + 1));
+
+                if (spec.kind == MACD)
+                {
+                    ready = true;
+                    *value = macd;
+                }
+                else
+                {
+                    ready = signalReady;
+                    *value = spec.kind == MACDSignal ? averages[2] : macd - averages[2];
+                }
+            }
+            break;
+
+        case BollingerUpper:
+        case BollingerMiddle:
+        case BollingerLower:
+            {
+                addWindow(bar.close);
+                ready = barsCount >= period;
+
+                double mean = sum / period;
+                double deviation = qSqrt(qMax(0.0, sumSquares / period - mean * mean));
+
+                if (spec.kind == BollingerUpper)
+                    *value = mean + spec.width * deviation;
+                else if (spec.kind == BollingerLower)
+                    *value = mean - spec.width * deviation;
+                else
+                    *value = mean;
+            }
+            break;
+
+        case ATR:
+            {
+                double trueRange = bar.high - bar.low;
+
+                if (barsCount > 1)
+                    trueRange = qMax(trueRange, qMax(qAbs(bar.high - previousClose), qAbs(bar.low - previousClose)));
+
+                ready = addAverage(0, trueRange, period, 1.0 / period);
+                *value = averages[0];
+            }
+            break;
+    }
+
+    previousClose = bar.close;
+    return ready;
+}
+
+bool TechnicalIndicators::State::addAverage(int index, double input, int period, double smoothing)
+{
+    // Seeded with the simple average of the first period inputs
+    qint64 count = ++averagesCount[index];
+    double factor = count <= period ? 1.0 / count : smoothing;
+
+    averages[index] += (input - averages[index]) * factor;
+    return count >= period;
+}
+
+void TechnicalIndicators::State::addWindow(double input)
+{
+    if (window.isEmpty())
+        window.fill(0.0, spec.periods[0]);
+
+    double removed = window.at(windowPosition);
+    window[windowPosition] = input;
+    sum += input - removed;
+    sumSquares += input * input - removed * removed;
+
+    if (++windowPosition < window.size())
+        return;
+
+    windowPosition = 0;
+
+    // Rebuilt once per window so rounding errors never add up, still O(1) per bar on average
+    sum = 0.0;
+    sumSquares = 0.0;
+
+    for (int n = 0; n < window.size(); n++)
+    {
+        sum += window.at(n);
+        sumSquares += window.at(n) * window.at(n);
+    }
+}
@@ -0,0 +1,135 @@
+//  This file is part of Qt Bitcoin Trader
+//      https://github.com/JulyIGHOR/QtBitcoinTrader
+//  Copyright (C) 2013-2018 July IGHOR <julyighor@gmail.com>
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  In addition, as a special exception, the copyright holders give
+//  permission to link the code of portions of this program with the
+//  OpenSSL library under certain conditions as described in each
+//  individual source file, and distribute linked combinations including
+//  the two.
+//
+//  You must obey the GNU General Public License in all respects for all
+//  of the code used other than OpenSSL. If you modify file(s) with this
+//  exception, you may extend this exception to your version of the
+//  file(s), but you are not obligated to do so. If you do not wish to do
+//  so, delete this exception statement from your version. If you delete
+//  this exception statement from all source files in the program, then
+//  also delete it here.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef TECHNICALINDICATORS_H
+#define TECHNICALINDICATORS_H
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QVector>
+#include "barengine.h"
+
+class QThread;
+
+// EMA, SMA, RSI, MACD, Bollinger Bands and ATR over the closed bars of BarEngine, named like
+// EMA(14,1m), SMA(20,5m), RSI(14,1h), MACD(12,26,9,1m), MACDSignal(12,26,9,1m), MACDHist(12,26,9,1m),
+// BBUpper(20,2,1m), BBMiddle(20,2,1m), BBLower(20,2,1m) and ATR(14,1m). The timeframe defaults to 1m.
+// An indicator is registered per symbol on its first use and warmed up from the bars history, after that
+// each closed bar updates it in O(1) in the indicators thread. Values are sent to IndicatorEngine and
+// scripts under the canonical name, they stay 0 until there are enough bars for the period.
+// Scripts and rules turn the names they wait for into the canonical one, so EMA(14) gets EMA(14,1m).
+class TechnicalIndicators : public QObject
+{
+    Q_OBJECT
+public:
+    enum Kind {EMA, SMA, RSI, MACD, MACDSignal, MACDHistogram, BollingerUpper, BollingerMiddle, BollingerLower, ATR,
+               KindsCount};
+
+    struct Spec
+    {
+        Spec();
+
+        int kind;
+        int timeframe;
+        int periods[3];
+        double width;
+    };
+
+    TechnicalIndicators();
+    ~TechnicalIndicators();
+
+    static TechnicalIndicators* global();
+
+    static QString kindName(int kind);
+    static bool parseName(const QString& name, Spec* spec);
+    static QString specName(const Spec& spec);
+    static bool isValidName(const QString& name);
+
+    // GUI thread. Returns the IndicatorEngine id of the indicator or -1 for an unknown symbol or name
+    qint32 registerIndicator(const QString& symbol, const QString& name);
+    void addClosedBar(const QString& symbol, int timeframe, const BarItem& bar);
+
+    // GUI thread, on exit while the application is still there. Indicators are not updated after it
+    void stopThread();
+
+    // One indicator of one symbol, fed the closed bars oldest first. Owned by the indicators thread,
+    // tests feed it bars directly
+    struct State
+    {
+        State();
+
+        Spec spec;
+        QString symbol;
+        QString name;
+        qint32 id;
+        qint64 lastDate;
+        qint64 barsCount;
+        double previousClose;
+
+        QVector<double> window;
+        int windowPosition;
+        double sum;
+        double sumSquares;
+
+        double averages[3];
+        qint64 averagesCount[3];
+
+        bool update(const BarItem& bar, double* value);
+        bool addAverage(int index, double input, int period, double smoothing);
+        void addWindow(double input);
+    };
+
+private:
+    static const int maxPeriod = 10000;
+
+    QThread* indicatorsThread;
+
+    // GUI thread
+    QHash<QString, qint32> registeredIds;
+    QHash<QString, quint32> usedTimeframes;
+
+    // Indicators thread
+    QHash<QString, QVector<State> > states;
+
+    static QString statesKey(const QString& symbol, int timeframe);
+    void publish(const State& state, double value);
+
+private slots:
+    void registerSlot(QString symbol, QString publishSymbol, QString name, qint32 id, QList<BarItem> history);
+    void closedBarSlot(QString symbol, int timeframe, BarItem bar);
+
+signals:
+    void registerSignal(QString symbol, QString publishSymbol, QString name, qint32 id, QList<BarItem> history);
+    void closedBarSignal(QString symbol, int timeframe, BarItem bar);
+};
+
+#endif // TECHNICALINDICATORS_H
@@ -0,0 +1,13 @@
+#
+# Lock-free ring only, does not need the application sources
+#
+QT += testlib
+QT -= gui
+CONFIG += testcase console c++11
+CONFIG -= app_bundle
+
+TARGET = tst_depthdeltaqueue
+INCLUDEPATH += $$clean_path($${PWD}/../..)
+
+SOURCES += $${PWD}/tst_depthdeltaqueue.cpp \
+           $$clean_path($${PWD}/../../depthdeltaqueue.cpp)
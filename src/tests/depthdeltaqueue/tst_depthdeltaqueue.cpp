@@ -0,0 +1,170 @@
+//  This file is part of Qt Bitcoin Trader
+//      https://github.com/JulyIGHOR/QtBitcoinTrader
+//  Copyright (C) 2013-2018 July IGHOR <julyighor@gmail.com>
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  In addition, as a special exception, the copyright holders give
+//  permission to link the code of portions of this program with the
+//  OpenSSL library under certain conditions as described in each
+//  individual source file, and distribute linked combinations including
+//  the two.
+//
+//  You must obey the GNU General Public License in all respects for all
+//  of the code used other than OpenSSL. If you modify file(s) with this
+//  exception, you may extend this exception to your version of the
+//  file(s), but you are not obligated to do so. If you do not wish to do
+//  so, delete this exception statement from your version. If you delete
+//  this exception statement from all source files in the program, then
+//  also delete it here.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <QtTest>
+#include "depthdeltaqueue.h"
+
+namespace
+{
+    // Four slots, small enough to overflow by hand
+    const int smallCapacity = 2;
+
+    void pushLevels(DepthDeltaQueue* queue, int count, double firstPrice)
+    {
+        for (int n = 0; n < count; n++)
+            queue->push(DepthDelta::Level, true, firstPrice + n, 1.0);
+    }
+}
+
+class DepthDeltaQueueTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void deliversInOrder()
+    {
+        DepthDeltaQueue queue(smallCapacity);
+        DepthDelta delta;
+        QVERIFY(!queue.wakeReader());
+        QVERIFY(!queue.pop(&delta));
+
+        queue.push(DepthDelta::Reset, false, 0.0, 0.0);
+        queue.push(DepthDelta::Level, true, 101.0, 2.0);
+        queue.push(DepthDelta::Level, false, 99.0, 3.0);
+
+        // One wake per batch until the reader takes it
+        QVERIFY(queue.wakeReader());
+        QVERIFY(!queue.wakeReader());
+        queue.readerWoken();
+
+        QVERIFY(queue.pop(&delta));
+        QCOMPARE(delta.kind, qint32(DepthDelta::Reset));
+        QCOMPARE(delta.sequence, quint64(1));
+
+        QVERIFY(queue.pop(&delta));
+        QCOMPARE(delta.kind, qint32(DepthDelta::Level));
+        QCOMPARE(delta.sequence, quint64(2));
+        QCOMPARE(delta.isAsk, true);
+        QCOMPARE(delta.price, 101.0);
+        QCOMPARE(delta.volume, 2.0);
+
+        QVERIFY(queue.pop(&delta));
+        QCOMPARE(delta.sequence, quint64(3));
+        QCOMPARE(delta.isAsk, false);
+        QCOMPARE(delta.price, 99.0);
+
+        QVERIFY(!queue.pop(&delta));
+        QVERIFY(!queue.wakeReader());
+        QVERIFY(!queue.takeResyncRequest());
+
+        // The ring wraps around without losing order
+        for (int round = 0; round < 3; round++)
+        {
+            pushLevels(&queue, 3, 200.0);
+
+            for (int n = 0; n < 3; n++)
+            {
+                QVERIFY(queue.pop(&delta));
+                QCOMPARE(delta.price, 200.0 + n);
+            }
+        }
+
+        QVERIFY(!queue.takeResyncRequest());
+    }
+
+    void overflowRequestsResync()
+    {
+        DepthDeltaQueue queue(smallCapacity);
+        DepthDelta delta;
+        pushLevels(&queue, 6, 100.0);
+
+        // The two deltas past the ring are dropped and the writer owes a Reset, once
+        QVERIFY(queue.takeResyncRequest());
+        QVERIFY(!queue.takeResyncRequest());
+
+        for (int n = 0; n < 4; n++)
+        {
+            QVERIFY(queue.pop(&delta));
+            QCOMPARE(delta.sequence, quint64(n + 1));
+        }
+
+        QVERIFY(!queue.pop(&delta));
+
+        queue.push(DepthDelta::Reset, false, 0.0, 0.0);
+        queue.push(DepthDelta::Level, true, 110.0, 1.0);
+
+        QVERIFY(queue.pop(&delta));
+        QCOMPARE(delta.kind, qint32(DepthDelta::Reset));
+        QCOMPARE(delta.sequence, quint64(7));
+
+        QVERIFY(queue.pop(&delta));
+        QCOMPARE(delta.kind, qint32(DepthDelta::Level));
+        QCOMPARE(delta.sequence, quint64(8));
+        QCOMPARE(delta.price, 110.0);
+
+        QVERIFY(!queue.pop(&delta));
+        QVERIFY(!queue.takeResyncRequest());
+    }
+
+    void gapSkipsToNextReset()
+    {
+        DepthDeltaQueue queue(smallCapacity);
+        DepthDelta delta;
+        pushLevels(&queue, 5, 100.0);
+
+        for (int n = 0; n < 4; n++)
+            QVERIFY(queue.pop(&delta));
+
+        // Sequence 5 was dropped, everything up to the next Reset is skipped
+        pushLevels(&queue, 2, 120.0);
+        QVERIFY(!queue.pop(&delta));
+        QVERIFY(queue.takeResyncRequest());
+        QVERIFY(!queue.takeResyncRequest());
+
+        pushLevels(&queue, 1, 130.0);
+        queue.push(DepthDelta::Reset, false, 0.0, 0.0);
+        queue.push(DepthDelta::Level, false, 90.0, 4.0);
+
+        QVERIFY(queue.pop(&delta));
+        QCOMPARE(delta.kind, qint32(DepthDelta::Reset));
+        QCOMPARE(delta.sequence, quint64(9));
+
+        QVERIFY(queue.pop(&delta));
+        QCOMPARE(delta.sequence, quint64(10));
+        QCOMPARE(delta.price, 90.0);
+
+        QVERIFY(!queue.pop(&delta));
+        QVERIFY(!queue.takeResyncRequest());
+    }
+};
+
+QTEST_APPLESS_MAIN(DepthDeltaQueueTest)
+#include "tst_depthdeltaqueue.moc"
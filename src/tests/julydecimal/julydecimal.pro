@@ -0,0 +1,13 @@
+#
+# Parser only, does not need the application sources
+#
+QT += testlib
+QT -= gui
+CONFIG += testcase console c++11
+CONFIG -= app_bundle
+
+TARGET = tst_julydecimal
+INCLUDEPATH += $$clean_path($${PWD}/../..)
+
+SOURCES += $${PWD}/tst_julydecimal.cpp \
+           $$clean_path($${PWD}/../../julydecimal.cpp)
@@ -0,0 +1,285 @@
+//  This file is part of Qt Bitcoin Trader
+//      https://github.com/JulyIGHOR/QtBitcoinTrader
+//  Copyright (C) 2013-2018 July IGHOR <julyighor@gmail.com>
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  In addition, as a special exception, the copyright holders give
+//  permission to link the code of portions of this program with the
+//  OpenSSL library under certain conditions as described in each
+//  individual source file, and distribute linked combinations including
+//  the two.
+//
+//  You must obey the GNU General Public License in all respects for all
+//  of the code used other than OpenSSL. If you modify file(s) with this
+//  exception, you may extend this exception to your version of the
+//  file(s), but you are not obligated to do so. If you do not wish to do
+//  so, delete this exception statement from your version. If you delete
+//  this exception statement from all source files in the program, then
+//  also delete it here.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <QtTest>
+#include <QStringList>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <limits>
+#include "julydecimal.h"
+
+namespace
+{
+    // Exact comparison, QCOMPARE on doubles is fuzzy
+    quint64 doubleBits(double value)
+    {
+        quint64 bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    double parse(const QByteArray& text, bool* ok)
+    {
+        return JulyDecimal::toDouble(text.constData(), text.constData() + text.size(), ok);
+    }
+}
+
+class JulyDecimalTest : public QObject
+{
+    Q_OBJECT
+
+private:
+    QByteArray depthPayload;
+    QVector<int> valueBegins;
+    QVector<int> valueEnds;
+
+    // A Binance style depth side with 1000 levels
+    void buildDepthPayload()
+    {
+        if (!depthPayload.isEmpty())
+            return;
+
+        std::mt19937_64 random(42);
+        depthPayload = "[";
+
+        for (int n = 0; n < 1000; n++)
+        {
+            if (n)
+                depthPayload += ",";
+
+            depthPayload += "[\"" + QByteArray::number(7000.0 + double(random() % 100000) / 100.0, 'f', 8) + "\",\"" +
+                            QByteArray::number(double(random() % 100000000) / 1e8, 'f', 8) + "\"]";
+        }
+
+        depthPayload += "]";
+
+        for (int pos = depthPayload.indexOf('"'); pos != -1; pos = depthPayload.indexOf('"', pos + 1))
+        {
+            int end = depthPayload.indexOf('"', pos + 1);
+            valueBegins << pos + 1;
+            valueEnds << end;
+            pos = end;
+        }
+    }
+
+private slots:
+    void toDouble_data()
+    {
+        QTest::addColumn<QByteArray>("text");
+        QTest::addColumn<bool>("ok");
+        QTest::addColumn<double>("expected");
+
+        QTest::newRow("price") << QByteArray("0.00100000") << true << 0.001;
+        QTest::newRow("integer") << QByteArray("-12") << true << -12.0;
+        QTest::newRow("plus sign") << QByteArray("+3.25") << true << 3.25;
+        QTest::newRow("exponent") << QByteArray("1.5e-7") << true << 1.5e-7;
+        QTest::newRow("upper exponent") << QByteArray("2E+3") << true << 2000.0;
+        QTest::newRow("quoted") << QByteArray("\"7254.6\"") << true << 7254.6;
+        QTest::newRow("spaces") << QByteArray(" \t42.5\r\n") << true << 42.5;
+        QTest::newRow("no integer part") << QByteArray(".5") << true << 0.5;
+        QTest::newRow("no fraction digits") << QByteArray("5.") << true << 5.0;
+        QTest::newRow("zero") << QByteArray("0.00000000") << true << 0.0;
+        QTest::newRow("leading zeros") << QByteArray("000123.4500") << true << 123.45;
+        QTest::newRow("long mantissa") << QByteArray("12345678901234567890") << true << 12345678901234567890.0;
+        QTest::newRow("long fraction") << QByteArray("0.1234567890123456789012") << true << 0.1234567890123456789012;
+        QTest::newRow("big exponent") << QByteArray("1.7e300") << true << 1.7e300;
+        QTest::newRow("small exponent") << QByteArray("4.9e-300") << true << 4.9e-300;
+        QTest::newRow("satoshi") << QByteArray("0.00000001") << true << 1e-8;
+
+        QTest::newRow("empty") << QByteArray("") << false << 0.0;
+        QTest::newRow("quotes only") << QByteArray("\"\"") << false << 0.0;
+        QTest::newRow("sign only") << QByteArray("-") << false << 0.0;
+        QTest::newRow("text") << QByteArray("abc") << false << 0.0;
+        QTest::newRow("two points") << QByteArray("1.2.3") << false << 0.0;
+        QTest::newRow("no exponent digits") << QByteArray("1e") << false << 0.0;
+        QTest::newRow("double sign") << QByteArray("--1") << false << 0.0;
+        QTest::newRow("trailing text") << QByteArray("12a") << false << 0.0;
+        QTest::newRow("exponent only") << QByteArray("e5") << false << 0.0;
+        QTest::newRow("open quote") << QByteArray("\"12") << false << 0.0;
+        QTest::newRow("null") << QByteArray("null") << false << 0.0;
+    }
+
+    void toDouble()
+    {
+        QFETCH(QByteArray, text);
+        QFETCH(bool, ok);
+        QFETCH(double, expected);
+
+        bool resultOk = !ok;
+        double result = parse(text, &resultOk);
+
+        QCOMPARE(resultOk, ok);
+        QCOMPARE(doubleBits(result), doubleBits(expected));
+    }
+
+    void toDoubleMatchesStrtod()
+    {
+        std::mt19937_64 random(12345);
+        char text[64];
+
+        for (int n = 0; n < 1000000; n++)
+        {
+            int decimals = int(random() % 11);
+            int size;
+
+            if (n % 5 == 0)
+                size = qsnprintf(text, sizeof(text), "%.*e", int(random() % 17),
+                                 double(random() % 100000) / double(1 + random() % 1000));
+            else
+                size = qsnprintf(text, sizeof(text), "%llu.%0*llu", (unsigned long long)(random() % 10000000),
+                                 decimals, (unsigned long long)(random() % 10000000000ULL));
+
+            bool ok = false;
+            double result = JulyDecimal::toDouble(text, text + size, &ok);
+
+            if (!ok || doubleBits(result) != doubleBits(strtod(text, nullptr)))
+                QFAIL((QByteArray("Mismatch for ") + text).constData());
+        }
+    }
+
+    void toScaled_data()
+    {
+        QTest::addColumn<QByteArray>("text");
+        QTest::addColumn<int>("decimals");
+        QTest::addColumn<bool>("ok");
+        QTest::addColumn<qint64>("expected");
+
+        QTest::newRow("price ticks") << QByteArray("7254.6") << 2 << true << qint64(725460);
+        QTest::newRow("amount") << QByteArray("0.00100000") << 8 << true << qint64(100000);
+        QTest::newRow("cut") << QByteArray("1.999") << 2 << true << qint64(199);
+        QTest::newRow("negative cut") << QByteArray("-1.999") << 2 << true << qint64(-199);
+        QTest::newRow("exponent") << QByteArray("1.5e-7") << 8 << true << qint64(15);
+        QTest::newRow("below one tick") << QByteArray("0.000000001") << 8 << true << qint64(0);
+        QTest::newRow("quoted") << QByteArray("\"12\"") << 0 << true << qint64(12);
+        QTest::newRow("max") << QByteArray("9223372036854775807") << 0 << true << std::numeric_limits<qint64>::max();
+        QTest::newRow("min") << QByteArray("-9223372036854775808") << 0 << true << std::numeric_limits<qint64>::min();
+        QTest::newRow("over max") << QByteArray("9223372036854775808") << 0 << false << qint64(0);
+        QTest::newRow("over max after scaling") << QByteArray("100000000000") << 8 << false << qint64(0);
+        QTest::newRow("huge exponent") << QByteArray("1e19") << 0 << false << qint64(0);
+        QTest::newRow("text") << QByteArray("abc") << 2 << false << qint64(0);
+    }
+
+    void toScaled()
+    {
+        QFETCH(QByteArray, text);
+        QFETCH(int, decimals);
+        QFETCH(bool, ok);
+        QFETCH(qint64, expected);
+
+        bool resultOk = !ok;
+        qint64 result = JulyDecimal::toScaled(text.constData(), text.constData() + text.size(), decimals, &resultOk);
+
+        QCOMPARE(resultOk, ok);
+        QCOMPARE(result, expected);
+    }
+
+    void toLongLong_data()
+    {
+        QTest::addColumn<QByteArray>("text");
+        QTest::addColumn<bool>("ok");
+        QTest::addColumn<qint64>("expected");
+
+        QTest::newRow("integer") << QByteArray("42") << true << qint64(42);
+        QTest::newRow("negative") << QByteArray("-7") << true << qint64(-7);
+        QTest::newRow("zero fraction") << QByteArray("1574694475.0") << true << qint64(1574694475);
+        QTest::newRow("quoted") << QByteArray("\"100\"") << true << qint64(100);
+        QTest::newRow("exponent") << QByteArray("1e3") << true << qint64(1000);
+        QTest::newRow("fraction") << QByteArray("12.50") << false << qint64(0);
+        QTest::newRow("text") << QByteArray("abc") << false << qint64(0);
+    }
+
+    void toLongLong()
+    {
+        QFETCH(QByteArray, text);
+        QFETCH(bool, ok);
+        QFETCH(qint64, expected);
+
+        bool resultOk = !ok;
+        qint64 result = JulyDecimal::toLongLong(text.constData(), text.constData() + text.size(), &resultOk);
+
+        QCOMPARE(resultOk, ok);
+        QCOMPARE(result, expected);
+    }
+
+    void benchmarkJulyDecimal()
+    {
+        buildDepthPayload();
+        const char* data = depthPayload.constData();
+        double sum = 0.0;
+
+        QBENCHMARK
+        {
+            for (int n = 0; n < valueBegins.count(); n++)
+                sum += JulyDecimal::toDouble(data + valueBegins.at(n), data + valueEnds.at(n));
+        }
+
+        QVERIFY(sum > 0.0);
+    }
+
+    // How JulyJsonValue read numbers before, through a null terminated copy
+    void benchmarkByteArrayToDouble()
+    {
+        buildDepthPayload();
+        double sum = 0.0;
+
+        QBENCHMARK
+        {
+            for (int n = 0; n < valueBegins.count(); n++)
+                sum += depthPayload.mid(valueBegins.at(n), valueEnds.at(n) - valueBegins.at(n)).toDouble();
+        }
+
+        QVERIFY(sum > 0.0);
+    }
+
+    // How the Binance depth loop read levels before, through QString splitting
+    void benchmarkStringSplitToDouble()
+    {
+        buildDepthPayload();
+        double sum = 0.0;
+
+        QBENCHMARK
+        {
+            QStringList levels = QString(depthPayload.mid(2, depthPayload.size() - 4)).split("],[");
+
+            for (int n = 0; n < levels.count(); n++)
+            {
+                QStringList currentPair = levels.at(n).split(",");
+                sum += currentPair.first().remove('"').toDouble() + currentPair.last().remove('"').toDouble();
+            }
+        }
+
+        QVERIFY(sum > 0.0);
+    }
+};
+
+QTEST_APPLESS_MAIN(JulyDecimalTest)
+#include "tst_julydecimal.moc"
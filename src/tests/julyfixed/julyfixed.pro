@@ -0,0 +1,13 @@
+#
+# Header only type, needs the decimal parser for fromText
+#
+QT += testlib
+QT -= gui
+CONFIG += testcase console c++11
+CONFIG -= app_bundle
+
+TARGET = tst_julyfixed
+INCLUDEPATH += $$clean_path($${PWD}/../..)
+
+SOURCES += $${PWD}/tst_julyfixed.cpp \
+           $$clean_path($${PWD}/../../julydecimal.cpp)
@@ -0,0 +1,213 @@
+//  This file is part of Qt Bitcoin Trader
+//      https://github.com/JulyIGHOR/QtBitcoinTrader
+//  Copyright (C) 2013-2018 July IGHOR <julyighor@gmail.com>
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  In addition, as a special exception, the copyright holders give
+//  permission to link the code of portions of this program with the
+//  OpenSSL library under certain conditions as described in each
+//  individual source file, and distribute linked combinations including
+//  the two.
+//
+//  You must obey the GNU General Public License in all respects for all
+//  of the code used other than OpenSSL. If you modify file(s) with this
+//  exception, you may extend this exception to your version of the
+//  file(s), but you are not obligated to do so. If you do not wish to do
+//  so, delete this exception statement from your version. If you delete
+//  this exception statement from all source files in the program, then
+//  also delete it here.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <QtTest>
+#include <QSet>
+#include <cstring>
+#include <random>
+#include "julyfixed.h"
+
+namespace
+{
+    JulyAmount amount(double value)
+    {
+        return JulyAmount::fromDouble(value);
+    }
+}
+
+class JulyFixedTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void fromDouble_data()
+    {
+        QTest::addColumn<double>("value");
+        QTest::addColumn<qint64>("raw");
+        QTest::addColumn<int>("decimals");
+
+        QTest::newRow("zero") << 0.0 << qint64(0) << 8;
+        QTest::newRow("satoshi") << 1e-8 << qint64(1) << 8;
+        QTest::newRow("below satoshi rounds") << 0.6e-8 << qint64(1) << 8;
+        QTest::newRow("price") << 7254.6 << Q_INT64_C(725460000000) << 8;
+        QTest::newRow("negative") << -1.5 << Q_INT64_C(-150000000) << 8;
+        QTest::newRow("large with eight decimals") << 34359738368.0 << Q_INT64_C(3435973836800000000) << 8;
+        QTest::newRow("past the old qint64 range") << 1e11 << Q_INT64_C(1000000000000000000) << 7;
+        QTest::newRow("high supply level") << 5e14 << Q_INT64_C(500000000000000000) << 3;
+        QTest::newRow("negative large") << -2e12 << Q_INT64_C(-2000000000000000000) << 6;
+        QTest::newRow("not a number") << std::numeric_limits<double>::quiet_NaN() << qint64(0) << 8;
+        QTest::newRow("infinity") << std::numeric_limits<double>::infinity() << qint64(0) << 8;
+    }
+
+    void fromDouble()
+    {
+        QFETCH(double, value);
+        QFETCH(qint64, raw);
+        QFETCH(int, decimals);
+
+        JulyAmount result = JulyAmount::fromDouble(value);
+        QCOMPARE(result.raw(), raw);
+        QCOMPARE(result.decimals(), decimals);
+    }
+
+    void largeValuesKeepTheirValue()
+    {
+        QVERIFY(!amount(1e11).isNull());
+        QCOMPARE(amount(1e11).toDouble(), 1e11);
+        QCOMPARE(amount(5e14).toDouble(), 5e14);
+        QCOMPARE(JulyAmount::fromDoubleFloor(1e13).toDouble(), 1e13);
+    }
+
+    void sumsPastTheScaleDoNotOverflow()
+    {
+        JulyAmount sum;
+
+        for (int n = 0; n < 1000; n++)
+            sum += amount(9e10);
+
+        QCOMPARE(sum.toDouble(), 9e13);
+        QVERIFY(sum > amount(9e10));
+
+        for (int n = 0; n < 1000; n++)
+            sum -= amount(9e10);
+
+        QVERIFY(sum.isNull());
+        QCOMPARE(sum, JulyAmount());
+    }
+
+    void mixedScales()
+    {
+        // 4e10 keeps one decimal less than 39999999999.5, the difference comes back to the full scale
+        JulyAmount difference = amount(4e10) - JulyAmount::fromRaw(Q_INT64_C(3999999999950000000));
+        QCOMPARE(difference, amount(0.5));
+        QCOMPARE(difference.decimals(), 8);
+
+        QCOMPARE((amount(1e11) + amount(0.12345678)).toString(8), QString("100000000000.1234568"));
+        QCOMPARE(amount(1e11) + amount(1e11), amount(2e11));
+    }
+
+    void comparesAcrossScales()
+    {
+        std::mt19937_64 random(7);
+        std::uniform_real_distribution<double> exponent(-8.0, 16.0);
+
+        for (int n = 0; n < 100000; n++)
+        {
+            double a = std::pow(10.0, exponent(random)) * (random() % 2 ? 1.0 : -1.0);
+            double b = std::pow(10.0, exponent(random)) * (random() % 2 ? 1.0 : -1.0);
+            JulyAmount fixedA = amount(a);
+            JulyAmount fixedB = amount(b);
+
+            if ((fixedA < fixedB) != (fixedA.toDouble() < fixedB.toDouble()))
+                QFAIL(QByteArray("Wrong order of " + QByteArray::number(a, 'g', 17) + " and " +
+                                 QByteArray::number(b, 'g', 17)).constData());
+
+            QCOMPARE(fixedA <= fixedB, !(fixedB < fixedA));
+            QCOMPARE(fixedA == fixedB, fixedA.toDouble() == fixedB.toDouble());
+        }
+    }
+
+    void equalValuesHashEqual()
+    {
+        QSet<JulyAmount> values;
+        values << amount(2e11) << amount(1e11) + amount(1e11) << amount(0.1) << amount(0.05) + amount(0.05);
+        QCOMPARE(values.count(), 2);
+        QCOMPARE(qHash(amount(7254.6)), qHash(JulyAmount::fromRaw(Q_INT64_C(725460000000))));
+    }
+
+    void rounding()
+    {
+        QCOMPARE(amount(2.5e-8).raw(), qint64(3));
+        QCOMPARE(JulyAmount::fromDoubleFloor(0.123456789).raw(), qint64(12345678));
+        QCOMPARE(JulyAmount::fromDoubleFloor(-0.123456781).raw(), qint64(-12345679));
+
+        QCOMPARE(amount(12.3456789).cut(2), amount(12.34));
+        QCOMPARE(amount(12.345).cut(2, true), amount(12.35));
+        QCOMPARE(amount(-12.341).cut(2), amount(-12.35));
+        QCOMPARE(amount(1e11 + 0.5).cut(0), amount(1e11));
+        QCOMPARE(amount(1.25).cut(10), amount(1.25));
+
+        QCOMPARE(amount(7005.0).roundToStep(amount(10.0)), amount(7000.0));
+        QCOMPARE(amount(7005.0).roundToStep(amount(10.0), true), amount(7010.0));
+        QCOMPARE(amount(7010.0).roundToStep(amount(10.0), true), amount(7010.0));
+        QCOMPARE(amount(0.00012345).roundToStep(amount(0.0001)), amount(0.0001));
+        QCOMPARE(amount(123456789012.0).roundToStep(amount(1000.0)), amount(123456789000.0));
+        QCOMPARE(amount(5.0).roundToStep(JulyAmount()), amount(5.0));
+    }
+
+    void fromText()
+    {
+        QByteArray small = "0.00012345";
+        QByteArray large = "123456789012.123456789";
+
+        QCOMPARE(JulyAmount::fromText(small.constData(), small.constData() + small.size()), amount(0.00012345));
+
+        JulyAmount largeValue = JulyAmount::fromText(large.constData(), large.constData() + large.size());
+        QCOMPARE(largeValue.decimals(), 7);
+        QCOMPARE(largeValue.toString(8), QString("123456789012.1234567"));
+    }
+
+    void toString_data()
+    {
+        QTest::addColumn<double>("value");
+        QTest::addColumn<int>("maxDecimals");
+        QTest::addColumn<int>("minDecimals");
+        QTest::addColumn<QString>("expected");
+
+        QTest::newRow("trimmed") << 1.5 << 8 << 1 << "1.5";
+        QTest::newRow("whole") << 2.0 << 8 << 1 << "2.0";
+        QTest::newRow("no decimals") << 2.0 << 8 << 0 << "2";
+        QTest::newRow("kept zeros") << 2.5 << 4 << 3 << "2.500";
+        QTest::newRow("cut not rounded") << 12.3456789 << 4 << 1 << "12.3456";
+        QTest::newRow("satoshi") << 1e-8 << 8 << 1 << "0.00000001";
+        QTest::newRow("negative") << -0.25 << 8 << 1 << "-0.25";
+        QTest::newRow("negative cut to zero") << -0.000000001 << 8 << 1 << "0.0";
+        QTest::newRow("negative below shown decimals") << -0.004 << 2 << 2 << "0.00";
+        QTest::newRow("large") << 1e11 << 8 << 1 << "100000000000.0";
+        QTest::newRow("large with asked zeros") << 1e11 << 8 << 8 << "100000000000.00000000";
+        QTest::newRow("high supply") << 5e14 << 2 << 0 << "500000000000000";
+        QTest::newRow("decimals out of range") << 1.123456789 << 12 << -3 << "1.12345679";
+    }
+
+    void toString()
+    {
+        QFETCH(double, value);
+        QFETCH(int, maxDecimals);
+        QFETCH(int, minDecimals);
+        QFETCH(QString, expected);
+
+        QCOMPARE(amount(value).toString(maxDecimals, minDecimals), expected);
+    }
+};
+
+QTEST_APPLESS_MAIN(JulyFixedTest)
+#include "tst_julyfixed.moc"
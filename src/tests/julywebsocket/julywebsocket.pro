@@ -0,0 +1,4 @@
+include($${PWD}/../tests.pri)
+
+TARGET = tst_julywebsocket
+SOURCES += $${PWD}/tst_julywebsocket.cpp
@@ -0,0 +1,324 @@
+//  This file is part of Qt Bitcoin Trader
+//      https://github.com/JulyIGHOR/QtBitcoinTrader
+//  Copyright (C) 2013-2018 July IGHOR <julyighor@gmail.com>
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  In addition, as a special exception, the copyright holders give
+//  permission to link the code of portions of this program with the
+//  OpenSSL library under certain conditions as described in each
+//  individual source file, and distribute linked combinations including
+//  the two.
+//
+//  You must obey the GNU General Public License in all respects for all
+//  of the code used other than OpenSSL. If you modify file(s) with this
+//  exception, you may extend this exception to your version of the
+//  file(s), but you are not obligated to do so. If you do not wish to do
+//  so, delete this exception statement from your version. If you delete
+//  this exception statement from all source files in the program, then
+//  also delete it here.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <QtTest>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QCryptographicHash>
+#include <QtEndian>
+#include "main.h"
+#include "julywebsocket.h"
+
+// Accepts one RFC 6455 client at a time on localhost and records the frames it sends
+class MockWebSocketServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    QTcpServer server;
+    QTcpSocket* client = nullptr;
+    int connectionsCount = 0;
+    QList<int> opcodes;
+    QList<QByteArray> payloads;
+
+    bool listen()
+    {
+        connect(&server, &QTcpServer::newConnection, this, &MockWebSocketServer::newConnection);
+        return server.listen(QHostAddress::LocalHost, 0);
+    }
+
+    void sendFrame(int opcode, const QByteArray& payload, bool fin = true)
+    {
+        QByteArray frame;
+        frame.append(char((fin ? 0x80 : 0x00) | opcode));
+
+        if (payload.size() < 126)
+            frame.append(char(payload.size()));
+        else
+        {
+            uchar sizeBytes[2];
+            qToBigEndian<quint16>(quint16(payload.size()), sizeBytes);
+            frame.append(char(126));
+            frame.append(reinterpret_cast<const char*>(sizeBytes), 2);
+        }
+
+        frame.append(payload);
+        sendBytes(frame);
+    }
+
+    void sendBytes(const QByteArray& bytes)
+    {
+        client->write(bytes);
+        client->flush();
+    }
+
+    int framesCount(int opcode) const
+    {
+        return opcodes.count(opcode);
+    }
+
+    QByteArray lastPayload(int opcode) const
+    {
+        for (int n = opcodes.count() - 1; n >= 0; n--)
+            if (opcodes.at(n) == opcode)
+                return payloads.at(n);
+
+        return QByteArray();
+    }
+
+private:
+    QByteArray buffer;
+    bool handshakeDone = false;
+
+    bool readHandshake()
+    {
+        int headerEnd = buffer.indexOf("\r\n\r\n");
+
+        if (headerEnd == -1)
+            return false;
+
+        QList<QByteArray> lines = buffer.left(headerEnd).split('\n');
+        buffer.remove(0, headerEnd + 4);
+        QByteArray key;
+
+        for (int n = 0; n < lines.count(); n++)
+            if (lines.at(n).toLower().startsWith("sec-websocket-key:"))
+                key = lines.at(n).mid(18).trimmed();
+
+        QByteArray accept = QCryptographicHash::hash(key + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11",
+                            QCryptographicHash::Sha1).toBase64();
+
+        client->write("HTTP/1.1 101 Switching Protocols\r\n"
+                      "Upgrade: websocket\r\n"
+                      "Connection: Upgrade\r\n"
+                      "Sec-WebSocket-Accept: " + accept + "\r\n\r\n");
+        client->flush();
+        handshakeDone = true;
+        return true;
+    }
+
+    // Client frames are always masked
+    bool readFrame()
+    {
+        if (buffer.size() < 2)
+            return false;
+
+        const uchar* bytes = reinterpret_cast<const uchar*>(buffer.constData());
+        int payloadSize = bytes[1] & 0x7F;
+        int headerSize = 2;
+
+        if (payloadSize == 126)
+        {
+            if (buffer.size() < 4)
+                return false;
+
+            payloadSize = qFromBigEndian<quint16>(bytes + 2);
+            headerSize = 4;
+        }
+        else if (payloadSize == 127)
+        {
+            if (buffer.size() < 10)
+                return false;
+
+            payloadSize = int(qFromBigEndian<quint64>(bytes + 2));
+            headerSize = 10;
+        }
+
+        if (buffer.size() < headerSize + 4 + payloadSize)
+            return false;
+
+        QByteArray payload = buffer.mid(headerSize + 4, payloadSize);
+
+        for (int n = 0; n < payload.size(); n++)
+            payload[n] = payload.at(n) ^ bytes[headerSize + n % 4];
+
+        opcodes << (bytes[0] & 0x0F);
+        payloads << payload;
+        buffer.remove(0, headerSize + 4 + payloadSize);
+        return true;
+    }
+
+private slots:
+    void newConnection()
+    {
+        if (client)
+            client->deleteLater();
+
+        client = server.nextPendingConnection();
+        connectionsCount++;
+        buffer.clear();
+        handshakeDone = false;
+        connect(client, &QTcpSocket::readyRead, this, &MockWebSocketServer::readClient);
+    }
+
+    void readClient()
+    {
+        buffer.append(client->readAll());
+
+        if (!handshakeDone && !readHandshake())
+            return;
+
+        bool frameRead = true;
+
+        while (frameRead)
+            frameRead = readFrame();
+    }
+};
+
+class JulyWebSocketTest : public QObject
+{
+    Q_OBJECT
+
+private:
+    MockWebSocketServer* mockServer = nullptr;
+    JulyWebSocket* webSocket = nullptr;
+    QList<QByteArray> messages;
+
+private slots:
+    void initTestCase()
+    {
+        baseValues_ = new BaseValues();
+        baseValues.appVerStr = "test";
+    }
+
+    void init()
+    {
+        messages.clear();
+        mockServer = new MockWebSocketServer;
+        QVERIFY(mockServer->listen());
+
+        webSocket = new JulyWebSocket("127.0.0.1", mockServer->server.serverPort(), "/ws", nullptr, false);
+        webSocket->setSubscriptions(QList<QByteArray>() << "{\"subscribe\":\"trades\"}");
+        connect(webSocket, &JulyWebSocket::textMessageReceived, this, [this](QByteArray message)
+        {
+            messages << message;
+        });
+
+        QSignalSpy openedSpy(webSocket, &JulyWebSocket::opened);
+        webSocket->open();
+        QTRY_COMPARE(openedSpy.count(), 1);
+    }
+
+    void cleanup()
+    {
+        delete webSocket;
+        delete mockServer;
+    }
+
+    void subscribesAfterHandshake()
+    {
+        QTRY_COMPARE(mockServer->framesCount(0x1), 1);
+        QCOMPARE(mockServer->lastPayload(0x1), QByteArray("{\"subscribe\":\"trades\"}"));
+    }
+
+    void receivesWholeAndFragmentedMessages()
+    {
+        mockServer->sendFrame(0x1, "{\"price\":1}");
+        mockServer->sendFrame(0x1, "{\"pri", false);
+        mockServer->sendFrame(0x0, "ce\":", false);
+        mockServer->sendFrame(0x0, "2}");
+
+        QTRY_COMPARE(messages.count(), 2);
+        QCOMPARE(messages.at(0), QByteArray("{\"price\":1}"));
+        QCOMPARE(messages.at(1), QByteArray("{\"price\":2}"));
+    }
+
+    void answersPing()
+    {
+        mockServer->sendFrame(0x9, "ping data");
+
+        QTRY_COMPARE(mockServer->framesCount(0xA), 1);
+        QCOMPARE(mockServer->lastPayload(0xA), QByteArray("ping data"));
+    }
+
+    void closesOversizedMessage()
+    {
+        QSignalSpy closedSpy(webSocket, &JulyWebSocket::closed);
+        webSocket->setMaxMessageSize(1024);
+
+        mockServer->sendFrame(0x1, QByteArray(600, 'a'), false);
+        mockServer->sendFrame(0x0, QByteArray(600, 'b'), false);
+
+        // 1009: message too big
+        QTRY_COMPARE(mockServer->framesCount(0x8), 1);
+        QCOMPARE(mockServer->lastPayload(0x8), QByteArray("\x03\xF1", 2));
+        QCOMPARE(closedSpy.count(), 1);
+        QVERIFY(messages.isEmpty());
+    }
+
+    void receivesFrameSplitAcrossReads()
+    {
+        QByteArray payload = "{\"price\":" + QByteArray(200, '1') + "}";
+        QByteArray frame("\x81\x7E", 2);
+        frame.append(char(payload.size() >> 8));
+        frame.append(char(payload.size() & 0xFF));
+        frame.append(payload);
+
+        // Cut inside the extended length and inside the payload
+        mockServer->sendBytes(frame.left(3));
+        QTest::qWait(50);
+        mockServer->sendBytes(frame.mid(3, 20));
+        QTest::qWait(50);
+        QVERIFY(messages.isEmpty());
+
+        mockServer->sendBytes(frame.mid(23));
+        QTRY_COMPARE(messages.count(), 1);
+        QCOMPARE(messages.at(0), payload);
+        QVERIFY(webSocket->isOpened());
+    }
+
+    void closesOnMaskedFrame()
+    {
+        QSignalSpy closedSpy(webSocket, &JulyWebSocket::closed);
+
+        // Mask bit set and only two of the four mask bytes arrived
+        mockServer->sendBytes(QByteArray("\x81\x85\x01\x02", 4));
+
+        // 1002: protocol error
+        QTRY_COMPARE(mockServer->framesCount(0x8), 1);
+        QCOMPARE(mockServer->lastPayload(0x8), QByteArray("\x03\xEA", 2));
+        QCOMPARE(closedSpy.count(), 1);
+        QVERIFY(messages.isEmpty());
+    }
+
+    void reconnectsAndSubscribesAgain()
+    {
+        QTRY_COMPARE(mockServer->framesCount(0x1), 1);
+        mockServer->client->disconnectFromHost();
+
+        QTRY_COMPARE_WITH_TIMEOUT(mockServer->connectionsCount, 2, 5000);
+        QTRY_COMPARE_WITH_TIMEOUT(mockServer->framesCount(0x1), 2, 5000);
+        QVERIFY(webSocket->isOpened());
+    }
+};
+
+QTEST_MAIN(JulyWebSocketTest)
+#include "tst_julywebsocket.moc"
@@ -0,0 +1,4 @@
+include($${PWD}/../tests.pri)
+
+TARGET = tst_technicalindicators
+SOURCES += $${PWD}/tst_technicalindicators.cpp
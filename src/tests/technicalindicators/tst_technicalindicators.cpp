@@ -0,0 +1,170 @@
+//  This file is part of Qt Bitcoin Trader
+//      https://github.com/JulyIGHOR/QtBitcoinTrader
+//  Copyright (C) 2013-2018 July IGHOR <julyighor@gmail.com>
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  In addition, as a special exception, the copyright holders give
+//  permission to link the code of portions of this program with the
+//  OpenSSL library under certain conditions as described in each
+//  individual source file, and distribute linked combinations including
+//  the two.
+//
+//  You must obey the GNU General Public License in all respects for all
+//  of the code used other than OpenSSL. If you modify file(s) with this
+//  exception, you may extend this exception to your version of the
+//  file(s), but you are not obligated to do so. If you do not wish to do
+//  so, delete this exception statement from your version. If you delete
+//  this exception statement from all source files in the program, then
+//  also delete it here.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <QtTest>
+#include "technicalindicators.h"
+
+namespace
+{
+    // Closes of the StockCharts RSI example, expected values computed with the textbook definitions:
+    // SMA seeded EMA, Wilder smoothing for RSI and ATR, population deviation for Bollinger Bands
+    const double closes[] = {44.34, 44.09, 44.15, 43.61, 44.33, 44.83, 45.10, 45.42, 45.84, 46.08, 45.89, 46.03, 45.61,
+                             46.28, 46.28, 46.00, 46.03, 46.41, 46.22, 45.64, 46.21, 46.25, 45.71, 46.45, 45.78, 45.35,
+                             44.03, 44.18, 44.22, 44.57, 43.42, 42.66, 43.13};
+    const int barsCount = sizeof(closes) / sizeof(closes[0]);
+
+    BarItem barAt(int index)
+    {
+        BarItem bar;
+        bar.date = (index + 1) * 60;
+        bar.open = closes[index];
+        bar.high = closes[index] + 0.3 + (index % 3) * 0.1;
+        bar.low = closes[index] - 0.25 - (index % 2) * 0.1;
+        bar.close = closes[index];
+        return bar;
+    }
+
+    bool makeState(const QString& name, TechnicalIndicators::State* state)
+    {
+        state->name = name;
+        return TechnicalIndicators::parseName(name, &state->spec);
+    }
+}
+
+class TechnicalIndicatorsTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void matchesReference_data()
+    {
+        QTest::addColumn<QString>("name");
+        QTest::addColumn<int>("firstReadyBar");
+        QTest::addColumn<int>("checkedBar");
+        QTest::addColumn<double>("expected");
+
+        QTest::newRow("EMA seed") << "EMA(10)" << 9 << 9 << 44.7790000000;
+        QTest::newRow("EMA first step") << "EMA(10)" << 9 << 10 << 44.9810000000;
+        QTest::newRow("EMA last") << "EMA(10)" << 9 << 32 << 44.1192990152;
+        QTest::newRow("SMA first") << "SMA(10)" << 9 << 9 << 44.7790000000;
+        QTest::newRow("SMA rolled") << "SMA(10)" << 9 << 10 << 44.9340000000;
+        QTest::newRow("SMA after rebuilds") << "SMA(10)" << 9 << 32 << 44.3790000000;
+        QTest::newRow("RSI first") << "RSI(14)" << 14 << 14 << 70.4641350211;
+        QTest::newRow("RSI second") << "RSI(14)" << 14 << 15 << 66.2496185536;
+        QTest::newRow("RSI last") << "RSI(14)" << 14 << 32 << 37.7887719821;
+        QTest::newRow("MACD first") << "MACD(5,10,4)" << 9 << 9 << 0.7105802469;
+        QTest::newRow("MACD later") << "MACD(5,10,4)" << 9 << 12 << 0.4577216648;
+        QTest::newRow("MACD last") << "MACD(5,10,4)" << 9 << 32 << -0.6082205441;
+        QTest::newRow("MACD signal first") << "MACDSignal(5,10,4)" << 12 << 12 << 0.5993326172;
+        QTest::newRow("MACD signal last") << "MACDSignal(5,10,4)" << 12 << 32 << -0.5410112423;
+        QTest::newRow("MACD hist last") << "MACDHist(5,10,4)" << 12 << 32 << -0.0672093018;
+        QTest::newRow("BB upper first") << "BBUpper(20,2)" << 19 << 19 << 47.1153282217;
+        QTest::newRow("BB middle first") << "BBMiddle(20,2)" << 19 << 19 << 45.4090000000;
+        QTest::newRow("BB lower first") << "BBLower(20,2)" << 19 << 19 << 43.7026717783;
+        QTest::newRow("BB upper last") << "BBUpper(20,2)" << 19 << 32 << 47.6201502685;
+        QTest::newRow("BB lower last") << "BBLower(20,2)" << 19 << 32 << 42.8618497315;
+        QTest::newRow("ATR first") << "ATR(14)" << 13 << 13 << 0.7992857143;
+        QTest::newRow("ATR second") << "ATR(14)" << 13 << 14 << 0.7957653061;
+        QTest::newRow("ATR last") << "ATR(14)" << 13 << 32 << 0.9069413495;
+    }
+
+    void matchesReference()
+    {
+        QFETCH(QString, name);
+        QFETCH(int, firstReadyBar);
+        QFETCH(int, checkedBar);
+        QFETCH(double, expected);
+
+        TechnicalIndicators::State state;
+        QVERIFY(makeState(name, &state));
+
+        for (int n = 0; n <= checkedBar; n++)
+        {
+            double value = -1.0;
+            bool ready = state.update(barAt(n), &value);
+
+            // Not published until there are enough bars for the period, then on every bar
+            QCOMPARE(ready, n >= firstReadyBar);
+
+            if (n == checkedBar && qAbs(value - expected) > 1e-8)
+                QFAIL(qPrintable(QString("%1 at bar %2 is %3, expected %4").arg(name).arg(n)
+                                 .arg(value, 0, 'f', 10).arg(expected, 0, 'f', 10)));
+        }
+    }
+
+    void countsRepeatedBarOnce()
+    {
+        TechnicalIndicators::State state;
+        QVERIFY(makeState("SMA(3)", &state));
+        double value = 0.0;
+
+        QVERIFY(!state.update(barAt(0), &value));
+        QVERIFY(!state.update(barAt(1), &value));
+
+        // The warm up history and a late close may give the same bar twice
+        QVERIFY(!state.update(barAt(1), &value));
+        QCOMPARE(state.barsCount, qint64(2));
+
+        QVERIFY(state.update(barAt(2), &value));
+        QVERIFY(qAbs(value - (44.34 + 44.09 + 44.15) / 3.0) < 1e-10);
+    }
+
+    void rejectsBadNames_data()
+    {
+        QTest::addColumn<QString>("name");
+
+        QTest::newRow("unknown kind") << "WMA(10)";
+        QTest::newRow("zero period") << "EMA(0)";
+        QTest::newRow("too long period") << "SMA(10001)";
+        QTest::newRow("missing MACD periods") << "MACD(12,26)";
+        QTest::newRow("bad timeframe") << "RSI(14,7x)";
+        QTest::newRow("zero width") << "BBUpper(20,0)";
+    }
+
+    void rejectsBadNames()
+    {
+        QFETCH(QString, name);
+        QVERIFY(!TechnicalIndicators::isValidName(name));
+    }
+
+    void canonicalNames()
+    {
+        TechnicalIndicators::Spec spec;
+        QVERIFY(TechnicalIndicators::parseName(" macd( 12, 26, 9 ) ", &spec));
+        QCOMPARE(TechnicalIndicators::specName(spec), QString("MACD(12,26,9,1m)"));
+
+        QVERIFY(TechnicalIndicators::parseName("bbupper(20,2.5,5m)", &spec));
+        QCOMPARE(TechnicalIndicators::specName(spec), QString("BBUpper(20,2.5,5m)"));
+    }
+};
+
+QTEST_APPLESS_MAIN(TechnicalIndicatorsTest)
+#include "tst_technicalindicators.moc"
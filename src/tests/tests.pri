@@ -0,0 +1,15 @@
+#
+# Builds a test against the application sources, main.cpp is replaced by the test runner
+#
+include($${PWD}/../QtBitcoinTrader_Desktop.pro)
+
+TEMPLATE = app
+QT += testlib
+CONFIG += testcase console
+CONFIG -= app_bundle
+INCLUDEPATH += $$clean_path($${PWD}/..)
+
+SOURCES -= $$clean_path($${PWD}/../main.cpp)
+SOURCES += $${PWD}/testbasevalues.cpp
+
+INSTALLS =
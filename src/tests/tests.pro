@@ -0,0 +1,7 @@
+TEMPLATE = subdirs
+
+SUBDIRS += julywebsocket \
+           julydecimal \
+           julyfixed \
+           depthdeltaqueue \
+           technicalindicators
@@ -0,0 +1,530 @@
+//  This file is part of Qt Bitcoin Trader
+//      https://github.com/JulyIGHOR/QtBitcoinTrader
+//  Copyright (C) 2013-2018 July IGHOR <julyighor@gmail.com>
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  In addition, as a special exception, the copyright holders give
+//  permission to link the code of portions of this program with the
+//  OpenSSL library under certain conditions as described in each
+//  individual source file, and distribute linked combinations including
+//  the two.
+//
+//  You must obey the GNU General Public License in all respects for all
+//  of the code used other than OpenSSL. If you modify file(s) with this
+//  exception, you may extend this exception to your version of the
+//  file(s), but you are not obligated to do so. If you do not wish to do
+//  so, delete this exception statement from your version. If you delete
+//  this exception statement from all source files in the program, then
+//  also delete it here.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "tickstore.h"
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QMutexLocker>
+#include <QtEndian>
+#include <algorithm>
+#include "main.h"
+#include "tradesitem.h"
+
+namespace
+{
+    const char segmentMagic[4] = {'Q', 'B', 'T', 'T'};
+    const quint32 segmentVersion = 2;
+    const qint64 headerSize = 64;
+
+    const int countOffset = 16;
+    const int firstTimeOffset = 24;
+    const int lastTimeOffset = 32;
+
+    bool firstTimeLess(const QString& a, const QString& b)
+    {
+        return a.section('.', 0, 0).toLongLong() < b.section('.', 0, 0).toLongLong();
+    }
+}
+
+TickStore::Segment::Segment()
+{
+    file = nullptr;
+    data = nullptr;
+    version = 0;
+    firstTime = 0;
+    lastTime = 0;
+}
+
+TickStore::Segment::~Segment()
+{
+    close();
+}
+
+void TickStore::Segment::close()
+{
+    if (file)
+    {
+        if (data)
+            file->unmap(data);
+
+        file->close();
+        delete file;
+    }
+
+    file = nullptr;
+    data = nullptr;
+}
+
+TickStore::Series::Series()
+{
+    kind = 0;
+    resumeTime = 0;
+}
+
+TickStore::Series::~Series()
+{
+    qDeleteAll(segments);
+}
+
+TickStore::TickStore()
+{
+    enabled = true;
+    retentionDays = 7;
+}
+
+TickStore::~TickStore()
+{
+    qDeleteAll(seriesMap);
+}
+
+TickStore* TickStore::global()
+{
+    static TickStore instance;
+    return &instance;
+}
+
+void TickStore::setEnabled(bool on)
+{
+    QMutexLocker lock(&locker);
+    enabled = on;
+}
+
+bool TickStore::isEnabled() const
+{
+    QMutexLocker lock(&locker);
+    return enabled;
+}
+
+void TickStore::setRetentionDays(int days)
+{
+    QMutexLocker lock(&locker);
+    retentionDays = qMax(1, days);
+}
+
+int TickStore::columnsCount(int kind)
+{
+    return kind == TradesKind ? 4 : 5;
+}
+
+int TickStore::columnWidth(int kind, int column)
+{
+    // The trade type is the only narrow column
+    if (kind == TradesKind && column == 3)
+        return 1;
+
+    return 8;
+}
+
+qint64 TickStore::columnOffset(int kind, int column)
+{
+    qint64 offset = headerSize;
+
+    for (int n = 0; n < column; n++)
+        offset += qint64(segmentCapacity) * columnWidth(kind, n);
+
+    return offset;
+}
+
+qint64 TickStore::segmentSize(int kind)
+{
+    return columnOffset(kind, columnsCount(kind));
+}
+
+QString TickStore::segmentPath(const Series* series, qint64 firstTime) const
+{
+    return series->folder + QLatin1Char('/') + QString::number(firstTime) +
+           (series->kind == TradesKind ? QLatin1String(".trades") : QLatin1String(".book"));
+}
+
+TickStore::Series* TickStore::series(const QString& exchange, const QString& symbol, int kind)
+{
+    QString key = exchange + QLatin1Char('/') + symbol + QLatin1Char('/') + QString::number(kind);
+    Series* result = seriesMap.value(key, nullptr);
+
+    if (result)
+        return result;
+
+    result = new Series;
+    result->kind = kind;
+    result->folder = appDataDir + "/Ticks/" + exchange + QLatin1Char('/') + symbol;
+    seriesMap.insert(key, result);
+
+    if (!QFile::exists(result->folder))
+        QDir().mkpath(result->folder);
+
+    QDir folder(result->folder);
+
+    QStringList fileNames = folder.entryList(QStringList() << (kind == TradesKind ? "*.trades" : "*.book"), QDir::Files);
+    std::sort(fileNames.begin(), fileNames.end(), firstTimeLess);
+
+    for (int n = 0; n < fileNames.count(); n++)
+    {
+        Segment* segment = new Segment;
+        segment->firstTime = fileNames.at(n).section('.', 0, 0).toLongLong();
+        segment->lastTime = segment->firstTime;
+        result->segments << segment;
+    }
+
+    removeExpired(result);
+
+    if (!result->segments.isEmpty() && mapSegment(result, result->segments.last(), false))
+        result->resumeTime = result->segments.last()->lastTime;
+
+    return result;
+}
+
+bool TickStore::mapSegment(Series* series, Segment* segment, bool create)
+{
+    if (segment->data)
+        return true;
+
+    if (segment->file)
+        return false;
+
+    qint64 size = segmentSize(series->kind);
+    segment->file = new QFile(segmentPath(series, segment->firstTime));
+
+    if ((!create && !segment->file->exists()) || !segment->file->open(QIODevice::ReadWrite))
+    {
+        if (debugLevel)
+            logThread->writeLog("Can't open tick segment " + segment->file->fileName().toUtf8(), 2);
+
+        return false;
+    }
+
+    if (create && !segment->file->resize(size))
+        return false;
+
+    if (segment->file->size() < size)
+        return false;
+
+    segment->data = segment->file->map(0, size);
+
+    if (segment->data == nullptr)
+        return false;
+
+    if (create)
+    {
+        memset(segment->data, 0, headerSize);
+        memcpy(segment->data, segmentMagic, sizeof(segmentMagic));
+        qToLittleEndian<quint32>(segmentVersion, segment->data + 4);
+        qToLittleEndian<quint32>(quint32(series->kind), segment->data + 8);
+        qToLittleEndian<quint32>(segmentCapacity, segment->data + 12);
+        qToLittleEndian<qint64>(segment->firstTime, segment->data + firstTimeOffset);
+        qToLittleEndian<qint64>(segment->firstTime, segment->data + lastTimeOffset);
+    }
+    else if (memcmp(segment->data, segmentMagic, sizeof(segmentMagic)) != 0 ||
+             qFromLittleEndian<quint32>(segment->data + 4) == 0 ||
+             qFromLittleEndian<quint32>(segment->data + 4) > segmentVersion ||
+             qFromLittleEndian<quint32>(segment->data + 8) != quint32(series->kind) ||
+             qFromLittleEndian<quint32>(segment->data + 12) != segmentCapacity)
+    {
+        segment->file->unmap(segment->data);
+        segment->data = nullptr;
+        return false;
+    }
+
+    segment->version = qFromLittleEndian<quint32>(segment->data + 4);
+    segment->lastTime = qFromLittleEndian<qint64>(segment->data + lastTimeOffset);
+    return true;
+}
+
+quint64 TickStore::segmentCount(const Segment* segment) const
+{
+    return qMin<quint64>(qFromLittleEndian<quint64>(segment->data + countOffset), segmentCapacity);
+}
+
+qint64 TickStore::value(const Series* series, const Segment* segment, int column, quint64 row) const
+{
+    const uchar* position = segment->data + columnOffset(series->kind, column) + row * columnWidth(series->kind, column);
+
+    if (columnWidth(series->kind, column) == 1)
+        return qint8(*position);
+
+    return qFromLittleEndian<qint64>(position);
+}
+
+double TickStore::number(const Series* series, const Segment* segment, int column, quint64 row) const
+{
+    qint64 bits = value(series, segment, column, row);
+
+    if (segment->version == 1)
+        return JulyAmount::fromRaw(bits).toDouble();
+
+    double result;
+    memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+qint64 TickStore::numberBits(double number)
+{
+    qint64 bits;
+    memcpy(&bits, &number, sizeof(bits));
+    return bits;
+}
+
+void TickStore::setValue(const Series* series, Segment* segment, int column, quint64 row, qint64 newValue)
+{
+    uchar* position = segment->data + columnOffset(series->kind, column) + row * columnWidth(series->kind, column);
+
+    if (columnWidth(series->kind, column) == 1)
+        *position = uchar(qint8(newValue));
+    else
+        qToLittleEndian<qint64>(newValue, position);
+}
+
+quint64 TickStore::firstRowFrom(const Series* series, const Segment* segment, qint64 fromTime) const
+{
+    quint64 first = 0;
+    quint64 last = segmentCount(segment);
+
+    while (first < last)
+    {
+        quint64 middle = (first + last) / 2;
+
+        if (value(series, segment, 0, middle) < fromTime)
+            first = middle + 1;
+        else
+            last = middle;
+    }
+
+    return first;
+}
+
+QList<TickStore::Segment*> TickStore::segmentsBetween(Series* series, qint64 fromTime, qint64 toTime)
+{
+    QList<Segment*> result;
+
+    for (int n = 0; n < series->segments.count(); n++)
+    {
+        Segment* segment = series->segments.at(n);
+
+        if (segment->firstTime >= toTime)
+            break;
+
+        if (n + 1 < series->segments.count() && series->segments.at(n + 1)->firstTime < fromTime)
+            continue;
+
+        if (mapSegment(series, segment, false))
+            result << segment;
+    }
+
+    return result;
+}
+
+void TickStore::releaseSegments(Series* series, const QList<Segment*>& segments)
+{
+    for (int n = 0; n < segments.count(); n++)
+        if (segments.at(n) != series->segments.last())
+            segments.at(n)->close();
+}
+
+void TickStore::removeExpired(Series* series)
+{
+    // A segment ends where the next one starts, so old segments are found without opening them
+    qint64 oldestKept = QDateTime::currentMSecsSinceEpoch() - qint64(retentionDays) * 86400000;
+
+    while (series->segments.count() > 1 && series->segments.at(1)->firstTime < oldestKept)
+    {
+        Segment* segment = series->segments.takeFirst();
+        QString path = segmentPath(series, segment->firstTime);
+        delete segment;
+        QFile::remove(path);
+    }
+}
+
+void TickStore::append(Series* series, const qint64* values)
+{
+    qint64 time = values[0];
+
+    // Records the store had before a restart come again from the exchange, times never go back
+    if (time <= series->resumeTime)
+        return;
+
+    Segment* segment = series->segments.isEmpty() ? nullptr : series->segments.last();
+
+    // A damaged or older version last segment is left as it is and writing goes on in a new one
+    if (segment && (!mapSegment(series, segment, false) || segment->version != segmentVersion))
+        segment = nullptr;
+
+    if (segment && time < segment->lastTime)
+        return;
+
+    if (segment == nullptr || segmentCount(segment) >= segmentCapacity)
+    {
+        if (!series->segments.isEmpty() && series->segments.last()->firstTime >= time)
+            return;
+
+        segment = new Segment;
+        segment->firstTime = time;
+        segment->lastTime = time;
+
+        if (!mapSegment(series, segment, true))
+        {
+            QString path = segmentPath(series, segment->firstTime);
+            delete segment;
+            QFile::remove(path);
+            return;
+        }
+
+        // The segment written before is done, it is only mapped again by reads
+        if (!series->segments.isEmpty())
+            series->segments.last()->close();
+
+        series->segments << segment;
+        removeExpired(series);
+    }
+
+    quint64 row = segmentCount(segment);
+
+    for (int column = 0; column < columnsCount(series->kind); column++)
+        setValue(series, segment, column, row, values[column]);
+
+    segment->lastTime = time;
+    qToLittleEndian<qint64>(time, segment->data + lastTimeOffset);
+
+    // Written last, readers never see a row before its columns
+    qToLittleEndian<quint64>(row + 1, segment->data + countOffset);
+}
+
+void TickStore::appendTrades(const QString& exchange, const QString& symbol, const QList<TradesItem>& trades)
+{
+    QMutexLocker lock(&locker);
+
+    if (!enabled || symbol.isEmpty())
+        return;
+
+    Series* tradesSeries = series(exchange, symbol, TradesKind);
+    qint64 values[4];
+
+    for (int n = 0; n < trades.count(); n++)
+    {
+        const TradesItem& trade = trades.at(n);
+
+        if (!trade.isValid())
+            continue;
+
+        values[0] = trade.date * 1000;
+        values[1] = numberBits(trade.price);
+        values[2] = numberBits(trade.amount);
+        values[3] = trade.orderType;
+        append(tradesSeries, values);
+    }
+}
+
+void TickStore::appendTopOfBook(const QString& exchange, const QString& symbol, const TopOfBookTick& tick)
+{
+    QMutexLocker lock(&locker);
+
+    if (!enabled || symbol.isEmpty())
+        return;
+
+    qint64 values[5];
+    values[0] = tick.time;
+    values[1] = numberBits(tick.bidPrice.toDouble());
+    values[2] = numberBits(tick.bidVolume.toDouble());
+    values[3] = numberBits(tick.askPrice.toDouble());
+    values[4] = numberBits(tick.askVolume.toDouble());
+    append(series(exchange, symbol, BookKind), values);
+}
+
+void TickStore::readTrades(const QString& exchange, const QString& symbol, qint64 fromTime, qint64 toTime,
+                           QList<TradesItem>* trades)
+{
+    QMutexLocker lock(&locker);
+
+    if (!enabled || symbol.isEmpty())
+        return;
+
+    Series* tradesSeries = series(exchange, symbol, TradesKind);
+    QList<Segment*> segments = segmentsBetween(tradesSeries, fromTime, toTime);
+
+    for (int n = 0; n < segments.count(); n++)
+    {
+        const Segment* segment = segments.at(n);
+        quint64 rowsCount = segmentCount(segment);
+
+        for (quint64 row = firstRowFrom(tradesSeries, segment, fromTime); row < rowsCount; row++)
+        {
+            qint64 time = value(tradesSeries, segment, 0, row);
+
+            if (time >= toTime)
+                break;
+
+            TradesItem trade;
+            trade.date = time / 1000;
+            trade.price = number(tradesSeries, segment, 1, row);
+            trade.amount = number(tradesSeries, segment, 2, row);
+            trade.orderType = int(value(tradesSeries, segment, 3, row));
+            trade.total = trade.price * trade.amount;
+            trade.symbol = symbol;
+            (*trades) << trade;
+        }
+    }
+
+    releaseSegments(tradesSeries, segments);
+}
+
+void TickStore::readTopOfBook(const QString& exchange, const QString& symbol, qint64 fromTime, qint64 toTime,
+                              QVector<TopOfBookTick>* ticks)
+{
+    QMutexLocker lock(&locker);
+
+    if (!enabled || symbol.isEmpty())
+        return;
+
+    Series* bookSeries = series(exchange, symbol, BookKind);
+    QList<Segment*> segments = segmentsBetween(bookSeries, fromTime, toTime);
+
+    for (int n = 0; n < segments.count(); n++)
+    {
+        const Segment* segment = segments.at(n);
+        quint64 rowsCount = segmentCount(segment);
+
+        for (quint64 row = firstRowFrom(bookSeries, segment, fromTime); row < rowsCount; row++)
+        {
+            TopOfBookTick tick;
+            tick.time = value(bookSeries, segment, 0, row);
+
+            if (tick.time >= toTime)
+                break;
+
+            tick.bidPrice = JulyPrice::fromDouble(number(bookSeries, segment, 1, row));
+            tick.bidVolume = JulyAmount::fromDouble(number(bookSeries, segment, 2, row));
+            tick.askPrice = JulyPrice::fromDouble(number(bookSeries, segment, 3, row));
+            tick.askVolume = JulyAmount::fromDouble(number(bookSeries, segment, 4, row));
+            ticks->append(tick);
+        }
+    }
+
+    releaseSegments(bookSeries, segments);
+}
@@ -0,0 +1,146 @@
+//  This file is part of Qt Bitcoin Trader
+//      https://github.com/JulyIGHOR/QtBitcoinTrader
+//  Copyright (C) 2013-2018 July IGHOR <julyighor@gmail.com>
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  In addition, as a special exception, the copyright holders give
+//  permission to link the code of portions of this program with the
+//  OpenSSL library under certain conditions as described in each
+//  individual source file, and distribute linked combinations including
+//  the two.
+//
+//  You must obey the GNU General Public License in all respects for all
+//  of the code used other than OpenSSL. If you modify file(s) with this
+//  exception, you may extend this exception to your version of the
+//  file(s), but you are not obligated to do so. If you do not wish to do
+//  so, delete this exception statement from your version. If you delete
+//  this exception statement from all source files in the program, then
+//  also delete it here.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef TICKSTORE_H
+#define TICKSTORE_H
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+#include "julyfixed.h"
+
+class QFile;
+struct TradesItem;
+
+struct TopOfBookTick
+{
+    qint64 time;//Milliseconds since epoch
+    JulyPrice bidPrice;
+    JulyAmount bidVolume;
+    JulyPrice askPrice;
+    JulyAmount askVolume;
+};
+
+// Append only store of trades and best bid/ask per exchange and symbol, kept across restarts.
+// Files live in appDataDir/Ticks/<exchange>/<symbol>/ as segments named by their first time,
+// "<ms>.trades" and "<ms>.book". A segment is one memory mapped file of fixed capacity:
+// a 64 byte header (magic "QBTT", version, kind, capacity, count, first and last time, all
+// little endian) followed by one column per field, each capacity values long.
+// Trades columns: time qint64 ms, price double, amount double, type qint8.
+// Book columns: time qint64 ms, bid price, bid volume, ask price, ask volume, all double.
+// Version 1 segments kept prices and amounts as qint64 10^-8 units, too narrow for the volumes
+// of high supply tokens. They are still read, writing always goes on in a new segment.
+// Times never decrease, so the segment names are the time index and reads binary search
+// the time column. The header count is written after the columns, other readers may map
+// the files at any time. Writes come from the exchange thread, reads from any thread.
+// Only the segment being written stays mapped, read segments are unmapped after the read and
+// segments past the retention are removed whenever writing moves on to a new segment.
+class TickStore
+{
+public:
+    TickStore();
+    ~TickStore();
+
+    static TickStore* global();
+
+    void setEnabled(bool on);
+    bool isEnabled() const;
+    void setRetentionDays(int days);
+
+    void appendTrades(const QString& exchange, const QString& symbol, const QList<TradesItem>& trades);
+    void appendTopOfBook(const QString& exchange, const QString& symbol, const TopOfBookTick& tick);
+
+    // Appends the kept records with fromTime <= time < toTime, oldest first. The store is locked for
+    // the whole call, so readers outside the exchange thread ask for an hour or so at a time
+    void readTrades(const QString& exchange, const QString& symbol, qint64 fromTime, qint64 toTime,
+                    QList<TradesItem>* trades);
+    void readTopOfBook(const QString& exchange, const QString& symbol, qint64 fromTime, qint64 toTime,
+                       QVector<TopOfBookTick>* ticks);
+
+private:
+    enum Kind {TradesKind = 1, BookKind = 2};
+
+    struct Segment
+    {
+        Segment();
+        ~Segment();
+
+        void close();
+
+        QFile* file;
+        uchar* data;
+        quint32 version;
+        qint64 firstTime;
+        qint64 lastTime;
+    };
+
+    struct Series
+    {
+        Series();
+        ~Series();
+
+        int kind;
+        QString folder;
+        QList<Segment*> segments;
+        qint64 resumeTime;
+    };
+
+    mutable QMutex locker;
+    QHash<QString, Series*> seriesMap;
+    bool enabled;
+    int retentionDays;
+
+    static const quint32 segmentCapacity = 65536;
+
+    static int columnsCount(int kind);
+    static int columnWidth(int kind, int column);
+    static qint64 columnOffset(int kind, int column);
+    static qint64 segmentSize(int kind);
+
+    Series* series(const QString& exchange, const QString& symbol, int kind);
+    bool mapSegment(Series* series, Segment* segment, bool create);
+    Segment* writableSegment(Series* series, qint64 time);
+    QString segmentPath(const Series* series, qint64 firstTime) const;
+    quint64 segmentCount(const Segment* segment) const;
+    qint64 value(const Series* series, const Segment* segment, int column, quint64 row) const;
+    double number(const Series* series, const Segment* segment, int column, quint64 row) const;
+    static qint64 numberBits(double number);
+    void setValue(const Series* series, Segment* segment, int column, quint64 row, qint64 newValue);
+    quint64 firstRowFrom(const Series* series, const Segment* segment, qint64 fromTime) const;
+    QList<Segment*> segmentsBetween(Series* series, qint64 fromTime, qint64 toTime);
+    void releaseSegments(Series* series, const QList<Segment*>& segments);
+    void removeExpired(Series* series);
+    void append(Series* series, const qint64* values);
+};
+
+#endif // TICKSTORE_H
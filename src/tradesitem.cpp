@@ -31,7 +31,8 @@
 
 #include "tradesitem.h"
 #include "main.h"
-#include "julymath.h"
+#include "julyfixed.h"
+#include "rowtextcache.h"
 
 TradesItem::TradesItem()
 {
@@ -43,48 +44,60 @@ TradesItem::TradesItem()
     total = 0.0;
     orderType = 0;
     direction = 0;
+    generation = RowTextCache::newGeneration();
 }
 
-void TradesItem::cacheStrings()
+QString TradesItem::timeText() const
 {
     QDateTime itemDate = QDateTime::fromTime_t(date);
 
     if (baseValues_->use24HourTimeFormat)
-    {
-        timeStr = itemDate.toString(baseValues.timeFormat);
-        dateStr = itemDate.toString(baseValues.dateTimeFormat);
-    }
-    else
-    {
-        QString mmssTemp = itemDate.toString("mm:ss");
-        QString hTemp = itemDate.toString("H");
-        qint16 hTempInt = hTemp.toShort();
-
-        if (hTempInt <= 12)
-            timeStr = hTemp + ':' + mmssTemp + " am";
-        else
-            timeStr = QString::number(hTempInt - 12) + ':' + mmssTemp + " pm";
-
-        dateStr = itemDate.toString("dd.MM.yyyy") + ' ' + timeStr;
-    }
-
-    if (price > 0.0)
-        priceStr = JulyMath::textFromDouble(price, baseValues.decimalsPriceLastTrades);
-
-    if (amount > 0.0)
-        amountStr = JulyMath::textFromDouble(amount, baseValues.decimalsAmountLastTrades);
-
-    if (amount > 0.0 && price > 0.0)
-        totalStr = JulyMath::textFromDouble(price * amount, qMin(baseValues.currentPair.currBDecimals,
-                                            baseValues.decimalsTotalLastTrades));
+        return itemDate.toString(baseValues.timeFormat);
+
+    QString mmssTemp = itemDate.toString("mm:ss");
+    QString hTemp = itemDate.toString("H");
+    qint16 hTempInt = hTemp.toShort();
+
+    if (hTempInt <= 12)
+        return hTemp + ':' + mmssTemp + " am";
+
+    return QString::number(hTempInt - 12) + ':' + mmssTemp + " pm";
+}
+
+QString TradesItem::dateText() const
+{
+    if (baseValues_->use24HourTimeFormat)
+        return QDateTime::fromTime_t(date).toString(baseValues.dateTimeFormat);
+
+    return QDateTime::fromTime_t(date).toString("dd.MM.yyyy") + ' ' + timeText();
+}
+
+QString TradesItem::amountText() const
+{
+    if (amount <= 0.0)
+        return QString();
+
+    return JulyAmount::fromDouble(amount).toString(baseValues.decimalsAmountLastTrades);
 }
 
-bool TradesItem::isValid()
+QString TradesItem::priceText() const
 {
-    bool valid = date > 0 && price > 0.0 && amount > 0.0;
+    if (price <= 0.0)
+        return QString();
 
-    if (valid)
-        cacheStrings();
+    return JulyPrice::fromDouble(price).toString(baseValues.decimalsPriceLastTrades);
+}
 
-    return valid;
+QString TradesItem::totalText() const
+{
+    if (amount <= 0.0 || price <= 0.0)
+        return QString();
+
+    return JulyPrice::fromDouble(price * amount).toString(qMin(baseValues.currentPair.currBDecimals,
+                                                               baseValues.decimalsTotalLastTrades));
+}
+
+bool TradesItem::isValid() const
+{
+    return date > 0 && price > 0.0 && amount > 0.0;
 }
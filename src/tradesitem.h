@@ -41,17 +41,12 @@ struct TradesItem
 
     bool displayFullDate;
     qint64 date;
-    QString dateStr;
-    QString timeStr;
 
     double amount;
-    QString amountStr;
 
     double price;
-    QString priceStr;
 
     double total;
-    QString totalStr;
 
     QString symbol;//Like a "BTCUSD" 6 symbols only
 
@@ -59,9 +54,15 @@ struct TradesItem
 
     int direction;//-1:Down; 0: None; 1:Up
 
-    void cacheStrings();
+    quint64 generation;//Identifies the formatted texts in the models cache
 
-    bool isValid();
+    QString timeText() const;
+    QString dateText() const;
+    QString amountText() const;
+    QString priceText() const;
+    QString totalText() const;
+
+    bool isValid() const;
 };
 
 #endif // TRADESITEM_H
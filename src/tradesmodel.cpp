@@ -37,10 +37,13 @@ TradesModel::TradesModel()
 {
     lastPrecentBids = 0.0;
     lastRemoveDate = 0;
+    windowLength = 600;
     lastPrice = 0.0;
     columnsCount = 8;
     dateWidth = 100;
     typeWidth = 100;
+    windowVolume.clear();
+    windowBidsVolume.clear();
 }
 
 TradesModel::~TradesModel()
@@ -56,9 +59,49 @@ void TradesModel::clear()
     beginResetModel();
     lastPrice = 0.0;
     itemsList.clear();
+    windowVolume.clear();
+    windowBidsVolume.clear();
+    textCache.clear();
     endResetModel();
 }
 
+QString TradesModel::rowText(int row, TextField field) const
+{
+    const TradesItem& item = itemsList.at(row);
+    const QString* cachedText = textCache.find(item.generation, field);
+
+    if (cachedText)
+        return *cachedText;
+
+    QString text;
+
+    switch (field)
+    {
+        case TimeText:
+            text = item.timeText();
+            break;
+
+        case DateText:
+            text = item.dateText();
+            break;
+
+        case AmountText:
+            text = item.amountText();
+            break;
+
+        case PriceText:
+            text = item.priceText();
+            break;
+
+        case TotalText:
+            text = item.totalText();
+            break;
+    }
+
+    textCache.insert(item.generation, field, text);
+    return text;
+}
+
 int TradesModel::rowCount(const QModelIndex&) const
 {
     return itemsList.count();
@@ -69,12 +112,46 @@ int TradesModel::columnCount(const QModelIndex&) const
     return columnsCount;
 }
 
-void TradesModel::removeFirst()
+void TradesModel::setWindowSeconds(int seconds)
 {
-    if (itemsList.count() == 0)
-        return;
+    windowLength = qMax(1, seconds);
+}
+
+int TradesModel::windowSeconds() const
+{
+    return windowLength;
+}
 
-    itemsList.removeFirst();
+void TradesModel::WindowSum::clear()
+{
+    sum = 0.0;
+    compensation = 0.0;
+}
+
+void TradesModel::WindowSum::add(double value)
+{
+    double newSum = sum + value;
+
+    if (qAbs(sum) >= qAbs(value))
+        compensation += (sum - newSum) + value;
+    else
+        compensation += (value - newSum) + sum;
+
+    sum = newSum;
+}
+
+double TradesModel::WindowSum::value() const
+{
+    return sum + compensation;
+}
+
+void TradesModel::addToWindow(const TradesItem& item, int sign)
+{
+    double amount = sign < 0 ? -item.amount : item.amount;
+    windowVolume.add(amount);
+
+    if (item.orderType == -1)
+        windowBidsVolume.add(amount);
 }
 
 void TradesModel::removeDataOlderThen(quint32 date)
@@ -87,24 +164,17 @@ void TradesModel::removeDataOlderThen(quint32 date)
         return;
     }
 
-    int removeUpToIndex = -1;
+    int removeCount = 0;
 
-    for (int n = 0; n < itemsList.count(); n++)
-    {
-        if (date <= itemsList.at(n).date)
-            break;
+    while (removeCount < itemsList.count() && itemsList.at(removeCount).date < date)
+        addToWindow(itemsList.at(removeCount++), -1);
 
-        removeUpToIndex = n;
-    }
-
-    if (removeUpToIndex == -1)
+    if (removeCount == 0)
         return;
 
-    beginRemoveRows(QModelIndex(), 0, removeUpToIndex);
-
-    for (int n = 0; n <= removeUpToIndex; n++)
-        itemsList.removeFirst();
-
+    // The oldest trades are the last rows of the view
+    beginRemoveRows(QModelIndex(), itemsList.count() - removeCount, itemsList.count() - 1);
+    itemsList.removeFirst(removeCount);
     endRemoveRows();
 
     if (itemsList.count() == 0)
@@ -138,17 +208,17 @@ QVariant TradesModel::data(const QModelIndex& index, int role) const
                 break;
         }
 
-        return itemsList.at(currentRow).dateStr + " " + baseValues.currentPair.currASign + itemsList.at(
-                   currentRow).amountStr + " " + typeText + " " + (itemsList.at(currentRow).direction == 1 ? upArrowStr : downArrowStr) +
-               " " + baseValues.currentPair.currBSign + itemsList.at(currentRow).priceStr + " " + baseValues.currentPair.currBSign +
-               itemsList.at(currentRow).totalStr;
+        return rowText(currentRow, DateText) + " " + baseValues.currentPair.currASign + rowText(currentRow, AmountText) + " " +
+               typeText + " " + (itemsList.at(currentRow).direction == 1 ? upArrowStr : downArrowStr) + " " +
+               baseValues.currentPair.currBSign + rowText(currentRow, PriceText) + " " + baseValues.currentPair.currBSign +
+               rowText(currentRow, TotalText);
     }
 
     if (role == Qt::StatusTipRole)
     {
         QString lineText;
-        lineText += itemsList.at(currentRow).dateStr + "\t";
-        lineText += baseValues.currentPair.currASign + itemsList.at(currentRow).amountStr;
+        lineText += rowText(currentRow, DateText) + "\t";
+        lineText += baseValues.currentPair.currASign + rowText(currentRow, AmountText);
 
         switch (itemsList.at(currentRow).orderType)
         {
@@ -171,8 +241,8 @@ QVariant TradesModel::data(const QModelIndex& index, int role) const
                     lineText += "\t" + downArrowStr;
             }
 
-            lineText += "\t" + baseValues.currentPair.currBSign + itemsList.at(currentRow).priceStr + "\t";
-            lineText += baseValues.currentPair.currBSign + itemsList.at(currentRow).totalStr;
+            lineText += "\t" + baseValues.currentPair.currBSign + rowText(currentRow, PriceText) + "\t";
+            lineText += baseValues.currentPair.currBSign + rowText(currentRow, TotalText);
         }
 
         return lineText;
@@ -272,9 +342,9 @@ QVariant TradesModel::data(const QModelIndex& index, int role) const
         {
             //Date
             if (role == Qt::ToolTipRole || itemsList.at(currentRow).displayFullDate)
-                return itemsList.at(currentRow).dateStr;
+                return rowText(currentRow, DateText);
 
-            return itemsList.at(currentRow).timeStr;
+            return rowText(currentRow, TimeText);
             break;
         }
 
@@ -285,9 +355,9 @@ QVariant TradesModel::data(const QModelIndex& index, int role) const
                 return QVariant();
 
             if (role == Qt::ToolTipRole)
-                return baseValues.currentPair.currASign + itemsList.at(currentRow).amountStr;
+                return baseValues.currentPair.currASign + rowText(currentRow, AmountText);
 
-            return itemsList.at(currentRow).amountStr;
+            return rowText(currentRow, AmountText);
         }
         break;
 
@@ -333,9 +403,9 @@ QVariant TradesModel::data(const QModelIndex& index, int role) const
                 return QVariant();
 
             if (role == Qt::ToolTipRole)
-                return baseValues.currentPair.currBSign + itemsList.at(currentRow).priceStr;
+                return baseValues.currentPair.currBSign + rowText(currentRow, PriceText);
 
-            return itemsList.at(currentRow).priceStr;
+            return rowText(currentRow, PriceText);
         }
         break;
 
@@ -346,9 +416,9 @@ QVariant TradesModel::data(const QModelIndex& index, int role) const
                 return QVariant();
 
             if (role == Qt::ToolTipRole)
-                return baseValues.currentPair.currBSign + itemsList.at(currentRow).totalStr;
+                return baseValues.currentPair.currBSign + rowText(currentRow, TotalText);
 
-            return itemsList.at(currentRow).totalStr;
+            return rowText(currentRow, TotalText);
         }
 
         default:
@@ -412,18 +482,11 @@ QVariant TradesModel::headerData(int section, Qt::Orientation orientation, int r
 
 void TradesModel::updateTotalBTC()
 {
-    double summ = 0.0;
+    double summ = windowVolume.value();
     double bidsSumm = 0.0;
 
-    for (int n = 0; n < itemsList.count(); n++)
-    {
-        summ += itemsList.at(n).amount;
-
-        if (itemsList.at(n).orderType == -1)
-            bidsSumm += itemsList.at(n).amount;
-    }
-
-    bidsSumm = 100.0 * bidsSumm / summ;
+    if (summ > 0.0)
+        bidsSumm = qBound(0.0, 100.0 * windowBidsVolume.value() / summ, 100.0);
 
     if (bidsSumm != lastPrecentBids)
     {
@@ -517,7 +580,13 @@ void TradesModel::addNewTrades(QList<TradesItem>* newItems)
     {
         verifedItems[verifedItems.count() - 1].displayFullDate = true;
         beginInsertRows(QModelIndex(), 0, verifedItems.count() - 1);
-        itemsList << verifedItems;
+
+        for (int n = 0; n < verifedItems.count(); n++)
+        {
+            itemsList.append(verifedItems.at(n));
+            addToWindow(verifedItems.at(n), 1);
+        }
+
         endInsertRows();
     }
 
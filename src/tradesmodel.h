@@ -35,6 +35,8 @@
 #include <QAbstractItemModel>
 #include <QStringList>
 #include "tradesitem.h"
+#include "rowtextcache.h"
+#include "julyringbuffer.h"
 
 class TradesModel : public QAbstractItemModel
 {
@@ -51,6 +53,10 @@ public:
     void removeDataOlderThen(quint32);
     void addNewTrades(QList<TradesItem>*);
 
+    // Trades older than this are dropped by the periodic cleanup, 600 seconds by default
+    void setWindowSeconds(int seconds);
+    int windowSeconds() const;
+
     void setHorizontalHeaderLabels(QStringList list);
 
     QModelIndex index(int row, int column, const QModelIndex& parent = QModelIndex()) const;
@@ -64,9 +70,13 @@ public:
     int columnCount(const QModelIndex& parent = QModelIndex()) const;
 
 private:
+    enum TextField {TimeText, DateText, AmountText, PriceText, TotalText};
+    QString rowText(int row, TextField field) const;
+    mutable RowTextCache textCache;
+
     double lastPrecentBids;
     quint32 lastRemoveDate;
-    void removeFirst();
+    int windowLength;
     QString textBid;
     QString textAsk;
 
@@ -77,7 +87,24 @@ private:
 
     QStringList headerLabels;
 
-    QList<TradesItem> itemsList;
+    // Oldest trade first, the view shows them in reverse
+    JulyRingBuffer<TradesItem> itemsList;
+
+    // Compensated running sums of the trades in itemsList, so taking expired trades out
+    // again does not drift and no pair's volume can overflow them
+    struct WindowSum
+    {
+        double sum;
+        double compensation;
+
+        void clear();
+        void add(double value);
+        double value() const;
+    };
+
+    WindowSum windowVolume;
+    WindowSum windowBidsVolume;
+    void addToWindow(const TradesItem& item, int sign);
 signals:
     void precentBidsChanged(double);
     void trades10MinVolumeChanged(double);